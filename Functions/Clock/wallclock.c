@@ -0,0 +1,187 @@
+/**
+ ****************************************************************************************************
+ * @file        wallclock.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       由服务器对时的墙上时钟实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "wallclock.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static uint8_t  s_synced;                                   /* 1: 已对时 */
+static uint32_t s_base_ms;                                  /* 上次推进时的系统时基 */
+static uint64_t s_base_us;                                  /* 上次推进时的Unix时间 (us) */
+static int32_t  s_frac_ns;                                  /* 不足1us的累计修正量 */
+static int64_t  s_slew_ns;                                  /* 尚未修正完的误差 */
+static uint32_t s_ref_ms;                                   /* 频率估计参考点: 系统时基 */
+static uint64_t s_ref_us;                                   /* 频率估计参考点: 服务器时间 */
+static uint32_t s_ref_rtt;                                  /* 参考点样本的往返时间 */
+static wallclock_stats_t s_stats;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  推进到当前时刻: 按系统时基走时, 叠加频率补偿和逐渐修正
+ * @note   ms * ppm = ns, 修正速率远小于1, 结果单调递增
+ */
+static void wallclock_advance(uint32_t now_ms)
+{
+    uint32_t dt = now_ms - s_base_ms;
+    int64_t adj = (int64_t)dt * s_stats.drift_ppm;
+    int64_t lim, step;
+
+    if (s_slew_ns != 0)
+    {
+        lim = (int64_t)dt * WALLCLOCK_SLEW_PPM;
+        step = s_slew_ns;
+        if (step > lim) step = lim;
+        if (step < -lim) step = -lim;
+        s_slew_ns -= step;
+        adj += step;
+    }
+
+    adj += s_frac_ns;
+    s_base_us = (uint64_t)((int64_t)s_base_us + (int64_t)dt * 1000 + adj / 1000);
+    s_frac_ns = (int32_t)(adj % 1000);
+    s_base_ms = now_ms;
+}
+
+/**
+ * @brief  直接跳变到样本时间, 并以该样本作为频率估计的参考点
+ */
+static void wallclock_step(uint64_t target_us, uint32_t rtt_ms, uint32_t now_ms)
+{
+    s_base_us = target_us;
+    s_base_ms = now_ms;
+    s_frac_ns = 0;
+    s_slew_ns = 0;
+    s_ref_us = target_us;
+    s_ref_ms = now_ms;
+    s_ref_rtt = rtt_ms;
+    s_stats.steps++;
+}
+
+/**
+ * @brief  与参考点比较估计频率偏差, 间隔太短 (RTT误差占比过大) 时不更新
+ */
+static void wallclock_estimate_drift(uint64_t target_us, uint32_t rtt_ms, uint32_t now_ms)
+{
+    uint32_t elapsed = now_ms - s_ref_ms;
+    int64_t ppm;
+
+    /* 两个样本各有 ±rtt/2 的不确定度 */
+    if ((uint64_t)(rtt_ms + s_ref_rtt) * 500000 > (uint64_t)elapsed * WALLCLOCK_DRIFT_ERR_PPM)
+    {
+        return;
+    }
+
+    /* (服务器走过的时间 - 本地走过的时间) / 本地走过的时间, us*1000/ms = ppm */
+    ppm = ((int64_t)(target_us - s_ref_us) - (int64_t)elapsed * 1000) * 1000 / (int64_t)elapsed;
+    if (ppm > WALLCLOCK_DRIFT_MAX_PPM) ppm = WALLCLOCK_DRIFT_MAX_PPM;
+    if (ppm < -WALLCLOCK_DRIFT_MAX_PPM) ppm = -WALLCLOCK_DRIFT_MAX_PPM;
+    s_stats.drift_ppm = (int32_t)ppm;
+
+    /* 间隔接近时基回绕前换用当前样本作参考点 */
+    if (elapsed > 0x7FFFFFFFUL)
+    {
+        s_ref_us = target_us;
+        s_ref_ms = now_ms;
+        s_ref_rtt = rtt_ms;
+    }
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化
+ */
+void wallclock_init(void)
+{
+    s_synced = 0;
+    s_slew_ns = 0;
+    s_frac_ns = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+/**
+ * @brief  输入一个对时样本
+ */
+uint8_t wallclock_sync(uint64_t server_ms, uint32_t rtt_ms, uint32_t now_ms)
+{
+    uint64_t target_us = server_ms * 1000 + (uint64_t)rtt_ms * 500;
+    int64_t err_us;
+
+    if (!s_synced)
+    {
+        wallclock_step(target_us, rtt_ms, now_ms);
+        s_synced = 1;
+        s_stats.syncs++;
+        s_stats.last_err_ms = 0;
+        return 0;
+    }
+
+    if (rtt_ms > WALLCLOCK_MAX_RTT_MS)
+    {
+        s_stats.rejected++;
+        return 1;
+    }
+
+    /* 误差相对于已安排的修正完成后的时间 */
+    wallclock_advance(now_ms);
+    err_us = (int64_t)(target_us - s_base_us) - s_slew_ns / 1000;
+    s_stats.last_err_ms = (int32_t)(err_us / 1000);
+    s_stats.syncs++;
+
+    if (err_us > (int64_t)WALLCLOCK_STEP_MS * 1000 || err_us < -(int64_t)WALLCLOCK_STEP_MS * 1000)
+    {
+        wallclock_step(target_us, rtt_ms, now_ms);
+        return 0;
+    }
+
+    s_slew_ns += err_us * 1000;
+    wallclock_estimate_drift(target_us, rtt_ms, now_ms);
+    return 0;
+}
+
+/**
+ * @brief  当前Unix毫秒时间
+ */
+uint64_t wallclock_now(uint32_t now_ms)
+{
+    if (!s_synced) return 0;
+
+    wallclock_advance(now_ms);
+    return s_base_us / 1000;
+}
+
+/**
+ * @brief  是否已对时
+ */
+uint8_t wallclock_synced(void)
+{
+    return s_synced;
+}
+
+/**
+ * @brief  获取统计信息
+ */
+void wallclock_get_stats(wallclock_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_stats;
+    stats->synced = s_synced;
+    stats->slew_ms = (int32_t)(s_slew_ns / 1000000);
+}
@@ -0,0 +1,88 @@
+/**
+ ****************************************************************************************************
+ * @file        wallclock.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       由服务器对时的墙上时钟 (Unix毫秒)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 在单调的系统时基 millis() 上叠加一个从服务器学到的纪元偏移, 得到Unix毫秒时间
+ * - 对时样本: 服务器报文中的时间戳 + 往返时间的一半 (reg到reg_ok, hb到hb_ok)
+ * - 首次对时或误差超过 WALLCLOCK_STEP_MS 时直接跳变; 否则按不超过 WALLCLOCK_SLEW_PPM 的速率
+ *   逐渐修正 (slew), 时间始终单调递增, 不会因对时回退
+ * - 晶振频率偏差: 以第一次对时为参考点, 间隔足够长 (RTT带来的误差不超过 WALLCLOCK_DRIFT_ERR_PPM)
+ *   后估计频率偏差并持续补偿, 两次对时之间的漂移因此也得到修正
+ * - 往返时间超过 WALLCLOCK_MAX_RTT_MS 的样本误差太大, 已对时后不再采用
+ * - 本模块不依赖任何硬件, 时间由调用方传入, 可在主机下用模拟的时钟验证
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __WALLCLOCK_H
+#define __WALLCLOCK_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define WALLCLOCK_STEP_MS           1000        /* 误差超过该值直接跳变 (ms) */
+#define WALLCLOCK_SLEW_PPM          500         /* 逐渐修正的最大速率 (每秒0.5ms) */
+#define WALLCLOCK_MAX_RTT_MS        3000        /* 已对时后不采用往返时间超过该值的样本 (ms) */
+#define WALLCLOCK_DRIFT_MAX_PPM     500         /* 频率补偿上限 */
+#define WALLCLOCK_DRIFT_ERR_PPM     20          /* 估计频率偏差允许的最大测量误差 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 统计信息 */
+typedef struct {
+    uint8_t  synced;                    /* 1: 已对时 */
+    uint32_t syncs;                     /* 采用的对时样本数 */
+    uint32_t steps;                     /* 跳变次数 (含首次对时) */
+    uint32_t rejected;                  /* 因往返时间过长丢弃的样本数 */
+    int32_t  last_err_ms;               /* 最近一次对时的误差 (服务器时间 - 本地时间) */
+    int32_t  slew_ms;                   /* 尚未修正完的误差 */
+    int32_t  drift_ppm;                 /* 当前频率补偿 (正数表示本地时钟偏慢) */
+} wallclock_stats_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化 (清除对时状态)
+ */
+void wallclock_init(void);
+
+/**
+ * @brief  输入一个对时样本
+ * @param  server_ms: 服务器报文中的Unix毫秒时间
+ * @param  rtt_ms: 该报文对应请求的往返时间, 服务器时间按 server_ms + rtt_ms/2 计算
+ * @param  now_ms: 收到报文时的系统时基 (ms)
+ * @retval 0:已采用 1:往返时间过长被丢弃
+ */
+uint8_t wallclock_sync(uint64_t server_ms, uint32_t rtt_ms, uint32_t now_ms);
+
+/**
+ * @brief  当前Unix毫秒时间
+ * @param  now_ms: 当前系统时基 (ms, 允许回绕, 两次调用间隔不超过49天)
+ * @retval Unix毫秒时间, 0表示尚未对时
+ */
+uint64_t wallclock_now(uint32_t now_ms);
+
+/**
+ * @brief  是否已对时
+ */
+uint8_t wallclock_synced(void);
+
+/**
+ * @brief  获取统计信息
+ */
+void wallclock_get_stats(wallclock_stats_t *stats);
+
+#endif /* __WALLCLOCK_H */
@@ -0,0 +1,201 @@
+/**
+ ****************************************************************************************************
+ * @file        control.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       规则表驱动的自动控制引擎实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "control.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static ctrl_config_t s_cfg;                                 /* 引擎配置 */
+static uint8_t  s_act_on[CTRL_MAX_ACTUATORS];               /* 引擎记录的执行器状态 */
+static uint32_t s_act_since[CTRL_MAX_ACTUATORS];            /* 执行器上次切换时间 */
+static uint8_t  s_level[CTRL_MAX_SENSORS];                  /* 各传感器告警等级 */
+static ctrl_event_fn_t s_subs[CTRL_MAX_SUBSCRIBERS];        /* 事件订阅者 */
+static uint8_t  s_sub_count = 0;
+static ctrl_stats_t s_stats;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  通知所有订阅者
+ */
+static void ctrl_publish(uint8_t type, uint8_t index, uint8_t value)
+{
+    ctrl_event_t evt;
+    uint8_t i;
+
+    evt.type = type;
+    evt.index = index;
+    evt.value = value;
+
+    for (i = 0; i < s_sub_count; i++)
+    {
+        s_subs[i](&evt);
+    }
+}
+
+/**
+ * @brief  按规则和当前状态计算执行器期望状态 (带回差)
+ */
+static uint8_t ctrl_rule_want(const ctrl_rule_t *r, uint8_t v, uint8_t on)
+{
+    int16_t th = *r->threshold;
+
+    if (r->cmp == CTRL_CMP_ABOVE)
+    {
+        return on ? (v > th - r->hysteresis) : (v > th);
+    }
+    return on ? (v < th + r->hysteresis) : (v < th);
+}
+
+/**
+ * @brief  计算告警等级 (带回差)
+ */
+static uint8_t ctrl_band_level(const ctrl_band_t *b, uint8_t v, uint8_t level)
+{
+    if (b->upper != NULL)
+    {
+        if (v > *b->upper) return CTRL_LEVEL_HIGH;
+        if (level == CTRL_LEVEL_HIGH && v > (int16_t)*b->upper - b->hysteresis) return CTRL_LEVEL_HIGH;
+    }
+    if (b->lower != NULL)
+    {
+        if (v < *b->lower) return CTRL_LEVEL_LOW;
+        if (level == CTRL_LEVEL_LOW && v < (int16_t)*b->lower + b->hysteresis) return CTRL_LEVEL_LOW;
+    }
+    return CTRL_LEVEL_NORMAL;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化引擎
+ */
+uint8_t ctrl_init(const ctrl_config_t *cfg, uint32_t now_ms)
+{
+    uint8_t i;
+
+    if (cfg == NULL || cfg->rule_count > CTRL_MAX_RULES || cfg->actuator_count > CTRL_MAX_ACTUATORS ||
+        cfg->sensor_count > CTRL_MAX_SENSORS)
+    {
+        return 1;
+    }
+
+    s_cfg = *cfg;
+    s_sub_count = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_level, CTRL_LEVEL_NORMAL, sizeof(s_level));
+
+    for (i = 0; i < cfg->actuator_count; i++)
+    {
+        s_act_on[i] = *cfg->actuators[i].state;
+        s_act_since[i] = now_ms;
+    }
+    return 0;
+}
+
+/**
+ * @brief  订阅事件
+ */
+uint8_t ctrl_subscribe(ctrl_event_fn_t fn)
+{
+    if (fn == NULL || s_sub_count >= CTRL_MAX_SUBSCRIBERS) return 1;
+    s_subs[s_sub_count++] = fn;
+    return 0;
+}
+
+/**
+ * @brief  执行一个控制周期
+ */
+void ctrl_step(const uint8_t *values, uint8_t auto_mode, uint32_t now_ms)
+{
+    const ctrl_rule_t *r;
+    const ctrl_actuator_t *act;
+    uint8_t i, a, want, level;
+    uint32_t hold;
+
+    s_stats.steps++;
+
+    /* 执行器状态被手动/远程控制改变: 以实际状态为准并重新计时 */
+    for (a = 0; a < s_cfg.actuator_count; a++)
+    {
+        if (*s_cfg.actuators[a].state != s_act_on[a])
+        {
+            s_act_on[a] = *s_cfg.actuators[a].state;
+            s_act_since[a] = now_ms;
+        }
+    }
+
+    /* 控制规则 */
+    for (i = 0; auto_mode && i < s_cfg.rule_count; i++)
+    {
+        r = &s_cfg.rules[i];
+        a = r->actuator;
+        if (a >= s_cfg.actuator_count || r->sensor >= s_cfg.sensor_count) continue;
+        if (values[r->sensor] == CTRL_VALUE_INVALID) continue;
+
+        want = ctrl_rule_want(r, values[r->sensor], s_act_on[a]);
+        if (want == s_act_on[a]) continue;
+
+        hold = s_act_on[a] ? r->min_on_ms : r->min_off_ms;
+        if (now_ms - s_act_since[a] < hold)
+        {
+            s_stats.held++;
+            continue;
+        }
+
+        act = &s_cfg.actuators[a];
+        act->set(want);
+        *act->state = want;
+        s_act_on[a] = want;
+        s_act_since[a] = now_ms;
+        s_stats.switches++;
+        ctrl_publish(CTRL_EVT_ACTUATOR, a, want);
+    }
+
+    /* 告警等级 */
+    for (i = 0; s_cfg.bands != NULL && i < s_cfg.sensor_count; i++)
+    {
+        if (values[i] == CTRL_VALUE_INVALID) continue;
+
+        level = ctrl_band_level(&s_cfg.bands[i], values[i], s_level[i]);
+        if (level != s_level[i])
+        {
+            s_level[i] = level;
+            s_stats.level_changes++;
+            ctrl_publish(CTRL_EVT_LEVEL, i, level);
+        }
+    }
+}
+
+/**
+ * @brief  获取传感器的告警等级
+ */
+uint8_t ctrl_get_level(uint8_t sensor)
+{
+    return (sensor < CTRL_MAX_SENSORS) ? s_level[sensor] : CTRL_LEVEL_NORMAL;
+}
+
+/**
+ * @brief  获取统计信息
+ */
+void ctrl_get_stats(ctrl_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_stats;
+}
@@ -0,0 +1,151 @@
+/**
+ ****************************************************************************************************
+ * @file        control.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       规则表驱动的自动控制引擎
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 每条规则: 传感器 + 比较方式 + 阈值 + 回差 + 最短开/关时间 + 执行器
+ *   ABOVE: 数值 > 阈值时开启, 降到 阈值-回差 及以下时关闭
+ *   BELOW: 数值 < 阈值时开启, 升到 阈值+回差 及以上时关闭
+ *   执行器开启/关闭后至少保持 min_on_ms/min_off_ms 才允许再次切换, 防止继电器抖动
+ * - 阈值以指针引用, 界面或服务器修改阈值后下一个控制周期立即生效
+ * - 每个传感器还可配置上下限区间, 引擎据此给出告警等级 (同样带回差)
+ * - 执行器切换和告警等级变化以事件通知订阅者 (界面着色、上报等), 引擎本身不依赖界面
+ * - 手动模式下不驱动执行器, 只跟踪执行器的实际状态 (手动/远程控制改变状态时重新计时)
+ * - 传感器值为 CTRL_VALUE_INVALID (传感器失效/读数过期) 时, 依赖它的规则保持执行器当前状态,
+ *   告警等级也保持不变
+ * - 本模块不依赖任何硬件, 执行器通过回调驱动, 可在主机下用模拟的传感器序列验证
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __CONTROL_H
+#define __CONTROL_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define CTRL_MAX_RULES          8           /* 最大规则数 */
+#define CTRL_MAX_ACTUATORS      8           /* 最大执行器数 */
+#define CTRL_MAX_SENSORS        8           /* 最大传感器数 */
+#define CTRL_MAX_SUBSCRIBERS    4           /* 最大事件订阅者数 */
+
+/******************************************************************************************/
+/* 定义 */
+
+/* 比较方式 */
+#define CTRL_CMP_ABOVE          0           /* 高于阈值时开启 */
+#define CTRL_CMP_BELOW          1           /* 低于阈值时开启 */
+
+/* 告警等级 */
+#define CTRL_LEVEL_NORMAL       0           /* 正常 */
+#define CTRL_LEVEL_HIGH         1           /* 超上限 */
+#define CTRL_LEVEL_LOW          2           /* 低于下限 */
+
+/* 传感器无效值 (传感器失效或读数过期) */
+#define CTRL_VALUE_INVALID      0xFF
+
+/* 事件类型 */
+#define CTRL_EVT_ACTUATOR       0           /* 执行器切换, index为执行器编号, value为新状态 */
+#define CTRL_EVT_LEVEL          1           /* 告警等级变化, index为传感器编号, value为CTRL_LEVEL_* */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 控制规则 */
+typedef struct {
+    uint8_t  sensor;                    /* 传感器编号 */
+    uint8_t  cmp;                       /* 比较方式 CTRL_CMP_* */
+    const uint8_t *threshold;           /* 阈值 */
+    uint8_t  hysteresis;                /* 回差 */
+    uint32_t min_on_ms;                 /* 最短开启时间 (ms) */
+    uint32_t min_off_ms;                /* 最短关闭时间 (ms) */
+    uint8_t  actuator;                  /* 执行器编号, 每个执行器最多对应一条规则 */
+} ctrl_rule_t;
+
+/* 执行器 */
+typedef struct {
+    void (*set)(uint8_t on);            /* 驱动执行器 */
+    uint8_t *state;                     /* 执行器当前状态 (手动/远程控制也会修改) */
+} ctrl_actuator_t;
+
+/* 传感器告警区间 */
+typedef struct {
+    const uint8_t *upper;               /* 上限, NULL表示不判断 */
+    const uint8_t *lower;               /* 下限, NULL表示不判断 */
+    uint8_t hysteresis;                 /* 回差 */
+} ctrl_band_t;
+
+/* 引擎配置 (表格均需长期有效) */
+typedef struct {
+    const ctrl_rule_t *rules;
+    uint8_t rule_count;
+    const ctrl_actuator_t *actuators;
+    uint8_t actuator_count;
+    const ctrl_band_t *bands;           /* 每个传感器一项, NULL表示不计算告警等级 */
+    uint8_t sensor_count;
+} ctrl_config_t;
+
+/* 事件 */
+typedef struct {
+    uint8_t type;                       /* CTRL_EVT_* */
+    uint8_t index;                      /* 执行器或传感器编号 */
+    uint8_t value;                      /* 新状态或等级 */
+} ctrl_event_t;
+
+typedef void (*ctrl_event_fn_t)(const ctrl_event_t *evt);
+
+/* 统计信息 */
+typedef struct {
+    uint32_t steps;                     /* 控制周期数 */
+    uint32_t switches;                  /* 执行器切换次数 */
+    uint32_t held;                      /* 因最短开/关时间未到而推迟切换的次数 (每周期计一次) */
+    uint32_t level_changes;             /* 告警等级变化次数 */
+} ctrl_stats_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化引擎 (清除订阅者和状态)
+ * @param  cfg: 引擎配置
+ * @param  now_ms: 当前时间, 执行器的最短开/关时间从此刻开始计算
+ * @retval 0:成功 1:配置超出容量
+ */
+uint8_t ctrl_init(const ctrl_config_t *cfg, uint32_t now_ms);
+
+/**
+ * @brief  订阅事件
+ * @retval 0:成功 1:订阅者已满
+ */
+uint8_t ctrl_subscribe(ctrl_event_fn_t fn);
+
+/**
+ * @brief  执行一个控制周期
+ * @param  values: 各传感器当前值 (sensor_count个), CTRL_VALUE_INVALID表示无效
+ * @param  auto_mode: 1:自动模式, 按规则驱动执行器 0:手动模式, 只跟踪状态
+ * @param  now_ms: 当前时间 (ms, 允许回绕)
+ */
+void ctrl_step(const uint8_t *values, uint8_t auto_mode, uint32_t now_ms);
+
+/**
+ * @brief  获取传感器的告警等级
+ * @retval CTRL_LEVEL_*
+ */
+uint8_t ctrl_get_level(uint8_t sensor);
+
+/**
+ * @brief  获取统计信息
+ */
+void ctrl_get_stats(ctrl_stats_t *stats);
+
+#endif /* __CONTROL_H */
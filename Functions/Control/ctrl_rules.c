@@ -0,0 +1,106 @@
+/**
+ ****************************************************************************************************
+ * @file        ctrl_rules.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       花盆自动控制规则表实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "ctrl_rules.h"
+#include "ui.h"
+#include "led.h"
+#include "bump.h"
+#include "timer.h"
+
+/******************************************************************************************/
+/* 执行器驱动 */
+
+static void fan_set(uint8_t on)
+{
+    if (on) FUN_ON; else FUN_OFF;
+}
+
+static void pump_set(uint8_t on)
+{
+    if (on) BUMP_ON; else BUMP_OFF;
+}
+
+static void light_set(uint8_t on)
+{
+    LED1 = on ? 0 : 1;      /* 低电平点亮 */
+}
+
+/******************************************************************************************/
+/* 规则表 */
+
+static const ctrl_actuator_t s_actuators[CTRL_ACT_NUM] = {
+    {fan_set,   &fun_status},
+    {pump_set,  &water_status},
+    {light_set, &light_status},
+};
+
+static const ctrl_rule_t s_rules[] = {
+    /* 传感器           比较方式        阈值                     回差             最短开启              最短关闭               执行器 */
+    {CTRL_SENSOR_TEMP,  CTRL_CMP_ABOVE, &lim_value.temp_upper,   CTRL_HYST_TEMP,  CTRL_FAN_MIN_ON_MS,   CTRL_FAN_MIN_OFF_MS,   CTRL_ACT_FAN},
+    {CTRL_SENSOR_LIGHT, CTRL_CMP_BELOW, &lim_value.light_lower,  CTRL_HYST_LIGHT, CTRL_LIGHT_MIN_ON_MS, CTRL_LIGHT_MIN_OFF_MS, CTRL_ACT_LIGHT},
+};
+
+static const ctrl_band_t s_bands[CTRL_SENSOR_NUM] = {
+    {&lim_value.temp_upper,  &lim_value.temp_lower,  CTRL_HYST_TEMP},
+    {&lim_value.humi_upper,  &lim_value.humi_lower,  CTRL_HYST_HUMI},
+    {&lim_value.shumi_upper, &lim_value.shumi_lower, CTRL_HYST_SOIL},
+    {&lim_value.light_upper, &lim_value.light_lower, CTRL_HYST_LIGHT},
+};
+
+static const ctrl_config_t s_config = {
+    s_rules, sizeof(s_rules) / sizeof(s_rules[0]),
+    s_actuators, CTRL_ACT_NUM,
+    s_bands, CTRL_SENSOR_NUM,
+};
+
+/* 水泵不在规则表中, 由脉冲-渗透浇水控制器驱动 */
+static const water_config_t s_water = {
+    {pump_set, &water_status},
+    &lim_value.shumi_lower, &lim_value.shumi_upper,
+    WATER_MS_PER_PCT, WATER_MIN_PULSE_MS, WATER_MAX_PULSE_MS,
+    WATER_SOAK_MS, WATER_HOUR_CAP_MS, WATER_FLOW_ML_MIN, WATER_DRY_PULSES,
+};
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  加载规则表并初始化控制引擎
+ */
+void ctrl_rules_init(void)
+{
+    uint32_t now = millis();
+
+    ctrl_init(&s_config, now);
+    water_init(&s_water, now);
+}
+
+/**
+ * @brief  控制周期
+ */
+void ctrl_rules_step(void)
+{
+    uint8_t values[CTRL_SENSOR_NUM];
+    uint32_t now = millis();
+
+    /* DHT11读数过期时不按旧值控制风扇, 温湿度告警等级保持不变 */
+    values[CTRL_SENSOR_TEMP] = dht_stale ? CTRL_VALUE_INVALID : temp;
+    values[CTRL_SENSOR_HUMI] = dht_stale ? CTRL_VALUE_INVALID : humi;
+    values[CTRL_SENSOR_SOIL] = soil_humi;
+    values[CTRL_SENSOR_LIGHT] = light_intensity;
+
+    ctrl_step(values, mode == 0, now);
+    water_step(soil_humi, mode == 0, now);
+}
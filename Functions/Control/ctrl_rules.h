@@ -0,0 +1,79 @@
+/**
+ ****************************************************************************************************
+ * @file        ctrl_rules.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       花盆自动控制规则表 (传感器/执行器绑定)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 规则 (阈值取自 lim_value, 自动模式下生效):
+ * - 风扇:   温度 > 温度上限 开启, 降到 上限-CTRL_HYST_TEMP 及以下关闭
+ * - 水泵:   土壤湿度 < 土壤湿度下限 开始脉冲浇水, 每个脉冲后等待渗透再读数, 直到达到上下限中点 (见 watering.h)
+ * - 补光灯: 光照 < 光照下限 开启, 升到 下限+CTRL_HYST_LIGHT 及以上关闭
+ * 四个传感器都按各自上下限给出告警等级, 界面据此着色
+ * DHT11读数过期 (dht_stale) 时温湿度视为无效, 风扇规则和温湿度告警等级暂停
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __CTRL_RULES_H
+#define __CTRL_RULES_H
+
+#include "control.h"
+#include "watering.h"
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define CTRL_HYST_TEMP          1           /* 温度回差 (°C) */
+#define CTRL_HYST_HUMI          2           /* 空气湿度回差 (%), 仅用于告警等级 */
+#define CTRL_HYST_SOIL          3           /* 土壤湿度回差 (%), 仅用于告警等级 */
+#define CTRL_HYST_LIGHT         5           /* 光照强度回差 (%) */
+
+#define CTRL_FAN_MIN_ON_MS      30000       /* 风扇最短开启时间 */
+#define CTRL_FAN_MIN_OFF_MS     30000       /* 风扇最短关闭时间 */
+#define CTRL_LIGHT_MIN_ON_MS    60000       /* 补光灯最短开启时间 */
+#define CTRL_LIGHT_MIN_OFF_MS   60000       /* 补光灯最短关闭时间 */
+
+#define WATER_MS_PER_PCT        500         /* 每1%缺水量的脉冲时长 (ms) */
+#define WATER_MIN_PULSE_MS      1000        /* 最短脉冲 */
+#define WATER_MAX_PULSE_MS      5000        /* 单次脉冲最长开泵时间 */
+#define WATER_SOAK_MS           180000      /* 渗透等待时间 (3分钟) */
+#define WATER_HOUR_CAP_MS       30000       /* 每小时最长开泵时间 */
+#define WATER_FLOW_ML_MIN       300         /* 水泵流量 (ml/min), 按实际水泵标定 */
+#define WATER_DRY_PULSES        4           /* 连续4个脉冲读数不升判为故障 */
+
+/******************************************************************************************/
+/* 编号定义 */
+
+/* 传感器 */
+#define CTRL_SENSOR_TEMP        0           /* 温度 */
+#define CTRL_SENSOR_HUMI        1           /* 空气湿度 */
+#define CTRL_SENSOR_SOIL        2           /* 土壤湿度 */
+#define CTRL_SENSOR_LIGHT       3           /* 光照强度 */
+#define CTRL_SENSOR_NUM         4
+
+/* 执行器 */
+#define CTRL_ACT_FAN            0           /* 风扇 */
+#define CTRL_ACT_PUMP           1           /* 水泵 */
+#define CTRL_ACT_LIGHT          2           /* 补光灯 */
+#define CTRL_ACT_NUM            3
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  加载规则表并初始化控制引擎 (执行器初始化之后调用)
+ */
+void ctrl_rules_init(void);
+
+/**
+ * @brief  控制周期: 读取当前传感器值和模式, 执行控制引擎 (与当前界面无关)
+ */
+void ctrl_rules_step(void);
+
+#endif /* __CTRL_RULES_H */
@@ -0,0 +1,249 @@
+/**
+ ****************************************************************************************************
+ * @file        watering.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       脉冲-渗透浇水控制器实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "watering.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static water_config_t s_cfg;                                /* 配置 */
+static uint8_t  s_state = WATER_IDLE;                       /* 当前状态 */
+static uint32_t s_phase_start;                              /* 当前脉冲/渗透的开始时间 */
+static uint32_t s_pulse_len;                                /* 当前脉冲时长 */
+static uint8_t  s_soil_ref;                                 /* 当前脉冲开始时的读数 */
+static uint8_t  s_dry;                                      /* 连续读数不升的脉冲数 */
+static uint8_t  s_pump_seen;                                /* 上个周期观察到的水泵状态 */
+static uint32_t s_last_ms;                                  /* 上个周期的时间 */
+static uint32_t s_slot_ms[WATER_WINDOW_SLOTS];              /* 每小时窗口内各格的开泵时间 */
+static uint32_t s_slot_idx;                                 /* 当前格编号 (now / WATER_SLOT_MS) */
+static water_stats_t s_stats;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  累计开泵时间 (含手动/远程开泵), 更新每小时窗口
+ */
+static void water_account(uint32_t now_ms)
+{
+    uint32_t idx = now_ms / WATER_SLOT_MS;
+    uint32_t dt = now_ms - s_last_ms;
+    uint32_t n;
+
+    /* 进入新的格: 清除已滑出窗口的格 (时间回绕时全部清除) */
+    if (idx != s_slot_idx)
+    {
+        n = idx - s_slot_idx;
+        if (n >= WATER_WINDOW_SLOTS)
+        {
+            memset(s_slot_ms, 0, sizeof(s_slot_ms));
+        }
+        else
+        {
+            while (n--)
+            {
+                s_slot_ms[(idx - n) % WATER_WINDOW_SLOTS] = 0;
+            }
+        }
+        s_slot_idx = idx;
+    }
+
+    if (s_pump_seen)
+    {
+        s_stats.on_ms += dt;
+        s_slot_ms[idx % WATER_WINDOW_SLOTS] += dt;
+    }
+
+    s_pump_seen = *s_cfg.pump.state;
+    s_last_ms = now_ms;
+}
+
+/**
+ * @brief  最近一小时开泵时间
+ */
+static uint32_t water_hour_used(void)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < WATER_WINDOW_SLOTS; i++)
+    {
+        sum += s_slot_ms[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief  驱动水泵
+ */
+static void water_pump(uint8_t on)
+{
+    s_cfg.pump.set(on);
+    *s_cfg.pump.state = on;
+    s_pump_seen = on;
+}
+
+/**
+ * @brief  按缺水量开始一个脉冲, 时长不超过单次上限和本小时剩余额度
+ * @retval 0:已开泵 1:本小时额度不足
+ */
+static uint8_t water_start_pulse(uint8_t soil, uint8_t target, uint32_t now_ms)
+{
+    uint32_t used = water_hour_used();
+    uint32_t len = (uint32_t)(target - soil) * s_cfg.ms_per_pct;
+
+    if (len < s_cfg.min_pulse_ms) len = s_cfg.min_pulse_ms;
+    if (len > s_cfg.max_pulse_ms) len = s_cfg.max_pulse_ms;
+
+    if (used >= s_cfg.hour_cap_ms || s_cfg.hour_cap_ms - used < s_cfg.min_pulse_ms)
+    {
+        return 1;
+    }
+    if (len > s_cfg.hour_cap_ms - used) len = s_cfg.hour_cap_ms - used;
+
+    s_pulse_len = len;
+    s_soil_ref = soil;
+    s_phase_start = now_ms;
+    s_state = WATER_PULSE;
+    s_stats.pulses++;
+    water_pump(1);
+    return 0;
+}
+
+/**
+ * @brief  开始脉冲, 额度不足时进入暂停状态
+ */
+static void water_try_pulse(uint8_t soil, uint8_t target, uint32_t now_ms)
+{
+    if (water_start_pulse(soil, target, now_ms))
+    {
+        s_state = WATER_CAPPED;
+        s_stats.capped++;
+    }
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化浇水控制器
+ */
+void water_init(const water_config_t *cfg, uint32_t now_ms)
+{
+    s_cfg = *cfg;
+    s_state = WATER_IDLE;
+    s_dry = 0;
+    s_pump_seen = *cfg->pump.state;
+    s_last_ms = now_ms;
+    s_slot_idx = now_ms / WATER_SLOT_MS;
+    memset(s_slot_ms, 0, sizeof(s_slot_ms));
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+/**
+ * @brief  执行一个控制周期
+ */
+void water_step(uint8_t soil, uint8_t auto_mode, uint32_t now_ms)
+{
+    uint8_t lower = *s_cfg.lower;
+    uint8_t target = lower + (uint8_t)((*s_cfg.upper > lower) ? (*s_cfg.upper - lower) / 2 : 0);
+
+    water_account(now_ms);
+
+    /* 手动模式: 停止正在进行的脉冲, 清除故障 */
+    if (!auto_mode)
+    {
+        if (s_state == WATER_PULSE && *s_cfg.pump.state)
+        {
+            water_pump(0);
+        }
+        s_state = WATER_IDLE;
+        s_dry = 0;
+        return;
+    }
+
+    switch (s_state)
+    {
+        case WATER_IDLE:
+            if (soil < lower)
+            {
+                water_try_pulse(soil, target, now_ms);
+            }
+            break;
+
+        case WATER_PULSE:
+            /* 到时、超出本小时额度或被远程关泵都结束脉冲 */
+            if (now_ms - s_phase_start >= s_pulse_len || !*s_cfg.pump.state ||
+                water_hour_used() >= s_cfg.hour_cap_ms)
+            {
+                if (*s_cfg.pump.state) water_pump(0);
+                s_stats.last_pulse_ms = now_ms - s_phase_start;
+                s_phase_start = now_ms;
+                s_state = WATER_SOAK;
+            }
+            break;
+
+        case WATER_SOAK:
+            if (now_ms - s_phase_start < s_cfg.soak_ms) break;
+
+            /* 渗透结束, 重新读数 */
+            s_dry = (soil <= s_soil_ref) ? s_dry + 1 : 0;
+            if (soil >= target)
+            {
+                s_state = WATER_IDLE;
+                s_dry = 0;
+                s_stats.cycles++;
+            }
+            else if (s_cfg.dry_pulses && s_dry >= s_cfg.dry_pulses)
+            {
+                s_state = WATER_FAULT;
+                s_stats.faults++;
+            }
+            else
+            {
+                water_try_pulse(soil, target, now_ms);
+            }
+            break;
+
+        case WATER_CAPPED:
+            /* 窗口内开泵时间回落后重新判断 */
+            if (water_hour_used() + s_cfg.min_pulse_ms <= s_cfg.hour_cap_ms)
+            {
+                s_state = WATER_IDLE;
+                if (soil < target)
+                {
+                    water_try_pulse(soil, target, now_ms);
+                }
+            }
+            break;
+
+        default:
+            /* 故障锁定, 等待切换到手动模式 */
+            break;
+    }
+}
+
+/**
+ * @brief  获取统计信息
+ */
+void water_get_stats(water_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_stats;
+    stats->state = s_state;
+    stats->hour_on_ms = water_hour_used();
+    stats->delivered_ml = (uint32_t)((uint64_t)s_stats.on_ms * s_cfg.flow_ml_min / 60000);
+}
@@ -0,0 +1,100 @@
+/**
+ ****************************************************************************************************
+ * @file        watering.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       脉冲-渗透浇水控制器
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 土壤湿度传感器读数明显滞后于浇水, 开泵直到读数达标必然浇多, 因此改为:
+ *   读数低于下限 -> 开泵一个脉冲 -> 关泵等待渗透 -> 重新读数, 未达到目标 (上下限中点) 则再浇一个脉冲
+ * - 脉冲时长与缺水量成正比 (ms_per_pct), 并限制在 [min_pulse_ms, max_pulse_ms] 内
+ * - 防失控:
+ *   每小时 (滑动窗口, 10分钟一格) 开泵总时长不超过 hour_cap_ms, 超出后暂停到窗口内时长回落;
+ *   连续 dry_pulses 个脉冲后读数都没有上升 (水箱空/传感器脱落/水管漏水) 则进入故障锁定,
+ *   切换到手动模式再切回自动模式后解除
+ * - 出水量按开泵时间和水泵流量估算, 手动/远程开泵也计入
+ * - 手动模式下不驱动水泵; 自动模式切到手动时若正在脉冲则立即关泵
+ * - 本模块不依赖任何硬件, 水泵通过 ctrl_actuator_t 驱动 (与控制引擎共用同一个执行器)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __WATERING_H
+#define __WATERING_H
+
+#include <stdint.h>
+#include "control.h"
+
+/******************************************************************************************/
+/* 定义 */
+
+/* 状态 */
+#define WATER_IDLE              0           /* 空闲, 等待读数低于下限 */
+#define WATER_PULSE             1           /* 正在浇水脉冲 */
+#define WATER_SOAK              2           /* 关泵等待渗透 */
+#define WATER_CAPPED            3           /* 达到每小时上限, 暂停 */
+#define WATER_FAULT             4           /* 连续脉冲读数不升, 故障锁定 */
+
+#define WATER_WINDOW_SLOTS      6           /* 每小时滑动窗口格数 */
+#define WATER_SLOT_MS           600000      /* 每格时长 (10分钟) */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 配置 */
+typedef struct {
+    ctrl_actuator_t pump;               /* 水泵 */
+    const uint8_t *lower;               /* 土壤湿度下限 (低于此值开始浇水) */
+    const uint8_t *upper;               /* 土壤湿度上限 (目标为上下限中点) */
+    uint16_t ms_per_pct;                /* 每1%缺水量对应的脉冲时长 (ms) */
+    uint32_t min_pulse_ms;              /* 最短脉冲 */
+    uint32_t max_pulse_ms;              /* 单次脉冲最长开泵时间 */
+    uint32_t soak_ms;                   /* 渗透等待时间 */
+    uint32_t hour_cap_ms;               /* 每小时最长开泵时间 */
+    uint16_t flow_ml_min;               /* 水泵流量 (ml/min) */
+    uint8_t  dry_pulses;                /* 连续多少个脉冲读数不升判为故障, 0表示不检测 */
+} water_config_t;
+
+/* 统计信息 */
+typedef struct {
+    uint8_t  state;                     /* 当前状态 WATER_* */
+    uint32_t pulses;                    /* 浇水脉冲数 */
+    uint32_t cycles;                    /* 完成的浇水过程数 (读数达到目标) */
+    uint32_t on_ms;                     /* 累计开泵时间 (含手动) */
+    uint32_t delivered_ml;              /* 累计出水量估算 (ml) */
+    uint32_t hour_on_ms;                /* 最近一小时开泵时间 */
+    uint32_t last_pulse_ms;             /* 上一个脉冲时长 */
+    uint32_t capped;                    /* 触发每小时上限的次数 */
+    uint32_t faults;                    /* 故障锁定次数 */
+} water_stats_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化浇水控制器
+ * @param  cfg: 配置 (需长期有效)
+ * @param  now_ms: 当前时间
+ */
+void water_init(const water_config_t *cfg, uint32_t now_ms);
+
+/**
+ * @brief  执行一个控制周期 (建议200ms以内调用一次, 脉冲时长精度取决于调用周期)
+ * @param  soil: 当前土壤湿度
+ * @param  auto_mode: 1:自动模式 0:手动模式
+ * @param  now_ms: 当前时间 (ms, 允许回绕)
+ */
+void water_step(uint8_t soil, uint8_t auto_mode, uint32_t now_ms);
+
+/**
+ * @brief  获取统计信息
+ */
+void water_get_stats(water_stats_t *stats);
+
+#endif /* __WATERING_H */
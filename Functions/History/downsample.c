@@ -0,0 +1,107 @@
+/**
+ ****************************************************************************************************
+ * @file        downsample.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       时间序列流式降采样实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "downsample.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  输出当前桶并进入下一个桶
+ */
+static void ds_close_bucket(ds_minmax_t *ds)
+{
+    ds->emit(ds->has, ds->min, ds->max, ds->arg);
+    ds->has = 0;
+    ds->end += ds->bucket_s;
+}
+
+/**
+ * @brief  跳过超出max_gap的空桶, 只保留最后max_gap个
+ */
+static void ds_skip_gap(ds_minmax_t *ds, uint32_t t)
+{
+    uint32_t n;
+
+    if (ds->has || t < ds->end) return;
+
+    n = (t - ds->end) / ds->bucket_s + 1;       /* 在t之前结束的桶数 */
+    if (n > ds->max_gap)
+    {
+        ds->end += (n - ds->max_gap) * ds->bucket_s;
+    }
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化降采样器
+ */
+void ds_minmax_init(ds_minmax_t *ds, uint32_t t_start, uint32_t bucket_s, uint16_t max_gap,
+                    ds_emit_fn_t emit, void *arg)
+{
+    memset(ds, 0, sizeof(ds_minmax_t));
+    ds->bucket_s = bucket_s ? bucket_s : 1;
+    ds->end = t_start + ds->bucket_s;
+    ds->max_gap = max_gap ? max_gap : 1;
+    ds->emit = emit;
+    ds->arg = arg;
+}
+
+/**
+ * @brief  输入一个样本
+ */
+void ds_minmax_add(ds_minmax_t *ds, uint32_t ts, uint8_t v)
+{
+    if (ts + ds->bucket_s < ds->end) return;
+
+    if (ts >= ds->end)
+    {
+        ds_minmax_advance(ds, ts);
+    }
+
+    if (!ds->has)
+    {
+        ds->min = v;
+        ds->max = v;
+        ds->has = 1;
+    }
+    else if (v < ds->min)
+    {
+        ds->min = v;
+    }
+    else if (v > ds->max)
+    {
+        ds->max = v;
+    }
+}
+
+/**
+ * @brief  时间推进到t
+ */
+uint16_t ds_minmax_advance(ds_minmax_t *ds, uint32_t t)
+{
+    uint16_t n = 0;
+
+    while (t >= ds->end)
+    {
+        ds_close_bucket(ds);
+        n++;
+        ds_skip_gap(ds, t);
+    }
+    return n;
+}
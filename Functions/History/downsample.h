@@ -0,0 +1,73 @@
+/**
+ ****************************************************************************************************
+ * @file        downsample.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       时间序列流式降采样 (按时间分桶的最小/最大值)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 时间轴按 bucket_s 秒切分为桶, 每个桶输出其中样本的最小值和最大值, 一个桶对应图表上的一个点
+ * - 样本按时间顺序逐个输入, 桶结束时立即通过回调输出, 只保存当前桶的状态,
+ *   内存占用与历史数据量和图表宽度都无关
+ * - 最小/最大值能保留短时尖峰 (例如浇水前后土壤湿度的突变), 且支持逐点追加;
+ *   LTTB 需要下一个桶的平均值才能确定当前桶的取点, 要多缓存一个桶, 这里不采用
+ * - 没有样本的桶输出为无效点, 图表上显示为断线
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __DOWNSAMPLE_H
+#define __DOWNSAMPLE_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 桶输出回调: valid为0表示该桶没有样本 */
+typedef void (*ds_emit_fn_t)(uint8_t valid, uint8_t min, uint8_t max, void *arg);
+
+/* 降采样器 */
+typedef struct {
+    uint32_t bucket_s;                  /* 桶宽 (秒) */
+    uint32_t end;                       /* 当前桶的结束时间 (不含) */
+    uint16_t max_gap;                   /* 长时间无数据时最多连续输出的空桶数 (通常为图表点数) */
+    uint8_t  min;                       /* 当前桶最小值 */
+    uint8_t  max;                       /* 当前桶最大值 */
+    uint8_t  has;                       /* 1: 当前桶已有样本 */
+    ds_emit_fn_t emit;                  /* 桶输出回调 */
+    void *arg;                          /* 回调参数 */
+} ds_minmax_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化降采样器
+ * @param  t_start: 第一个桶的起始时间 (秒)
+ * @param  bucket_s: 桶宽 (秒)
+ * @param  max_gap: 最多连续输出的空桶数
+ * @param  emit: 桶输出回调
+ * @param  arg: 回调参数
+ */
+void ds_minmax_init(ds_minmax_t *ds, uint32_t t_start, uint32_t bucket_s, uint16_t max_gap,
+                    ds_emit_fn_t emit, void *arg);
+
+/**
+ * @brief  输入一个样本 (时间应不减, 早于当前桶的样本被忽略)
+ */
+void ds_minmax_add(ds_minmax_t *ds, uint32_t ts, uint8_t v);
+
+/**
+ * @brief  时间推进到t: 输出所有在t之前 (含t) 结束的桶
+ * @note   调用前应已输入所有早于t的样本
+ * @retval 输出的桶数
+ */
+uint16_t ds_minmax_advance(ds_minmax_t *ds, uint32_t t);
+
+#endif /* __DOWNSAMPLE_H */
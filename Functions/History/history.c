@@ -0,0 +1,184 @@
+/**
+ ****************************************************************************************************
+ * @file        history.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       传感器历史数据存储实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 扇区擦除 (典型45ms) 在记录任务中同步执行, 每写满4KB才发生一次。
+ *
+ ****************************************************************************************************
+ */
+
+#include "history.h"
+#include "w25qxx.h"
+#include "timer.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static tslog_t s_log;                   /* 日志实例 */
+static uint8_t s_ready = 0;             /* 1: 已挂载 */
+static uint32_t s_time_base = 0;        /* 上电时刻对应的历史时间 (秒) */
+static const uint32_t s_log_base = HISTORY_FLASH_BASE;      /* 日志区起始地址 */
+static const uint32_t s_spool_base = HISTORY_SPOOL_BASE;    /* 离线缓存溢出区起始地址 */
+
+/******************************************************************************************/
+/* W25QXX 接口 (ctx 指向区域起始地址) */
+
+static uint8_t flash_read(void *ctx, uint32_t addr, uint8_t *buf, uint16_t len)
+{
+    W25QXX_Read(buf, *(const uint32_t *)ctx + addr, len);
+    return 0;
+}
+
+static uint8_t flash_program(void *ctx, uint32_t addr, const uint8_t *buf, uint16_t len)
+{
+    W25QXX_Write_NoCheck((uint8_t *)buf, *(const uint32_t *)ctx + addr, len);
+    return 0;
+}
+
+static uint8_t flash_erase(void *ctx, uint32_t addr)
+{
+    W25QXX_Erase_Sector((*(const uint32_t *)ctx + addr) / TSLOG_SECTOR_SIZE);
+    return 0;
+}
+
+/**
+ * @brief  填充指定区域的Flash接口
+ */
+static void flash_bind(tslog_flash_t *flash, const uint32_t *base)
+{
+    flash->read = flash_read;
+    flash->program = flash_program;
+    flash->erase = flash_erase;
+    flash->ctx = (void *)base;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化W25QXX并挂载日志
+ */
+uint8_t history_init(void)
+{
+    tslog_flash_t flash;
+    uint32_t t_first, t_last;
+
+    W25QXX_Init();
+
+    /* 读不到合法ID说明没有焊接Flash或SPI异常 */
+    if ((W25QXX_TYPE >> 8) != 0xEF && (W25QXX_TYPE >> 8) != 0x52)
+    {
+        printf("[History] W25QXX not found (id=%04X)\r\n", W25QXX_TYPE);
+        return 1;
+    }
+
+    flash_bind(&flash, &s_log_base);
+
+    if (tslog_mount(&s_log, &flash) != 0)
+    {
+        printf("[History] Mount failed\r\n");
+        return 1;
+    }
+
+    if (tslog_get_range(&s_log, &t_first, &t_last) == 0)
+    {
+        s_time_base = t_last + 1;
+        printf("[History] %lu..%lu s, head sector %u\r\n",
+               (unsigned long)t_first, (unsigned long)t_last, s_log.head);
+    }
+    else
+    {
+        printf("[History] Empty log\r\n");
+    }
+
+    s_time_base -= millis() / 1000;
+    s_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief  是否可用
+ */
+uint8_t history_ready(void)
+{
+    return s_ready;
+}
+
+/**
+ * @brief  当前历史时间 (秒)
+ */
+uint32_t history_now(void)
+{
+    return s_time_base + millis() / 1000;
+}
+
+/**
+ * @brief  记录一个样本
+ */
+uint8_t history_record(uint8_t temp, uint8_t humi, uint8_t soil, uint8_t light)
+{
+    uint8_t v[TSLOG_CHANNELS];
+
+    if (!s_ready) return 1;
+
+    v[HISTORY_CH_TEMP] = temp;
+    v[HISTORY_CH_HUMI] = humi;
+    v[HISTORY_CH_SOIL] = soil;
+    v[HISTORY_CH_LIGHT] = light;
+
+    return tslog_append(&s_log, history_now(), v);
+}
+
+/**
+ * @brief  把尚在RAM页缓冲中的样本写入Flash
+ */
+uint8_t history_sync(void)
+{
+    if (!s_ready) return 1;
+    return tslog_sync(&s_log);
+}
+
+/**
+ * @brief  查询时间区间内的样本
+ */
+uint32_t history_query(uint32_t t_from, uint32_t t_to, tslog_visit_fn_t visit, void *arg)
+{
+    if (!s_ready) return 0;
+    return tslog_query(&s_log, t_from, t_to, visit, arg);
+}
+
+/**
+ * @brief  获取日志统计
+ */
+void history_get_stats(tslog_stats_t *stats)
+{
+    if (stats == NULL) return;
+
+    if (!s_ready)
+    {
+        memset(stats, 0, sizeof(tslog_stats_t));
+        return;
+    }
+    *stats = s_log.stats;
+}
+
+/**
+ * @brief  获取离线缓存溢出区的Flash接口
+ */
+uint8_t history_get_spool_flash(tslog_flash_t *flash)
+{
+    if (!s_ready || flash == NULL) return 1;
+
+    flash_bind(flash, &s_spool_base);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ ****************************************************************************************************
+ * @file        history.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       传感器历史数据存储 (W25QXX上的时间序列日志)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 日志格式见 tslog.h, 本文件只负责把 tslog 接到 W25QXX 驱动并提供采样时间
+ * - 日志区之后为离线上报缓存 (spool.h) 的溢出区, 由 myserver 使用
+ * - 通道顺序: 0-温度 1-空气湿度 2-土壤湿度 3-光照强度
+ * - 时间戳单位为秒; 上电后从日志中最后一个样本之后继续计时, 保证跨重启单调递增
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __HISTORY_H
+#define __HISTORY_H
+
+#include <stdint.h>
+#include "tslog.h"
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define HISTORY_FLASH_BASE      0x000000    /* 日志区在W25QXX中的起始地址 (需4KB对齐, 正点原子字库位于12MB之后) */
+#define HISTORY_PERIOD_MS       60000       /* 采样记录周期 (ms) */
+#define HISTORY_SPOOL_BASE      (HISTORY_FLASH_BASE + TSLOG_SECTORS * TSLOG_SECTOR_SIZE)    /* 离线上报缓存溢出区起始地址 */
+#define HISTORY_SPOOL_SECTORS   16          /* 离线上报缓存溢出区扇区数 (64KB, 8192个样本) */
+
+/* 通道定义 */
+#define HISTORY_CH_TEMP         0
+#define HISTORY_CH_HUMI         1
+#define HISTORY_CH_SOIL         2
+#define HISTORY_CH_LIGHT        3
+
+#define HISTORY_VALUE_INVALID   0xFF        /* 无效值 (传感器失效或读数过期), 曲线上显示为空缺 */
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化W25QXX并挂载日志
+ * @retval 0:成功 1:Flash不存在或挂载失败 (之后的记录和查询都会被忽略)
+ */
+uint8_t history_init(void);
+
+/**
+ * @brief  是否可用
+ * @retval 1:可用 0:不可用
+ */
+uint8_t history_ready(void);
+
+/**
+ * @brief  当前历史时间 (秒)
+ */
+uint32_t history_now(void);
+
+/**
+ * @brief  记录一个样本 (时间取history_now)
+ * @retval 0:成功 1:不可用或Flash操作失败
+ */
+uint8_t history_record(uint8_t temp, uint8_t humi, uint8_t soil, uint8_t light);
+
+/**
+ * @brief  把尚在RAM页缓冲中的样本写入Flash
+ * @retval 0:成功 1:失败
+ */
+uint8_t history_sync(void);
+
+/**
+ * @brief  查询时间区间 [t_from, t_to] 内的样本
+ * @retval 回调的样本数
+ */
+uint32_t history_query(uint32_t t_from, uint32_t t_to, tslog_visit_fn_t visit, void *arg);
+
+/**
+ * @brief  获取日志统计
+ */
+void history_get_stats(tslog_stats_t *stats);
+
+/**
+ * @brief  获取离线上报缓存溢出区的Flash接口 (地址相对 HISTORY_SPOOL_BASE)
+ * @retval 0:成功 1:W25QXX不可用
+ */
+uint8_t history_get_spool_flash(tslog_flash_t *flash);
+
+#endif /* __HISTORY_H */
@@ -0,0 +1,223 @@
+/**
+ ****************************************************************************************************
+ * @file        spool.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       离线上报缓存实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * Flash写入位置 = (rd + flash_count) 取模, 出队和丢弃只移动 rd 并同步减少 flash_count,
+ * 因此写入位置始终按页对齐, 每次溢出正好写满一页。
+ *
+ ****************************************************************************************************
+ */
+
+#include "spool.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有定义 */
+
+#define SPOOL_CHUNK_RECS        8           /* 溢出时每次编程的记录数 (栈上缓冲 64 字节) */
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  溢出区容量 (记录数)
+ */
+static uint32_t spool_capacity(const spool_t *sp)
+{
+    return (uint32_t)sp->sectors * SPOOL_SECTOR_RECS;
+}
+
+/**
+ * @brief  把RAM队列中的全部样本写入Flash
+ * @retval 0:成功 1:Flash不可用或操作失败
+ */
+static uint8_t spool_spill(spool_t *sp)
+{
+    uint8_t buf[SPOOL_CHUNK_RECS * SPOOL_REC_SIZE];
+    uint32_t cap = spool_capacity(sp);
+    uint32_t wr, n;
+    uint8_t i, k, idx;
+    const spool_rec_t *r;
+
+    if (cap == 0 || !sp->spill_ok) return 1;
+
+    wr = (sp->rd + sp->flash_count) % cap;
+
+    /* 进入新扇区: 溢出区满时先丢弃最早扇区中的剩余记录, 再擦除 */
+    if (wr % SPOOL_SECTOR_RECS == 0)
+    {
+        if (sp->flash_count > cap - SPOOL_SECTOR_RECS)
+        {
+            n = SPOOL_SECTOR_RECS - sp->rd % SPOOL_SECTOR_RECS;
+            sp->rd = (sp->rd + n) % cap;
+            sp->flash_count -= n;
+            sp->seq += n;
+            sp->stats.dropped += n;
+        }
+
+        if (sp->flash.erase(sp->flash.ctx, wr * SPOOL_REC_SIZE) != 0)
+        {
+            sp->spill_ok = 0;
+            sp->stats.flash_errors++;
+            return 1;
+        }
+    }
+
+    for (i = 0; i < SPOOL_RAM_SIZE; i += SPOOL_CHUNK_RECS)
+    {
+        for (k = 0; k < SPOOL_CHUNK_RECS; k++)
+        {
+            idx = (sp->ram_head + i + k) % SPOOL_RAM_SIZE;
+            r = &sp->ram[idx];
+            buf[k * SPOOL_REC_SIZE + 0] = (uint8_t)(r->ms);
+            buf[k * SPOOL_REC_SIZE + 1] = (uint8_t)(r->ms >> 8);
+            buf[k * SPOOL_REC_SIZE + 2] = (uint8_t)(r->ms >> 16);
+            buf[k * SPOOL_REC_SIZE + 3] = (uint8_t)(r->ms >> 24);
+            memcpy(&buf[k * SPOOL_REC_SIZE + 4], r->v, TSLOG_CHANNELS);
+        }
+
+        if (sp->flash.program(sp->flash.ctx, (wr + i) * SPOOL_REC_SIZE, buf, sizeof(buf)) != 0)
+        {
+            sp->spill_ok = 0;
+            sp->stats.flash_errors++;
+            return 1;
+        }
+    }
+
+    sp->flash_count += SPOOL_RAM_SIZE;
+    sp->stats.spilled += SPOOL_RAM_SIZE;
+    sp->ram_head = 0;
+    sp->ram_count = 0;
+    return 0;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化队列
+ */
+void spool_init(spool_t *sp, const tslog_flash_t *flash, uint8_t sectors)
+{
+    memset(sp, 0, sizeof(spool_t));
+
+    if (flash != NULL && sectors > 0)
+    {
+        sp->flash = *flash;
+        sp->sectors = sectors;
+    }
+    sp->spill_ok = 1;
+}
+
+/**
+ * @brief  样本入队
+ */
+uint8_t spool_push(spool_t *sp, uint32_t ms, const uint8_t *v)
+{
+    spool_rec_t *r;
+
+    if (sp->ram_count >= SPOOL_RAM_SIZE && spool_spill(sp) != 0)
+    {
+        if (sp->flash_count > 0)
+        {
+            /* 队首在Flash中, 丢弃RAM中的样本会使序号不连续, 只能丢弃新样本 */
+            sp->stats.dropped++;
+            return 1;
+        }
+
+        sp->ram_head = (sp->ram_head + 1) % SPOOL_RAM_SIZE;
+        sp->ram_count--;
+        sp->seq++;
+        sp->stats.dropped++;
+    }
+
+    r = &sp->ram[(sp->ram_head + sp->ram_count) % SPOOL_RAM_SIZE];
+    r->ms = ms;
+    memcpy(r->v, v, TSLOG_CHANNELS);
+    sp->ram_count++;
+    sp->stats.pushed++;
+    return 0;
+}
+
+/**
+ * @brief  读取队首的若干样本但不出队
+ * @note   一次只从Flash或RAM其中一处读取, 不跨越溢出区末尾
+ */
+uint8_t spool_peek(spool_t *sp, spool_rec_t *out, uint8_t max, uint32_t *first_seq)
+{
+    uint32_t cap = spool_capacity(sp);
+    uint8_t *raw = (uint8_t *)out;
+    uint8_t n, i;
+    uint32_t ms;
+
+    if (first_seq != NULL) *first_seq = sp->seq;
+    if (max == 0) return 0;
+
+    if (sp->flash_count > 0)
+    {
+        n = (sp->flash_count < max) ? (uint8_t)sp->flash_count : max;
+        if (n > cap - sp->rd) n = (uint8_t)(cap - sp->rd);
+
+        /* spool_rec_t 与Flash记录同为8字节, 原地读取后逐条转换字节序 */
+        if (sp->flash.read(sp->flash.ctx, sp->rd * SPOOL_REC_SIZE, raw, (uint16_t)n * SPOOL_REC_SIZE) != 0)
+        {
+            sp->stats.flash_errors++;
+            return 0;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            raw = (uint8_t *)&out[i];
+            ms = (uint32_t)raw[0] | ((uint32_t)raw[1] << 8) | ((uint32_t)raw[2] << 16) | ((uint32_t)raw[3] << 24);
+            out[i].ms = ms;
+        }
+        return n;
+    }
+
+    n = (sp->ram_count < max) ? sp->ram_count : max;
+    for (i = 0; i < n; i++)
+    {
+        out[i] = sp->ram[(sp->ram_head + i) % SPOOL_RAM_SIZE];
+    }
+    return n;
+}
+
+/**
+ * @brief  丢弃队首的n个样本
+ */
+void spool_pop(spool_t *sp, uint8_t n)
+{
+    uint32_t k;
+
+    if (sp->flash_count > 0)
+    {
+        k = (sp->flash_count < n) ? sp->flash_count : n;
+        sp->rd = (sp->rd + k) % spool_capacity(sp);
+        sp->flash_count -= k;
+    }
+    else
+    {
+        k = (sp->ram_count < n) ? sp->ram_count : n;
+        sp->ram_head = (sp->ram_head + k) % SPOOL_RAM_SIZE;
+        sp->ram_count -= (uint8_t)k;
+    }
+
+    sp->seq += k;
+    sp->stats.popped += k;
+}
+
+/**
+ * @brief  队列中的样本数
+ */
+uint32_t spool_count(const spool_t *sp)
+{
+    return sp->flash_count + sp->ram_count;
+}
@@ -0,0 +1,107 @@
+/**
+ ****************************************************************************************************
+ * @file        spool.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       离线上报缓存 (RAM环形队列 + SPI NOR Flash溢出区)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 先进先出队列, 新样本先放入RAM队列, RAM队列满时整页 (SPOOL_RAM_SIZE条) 写入Flash溢出区
+ * - Flash中的样本总是比RAM中的早, 出队时先取Flash再取RAM
+ * - Flash溢出区由若干4KB扇区组成, 按顺序循环使用, 写入新扇区前擦除; 溢出区满时丢弃最早的一个扇区
+ * - 队列中样本的序号连续递增; 需要腾出空间时丢弃最早的样本 (表现为序号跳变),
+ *   只有RAM队列满且Flash不可写入时才丢弃新样本 (不占用序号), 两者都计入统计
+ * - 溢出区不跨重启保留 (样本时间为上电后的毫秒数), 初始化时从溢出区开头重新使用
+ * - 未提供Flash接口时只使用RAM队列, 满时丢弃最早的样本
+ *
+ * Flash记录格式 (8字节, 小端): ms(4) v[4], 每页32条, 不跨页
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SPOOL_H
+#define __SPOOL_H
+
+#include <stdint.h>
+#include "tslog.h"
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define SPOOL_RAM_SIZE          32          /* RAM队列条数 (等于一页Flash记录数) */
+#define SPOOL_REC_SIZE          8           /* Flash记录长度 */
+#define SPOOL_SECTOR_RECS       (TSLOG_SECTOR_SIZE / SPOOL_REC_SIZE)    /* 每扇区记录数 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 队列样本 */
+typedef struct {
+    uint32_t ms;                        /* 采集时间 (上电后毫秒数) */
+    uint8_t  v[TSLOG_CHANNELS];         /* 通道值 */
+} spool_rec_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t pushed;                    /* 入队样本数 */
+    uint32_t popped;                    /* 出队样本数 */
+    uint32_t spilled;                   /* 写入Flash的样本数 */
+    uint32_t dropped;                   /* 队列满丢弃的样本数 */
+    uint32_t flash_errors;              /* Flash操作失败次数 */
+} spool_stats_t;
+
+/* 队列实例 */
+typedef struct {
+    tslog_flash_t flash;                /* Flash接口 */
+    uint8_t  sectors;                   /* 溢出区扇区数, 0表示只使用RAM */
+    uint8_t  spill_ok;                  /* 0: Flash写入失败过, 不再溢出 */
+    uint32_t rd;                        /* Flash中最早记录在溢出区中的位置 (记录编号) */
+    uint32_t flash_count;               /* Flash中的记录数 */
+    uint32_t seq;                       /* 队首 (最早样本) 的序号 */
+    uint8_t  ram_head;                  /* RAM队列中最早样本的位置 */
+    uint8_t  ram_count;                 /* RAM队列样本数 */
+    spool_rec_t ram[SPOOL_RAM_SIZE];    /* RAM队列 */
+    spool_stats_t stats;                /* 统计信息 */
+} spool_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化队列
+ * @param  flash: Flash接口 (地址相对溢出区起始), NULL表示只使用RAM
+ * @param  sectors: 溢出区扇区数
+ */
+void spool_init(spool_t *sp, const tslog_flash_t *flash, uint8_t sectors);
+
+/**
+ * @brief  样本入队
+ * @retval 0:成功 1:队列满, 新样本被丢弃
+ */
+uint8_t spool_push(spool_t *sp, uint32_t ms, const uint8_t *v);
+
+/**
+ * @brief  读取队首的若干样本但不出队
+ * @param  out: 输出缓冲
+ * @param  max: 最多读取的样本数
+ * @param  first_seq: 输出第一个样本的序号, 可为NULL
+ * @retval 读取的样本数, 0表示队列为空或Flash读取失败
+ */
+uint8_t spool_peek(spool_t *sp, spool_rec_t *out, uint8_t max, uint32_t *first_seq);
+
+/**
+ * @brief  丢弃队首的n个样本 (发送成功后调用)
+ */
+void spool_pop(spool_t *sp, uint8_t n);
+
+/**
+ * @brief  队列中的样本数
+ */
+uint32_t spool_count(const spool_t *sp);
+
+#endif /* __SPOOL_H */
@@ -0,0 +1,487 @@
+/**
+ ****************************************************************************************************
+ * @file        tslog.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       追加写/扇区轮转的时间序列日志实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 上电恢复: 最新扇区从头解码到数据末尾得到差分基准, 之后从下一个空白页继续写入,
+ * 未写满的最后一页剩余空间不再使用 (解码时遇到0xFF即跳到下一页)。
+ *
+ ****************************************************************************************************
+ */
+
+#include "tslog.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有类型 */
+
+#define RD_CACHE_SIZE           32          /* 读取缓存大小 */
+
+/* 扇区顺序读取/解码器 */
+typedef struct {
+    tslog_t *log;
+    uint8_t  sector;                        /* 扇区号 */
+    uint16_t off;                           /* 下一个字节在扇区内的偏移 */
+    uint16_t cache_off;                     /* 缓存对应的偏移 */
+    uint8_t  cache_len;                     /* 缓存有效长度 */
+    uint8_t  cache[RD_CACHE_SIZE];
+    uint8_t  err;                           /* 1: Flash读取失败 */
+    tslog_sample_t cur;                     /* 当前样本 */
+} tslog_iter_t;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  扇区基地址
+ */
+static uint32_t sector_addr(uint8_t sector)
+{
+    return (uint32_t)sector * TSLOG_SECTOR_SIZE;
+}
+
+/**
+ * @brief  读取一个字节 (最新扇区的当前页从RAM缓冲读取)
+ */
+static uint8_t rd_byte(tslog_iter_t *it)
+{
+    tslog_t *log = it->log;
+    uint16_t len;
+    uint8_t c;
+
+    if (it->off >= TSLOG_SECTOR_SIZE) return 0xFF;
+
+    if (it->off >= it->cache_off && it->off < it->cache_off + it->cache_len)
+    {
+        return it->cache[it->off++ - it->cache_off];
+    }
+
+    if (log->open && it->sector == log->head && it->off >= log->page_addr)
+    {
+        c = (it->off < log->page_addr + log->page_len) ? log->page[it->off - log->page_addr] : 0xFF;
+        it->off++;
+        return c;
+    }
+
+    /* 从Flash填充缓存, 不越过当前页 (当前页以RAM为准) */
+    len = RD_CACHE_SIZE;
+    if (it->off + len > TSLOG_SECTOR_SIZE) len = TSLOG_SECTOR_SIZE - it->off;
+    if (log->open && it->sector == log->head && it->off + len > log->page_addr) len = log->page_addr - it->off;
+
+    if (log->flash.read(log->flash.ctx, sector_addr(it->sector) + it->off, it->cache, len) != 0)
+    {
+        it->err = 1;
+        log->stats.flash_errors++;
+        it->off = TSLOG_SECTOR_SIZE;
+        return 0xFF;
+    }
+    it->cache_off = it->off;
+    it->cache_len = (uint8_t)len;
+    return it->cache[it->off++ - it->cache_off];
+}
+
+/**
+ * @brief  读取变长整数
+ */
+static uint32_t rd_varint(tslog_iter_t *it)
+{
+    uint32_t v = 0;
+    uint8_t c, shift = 0;
+
+    do
+    {
+        c = rd_byte(it);
+        v |= (uint32_t)(c & 0x7F) << shift;
+        shift += 7;
+    } while ((c & 0x80) && shift < 35);
+
+    return v;
+}
+
+/**
+ * @brief  写入变长整数, 返回字节数
+ */
+static uint8_t put_varint(uint8_t *p, uint32_t v)
+{
+    uint8_t n = 0;
+
+    while (v >= 0x80)
+    {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+/**
+ * @brief  解析扇区头
+ * @retval 0:有效 1:空白或无效
+ */
+static uint8_t parse_header(const uint8_t *h, uint32_t *seq, tslog_sample_t *first)
+{
+    uint8_t i;
+
+    if ((h[0] | (h[1] << 8)) != TSLOG_MAGIC || h[2] != TSLOG_VERSION || h[3] != TSLOG_CHANNELS)
+    {
+        return 1;
+    }
+
+    *seq = h[4] | ((uint32_t)h[5] << 8) | ((uint32_t)h[6] << 16) | ((uint32_t)h[7] << 24);
+    first->ts = h[8] | ((uint32_t)h[9] << 8) | ((uint32_t)h[10] << 16) | ((uint32_t)h[11] << 24);
+    for (i = 0; i < TSLOG_CHANNELS; i++)
+    {
+        first->v[i] = h[12 + i];
+    }
+    return 0;
+}
+
+/**
+ * @brief  生成扇区头
+ */
+static void build_header(uint8_t *h, uint32_t seq, uint32_t ts, const uint8_t *v)
+{
+    uint8_t i;
+
+    h[0] = (uint8_t)TSLOG_MAGIC;
+    h[1] = (uint8_t)(TSLOG_MAGIC >> 8);
+    h[2] = TSLOG_VERSION;
+    h[3] = TSLOG_CHANNELS;
+    for (i = 0; i < 4; i++)
+    {
+        h[4 + i] = (uint8_t)(seq >> (8 * i));
+        h[8 + i] = (uint8_t)(ts >> (8 * i));
+    }
+    for (i = 0; i < TSLOG_CHANNELS; i++)
+    {
+        h[12 + i] = v[i];
+    }
+}
+
+/**
+ * @brief  开始解码一个扇区, cur为扇区头中的第一个样本
+ * @retval 0:成功 1:扇区无效或读取失败
+ */
+static uint8_t iter_begin(tslog_iter_t *it, tslog_t *log, uint8_t sector)
+{
+    uint8_t h[TSLOG_HEADER_SIZE];
+    uint32_t seq;
+    uint8_t i;
+
+    memset(it, 0, sizeof(tslog_iter_t));
+    it->log = log;
+    it->sector = sector;
+
+    for (i = 0; i < TSLOG_HEADER_SIZE; i++)
+    {
+        h[i] = rd_byte(it);
+    }
+    if (it->err) return 1;
+
+    return parse_header(h, &seq, &it->cur);
+}
+
+/**
+ * @brief  解码下一个样本
+ * @retval 1:得到样本 0:扇区数据结束 (it->off为结束位置)
+ */
+static uint8_t iter_next(tslog_iter_t *it)
+{
+    uint8_t tag, ch;
+    uint32_t zz;
+    uint16_t start;
+
+    while (it->off < TSLOG_SECTOR_SIZE)
+    {
+        start = it->off;
+        tag = rd_byte(it);
+        if (it->err) return 0;
+
+        if (tag == 0xFF)
+        {
+            /* 页首为空白: 数据结束; 页中为空白: 本页结束, 转到下一页 */
+            if (start % TSLOG_PAGE_SIZE == 0)
+            {
+                it->off = start;
+                return 0;
+            }
+            it->off = (start / TSLOG_PAGE_SIZE + 1) * TSLOG_PAGE_SIZE;
+            continue;
+        }
+
+        if (tag & 0x0F)
+        {
+            it->off = TSLOG_SECTOR_SIZE;    /* 格式错误, 放弃本扇区剩余部分 */
+            return 0;
+        }
+
+        it->cur.ts += rd_varint(it);
+        for (ch = 0; ch < TSLOG_CHANNELS; ch++)
+        {
+            if (tag & (0x10 << ch))
+            {
+                zz = rd_varint(it);
+                it->cur.v[ch] += (uint8_t)((zz >> 1) ^ (0U - (zz & 1)));
+            }
+        }
+        return it->err ? 0 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  把当前页中尚未写入的部分写入Flash
+ */
+static uint8_t flush_page(tslog_t *log)
+{
+    uint16_t len = log->page_len - log->page_synced;
+
+    if (!log->open || len == 0) return 0;
+
+    if (log->flash.program(log->flash.ctx, sector_addr(log->head) + log->page_addr + log->page_synced,
+                           log->page + log->page_synced, len) != 0)
+    {
+        log->stats.flash_errors++;
+        return 1;
+    }
+    log->page_synced = log->page_len;
+    log->stats.pages_written++;
+    return 0;
+}
+
+/**
+ * @brief  擦除下一个扇区并以该样本作为扇区头开始新扇区
+ */
+static uint8_t open_sector(tslog_t *log, uint32_t ts, const uint8_t *v)
+{
+    uint8_t next;
+
+    if (flush_page(log) != 0) return 1;
+
+    next = (uint8_t)((log->head + 1) % TSLOG_SECTORS);
+    log->open = 0;
+    log->index[next] = TSLOG_T0_EMPTY;
+    if (log->flash.erase(log->flash.ctx, sector_addr(next)) != 0)
+    {
+        log->stats.flash_errors++;
+        return 1;
+    }
+    log->stats.sectors_erased++;
+
+    log->head = next;
+    log->seq++;
+    log->index[next] = ts;
+    log->open = 1;
+    log->page_addr = 0;
+    log->page_synced = 0;
+    memset(log->page, 0xFF, sizeof(log->page));
+    build_header(log->page, log->seq, ts, v);
+    log->page_len = TSLOG_HEADER_SIZE;
+
+    log->last.ts = ts;
+    memcpy(log->last.v, v, TSLOG_CHANNELS);
+    log->stats.appended++;
+    return 0;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  挂载日志
+ */
+uint8_t tslog_mount(tslog_t *log, const tslog_flash_t *flash)
+{
+    uint8_t h[TSLOG_HEADER_SIZE];
+    uint8_t i, found = 0;
+    uint32_t seq, max_seq = 0;
+    tslog_sample_t first;
+    tslog_iter_t it;
+
+    memset(log, 0, sizeof(tslog_t));
+    log->flash = *flash;
+    log->head = TSLOG_SECTORS - 1;      /* 空日志从0号扇区开始 */
+
+    for (i = 0; i < TSLOG_SECTORS; i++)
+    {
+        log->index[i] = TSLOG_T0_EMPTY;
+        if (flash->read(flash->ctx, sector_addr(i), h, TSLOG_HEADER_SIZE) != 0) return 1;
+        if (parse_header(h, &seq, &first) != 0) continue;
+
+        log->index[i] = first.ts;
+        if (!found || (int32_t)(seq - max_seq) > 0)
+        {
+            max_seq = seq;
+            log->head = i;
+            found = 1;
+        }
+    }
+
+    if (!found) return 0;
+    log->seq = max_seq;
+
+    /* 解码最新扇区, 恢复差分基准和写入位置 */
+    if (iter_begin(&it, log, log->head) != 0) return 1;
+    while (iter_next(&it));
+    if (it.err) return 1;
+
+    log->last = it.cur;
+    if (it.off < TSLOG_SECTOR_SIZE)
+    {
+        log->open = 1;
+        log->page_addr = it.off;
+        log->page_len = 0;
+        log->page_synced = 0;
+        memset(log->page, 0xFF, sizeof(log->page));
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  擦除整个日志区并重新挂载
+ */
+uint8_t tslog_format(tslog_t *log)
+{
+    tslog_flash_t flash = log->flash;
+    uint8_t i;
+
+    for (i = 0; i < TSLOG_SECTORS; i++)
+    {
+        if (flash.erase(flash.ctx, sector_addr(i)) != 0) return 1;
+    }
+    return tslog_mount(log, &flash);
+}
+
+/**
+ * @brief  追加一个样本
+ */
+uint8_t tslog_append(tslog_t *log, uint32_t ts, const uint8_t *v)
+{
+    uint8_t rec[TSLOG_RECORD_MAX];
+    uint8_t len = 1, tag = 0, ch;
+    int32_t d;
+
+    if (log->index[log->head] != TSLOG_T0_EMPTY && ts < log->last.ts)
+    {
+        ts = log->last.ts;
+        log->stats.ts_clamped++;
+    }
+
+    if (!log->open) return open_sector(log, ts, v);
+
+    /* 编码差分记录 */
+    len += put_varint(rec + len, ts - log->last.ts);
+    for (ch = 0; ch < TSLOG_CHANNELS; ch++)
+    {
+        d = (int32_t)v[ch] - log->last.v[ch];
+        if (d != 0)
+        {
+            tag |= 0x10 << ch;
+            len += put_varint(rec + len, ((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+        }
+    }
+    rec[0] = tag;
+
+    /* 页内放不下: 写出当前页, 转到下一页或下一个扇区 */
+    if (log->page_len + len > TSLOG_PAGE_SIZE)
+    {
+        if (flush_page(log) != 0) return 1;
+
+        if (log->page_addr + TSLOG_PAGE_SIZE >= TSLOG_SECTOR_SIZE)
+        {
+            return open_sector(log, ts, v);
+        }
+        log->page_addr += TSLOG_PAGE_SIZE;
+        log->page_len = 0;
+        log->page_synced = 0;
+        memset(log->page, 0xFF, sizeof(log->page));
+    }
+
+    memcpy(log->page + log->page_len, rec, len);
+    log->page_len += len;
+    log->last.ts = ts;
+    memcpy(log->last.v, v, TSLOG_CHANNELS);
+    log->stats.appended++;
+    log->stats.bytes += len;
+    return 0;
+}
+
+/**
+ * @brief  立即写入页缓冲
+ */
+uint8_t tslog_sync(tslog_t *log)
+{
+    return flush_page(log);
+}
+
+/**
+ * @brief  区间查询
+ * @note   扇区按写入顺序从最旧到最新排列; 下一个扇区的起始时间不大于t_from时,
+ *         本扇区的样本都早于区间, 直接跳过; 扇区起始时间大于t_to时结束
+ */
+uint32_t tslog_query(tslog_t *log, uint32_t t_from, uint32_t t_to, tslog_visit_fn_t visit, void *arg)
+{
+    tslog_iter_t it;
+    uint32_t count = 0;
+    uint16_t k;
+    uint8_t s, next;
+
+    if (log->index[log->head] == TSLOG_T0_EMPTY || t_from > t_to) return 0;
+
+    for (k = 1; k <= TSLOG_SECTORS; k++)
+    {
+        s = (uint8_t)((log->head + k) % TSLOG_SECTORS);
+        if (log->index[s] == TSLOG_T0_EMPTY) continue;
+        if (log->index[s] > t_to) break;
+
+        next = (uint8_t)((s + 1) % TSLOG_SECTORS);
+        if (s != log->head && log->index[next] != TSLOG_T0_EMPTY && log->index[next] < t_from) continue;
+
+        if (iter_begin(&it, log, s) != 0) continue;
+        log->stats.sectors_read++;
+
+        do
+        {
+            if (it.cur.ts > t_to) return count;
+            if (it.cur.ts >= t_from)
+            {
+                count++;
+                if (visit(&it.cur, arg) != 0) return count;
+            }
+        } while (iter_next(&it));
+    }
+
+    return count;
+}
+
+/**
+ * @brief  获取最早/最新样本时间
+ */
+uint8_t tslog_get_range(const tslog_t *log, uint32_t *t_first, uint32_t *t_last)
+{
+    uint16_t k;
+    uint8_t s;
+
+    if (log->index[log->head] == TSLOG_T0_EMPTY) return 1;
+
+    for (k = 1; k <= TSLOG_SECTORS; k++)
+    {
+        s = (uint8_t)((log->head + k) % TSLOG_SECTORS);
+        if (log->index[s] != TSLOG_T0_EMPTY)
+        {
+            *t_first = log->index[s];
+            break;
+        }
+    }
+    *t_last = log->last.ts;
+    return 0;
+}
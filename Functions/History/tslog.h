@@ -0,0 +1,149 @@
+/**
+ ****************************************************************************************************
+ * @file        tslog.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       追加写/扇区轮转的时间序列日志 (SPI NOR Flash)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 存储格式:
+ * - 日志区由 TSLOG_SECTORS 个4KB扇区组成, 按顺序循环使用, 写满最后一个扇区后擦除最旧的扇区继续写,
+ *   每个扇区在一轮中只擦除一次, 磨损均匀
+ * - 扇区头 (16字节): magic(2) ver(1) ch(1) seq(4) t0(4) v0[4]
+ *   t0/v0 即该扇区第一个样本, 扇区可独立解码; seq 每开一个新扇区加1, 上电时据此找到最新扇区
+ * - 之后为差分记录, 记录不跨页, 页内剩余空间不足时转到下一页 (剩余部分保持0xFF):
+ *   tag(1)  高4位为变化通道掩码 (bit4对应通道0), 低4位为0; 0xFF表示本页结束
+ *   dt      与上一样本的时间差 (秒), 无符号变长整数 (每字节7位, 最高位为1表示后面还有)
+ *   delta   每个变化通道一个 zigzag 编码的变长整数
+ *   数值不变且间隔小于128秒的样本只占2字节, 最长14字节
+ *
+ * 写入:
+ * - 记录先放入RAM页缓冲, 页满时整页写入 (不擦除), tslog_sync() 可立即写入未落盘部分
+ * - 时间戳必须不减, 比上一样本小时按上一样本的时间记录并计数
+ *
+ * 查询:
+ * - RAM中保存每个扇区第一个样本的时间 (扇区时间索引), 区间查询只读取与区间相交的扇区
+ *
+ * Flash读写通过 tslog_flash_t 注入, 本模块不依赖任何硬件, 可在主机下用文件模拟Flash验证
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __TSLOG_H
+#define __TSLOG_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define TSLOG_SECTORS           64          /* 日志区扇区数 (64 * 4KB = 256KB) */
+#define TSLOG_SECTOR_SIZE       4096        /* 扇区大小 */
+#define TSLOG_PAGE_SIZE         256         /* 页大小 (一次编程的最大长度) */
+#define TSLOG_CHANNELS          4           /* 每个样本的通道数 */
+
+/******************************************************************************************/
+/* 格式定义 */
+
+#define TSLOG_MAGIC             0x4C54      /* 扇区头标识 */
+#define TSLOG_VERSION           1           /* 格式版本 */
+#define TSLOG_HEADER_SIZE       16          /* 扇区头长度 */
+#define TSLOG_RECORD_MAX        (1 + 5 + TSLOG_CHANNELS * 2)    /* 单条记录最大长度 */
+#define TSLOG_T0_EMPTY          0xFFFFFFFF  /* 索引中表示空扇区 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* Flash操作接口 (地址均相对日志区起始) */
+typedef struct {
+    uint8_t (*read)(void *ctx, uint32_t addr, uint8_t *buf, uint16_t len);          /* 读, 返回0成功 */
+    uint8_t (*program)(void *ctx, uint32_t addr, const uint8_t *buf, uint16_t len); /* 页内编程, 返回0成功 */
+    uint8_t (*erase)(void *ctx, uint32_t addr);                                     /* 擦除addr所在扇区, 返回0成功 */
+    void *ctx;                                                                      /* 传给接口的上下文 */
+} tslog_flash_t;
+
+/* 样本 */
+typedef struct {
+    uint32_t ts;                        /* 时间戳 (秒) */
+    uint8_t  v[TSLOG_CHANNELS];         /* 通道值 */
+} tslog_sample_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t appended;                  /* 追加的样本数 */
+    uint32_t bytes;                     /* 记录占用的字节数 (不含扇区头) */
+    uint32_t pages_written;             /* 页编程次数 */
+    uint32_t sectors_erased;            /* 扇区擦除次数 */
+    uint32_t ts_clamped;                /* 时间戳回退而被修正的样本数 */
+    uint32_t flash_errors;              /* Flash操作失败次数 */
+    uint32_t sectors_read;              /* 查询时解码的扇区数 */
+} tslog_stats_t;
+
+/* 日志实例 */
+typedef struct {
+    tslog_flash_t flash;                            /* Flash接口 */
+    uint32_t index[TSLOG_SECTORS];                  /* 扇区时间索引: 每个扇区第一个样本的时间 */
+    uint32_t seq;                                   /* 最新扇区的序号 */
+    uint8_t  head;                                  /* 最新扇区 */
+    uint8_t  open;                                  /* 1: 最新扇区可以继续追加 */
+    uint16_t page_addr;                             /* 当前页在扇区内的偏移 */
+    uint16_t page_len;                              /* 当前页已用字节 */
+    uint16_t page_synced;                           /* 当前页已写入Flash的字节 */
+    uint8_t  page[TSLOG_PAGE_SIZE];                 /* 页缓冲 */
+    tslog_sample_t last;                            /* 最后一个样本 (差分基准) */
+    tslog_stats_t stats;                            /* 统计信息 */
+} tslog_t;
+
+/* 查询回调, 返回0继续, 非0停止 */
+typedef uint8_t (*tslog_visit_fn_t)(const tslog_sample_t *sample, void *arg);
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  挂载日志: 扫描扇区头建立时间索引, 恢复最新扇区的写入位置
+ * @param  log: 日志实例
+ * @param  flash: Flash接口
+ * @retval 0:成功 1:Flash读取失败
+ */
+uint8_t tslog_mount(tslog_t *log, const tslog_flash_t *flash);
+
+/**
+ * @brief  擦除整个日志区并重新挂载
+ * @retval 0:成功 1:Flash操作失败
+ */
+uint8_t tslog_format(tslog_t *log);
+
+/**
+ * @brief  追加一个样本
+ * @param  ts: 时间戳 (秒), 应不小于上一个样本
+ * @param  v: TSLOG_CHANNELS 个通道值
+ * @retval 0:成功 1:Flash操作失败
+ */
+uint8_t tslog_append(tslog_t *log, uint32_t ts, const uint8_t *v);
+
+/**
+ * @brief  把页缓冲中尚未写入的记录立即写入Flash (掉电前调用)
+ * @retval 0:成功 1:Flash操作失败
+ */
+uint8_t tslog_sync(tslog_t *log);
+
+/**
+ * @brief  查询时间区间 [t_from, t_to] 内的样本, 按时间顺序回调 (包含尚在页缓冲中的样本)
+ * @param  visit: 回调
+ * @param  arg: 回调参数
+ * @retval 回调的样本数
+ */
+uint32_t tslog_query(tslog_t *log, uint32_t t_from, uint32_t t_to, tslog_visit_fn_t visit, void *arg);
+
+/**
+ * @brief  获取最早/最新样本时间
+ * @retval 0:成功 1:日志为空
+ */
+uint8_t tslog_get_range(const tslog_t *log, uint32_t *t_first, uint32_t *t_last);
+
+#endif /* __TSLOG_H */
@@ -0,0 +1,192 @@
+/**
+ ****************************************************************************************************
+ * @file        heartbeat.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       基于毫秒时钟的自适应心跳与链路存活检测实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "heartbeat.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static hb_config_t s_cfg;                                   /* 配置 */
+static uint8_t  s_pending;                                  /* 1: 心跳已发送, 等待响应 */
+static uint32_t s_sent_ms;                                  /* 等待中的心跳的发送时间 */
+static uint32_t s_last_hb_ms;                               /* 上次发送心跳的时间 */
+static uint32_t s_last_tx_ms;                               /* 上次发送任意报文的时间 */
+static uint32_t s_last_rx_ms;                               /* 上次收到任意数据的时间 */
+static uint32_t s_skip_ms;                                  /* 跳过心跳的计时起点 */
+static uint32_t s_srtt8;                                    /* 平滑RTT * 8, 0表示尚无样本 */
+static hb_stats_t s_stats;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  当前响应超时
+ */
+static uint32_t hb_timeout(void)
+{
+    uint32_t t;
+
+    if (s_srtt8 == 0) return s_cfg.timeout_ms;
+
+    t = (s_srtt8 >> 3) * HB_TIMEOUT_RTT_MUL;
+    if (t < s_cfg.timeout_min_ms) t = s_cfg.timeout_min_ms;
+    if (t > s_cfg.timeout_ms) t = s_cfg.timeout_ms;
+    return t;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化
+ */
+void hb_init(const hb_config_t *cfg, uint32_t now_ms)
+{
+    s_cfg = *cfg;
+    memset(&s_stats, 0, sizeof(s_stats));
+    hb_reset(now_ms);
+}
+
+/**
+ * @brief  新连接建立
+ */
+void hb_reset(uint32_t now_ms)
+{
+    s_pending = 0;
+    s_last_hb_ms = now_ms;
+    s_last_tx_ms = now_ms;
+    s_last_rx_ms = now_ms;
+    s_skip_ms = now_ms;
+    s_srtt8 = 0;
+    s_stats.rtt_last = 0;
+    s_stats.rtt_min = 0;
+    s_stats.rtt_avg = 0;
+    s_stats.rtt_max = 0;
+    s_stats.degraded = 0;
+}
+
+/**
+ * @brief  收到服务器的任意数据
+ */
+void hb_on_rx(uint32_t now_ms)
+{
+    s_last_rx_ms = now_ms;
+}
+
+/**
+ * @brief  向服务器发送了任意报文
+ */
+void hb_on_tx(uint32_t now_ms)
+{
+    s_last_tx_ms = now_ms;
+}
+
+/**
+ * @brief  检查是否需要发送心跳或已超时
+ */
+uint8_t hb_poll(uint32_t now_ms)
+{
+    uint32_t since_hb = now_ms - s_last_hb_ms;
+
+    if (s_pending)
+    {
+        if (now_ms - s_sent_ms < hb_timeout()) return HB_NONE;
+
+        s_pending = 0;
+        s_stats.lost++;
+        s_stats.degraded = 1;
+        return HB_LOST;
+    }
+
+    /* RTT变差: 固定按短间隔确认链路, 不因其他报文跳过 */
+    if (s_stats.degraded)
+    {
+        return (since_hb >= s_cfg.min_ms) ? HB_SEND : HB_NONE;
+    }
+
+    /* 上行空闲, 或长时间没有下行数据需要确认链路 */
+    if (now_ms - s_last_tx_ms >= s_cfg.idle_ms ||
+        (now_ms - s_last_rx_ms >= s_cfg.probe_ms && since_hb >= s_cfg.idle_ms))
+    {
+        return HB_SEND;
+    }
+
+    /* 上行有其他报文, 每个心跳间隔计一次跳过 */
+    if (now_ms - s_skip_ms >= s_cfg.idle_ms)
+    {
+        s_skip_ms = now_ms;
+        s_stats.skipped++;
+    }
+    return HB_NONE;
+}
+
+/**
+ * @brief  心跳已发送
+ */
+void hb_sent(uint32_t now_ms)
+{
+    s_pending = 1;
+    s_sent_ms = now_ms;
+    s_last_hb_ms = now_ms;
+    s_last_tx_ms = now_ms;
+    s_skip_ms = now_ms;
+    s_stats.sent++;
+}
+
+/**
+ * @brief  收到心跳响应
+ */
+uint8_t hb_ack(uint32_t now_ms)
+{
+    uint32_t rtt;
+
+    if (!s_pending) return 1;
+
+    rtt = now_ms - s_sent_ms;
+    s_pending = 0;
+    s_last_rx_ms = now_ms;
+    s_stats.acked++;
+
+    if (s_srtt8 == 0)
+    {
+        s_srtt8 = (rtt << 3) ? (rtt << 3) : 1;
+        s_stats.rtt_min = rtt;
+        s_stats.rtt_max = rtt;
+    }
+    else
+    {
+        s_srtt8 = s_srtt8 + rtt - (s_srtt8 >> 3);
+        if (rtt < s_stats.rtt_min) s_stats.rtt_min = rtt;
+        if (rtt > s_stats.rtt_max) s_stats.rtt_max = rtt;
+    }
+    s_stats.rtt_last = rtt;
+    s_stats.rtt_avg = s_srtt8 >> 3;
+
+    /* 单次RTT突增立即缩短间隔, 平滑RTT回落到阈值以下后恢复 */
+    s_stats.degraded = (rtt > s_cfg.rtt_bad_ms || s_stats.rtt_avg > s_cfg.rtt_bad_ms);
+    return 0;
+}
+
+/**
+ * @brief  获取统计信息
+ */
+void hb_get_stats(hb_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_stats;
+    stats->interval_ms = s_stats.degraded ? s_cfg.min_ms : s_cfg.idle_ms;
+    stats->timeout_ms = hb_timeout();
+}
@@ -0,0 +1,119 @@
+/**
+ ****************************************************************************************************
+ * @file        heartbeat.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       基于毫秒时钟的自适应心跳与链路存活检测
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 所有计时基于单调毫秒时钟, 与调用周期无关, 任务被拖慢不会拉长心跳间隔和超时
+ * - 心跳有两个作用: 让服务器知道设备在线, 以及由hb到hb_ok的往返确认链路可用并测量RTT
+ *   上行已有其他报文 (dat/sta/ack等) 时服务器已能看到设备, 跳过心跳;
+ *   但超过 probe_ms 没有收到任何下行数据时仍发送心跳, 保证链路存活被定期确认
+ * - RTT变差 (单次RTT或平滑RTT超过 rtt_bad_ms) 时心跳间隔缩短到 min_ms, 不再跳过, 以尽快发现断线;
+ *   RTT恢复后回到 idle_ms
+ * - 等待hb_ok的超时为平滑RTT的 HB_TIMEOUT_RTT_MUL 倍, 限制在 [timeout_min_ms, timeout_ms] 内,
+ *   尚无RTT样本时为 timeout_ms
+ * - 同一时刻最多一个心跳等待响应, hb_ok与之一一对应
+ * - 本模块不依赖任何硬件, 时间由调用方传入, 可在主机下用模拟的时间序列验证
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __HEARTBEAT_H
+#define __HEARTBEAT_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 定义 */
+
+/* hb_poll返回的动作 */
+#define HB_NONE                 0           /* 无需操作 */
+#define HB_SEND                 1           /* 发送心跳, 发送成功后调用hb_sent */
+#define HB_LOST                 2           /* 心跳响应超时, 判定连接断开 */
+
+#define HB_TIMEOUT_RTT_MUL      8           /* 响应超时 = 平滑RTT * 该倍数 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 配置 */
+typedef struct {
+    uint32_t idle_ms;                   /* 上行无其他报文时的心跳间隔 */
+    uint32_t probe_ms;                  /* 超过该时间未收到下行数据则必须发送心跳 */
+    uint32_t min_ms;                    /* RTT变差时的心跳间隔 */
+    uint32_t rtt_bad_ms;                /* RTT超过该值视为变差 */
+    uint32_t timeout_min_ms;            /* 响应超时下限 */
+    uint32_t timeout_ms;                /* 响应超时上限 (无RTT样本时使用) */
+} hb_config_t;
+
+/* 统计信息 (RTT统计在每次连接时清零) */
+typedef struct {
+    uint32_t sent;                      /* 已发送的心跳数 */
+    uint32_t acked;                     /* 收到响应的心跳数 */
+    uint32_t skipped;                   /* 因上行有其他报文而跳过的心跳数 */
+    uint32_t lost;                      /* 响应超时次数 */
+    uint32_t rtt_last;                  /* 最近一次RTT (ms) */
+    uint32_t rtt_min;                   /* 最小RTT */
+    uint32_t rtt_avg;                   /* 平滑RTT (1/8指数加权平均) */
+    uint32_t rtt_max;                   /* 最大RTT */
+    uint32_t interval_ms;               /* 当前心跳间隔 */
+    uint32_t timeout_ms;                /* 当前响应超时 */
+    uint8_t  degraded;                  /* 1: RTT变差, 已缩短心跳间隔 */
+} hb_stats_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化 (清除全部统计)
+ * @param  cfg: 配置 (会被复制)
+ * @param  now_ms: 当前时间
+ */
+void hb_init(const hb_config_t *cfg, uint32_t now_ms);
+
+/**
+ * @brief  新连接建立: 清除等待中的心跳和RTT统计, 从此刻重新计时
+ */
+void hb_reset(uint32_t now_ms);
+
+/**
+ * @brief  收到服务器的任意数据
+ */
+void hb_on_rx(uint32_t now_ms);
+
+/**
+ * @brief  向服务器发送了任意报文 (含心跳)
+ */
+void hb_on_tx(uint32_t now_ms);
+
+/**
+ * @brief  检查是否需要发送心跳或已超时 (周期调用, 周期应远小于min_ms)
+ * @param  now_ms: 当前时间 (ms, 允许回绕)
+ * @retval HB_NONE/HB_SEND/HB_LOST
+ */
+uint8_t hb_poll(uint32_t now_ms);
+
+/**
+ * @brief  心跳已发送, 开始等待响应
+ */
+void hb_sent(uint32_t now_ms);
+
+/**
+ * @brief  收到心跳响应hb_ok
+ * @retval 0:已计入RTT 1:没有等待中的心跳 (迟到或重复的响应)
+ */
+uint8_t hb_ack(uint32_t now_ms);
+
+/**
+ * @brief  获取统计信息
+ */
+void hb_get_stats(hb_stats_t *stats);
+
+#endif /* __HEARTBEAT_H */
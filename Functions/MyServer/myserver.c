@@ -28,6 +28,12 @@
 #include "led.h"
 #include "bump.h"
 #include "ui.h"
+#include "json_parser.h"
+#include "bin_codec.h"
+#include "wallclock.h"
+#include "perf.h"
+#include "lv_port_disp_template.h"
+#include "timer.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,23 +49,109 @@ my_device_config_t g_device_config = {0};               /* 设备动态配置 (V
 /******************************************************************************************/
 /* 私有变量 */
 
-static uint32_t s_heartbeat_timer = 0;      /* 心跳计时器 */
-static uint32_t s_heartbeat_timeout = 0;    /* 心跳超时计数器 (等待响应) */
-static uint8_t  s_heartbeat_pending = 0;    /* 心跳响应等待标志 */
+static const hb_config_t s_hb_cfg = {      /* 心跳策略 */
+    MY_HB_IDLE_MS, MY_HB_PROBE_MS, MY_HB_MIN_MS, MY_HB_RTT_BAD_MS, MY_HB_TIMEOUT_MIN_MS, MY_HB_TIMEOUT_MS
+};
 static uint32_t s_msg_seq = 0;              /* 消息序列号 */
+static uint32_t s_reg_ms = 0;               /* 注册消息发送时间 (计算reg_ok的往返时间) */
+static uint8_t  s_bt_report = 0;            /* 1: 上电到上线时间尚未上报, 下一条sta携带 */
 /* 接收到的命令结构 - 增加字符串ID存储 */
 static char s_cmd_id_str[64];               /* 命令ID字符串 (用于ACK响应) - UUID长度为36字符 */
 static char s_send_buf[512];                /* 发送缓冲区 - 增大以容纳完整的ACK消息 */
 static char s_recv_buf[512];                /* 接收缓冲区 - 增大以容纳完整的控制命令 */
+static uint16_t s_recv_len = 0;             /* 接收缓冲区中未处理的数据长度 */
+static uint32_t s_recv_ms = 0;              /* 最近一帧下行数据的到达时间 (ms, 不完整报文从此刻开始计时) */
+
+#define MY_JSON_MAX_TOKENS      48          /* 单条下行报文最大token数 */
+#define MY_JSON_PART_MS         1000        /* 不完整报文等待后续帧的最长时间 (ms) */
+#define MY_TS_SEC_LIMIT         100000000000ULL /* 小于该值的服务器时间戳按秒处理 */
+
+/* 命令处理延迟 (下行帧到达 -> ack入队) */
+static volatile uint32_t s_rx_event_us;     /* 第一个尚未取走的下行帧的到达时刻 (us) */
+static volatile uint8_t  s_rx_event_set = 0;/* 1: s_rx_event_us有效 */
+static uint32_t s_frame_us = 0;             /* 最近取走的一帧的到达时刻 */
+static uint32_t s_cmd_rx_us = 0;            /* 当前命令所在帧的到达时刻 */
+static uint8_t  s_recv_more = 0;            /* 1: 接收缓冲中还有未解析的数据 */
+static my_cmd_stats_t s_cmd_stats = {0};
+static uint64_t s_cmd_total_us = 0;
+
+/* 命令引起的界面更新 (由界面任务执行) */
+#define UI_REFRESH_MANUAL       0x01        /* 手动控制界面的开关状态 */
+#define UI_REFRESH_MODE         0x02        /* 主界面/菜单界面的模式显示 */
+#define UI_OVERLAY_ON           0x04        /* 显示性能浮层 */
+#define UI_OVERLAY_OFF          0x08        /* 隐藏性能浮层 */
+
+static struct {
+    uint8_t flags;                          /* UI_* */
+    const char *popup;                      /* 弹窗文字, NULL表示无 */
+} s_ui;
+
+/* 变化驱动上报 */
+static my_telemetry_policy_t s_tlm_policy = {
+    MY_TLM_DB_TEMP, MY_TLM_DB_HUMI, MY_TLM_DB_SOIL, MY_TLM_DB_LIGHT, MY_TLM_KEYFRAME_MS,
+    MY_TLM_BATCH_MAX, MY_TLM_BATCH_MS, MY_TLM_REPLAY_MS, MY_TLM_REPLAY_MAX
+};
+static my_telemetry_stats_t s_tlm_stats = {0};
+static my_sensor_data_t s_tlm_last_dat;     /* 上次发送的传感器数据 */
+static my_device_status_t s_tlm_last_sta;   /* 上次发送的设备状态 */
+static uint32_t s_tlm_keyframe_ms = 0;      /* 上次关键帧时间 */
+static uint8_t s_tlm_need_dat = 1;          /* 1:下次必须发送dat */
+static uint8_t s_tlm_need_sta = 1;          /* 1:下次必须发送sta */
+static my_sensor_data_t s_batch_data[MY_TLM_BATCH_MAX];    /* 待发送的dat样本 */
+static uint32_t s_batch_ms[MY_TLM_BATCH_MAX];              /* 样本采集时间 */
+static uint8_t s_batch_count = 0;           /* 待发送样本数 */
+static uint8_t s_batch_size = 1;            /* 当前自适应批量大小 */
+static uint8_t s_encoding = MY_ENC_JSON;    /* 当前上报编码, 每次连接重新协商 */
+static spool_t s_spool;                     /* 离线缓存 (未设置溢出区时只使用RAM) */
+static uint32_t s_replay_ms = 0;            /* 上次补发时间 */
+static my_link_stats_t s_link = {0};        /* 连接统计 */
+
+/* 连接状态机步骤 */
+#define LK_IDLE                 0           /* 空闲 */
+#define LK_EXIT                 1           /* 退出透传 */
+#define LK_CLOSE                2           /* 关闭旧的TCP连接 */
+#define LK_ATE                  3           /* 关闭回显 (同时确认模块在线) */
+#define LK_QUERY                4           /* 查询是否已自动连接WiFi */
+#define LK_QUERY_IP             5           /* 确认已获取IP */
+#define LK_MODE                 6           /* Station模式 */
+#define LK_JOIN                 7           /* 加入WiFi (同时保存到模块) */
+#define LK_AUTOCONN             8           /* 开启上电自动连接 */
+#define LK_IP                   9           /* 获取IP地址 */
+#define LK_RESTORE              10          /* 恢复出厂设置 */
+#define LK_AT                   11          /* AT测试 */
+#define LK_RST                  12          /* 软件复位 */
+#define LK_TCP                  13          /* 连接TCP服务器 */
+#define LK_PASS                 14          /* 进入透传 */
+#define LK_REG                  15          /* 发送注册消息 */
+
+/* 连接状态机 (由调度器通过myserver_link_poll推进, 每步提交一条异步AT指令) */
+static struct {
+    uint8_t  step;                          /* 当前步骤 LK_* */
+    uint8_t  next;                          /* 退出透传后的下一步 */
+    uint8_t  busy;                          /* 1: 指令已提交, 等待回调 */
+    uint8_t  done;                          /* 1: 当前步骤已完成, result有效 */
+    uint8_t  result;                        /* 当前步骤结果 ATK_MW8266D_AT_* */
+    uint8_t  want_server;                   /* 1: WiFi连接后继续连接服务器 */
+    uint8_t  passthrough;                   /* 1: 模块可能处于透传模式 */
+    uint8_t  tries;                         /* AT测试次数 */
+    uint32_t t0;                            /* WiFi连接开始时间 */
+    uint32_t wait_start;                    /* 执行当前步骤前的等待 */
+    uint32_t wait_ms;
+    char     ip[16];                        /* 获取到的IP地址 */
+} s_lk;
+
+static json_parser_t s_json_parser;         /* JSON分词器状态 (跨帧续传) */
+static json_tok_t s_json_tokens[MY_JSON_MAX_TOKENS];    /* JSON token索引 */
 
 /******************************************************************************************/
 /* 私有函数声明 */
 
 static uint8_t send_json_message(const char *json);
-static uint8_t parse_json_command(const char *json);
-static int find_json_int(const char *json, const char *key);
-static char* find_json_string(const char *json, const char *key, char *out, uint8_t max_len);
+static uint8_t send_bin_message(const uint8_t *frame, uint16_t len);
+static uint8_t parse_json_command(const char *json, const json_tok_t *tokens, int count);
 static uint8_t check_tcp_disconnected(void);
+static const char *msg_ts(void);
+static void clock_sync(const char *json, const json_tok_t *tokens, int count, uint32_t rtt_ms);
 
 /******************************************************************************************/
 /* 初始化与连接 */
@@ -79,189 +171,999 @@ uint8_t myserver_wifi_init(void)
         return 1;
     }
 
+    hb_init(&s_hb_cfg, millis());
     printf("[MyServer] WiFi module init OK\r\n");
     return 0;
 }
 
 /**
- * @brief  连接WiFi路由器
+ * @brief  连接状态机: 指令完成回调 (需要解析的应答在回调中解析, resp只在回调期间有效)
  */
-uint8_t myserver_wifi_connect(void)
+static void link_at_done(uint8_t result, const char *resp, void *arg)
 {
-    uint8_t ret = 0;
-    char ip_buf[16];
+    char ssid[33];
+
+    (void)arg;
+
+    if (result == ATK_MW8266D_AT_EOK)
+    {
+        if (s_lk.step == LK_QUERY)
+        {
+            if (atk_mw8266d_parse_ap(resp, ssid) != 0 || strcmp(ssid, MY_WIFI_SSID) != 0)
+            {
+                result = ATK_MW8266D_AT_ERROR;
+            }
+        }
+        else if (s_lk.step == LK_QUERY_IP || s_lk.step == LK_IP)
+        {
+            if (atk_mw8266d_parse_ip(resp, s_lk.ip) != 0 || strcmp(s_lk.ip, "0.0.0.0") == 0)
+            {
+                result = ATK_MW8266D_AT_ERROR;
+            }
+        }
+    }
 
-    printf("[MyServer] Connecting to WiFi: %s\r\n", MY_WIFI_SSID);
+    s_lk.result = result;
+    s_lk.busy = 0;
+    s_lk.done = 1;
+}
 
-    ret  = atk_mw8266d_restore();                                   /* 恢复出厂设置 */
-    ret += atk_mw8266d_at_test();                                   /* AT测试 */
-    ret += atk_mw8266d_set_mode(1);                                 /* Station模式 */
-    ret += atk_mw8266d_sw_reset();                                  /* 软件复位 */
-    ret += atk_mw8266d_ate_config(0);                               /* 关闭回显 */
-    ret += atk_mw8266d_join_ap(MY_WIFI_SSID, MY_WIFI_PWD);          /* 连接WiFi */
-    ret += atk_mw8266d_get_ip(ip_buf);                              /* 获取IP地址 */
+/**
+ * @brief  连接状态机: 转到下一步, 可在之前等待wait_ms
+ */
+static void link_goto(uint8_t step, uint32_t wait_ms)
+{
+    s_lk.step = step;
+    s_lk.wait_start = millis();
+    s_lk.wait_ms = wait_ms;
+}
 
-    if (ret != 0)
+/**
+ * @brief  连接状态机: WiFi连接结束
+ */
+static void link_wifi_finish(uint8_t ok)
+{
+    s_link.wifi_ms = millis() - s_lk.t0;
+
+    if (!ok)
     {
-        printf("[MyServer] WiFi connect failed!\r\n");
+        printf("[MyServer] WiFi connect failed! (%lums)\r\n", (unsigned long)s_link.wifi_ms);
         g_my_wifi_status = MY_WIFI_ERROR;
-        return ret;
+        s_link.failures++;
+        if (s_link.fail_streak < 0xFF) s_link.fail_streak++;
+        link_goto(LK_IDLE, 0);
+        return;
     }
 
-    printf("[MyServer] WiFi connected! IP: %s\r\n", ip_buf);
+    if (s_link.path == MY_LINK_PATH_FAST) s_link.fast++;
+    else if (s_link.path == MY_LINK_PATH_JOIN) s_link.joins++;
+    else s_link.full_resets++;
+    s_link.fail_streak = 0;
+
+    printf("[MyServer] WiFi connected! IP: %s (%s, %lums)\r\n", s_lk.ip,
+           s_link.path == MY_LINK_PATH_FAST ? "auto" : (s_link.path == MY_LINK_PATH_JOIN ? "join" : "full"),
+           (unsigned long)s_link.wifi_ms);
     g_my_wifi_status = MY_WIFI_CONNECTED;
-    atk_mw8266d_uart_rx_restart();
 
+    if (s_lk.want_server)
+    {
+        printf("[MyServer] Connecting to server %s:%s\r\n", MY_SERVER_IP, MY_SERVER_PORT);
+        link_goto(LK_TCP, 0);
+    }
+    else
+    {
+        link_goto(LK_IDLE, 0);
+    }
+}
+
+/**
+ * @brief  连接状态机: 自动连接未完成时继续查询, 超过MY_WIFI_AUTOCONN_MS则改为直接加入
+ */
+static void link_query_again(void)
+{
+    if (millis() - s_lk.t0 < MY_WIFI_AUTOCONN_MS)
+    {
+        link_goto(LK_QUERY, MY_WIFI_POLL_MS);
+    }
+    else
+    {
+        s_link.path = MY_LINK_PATH_JOIN;
+        link_goto(LK_MODE, 0);
+    }
+}
+
+/**
+ * @brief  连接状态机: 根据当前步骤的结果决定下一步
+ */
+static void link_advance(uint8_t ok)
+{
+    switch (s_lk.step)
+    {
+        case LK_EXIT:       link_goto(LK_CLOSE, 0); break;      /* 结果忽略 */
+        case LK_CLOSE:      link_goto(s_lk.next, 0); break;     /* 结果忽略 (未连接时应答ERROR) */
+        case LK_ATE:
+            if (!ok) link_wifi_finish(0);
+            else link_goto(s_link.path == MY_LINK_PATH_FULL ? LK_JOIN : LK_QUERY, 0);
+            break;
+        case LK_QUERY:      if (ok) link_goto(LK_QUERY_IP, 0); else link_query_again(); break;
+        case LK_QUERY_IP:   if (ok) link_wifi_finish(1); else link_query_again(); break;
+        case LK_MODE:
+            if (!ok) link_wifi_finish(0);
+            else link_goto(s_link.path == MY_LINK_PATH_FULL ? LK_RST : LK_JOIN, 0);
+            break;
+        case LK_JOIN:       if (ok) link_goto(LK_AUTOCONN, 0); else link_wifi_finish(0); break;
+        case LK_AUTOCONN:   link_goto(LK_IP, 0); break;         /* 结果忽略 */
+        case LK_IP:         link_wifi_finish(ok); break;
+        case LK_RESTORE:    if (ok) { s_lk.tries = 0; link_goto(LK_AT, 0); } else link_wifi_finish(0); break;
+        case LK_AT:
+            if (ok) link_goto(LK_MODE, 0);
+            else if (++s_lk.tries < 10) link_goto(LK_AT, 0);
+            else link_wifi_finish(0);
+            break;
+        case LK_RST:        if (ok) link_goto(LK_ATE, 1000); else link_wifi_finish(0); break;
+        case LK_TCP:
+        case LK_PASS:
+            if (ok)
+            {
+                link_goto(s_lk.step == LK_TCP ? LK_PASS : LK_REG, s_lk.step == LK_TCP ? 0 : 100);
+            }
+            else
+            {
+                printf("[MyServer] %s failed!\r\n", s_lk.step == LK_TCP ? "Server connect" : "Enter unvarnished mode");
+                g_my_server_status = MY_SERVER_DISCONNECTED;
+                link_goto(LK_IDLE, 0);
+            }
+            break;
+        default:            link_goto(LK_IDLE, 0); break;
+    }
+}
+
+/**
+ * @brief  连接状态机: 提交当前步骤的指令
+ */
+static void link_issue(void)
+{
+    uint8_t ret = 0;
+
+    switch (s_lk.step)
+    {
+        case LK_EXIT:
+            atk_mw8266d_exit_unvarnished();
+            s_lk.passthrough = 0;
+            s_lk.result = ATK_MW8266D_AT_EOK;
+            s_lk.done = 1;
+            s_lk.wait_start = millis();
+            s_lk.wait_ms = 100;
+            return;
+        case LK_CLOSE:      ret = atk_mw8266d_at_submit("AT+CIPCLOSE", "OK", 500, link_at_done, NULL); break;
+        case LK_ATE:        ret = atk_mw8266d_ate_config_async(0, link_at_done, NULL); break;
+        case LK_QUERY:      ret = atk_mw8266d_query_ap_async(link_at_done, NULL); break;
+        case LK_QUERY_IP:
+        case LK_IP:         ret = atk_mw8266d_get_ip_async(link_at_done, NULL); break;
+        case LK_MODE:       ret = atk_mw8266d_set_mode_async(1, link_at_done, NULL); break;
+        case LK_JOIN:       ret = atk_mw8266d_join_ap_async(MY_WIFI_SSID, MY_WIFI_PWD, link_at_done, NULL); break;
+        case LK_AUTOCONN:   ret = atk_mw8266d_set_autoconn_async(1, link_at_done, NULL); break;
+        case LK_RESTORE:    ret = atk_mw8266d_restore_async(link_at_done, NULL); break;
+        case LK_AT:         ret = atk_mw8266d_at_test_async(link_at_done, NULL); break;
+        case LK_RST:        ret = atk_mw8266d_sw_reset_async(link_at_done, NULL); break;
+        case LK_TCP:        ret = atk_mw8266d_connect_tcp_server_async(MY_SERVER_IP, MY_SERVER_PORT, link_at_done, NULL); break;
+        case LK_PASS:       ret = atk_mw8266d_enter_unvarnished_async(link_at_done, NULL); break;
+        case LK_REG:
+            /* 注册消息 (上电到上线的时间在收到reg_ok时记录) */
+            printf("[MyServer] Server connected!\r\n");
+            g_my_server_status = MY_SERVER_CONNECTED;
+            s_lk.passthrough = 1;
+            s_encoding = MY_ENC_JSON;               /* 协商完成前使用JSON */
+            myserver_telemetry_force_keyframe();    /* 新连接先上报完整数据 */
+            hb_reset(millis());                     /* 心跳与RTT统计从新连接开始 */
+            myserver_send_register();
+            link_goto(LK_IDLE, 0);
+            return;
+        default:
+            return;
+    }
+
+    /* 引擎队列满时下个周期再提交 */
+    if (ret == 0)
+    {
+        s_lk.busy = 1;
+    }
+}
+
+/**
+ * @brief  开始连接
+ */
+uint8_t myserver_link_start(uint8_t want_server)
+{
+    uint8_t first;
+
+    if (s_lk.step != LK_IDLE) return 1;
+
+    s_lk.want_server = want_server;
+    s_lk.done = 0;
+    s_lk.busy = 0;
+
+    if (g_my_wifi_status == MY_WIFI_CONNECTED)
+    {
+        if (!want_server || g_my_server_status == MY_SERVER_CONNECTED) return 0;
+        printf("[MyServer] Connecting to server %s:%s\r\n", MY_SERVER_IP, MY_SERVER_PORT);
+        first = LK_TCP;
+    }
+    else
+    {
+        printf("[MyServer] Connecting to WiFi: %s\r\n", MY_WIFI_SSID);
+        s_lk.t0 = millis();
+        if (s_link.fail_streak >= MY_WIFI_RESET_AFTER)
+        {
+            /* 多次失败: 模块配置可能已损坏, 恢复出厂设置 */
+            s_link.path = MY_LINK_PATH_FULL;
+            first = LK_RESTORE;
+        }
+        else
+        {
+            /* 模块保存了WiFi并在上电时自动连接, 只需确认状态 */
+            s_link.path = MY_LINK_PATH_FAST;
+            first = LK_ATE;
+        }
+    }
+
+    /* 之前处于透传模式: 先退出透传并关闭旧连接 */
+    if (s_lk.passthrough)
+    {
+        s_lk.next = first;
+        first = LK_EXIT;
+    }
+    link_goto(first, 0);
     return 0;
 }
 
+/**
+ * @brief  推进连接状态机
+ */
+void myserver_link_poll(void)
+{
+    uint8_t ok;
+
+    if (s_lk.step == LK_IDLE || s_lk.busy) return;
+    if (millis() - s_lk.wait_start < s_lk.wait_ms) return;
+
+    if (s_lk.done)
+    {
+        s_lk.done = 0;
+        ok = (s_lk.result == ATK_MW8266D_AT_EOK);
+        link_advance(ok);
+        if (s_lk.step == LK_IDLE || millis() - s_lk.wait_start < s_lk.wait_ms) return;
+    }
+
+    link_issue();
+}
+
+/**
+ * @brief  连接是否正在进行
+ */
+uint8_t myserver_link_busy(void)
+{
+    return s_lk.step != LK_IDLE;
+}
+
+/**
+ * @brief  同步执行连接状态机直到结束 (启动阶段使用)
+ */
+static void link_run(void)
+{
+    while (s_lk.step != LK_IDLE)
+    {
+        atk_mw8266d_at_poll();
+        myserver_link_poll();
+        delay_ms(1);
+    }
+}
+
+/**
+ * @brief  连接WiFi路由器
+ */
+uint8_t myserver_wifi_connect(void)
+{
+    if (myserver_link_start(0) != 0) return 1;
+    link_run();
+    return g_my_wifi_status == MY_WIFI_CONNECTED ? 0 : 1;
+}
+
 /**
  * @brief  连接到自定义服务器
  */
 uint8_t myserver_connect(void)
 {
-    uint8_t ret;
-
     if (g_my_wifi_status != MY_WIFI_CONNECTED)
     {
         printf("[MyServer] WiFi not connected!\r\n");
         return 1;
     }
 
-    printf("[MyServer] Connecting to server %s:%s\r\n", MY_SERVER_IP, MY_SERVER_PORT);
+    if (myserver_link_start(1) != 0) return 1;
+    link_run();
+    return g_my_server_status == MY_SERVER_CONNECTED ? 0 : 1;
+}
+
+/**
+ * @brief  断开服务器连接
+ */
+uint8_t myserver_disconnect(void)
+{
+    atk_mw8266d_exit_unvarnished();
+    delay_ms(100);
+    atk_mw8266d_send_at_cmd("AT+CIPCLOSE", "OK", 500);
+
+    g_my_server_status = MY_SERVER_DISCONNECTED;
+    s_lk.passthrough = 0;
+    printf("[MyServer] Server disconnected\r\n");
+
+    return 0;
+}
+
+/**
+ * @brief  重新连接服务器
+ */
+uint8_t myserver_reconnect(void)
+{
+    myserver_disconnect();
+    delay_ms(500);
+    return myserver_connect();
+}
+
+/******************************************************************************************/
+/* 数据发送 */
+
+/**
+ * @brief  转换为二进制帧的传感器样本 (无效值按超出范围截断为127)
+ */
+static void to_bin_dat(const my_sensor_data_t *data, bin_dat_t *dat)
+{
+    dat->temp = data->temperature;
+    dat->humi = data->humidity;
+    dat->soil = data->soil_humidity;
+    dat->light = data->light_intensity;
+}
+
+/**
+ * @brief  格式化4个传感器数值 (温度/空气湿度/土壤湿度/光照), 逗号分隔
+ * @param  keyed: 1: 输出为"键":值 0: 只输出值
+ * @note   无效值 (MY_SENSOR_INVALID) 输出为null
+ * @retval 需要的长度 (与snprintf相同, 超出size时输出被截断)
+ */
+static int fmt_values(char *buf, int size, const uint8_t *v, uint8_t keyed)
+{
+    static const char *const keys[4] = {"temp", "humi", "soil", "light"};
+    int len = 0;
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        char *p = buf + (len < size ? len : size);
+        int room = (len < size) ? size - len : 0;
+
+        if (keyed) len += snprintf(p, room, "%s\"%s\":", i ? "," : "", keys[i]);
+        else if (i) len += snprintf(p, room, ",");
+
+        p = buf + (len < size ? len : size);
+        room = (len < size) ? size - len : 0;
+        if (v[i] == MY_SENSOR_INVALID) len += snprintf(p, room, "null");
+        else len += snprintf(p, room, "%d", v[i]);
+    }
+
+    return len;
+}
+
+/**
+ * @brief  发送s_send_buf中的JSON上报消息并累计字节数
+ */
+static uint8_t send_tlm_json(void)
+{
+    uint16_t len = strlen(s_send_buf);
+
+    if (send_json_message(s_send_buf) != 0) return 1;
+    s_tlm_stats.bytes_sent += len;
+    return 0;
+}
+
+/**
+ * @brief  发送s_send_buf中的二进制上报帧并累计字节数
+ */
+static uint8_t send_tlm_bin(uint16_t len)
+{
+    if (len == 0 || send_bin_message((const uint8_t *)s_send_buf, len) != 0) return 1;
+    s_tlm_stats.bytes_sent += len;
+    return 0;
+}
+
+/**
+ * @brief  发送设备注册信息 (V2.0协议格式)
+ * @note   用户ID用于将设备绑定到指定用户账号
+ */
+uint8_t myserver_send_register(void)
+{
+    s_reg_ms = millis();
+    s_rx_event_set = 0;                     /* 连接过程中的帧事件不是命令 */
+
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"reg","p":{"d":"设备ID","u":"用户ID","ver":"固件版本","enc":[支持的编码],
+     *           "bt":上电到上线ms (尚未上线为0),"wt":最近一次WiFi连接ms,"wp":WiFi连接方式}} */
+    snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"reg\",\"p\":{\"d\":\"%s\",\"u\":\"%s\",\"ver\":\"2.0\""
+#if MY_TLM_BIN_ENABLE
+        ",\"enc\":[\"json\",\"bin1\"]"
+#endif
+        ",\"bt\":%lu,\"wt\":%lu,\"wp\":%u}}\n",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID, MY_USER_ID,
+        (unsigned long)s_link.boot_online_ms, (unsigned long)s_link.wifi_ms, s_link.path);
+
+    return send_json_message(s_send_buf);
+}
+
+/**
+ * @brief  发送心跳包 (V2.0协议格式)
+ */
+uint8_t myserver_send_heartbeat(void)
+{
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"hb","d":"设备ID","p":{}} */
+    snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"hb\",\"d\":\"%s\",\"p\":{}}\n",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID);
+
+    return send_json_message(s_send_buf);
+}
+
+/**
+ * @brief  发送传感器数据 (V2.0协议格式)
+ */
+uint8_t myserver_send_sensor_data(my_sensor_data_t *data)
+{
+    bin_dat_t dat;
+    uint8_t v[4];
+    uint16_t len;
+
+    if (data == NULL) return 1;
+
+    if (s_encoding == MY_ENC_BIN)
+    {
+        to_bin_dat(data, &dat);
+        len = bin_encode_dat((uint8_t *)s_send_buf, sizeof(s_send_buf), (uint16_t)s_msg_seq++, &dat);
+        return send_tlm_bin(len);
+    }
+
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"dat","d":"设备ID","p":{传感器数据}} */
+    v[0] = data->temperature;
+    v[1] = data->humidity;
+    v[2] = data->soil_humidity;
+    v[3] = data->light_intensity;
+    len = snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"dat\",\"d\":\"%s\",\"p\":{",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID);
+    len += fmt_values(s_send_buf + len, sizeof(s_send_buf) - len, v, 1);
+    if (len >= (int)sizeof(s_send_buf) - 3) return 1;
+    strcpy(s_send_buf + len, "}}\n");
+
+    return send_tlm_json();
+}
+
+/**
+ * @brief  发送批量传感器数据
+ */
+uint8_t myserver_send_sensor_batch(const my_sensor_data_t *samples, const uint32_t *offsets_ms, uint8_t count)
+{
+    int len, n;
+    uint8_t i, v[4];
+    bin_dat_t dat[BIN_MAX_SAMPLES];
+    uint16_t offset_10ms[BIN_MAX_SAMPLES];
+
+    if (samples == NULL || offsets_ms == NULL || count == 0) return 1;
+
+    if (s_encoding == MY_ENC_BIN && count <= BIN_MAX_SAMPLES)
+    {
+        for (i = 0; i < count; i++)
+        {
+            to_bin_dat(&samples[i], &dat[i]);
+            offset_10ms[i] = (offsets_ms[i] / 10 > 0xFFFF) ? 0xFFFF : (uint16_t)(offsets_ms[i] / 10);
+        }
+        len = bin_encode_dat_batch((uint8_t *)s_send_buf, sizeof(s_send_buf), (uint16_t)s_msg_seq++,
+                                   dat, offset_10ms, count);
+        return send_tlm_bin((uint16_t)len);
+    }
+
+    len = snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"dat\",\"d\":\"%s\","
+        "\"p\":{\"f\":[\"temp\",\"humi\",\"soil\",\"light\"],\"s\":[",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID);
+
+    for (i = 0; i < count && len < (int)sizeof(s_send_buf); i++)
+    {
+        v[0] = samples[i].temperature;
+        v[1] = samples[i].humidity;
+        v[2] = samples[i].soil_humidity;
+        v[3] = samples[i].light_intensity;
+        n = snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "%s[%lu,",
+            i ? "," : "", (unsigned long)offsets_ms[i]);
+        len += n;
+        if (len >= (int)sizeof(s_send_buf)) break;
+        len += fmt_values(s_send_buf + len, sizeof(s_send_buf) - len, v, 0);
+        if (len >= (int)sizeof(s_send_buf)) break;
+        len += snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "]");
+    }
+
+    if (len < (int)sizeof(s_send_buf))
+    {
+        len += snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "]}}\n");
+    }
+
+    if (len >= (int)sizeof(s_send_buf))
+    {
+        printf("[MyServer] Batch too large: %d samples\r\n", count);
+        return 1;
+    }
+
+    return send_tlm_json();
+}
+
+/**
+ * @brief  补发离线样本 (总是JSON, 格式见 myserver_telemetry_set_spool)
+ */
+static uint8_t send_sensor_backfill(const spool_rec_t *recs, uint8_t count, uint32_t first_seq, uint32_t now)
+{
+    int len, n;
+    uint8_t i;
+
+    len = snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"dat\",\"d\":\"%s\","
+        "\"p\":{\"bf\":1,\"q\":%lu,\"age\":%lu,\"f\":[\"temp\",\"humi\",\"soil\",\"light\"],\"s\":[",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID,
+        (unsigned long)first_seq, (unsigned long)(now - recs[0].ms));
+
+    for (i = 0; i < count && len < (int)sizeof(s_send_buf); i++)
+    {
+        n = snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "%s[%lu,",
+            i ? "," : "", (unsigned long)(recs[i].ms - recs[0].ms));
+        len += n;
+        if (len >= (int)sizeof(s_send_buf)) break;
+        len += fmt_values(s_send_buf + len, sizeof(s_send_buf) - len, recs[i].v, 0);
+        if (len >= (int)sizeof(s_send_buf)) break;
+        len += snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "]");
+    }
+
+    if (len < (int)sizeof(s_send_buf))
+    {
+        len += snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "]}}\n");
+    }
+
+    if (len >= (int)sizeof(s_send_buf)) return 1;
+
+    return send_tlm_json();
+}
+
+/**
+ * @brief  发送设备状态 (V2.0协议格式)
+ */
+uint8_t myserver_send_device_status(my_device_status_t *status)
+{
+    bin_sta_t sta;
+    hb_stats_t hb;
+    uint16_t len;
+
+    if (status == NULL) return 1;
+
+    if (s_encoding == MY_ENC_BIN && !s_bt_report)
+    {
+        sta.mode = status->mode;
+        sta.light = status->light_status;
+        sta.water = status->water_status;
+        sta.fan = status->fan_status;
+        len = bin_encode_sta((uint8_t *)s_send_buf, sizeof(s_send_buf), (uint16_t)s_msg_seq++, &sta);
+        return send_tlm_bin(len);
+    }
+
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"sta","d":"设备ID","p":{状态数据}}
+     * 附带本次连接的心跳RTT (ms, 0表示尚无样本); bin1状态帧格式固定, 不携带RTT.
+     * 首次上线后的第一条sta携带上电到上线时间bt (ms), 此时即使已协商bin1也以JSON发送 */
+    hb_get_stats(&hb);
+    len = snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"sta\",\"d\":\"%s\","
+        "\"p\":{\"mode\":%d,\"light\":%d,\"water\":%d,\"fan\":%d,"
+        "\"rtt_min\":%lu,\"rtt_avg\":%lu,\"rtt_max\":%lu",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID,
+        status->mode, status->light_status, status->water_status, status->fan_status,
+        (unsigned long)hb.rtt_min, (unsigned long)hb.rtt_avg, (unsigned long)hb.rtt_max);
+    if (s_bt_report)
+    {
+        len += snprintf(s_send_buf + len, sizeof(s_send_buf) - len, ",\"bt\":%lu",
+                        (unsigned long)s_link.boot_online_ms);
+    }
+    snprintf(s_send_buf + len, sizeof(s_send_buf) - len, "}}\n");
+
+    if (send_tlm_json() != 0) return 1;
+    s_bt_report = 0;
+    return 0;
+}
+
+/**
+ * @brief  发送命令确认 (V2.0协议格式)
+ * @note   使用原始命令的字符串ID作为ref字段，以便服务器匹配
+ */
+uint8_t myserver_send_ack(uint32_t cmd_id, uint8_t success)
+{
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"ack","d":"设备ID","p":{"ref":"原始命令ID","ok":1}} */
+    /* 使用保存的字符串ID作为ref字段 */
+    snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"ack\",\"d\":\"%s\","
+        "\"p\":{\"ref\":\"%s\",\"ok\":%d}}\n",
+        (unsigned long)s_msg_seq++, msg_ts(), MY_DEVICE_ID,
+        s_cmd_id_str, success ? 1 : 0);
+
+    return send_json_message(s_send_buf);
+}
+
+/**
+ * @brief  格式化一个剖析段的统计
+ * @retval 写入的长度
+ */
+static int perf_format(uint8_t id, char *buf, uint16_t size)
+{
+    perf_stats_t st;
+
+    perf_get(id, &st);
+    return snprintf(buf, size, "%s\"%s\":[%lu,%lu,%lu,%lu,[%u,%u,%u,%u,%u,%u,%u,%u]]",
+        id ? "," : "", st.name, (unsigned long)st.count,
+        (unsigned long)st.min_us, (unsigned long)st.avg_us, (unsigned long)st.max_us,
+        st.hist[0], st.hist[1], st.hist[2], st.hist[3],
+        st.hist[4], st.hist[5], st.hist[6], st.hist[7]);
+}
+
+/**
+ * @brief  格式化显示刷新统计和命令延迟, 作为剖析表的结尾
+ * @retval 写入的长度
+ */
+static int perf_format_render(char *buf, uint16_t size)
+{
+    lv_port_disp_stats_t st;
+    uint32_t n;
+
+    lv_port_disp_get_stats(&st);
+    n = st.frames ? st.frames : 1;
+    return snprintf(buf, size, "},\"r\":{\"fr\":%lu,\"rnd\":[%lu,%lu,%lu],\"fl\":[%lu,%lu,%lu],"
+        "\"px\":%lu,\"ar\":%u,\"mem\":[%lu,%lu,%lu,%u]},\"c\":[%lu,%lu,%lu,%lu,%lu]}}\n",
+        (unsigned long)st.frames, (unsigned long)st.last_render_us,
+        (unsigned long)(st.total_render_us / n), (unsigned long)st.max_render_us,
+        (unsigned long)st.last_frame_us, (unsigned long)(st.total_frame_us / n),
+        (unsigned long)st.max_frame_us, (unsigned long)st.last_px, st.last_areas,
+        (unsigned long)st.mem_used, (unsigned long)st.mem_free, (unsigned long)st.mem_max_used,
+        st.mem_frag_pct, (unsigned long)s_cmd_stats.count, (unsigned long)s_cmd_stats.last_us,
+        (unsigned long)s_cmd_stats.avg_us, (unsigned long)s_cmd_stats.max_us, (unsigned long)s_cmd_stats.slow);
+}
+
+/**
+ * @brief  发送性能剖析表
+ * @note   整张表超过s_send_buf, 先计算总长度并确认发送队列放得下, 再逐段格式化入队,
+ *         保证一条消息在发送队列中连续; 结尾的显示刷新统计暂存在s_send_buf中消息头之后
+ */
+uint8_t myserver_send_perf(void)
+{
+    char frag[128];
+    char *tail;
+    uint16_t total;
+    uint8_t i;
+    int len, tail_len;
+
+    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"perf","d":"设备ID",
+     *   "p":{"hz":72000000,"f":["n","min","avg","max","h"],"s":{"lvgl":[n,min,avg,max,[h0..h7]],...},
+     *        "r":{显示刷新},"c":[命令数,最近,平均,最大延迟us,慢命令数]}} */
+    len = snprintf(s_send_buf, sizeof(s_send_buf),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"%s\",\"d\":\"%s\","
+        "\"p\":{\"hz\":%lu,\"f\":[\"n\",\"min\",\"avg\",\"max\",\"h\"],\"s\":{",
+        (unsigned long)s_msg_seq++, msg_ts(), MSG_TYPE_PERF, MY_DEVICE_ID,
+        (unsigned long)SystemCoreClock);
+    if (len >= (int)sizeof(s_send_buf)) return 1;
+
+    tail = s_send_buf + len + 1;
+    tail_len = perf_format_render(tail, sizeof(s_send_buf) - len - 1);
+    if (tail_len >= (int)sizeof(s_send_buf) - len - 1) return 1;
+
+    total = (uint16_t)(len + tail_len);
+    for (i = 0; i < PERF_SCOPE_COUNT; i++)
+    {
+        total += perf_format(i, frag, sizeof(frag));
+    }
+    if (g_my_server_status != MY_SERVER_CONNECTED || atk_mw8266d_uart_tx_free() < total)
+    {
+        return 1;
+    }
+
+    send_json_message(s_send_buf);
+    for (i = 0; i < PERF_SCOPE_COUNT; i++)
+    {
+        len = perf_format(i, frag, sizeof(frag));
+        atk_mw8266d_uart_send((const uint8_t *)frag, (uint16_t)len);
+    }
+    atk_mw8266d_uart_send((const uint8_t *)tail, (uint16_t)tail_len);
+
+    return 0;
+}
+
+/******************************************************************************************/
+/* 变化驱动上报 */
+
+/**
+ * @brief  判断数值变化量是否达到死区
+ */
+static uint8_t tlm_exceeds(uint8_t now, uint8_t last, uint8_t deadband)
+{
+    uint8_t diff = (now > last) ? (now - last) : (last - now);
+
+    return (diff != 0 && diff >= deadband) ? 1 : 0;
+}
+
+/**
+ * @brief  样本转入离线缓存
+ */
+static void tlm_spool_sample(const my_sensor_data_t *data, uint32_t ms)
+{
+    uint8_t v[TSLOG_CHANNELS];
+
+    v[0] = data->temperature;
+    v[1] = data->humidity;
+    v[2] = data->soil_humidity;
+    v[3] = data->light_intensity;
+
+    if (spool_push(&s_spool, ms, v) == 0)
+    {
+        s_tlm_stats.spooled++;
+    }
+}
+
+/**
+ * @brief  未发送的批量样本全部转入离线缓存
+ */
+static void tlm_spool_batch(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_batch_count; i++)
+    {
+        tlm_spool_sample(&s_batch_data[i], s_batch_ms[i]);
+    }
+    s_batch_count = 0;
+}
+
+/**
+ * @brief  补发一批离线样本
+ * @note   限速: 距上次补发不足replay_ms或发送队列占用超过1/4时跳过, 保证实时数据不被补发挤占
+ * @retval 1:已发送 0:未发送
+ */
+static uint8_t tlm_replay(uint32_t now)
+{
+    spool_rec_t recs[MY_TLM_REPLAY_MAX];
+    atk_mw8266d_uart_tx_stats_t tx;
+    uint32_t seq;
+    uint8_t n, max;
+
+    if (spool_count(&s_spool) == 0 || now - s_replay_ms < s_tlm_policy.replay_ms) return 0;
+
+    atk_mw8266d_uart_tx_get_stats(&tx);
+    if (tx.used > ATK_MW8266D_UART_TX_RING_SIZE / 4) return 0;
+
+    max = s_tlm_policy.replay_max;
+    if (max > MY_TLM_REPLAY_MAX) max = MY_TLM_REPLAY_MAX;
+    if (max == 0) max = 1;
+
+    n = spool_peek(&s_spool, recs, max, &seq);
+    if (n == 0) return 0;
+
+    s_replay_ms = now;
+    if (send_sensor_backfill(recs, n, seq, now) != 0)
+    {
+        s_tlm_stats.send_failed++;
+        return 0;
+    }
+
+    spool_pop(&s_spool, n);
+    s_tlm_stats.replayed += n;
+    return 1;
+}
+
+/**
+ * @brief  发送缓存的dat样本并按链路状况调整批量大小
+ * @retval 0:已发送或无数据 1:发送失败
+ */
+static uint8_t tlm_flush_batch(void)
+{
+    uint32_t offsets[MY_TLM_BATCH_MAX];
+    atk_mw8266d_uart_tx_stats_t tx;
+    uint8_t i, ret, max;
+
+    if (s_batch_count == 0) return 0;
+
+    if (s_batch_count == 1)
+    {
+        ret = myserver_send_sensor_data(&s_batch_data[0]);
+    }
+    else
+    {
+        for (i = 0; i < s_batch_count; i++)
+        {
+            offsets[i] = s_batch_ms[i] - s_batch_ms[0];
+        }
+        ret = myserver_send_sensor_batch(s_batch_data, offsets, s_batch_count);
+    }
+
+    /* 链路质量: 发送失败或发送队列占用超过一半时加倍攒批, 队列基本空闲时逐步回到单条发送 */
+    max = s_tlm_policy.batch_max;
+    if (max > MY_TLM_BATCH_MAX) max = MY_TLM_BATCH_MAX;
+    if (max == 0) max = 1;
+    atk_mw8266d_uart_tx_get_stats(&tx);
+
+    if (ret != 0 || tx.used > ATK_MW8266D_UART_TX_RING_SIZE / 2)
+    {
+        s_batch_size = (s_batch_size * 2 > max) ? max : s_batch_size * 2;
+    }
+    else if (tx.used < ATK_MW8266D_UART_TX_RING_SIZE / 4 && s_batch_size > 1)
+    {
+        s_batch_size--;
+    }
+    if (s_batch_size > max) s_batch_size = max;
 
-    /* 连接TCP服务器 */
-    ret = atk_mw8266d_connect_tcp_server(MY_SERVER_IP, MY_SERVER_PORT);
     if (ret != 0)
     {
-        printf("[MyServer] Server connect failed!\r\n");
-        g_my_server_status = MY_SERVER_DISCONNECTED;
+        s_tlm_stats.send_failed++;
         return 1;
     }
 
-    /* 进入透传模式 */
-    ret = atk_mw8266d_enter_unvarnished();
-    if (ret != 0)
+    s_tlm_stats.dat_sent++;
+    s_tlm_stats.samples_sent += s_batch_count;
+    s_batch_count = 0;
+    return 0;
+}
+
+/**
+ * @brief  按上报策略发送传感器数据和设备状态
+ */
+uint8_t myserver_report(const my_sensor_data_t *data, const my_device_status_t *status)
+{
+    uint32_t now = millis();
+    uint8_t online = (g_my_server_status == MY_SERVER_CONNECTED);
+    uint8_t sent = 0;
+    uint8_t flush_now = 0;
+
+    if (data == NULL || status == NULL) return 0;
+
+    /* 关键帧到期 */
+    if (now - s_tlm_keyframe_ms >= s_tlm_policy.keyframe_ms)
+    {
+        s_tlm_keyframe_ms = now;
+        s_tlm_need_dat = 1;
+        s_tlm_need_sta = 1;
+        s_tlm_stats.keyframes++;
+    }
+
+    /* 传感器数据: 任一字段超出死区时记录一个样本 */
+    if (s_tlm_need_dat ||
+        tlm_exceeds(data->temperature, s_tlm_last_dat.temperature, s_tlm_policy.db_temp) ||
+        tlm_exceeds(data->humidity, s_tlm_last_dat.humidity, s_tlm_policy.db_humi) ||
+        tlm_exceeds(data->soil_humidity, s_tlm_last_dat.soil_humidity, s_tlm_policy.db_soil) ||
+        tlm_exceeds(data->light_intensity, s_tlm_last_dat.light_intensity, s_tlm_policy.db_light))
+    {
+        if (!online)
+        {
+            tlm_spool_sample(data, now);
+        }
+        else
+        {
+            if (s_batch_count >= MY_TLM_BATCH_MAX)
+            {
+                /* 缓存已满且之前发送失败, 最早的样本转入离线缓存 */
+                tlm_spool_sample(&s_batch_data[0], s_batch_ms[0]);
+                memmove(&s_batch_data[0], &s_batch_data[1], sizeof(s_batch_data[0]) * (MY_TLM_BATCH_MAX - 1));
+                memmove(&s_batch_ms[0], &s_batch_ms[1], sizeof(s_batch_ms[0]) * (MY_TLM_BATCH_MAX - 1));
+                s_batch_count--;
+            }
+            s_batch_data[s_batch_count] = *data;
+            s_batch_ms[s_batch_count] = now;
+            s_batch_count++;
+        }
+
+        s_tlm_last_dat = *data;
+        flush_now = s_tlm_need_dat;     /* 关键帧不等待攒批 */
+        s_tlm_need_dat = 0;
+    }
+    else
+    {
+        s_tlm_stats.dat_suppressed++;
+    }
+
+    if (!online)
+    {
+        /* 离线: 未发送的批量样本一并转入离线缓存, 重连后补发 */
+        tlm_spool_batch();
+        s_tlm_need_sta = 1;
+        return 0;
+    }
+
+    if (s_batch_count > 0 &&
+        (flush_now || s_batch_count >= s_batch_size || now - s_batch_ms[0] >= s_tlm_policy.batch_ms))
+    {
+        if (tlm_flush_batch() == 0)
+        {
+            sent++;
+        }
+    }
+
+    /* 设备状态: 任一执行器或模式变化 */
+    if (s_tlm_need_sta || memcmp(status, &s_tlm_last_sta, sizeof(my_device_status_t)) != 0)
     {
-        printf("[MyServer] Enter unvarnished mode failed!\r\n");
-        g_my_server_status = MY_SERVER_DISCONNECTED;
-        return 1;
+        if (myserver_send_device_status((my_device_status_t *)status) == 0)
+        {
+            s_tlm_last_sta = *status;
+            s_tlm_need_sta = 0;
+            s_tlm_stats.sta_sent++;
+            sent++;
+        }
+        else
+        {
+            s_tlm_need_sta = 1;
+            s_tlm_stats.send_failed++;
+        }
+    }
+    else
+    {
+        s_tlm_stats.sta_suppressed++;
     }
 
-    printf("[MyServer] Server connected!\r\n");
-    g_my_server_status = MY_SERVER_CONNECTED;
-
-    /* 发送注册消息 */
-    delay_ms(100);
-    myserver_send_register();
-
-    return 0;
-}
-
-/**
- * @brief  断开服务器连接
- */
-uint8_t myserver_disconnect(void)
-{
-    atk_mw8266d_exit_unvarnished();
-    delay_ms(100);
-    atk_mw8266d_send_at_cmd("AT+CIPCLOSE", "OK", 500);
-
-    g_my_server_status = MY_SERVER_DISCONNECTED;
-    printf("[MyServer] Server disconnected\r\n");
-
-    return 0;
-}
+    /* 补发离线样本 (在本周期实时数据之后) */
+    sent += tlm_replay(now);
 
-/**
- * @brief  重新连接服务器
- */
-uint8_t myserver_reconnect(void)
-{
-    myserver_disconnect();
-    delay_ms(500);
-    return myserver_connect();
+    return sent;
 }
 
-/******************************************************************************************/
-/* 数据发送 */
-
 /**
- * @brief  发送设备注册信息 (V2.0协议格式)
- * @note   用户ID用于将设备绑定到指定用户账号
+ * @brief  设置上报策略
  */
-uint8_t myserver_send_register(void)
+void myserver_telemetry_set_policy(const my_telemetry_policy_t *policy)
 {
-    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"reg","p":{"d":"设备ID","u":"用户ID","ver":"固件版本"}} */
-    snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"reg\",\"p\":{\"d\":\"%s\",\"u\":\"%s\",\"ver\":\"2.0\"}}\n",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000), MY_DEVICE_ID, MY_USER_ID);
-
-    return send_json_message(s_send_buf);
+    if (policy == NULL) return;
+    s_tlm_policy = *policy;
 }
 
 /**
- * @brief  发送心跳包 (V2.0协议格式)
+ * @brief  强制下一次上报为关键帧
  */
-uint8_t myserver_send_heartbeat(void)
+void myserver_telemetry_force_keyframe(void)
 {
-    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"hb","d":"设备ID","p":{}} */
-    snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"hb\",\"d\":\"%s\",\"p\":{}}\n",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000), MY_DEVICE_ID);
-
-    return send_json_message(s_send_buf);
+    s_tlm_keyframe_ms = millis() - s_tlm_policy.keyframe_ms;
 }
 
 /**
- * @brief  发送传感器数据 (V2.0协议格式)
+ * @brief  设置离线缓存的Flash溢出区
+ * @note   已缓存的样本会被清空, 应在开始上报前调用
  */
-uint8_t myserver_send_sensor_data(my_sensor_data_t *data)
+void myserver_telemetry_set_spool(const tslog_flash_t *flash, uint8_t sectors)
 {
-    if (data == NULL) return 1;
-
-    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"dat","d":"设备ID","p":{传感器数据}} */
-    snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"dat\",\"d\":\"%s\","
-        "\"p\":{\"temp\":%d,\"humi\":%d,\"soil\":%d,\"light\":%d}}\n",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000), MY_DEVICE_ID,
-        data->temperature, data->humidity, data->soil_humidity, data->light_intensity);
-
-    return send_json_message(s_send_buf);
+    spool_init(&s_spool, flash, sectors);
 }
 
 /**
- * @brief  发送设备状态 (V2.0协议格式)
+ * @brief  获取当前上报编码
  */
-uint8_t myserver_send_device_status(my_device_status_t *status)
+uint8_t myserver_get_encoding(void)
 {
-    if (status == NULL) return 1;
-
-    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"sta","d":"设备ID","p":{状态数据}} */
-    snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"sta\",\"d\":\"%s\","
-        "\"p\":{\"mode\":%d,\"light\":%d,\"water\":%d,\"fan\":%d}}\n",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000), MY_DEVICE_ID,
-        status->mode, status->light_status, status->water_status, status->fan_status);
-
-    return send_json_message(s_send_buf);
+    return s_encoding;
 }
 
 /**
- * @brief  发送命令确认 (V2.0协议格式)
- * @note   使用原始命令的字符串ID作为ref字段，以便服务器匹配
+ * @brief  获取上报统计
  */
-uint8_t myserver_send_ack(uint32_t cmd_id, uint8_t success)
+void myserver_telemetry_get_stats(my_telemetry_stats_t *stats)
 {
-    /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"ack","d":"设备ID","p":{"ref":"原始命令ID","ok":1}} */
-    /* 使用保存的字符串ID作为ref字段 */
-    snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"ack\",\"d\":\"%s\","
-        "\"p\":{\"ref\":\"%s\",\"ok\":%d}}\n",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000), MY_DEVICE_ID,
-        s_cmd_id_str, success ? 1 : 0);
-
-    return send_json_message(s_send_buf);
+    if (stats == NULL) return;
+    *stats = s_tlm_stats;
+    stats->batch_size = s_batch_size;
+    stats->encoding = s_encoding;
+    stats->samples_dropped = s_spool.stats.dropped;
+    stats->spool_pending = spool_count(&s_spool);
 }
 
 /******************************************************************************************/
@@ -269,37 +1171,151 @@ uint8_t myserver_send_ack(uint32_t cmd_id, uint8_t success)
 
 /**
  * @brief  接收并解析服务器消息
+ * @note   每次调用最多处理一条报文; 一帧中粘在一起的多条报文留在缓冲区中由后续调用处理,
+ *         被拆成多帧的报文由分词器从断点续传
  */
 my_cmd_type_t myserver_receive_command(void)
 {
     uint8_t *buf;
+    uint16_t len, consumed;
+    char *start;
+    int count;
+    my_cmd_type_t type = CMD_NONE;
 
     if (g_my_server_status != MY_SERVER_CONNECTED)
     {
         return CMD_NONE;
     }
 
+    /* 追加新到达的一帧 */
     buf = atk_mw8266d_uart_rx_get_frame();
-    if (buf == NULL)
+    if (buf != NULL)
+    {
+        len = atk_mw8266d_uart_rx_get_frame_len();
+        if (s_recv_len + len >= sizeof(s_recv_buf))
+        {
+            printf("[MyServer] Receive buffer overflow, %u bytes dropped\r\n", s_recv_len);
+            s_recv_len = 0;
+            json_init(&s_json_parser);
+            if (len >= sizeof(s_recv_buf)) len = sizeof(s_recv_buf) - 1;
+        }
+        memcpy(s_recv_buf + s_recv_len, buf, len);
+        s_recv_len += len;
+        s_recv_buf[s_recv_len] = '\0';
+        s_recv_ms = millis();
+        atk_mw8266d_uart_rx_restart();
+        hb_on_rx(millis());
+
+        if (s_rx_event_set)
+        {
+            s_frame_us = s_rx_event_us;
+            s_rx_event_set = 0;
+        }
+        else
+        {
+            s_frame_us = micros();
+        }
+    }
+
+    s_recv_more = 0;
+    if (s_recv_len == 0)
     {
         return CMD_NONE;
     }
 
-    /* 复制到接收缓冲区 */
-    strncpy(s_recv_buf, (char *)buf, sizeof(s_recv_buf) - 1);
-    s_recv_buf[sizeof(s_recv_buf) - 1] = '\0';
+    /* 新报文从'{'开始, 丢弃前面的非JSON内容 */
+    if (s_json_parser.pos == 0)
+    {
+        start = strchr(s_recv_buf, '{');
+        if (start == NULL)
+        {
+            s_recv_len = 0;
+            return CMD_NONE;
+        }
+        s_recv_len -= (uint16_t)(start - s_recv_buf);
+        memmove(s_recv_buf, start, s_recv_len + 1);
+        json_init(&s_json_parser);
+    }
 
-    printf("[MyServer] Received: %s\r\n", s_recv_buf);
+    PERF_BEGIN(PERF_RX);
+    count = json_parse(&s_json_parser, s_recv_buf, s_recv_len, s_json_tokens, MY_JSON_MAX_TOKENS);
 
-    /* 解析JSON命令 */
-    if (parse_json_command(s_recv_buf) == 0)
+    if (count == JSON_ERROR_PART)
     {
-        atk_mw8266d_uart_rx_restart();
-        return g_received_cmd.type;
+        /* 等待后续帧; 超时则丢弃, 避免残缺报文吞掉后面的报文.
+         * 按时间而不是调用次数计算: 帧事件会让本函数在周期调用之外额外运行 */
+        if (buf != NULL || millis() - s_recv_ms < MY_JSON_PART_MS)
+        {
+            PERF_END(PERF_RX);
+            return CMD_NONE;
+        }
+        printf("[MyServer] Incomplete message dropped\r\n");
+        consumed = s_recv_len;
+    }
+    else if (count < 0)
+    {
+        printf("[MyServer] JSON parse error %d\r\n", count);
+        consumed = s_recv_len;
+    }
+    else
+    {
+        consumed = s_json_parser.pos;
+
+        /* 命令在ack入队后再打印 (USART1轮询发送, 一条报文约10ms) */
+        if (parse_json_command(s_recv_buf, s_json_tokens, count) == 0)
+        {
+            type = g_received_cmd.type;
+        }
+        if (type == CMD_NONE)
+        {
+            printf("[MyServer] Received: %.*s\r\n", consumed, s_recv_buf);
+        }
+        else
+        {
+            s_cmd_rx_us = s_frame_us;
+        }
     }
 
-    atk_mw8266d_uart_rx_restart();
-    return CMD_NONE;
+    /* 移除已处理的报文, 剩余数据留给下一次调用 */
+    s_recv_len -= consumed;
+    memmove(s_recv_buf, s_recv_buf + consumed, s_recv_len + 1);
+    s_recv_more = (s_recv_len != 0);
+    json_init(&s_json_parser);
+    PERF_END(PERF_RX);
+
+    return type;
+}
+
+/**
+ * @brief  下行帧到达事件
+ * @note   在中断中调用; 只记录第一个尚未取走的帧, 由myserver_receive_command()取走
+ */
+void myserver_rx_event(void)
+{
+    if (s_rx_event_set || s_lk.step != LK_IDLE || g_my_server_status != MY_SERVER_CONNECTED) return;
+
+    s_rx_event_us = micros();
+    s_rx_event_set = 1;
+}
+
+/**
+ * @brief  是否还有待处理的下行数据
+ * @note   不完整的报文要等后续帧, 不算待处理
+ */
+uint8_t myserver_rx_pending(void)
+{
+    if (s_lk.step != LK_IDLE || g_my_server_status != MY_SERVER_CONNECTED) return 0;
+
+    return s_recv_more || atk_mw8266d_uart_rx_get_frame() != NULL;
+}
+
+/**
+ * @brief  获取命令处理统计
+ */
+void myserver_cmd_get_stats(my_cmd_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_cmd_stats;
 }
 
 /**
@@ -332,6 +1348,23 @@ uint8_t myserver_check_server(void)
     return g_my_server_status;
 }
 
+/**
+ * @brief  获取连接统计
+ */
+void myserver_link_get_stats(my_link_stats_t *stats)
+{
+    if (stats == NULL) return;
+    *stats = s_link;
+}
+
+/**
+ * @brief  获取心跳统计
+ */
+void myserver_heartbeat_get_stats(hb_stats_t *stats)
+{
+    hb_get_stats(stats);
+}
+
 /******************************************************************************************/
 /* 主处理函数 */
 
@@ -341,41 +1374,34 @@ uint8_t myserver_check_server(void)
  */
 void myserver_process(void)
 {
+    /* 连接过程中接收帧是AT应答, 由AT引擎处理 */
+    if (s_lk.step != LK_IDLE) return;
+
     /* 检测TCP是否断开 (透传模式下ESP8266返回CLOSED) */
     if (check_tcp_disconnected())
     {
         printf("[MyServer] TCP connection lost!\r\n");
         g_my_server_status = MY_SERVER_DISCONNECTED;
-        s_heartbeat_pending = 0;
-        s_heartbeat_timeout = 0;
         return;
     }
 
-    /* 心跳超时检测 - 如果等待响应超过30秒，认为连接断开 */
-    if (s_heartbeat_pending)
+    if (g_my_server_status != MY_SERVER_CONNECTED) return;
+
+    /* 心跳: 按毫秒时钟判断, 上行有其他报文时跳过, RTT变差时缩短间隔 */
+    switch (hb_poll(millis()))
     {
-        s_heartbeat_timeout++;
-        if (s_heartbeat_timeout >= 600)  /* 600 * 50ms = 30s */
-        {
+        case HB_SEND:
+            if (myserver_send_heartbeat() == 0)
+            {
+                hb_sent(millis());
+            }
+            break;
+        case HB_LOST:
             printf("[MyServer] Heartbeat timeout, connection lost!\r\n");
             g_my_server_status = MY_SERVER_DISCONNECTED;
-            s_heartbeat_pending = 0;
-            s_heartbeat_timeout = 0;
-            return;
-        }
-    }
-
-    /* 心跳发送 - 每15秒发送一次 */
-    s_heartbeat_timer++;
-    if (s_heartbeat_timer >= 300)  /* 300 * 50ms = 15s */
-    {
-        s_heartbeat_timer = 0;
-        if (g_my_server_status == MY_SERVER_CONNECTED)
-        {
-            myserver_send_heartbeat();
-            s_heartbeat_pending = 1;   /* 标记等待心跳响应 */
-            s_heartbeat_timeout = 0;   /* 重置超时计数器 */
-        }
+            break;
+        default:
+            break;
     }
 }
 
@@ -384,6 +1410,7 @@ void myserver_process(void)
 
 /**
  * @brief  发送JSON消息
+ * @retval 0:已入队 1:未连接或发送队列已满
  */
 static uint8_t send_json_message(const char *json)
 {
@@ -393,8 +1420,41 @@ static uint8_t send_json_message(const char *json)
         return 1;
     }
 
-    atk_mw8266d_uart_printf("%s", json);
+    /* 入队后立即返回, 由DMA在后台发送; 队列满时丢弃本帧, 由调用方决定是否重发 */
+    if (atk_mw8266d_uart_send((const uint8_t *)json, strlen(json)) != 0)
+    {
+        printf("[MyServer] TX queue full, frame dropped\r\n");
+        return 1;
+    }
+    hb_on_tx(millis());
+#if MY_DEBUG_TX_ECHO
     printf("[MyServer] Sent: %s", json);
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief  发送二进制帧
+ * @retval 0:已入队 1:未连接或发送队列已满
+ */
+static uint8_t send_bin_message(const uint8_t *frame, uint16_t len)
+{
+    if (g_my_server_status != MY_SERVER_CONNECTED)
+    {
+        printf("[MyServer] Not connected, cannot send!\r\n");
+        return 1;
+    }
+
+    if (atk_mw8266d_uart_send(frame, len) != 0)
+    {
+        printf("[MyServer] TX queue full, frame dropped\r\n");
+        return 1;
+    }
+    hb_on_tx(millis());
+#if MY_DEBUG_TX_ECHO
+    printf("[MyServer] Sent: bin type=%02X len=%u\r\n", frame[2], len);
+#endif
 
     return 0;
 }
@@ -403,21 +1463,25 @@ static uint8_t send_json_message(const char *json)
  * @brief  解析JSON命令 (V2.0协议格式)
  * @note   V2.0协议使用精简字段名: t=类型, p=载荷, k=控制项, s=状态
  *         控制命令格式: {"v":"1.0","id":"xxx","ts":123,"t":"ctl","d":"SFP_001","p":{"k":"light","s":1}}
+ *         字段按路径查找, 只匹配对应层级的键, 不会误匹配字符串内容或其他层级的同名键
  */
-static uint8_t parse_json_command(const char *json)
+static uint8_t parse_json_command(const char *json, const json_tok_t *tokens, int count)
 {
     char type_buf[16];
     char key_buf[16];
-    int state;
+    int32_t state;
+    int payload, key;
+    int32_t value;
+    hb_stats_t hb;
 
     /* 清空命令结构 */
     memset(&g_received_cmd, 0, sizeof(g_received_cmd));
 
     /* V2.0协议: 获取消息类型 "t" */
-    if (find_json_string(json, "t", type_buf, sizeof(type_buf)) == NULL)
+    if (json_get_string(json, tokens, count, "t", type_buf, sizeof(type_buf)) != 0)
     {
         /* 尝试旧协议格式 "type" (向后兼容) */
-        if (find_json_string(json, "type", type_buf, sizeof(type_buf)) == NULL)
+        if (json_get_string(json, tokens, count, "type", type_buf, sizeof(type_buf)) != 0)
         {
             return 1;
         }
@@ -425,7 +1489,7 @@ static uint8_t parse_json_command(const char *json)
 
     /* 获取消息ID "id" (用于ACK响应) - 保存完整的字符串ID */
     memset(s_cmd_id_str, 0, sizeof(s_cmd_id_str));
-    if (find_json_string(json, "id", s_cmd_id_str, sizeof(s_cmd_id_str)) != NULL)
+    if (json_get_string(json, tokens, count, "id", s_cmd_id_str, sizeof(s_cmd_id_str)) == 0)
     {
         g_received_cmd.cmd_id = (uint32_t)atoi(s_cmd_id_str);
     }
@@ -433,13 +1497,13 @@ static uint8_t parse_json_command(const char *json)
     /* 解析V2.0协议控制命令: t="ctl" */
     if (strcmp(type_buf, "ctl") == 0)
     {
-        /* 获取控制项 "k" 和状态 "s" - 这些字段在 payload "p" 内部 */
-        /* find_json_string 会在整个 JSON 中搜索，应该能找到嵌套的字段 */
-        if (find_json_string(json, "k", key_buf, sizeof(key_buf)) != NULL)
+        /* 控制项 "k" 和状态 "s" 在 payload "p" 内部 */
+        if (json_get_string(json, tokens, count, "p.k", key_buf, sizeof(key_buf)) == 0)
         {
-            state = find_json_int(json, "s");
-
-            printf("[MyServer] Parsed control: key=%s, state=%d\r\n", key_buf, state);
+            if (json_get_int(json, tokens, count, "p.s", &state) != 0)
+            {
+                state = -1;
+            }
 
             /* 根据控制项和状态设置命令类型 */
             if (strcmp(key_buf, "light") == 0)
@@ -472,12 +1536,18 @@ static uint8_t parse_json_command(const char *json)
     /* 解析V2.0协议功能操作: t="act" */
     else if (strcmp(type_buf, "act") == 0)
     {
-        if (find_json_string(json, "k", key_buf, sizeof(key_buf)) != NULL)
+        if (json_get_string(json, tokens, count, "p.k", key_buf, sizeof(key_buf)) == 0)
         {
             if (strcmp(key_buf, "get_status") == 0)
                 g_received_cmd.type = CMD_GET_STATUS;
             else if (strcmp(key_buf, "reboot") == 0)
                 g_received_cmd.type = CMD_REBOOT;
+            else if (strcmp(key_buf, "get_perf") == 0)
+                g_received_cmd.type = CMD_GET_PERF;
+            else if (strcmp(key_buf, "overlay_on") == 0)
+                g_received_cmd.type = CMD_OVERLAY_ON;
+            else if (strcmp(key_buf, "overlay_off") == 0)
+                g_received_cmd.type = CMD_OVERLAY_OFF;
             else
                 return 1;
         }
@@ -485,30 +1555,67 @@ static uint8_t parse_json_command(const char *json)
     /* 解析V2.0协议配置同步: t="cfg" */
     else if (strcmp(type_buf, "cfg") == 0)
     {
-        /* 阈值配置在payload中 */
+        /* 阈值配置在payload中, 未下发的字段保持当前值 */
         g_received_cmd.type = CMD_SET_THRESHOLD;
-        /* 尝试解析阈值数据 (简化处理，服务器会发送完整配置) */
-        g_received_cmd.threshold.temp_upper = find_json_int(json, "temp_upper");
-        g_received_cmd.threshold.temp_lower = find_json_int(json, "temp_lower");
-        g_received_cmd.threshold.humi_upper = find_json_int(json, "humi_upper");
-        g_received_cmd.threshold.humi_lower = find_json_int(json, "humi_lower");
-        g_received_cmd.threshold.soil_upper = find_json_int(json, "soil_upper");
-        g_received_cmd.threshold.soil_lower = find_json_int(json, "soil_lower");
-        g_received_cmd.threshold.light_upper = find_json_int(json, "light_upper");
-        g_received_cmd.threshold.light_lower = find_json_int(json, "light_lower");
+        g_received_cmd.threshold.temp_upper = lim_value.temp_upper;
+        g_received_cmd.threshold.temp_lower = lim_value.temp_lower;
+        g_received_cmd.threshold.humi_upper = lim_value.humi_upper;
+        g_received_cmd.threshold.humi_lower = lim_value.humi_lower;
+        g_received_cmd.threshold.soil_upper = lim_value.shumi_upper;
+        g_received_cmd.threshold.soil_lower = lim_value.shumi_lower;
+        g_received_cmd.threshold.light_upper = lim_value.light_upper;
+        g_received_cmd.threshold.light_lower = lim_value.light_lower;
+
+        /* 一次遍历payload的所有键 */
+        payload = json_find(json, tokens, count, "p");
+        for (key = json_obj_next(tokens, count, payload, -1); key >= 0;
+             key = json_obj_next(tokens, count, payload, key))
+        {
+            if (json_tok_int(json, &tokens[key + 1], &value) != 0) continue;
+
+            if (json_tok_equal(json, &tokens[key], "temp_upper"))       g_received_cmd.threshold.temp_upper = value;
+            else if (json_tok_equal(json, &tokens[key], "temp_lower"))  g_received_cmd.threshold.temp_lower = value;
+            else if (json_tok_equal(json, &tokens[key], "humi_upper"))  g_received_cmd.threshold.humi_upper = value;
+            else if (json_tok_equal(json, &tokens[key], "humi_lower"))  g_received_cmd.threshold.humi_lower = value;
+            else if (json_tok_equal(json, &tokens[key], "soil_upper"))  g_received_cmd.threshold.soil_upper = value;
+            else if (json_tok_equal(json, &tokens[key], "soil_lower"))  g_received_cmd.threshold.soil_lower = value;
+            else if (json_tok_equal(json, &tokens[key], "light_upper")) g_received_cmd.threshold.light_upper = value;
+            else if (json_tok_equal(json, &tokens[key], "light_lower")) g_received_cmd.threshold.light_lower = value;
+        }
     }
     /* 解析心跳响应: t="hb_ok" */
     else if (strcmp(type_buf, "hb_ok") == 0)
     {
-        /* 心跳响应，清除等待标志 */
-        s_heartbeat_pending = 0;
-        s_heartbeat_timeout = 0;
+        /* 心跳响应, 计算RTT, 并用服务器时间戳对时 */
+        if (hb_ack(millis()) == 0)
+        {
+            hb_get_stats(&hb);
+            clock_sync(json, tokens, count, hb.rtt_last);
+        }
         return 0;
     }
     /* 解析注册响应: t="reg_ok" */
     else if (strcmp(type_buf, "reg_ok") == 0)
     {
         printf("[MyServer] Registration confirmed by server\r\n");
+        clock_sync(json, tokens, count, millis() - s_reg_ms);
+        /* 首次注册确认即为上线: 首次的reg还没有该值, 由下一条sta上报, 之后的reg都携带 */
+        if (s_link.boot_online_ms == 0)
+        {
+            s_link.boot_online_ms = millis() ? millis() : 1;
+            s_bt_report = 1;
+            s_tlm_need_sta = 1;
+            printf("[MyServer] Boot to online: %lums\r\n", (unsigned long)s_link.boot_online_ms);
+        }
+#if MY_TLM_BIN_ENABLE
+        /* 编码协商: 服务器回复 "p":{"enc":"bin1"} 才启用二进制, 否则保持JSON */
+        if (json_get_string(json, tokens, count, "p.enc", type_buf, sizeof(type_buf)) == 0 &&
+            strcmp(type_buf, "bin1") == 0)
+        {
+            s_encoding = MY_ENC_BIN;
+            printf("[MyServer] Telemetry encoding: bin1\r\n");
+        }
+#endif
         return 0;
     }
     /* 解析错误响应: t="err" 或 t="reg_err" */
@@ -526,55 +1633,37 @@ static uint8_t parse_json_command(const char *json)
 }
 
 /**
- * @brief  从JSON中查找整数值 (简易解析)
+ * @brief  报文时间戳: 已对时为Unix毫秒, 尚未对时为0 (服务器以接收时间为准)
+ * @retval 十进制字符串 (静态缓冲, 下次调用前有效)
  */
-static int find_json_int(const char *json, const char *key)
+static const char *msg_ts(void)
 {
-    char search[32];
-    char *pos;
-
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    pos = strstr(json, search);
-    if (pos == NULL) return -1;
+    static char buf[21];
+    uint64_t ts = wallclock_now(millis());
+    char *p = &buf[sizeof(buf) - 1];
 
-    pos += strlen(search);
-    while (*pos == ' ') pos++;
+    *p = '\0';
+    do
+    {
+        *--p = (char)('0' + (uint8_t)(ts % 10));
+        ts /= 10;
+    } while (ts != 0);
 
-    return atoi(pos);
+    return p;
 }
 
 /**
- * @brief  从JSON中查找字符串值
+ * @brief  用服务器报文的ts字段对时
+ * @param  rtt_ms: 该报文对应请求的往返时间
  */
-static char* find_json_string(const char *json, const char *key, char *out, uint8_t max_len)
+static void clock_sync(const char *json, const json_tok_t *tokens, int count, uint32_t rtt_ms)
 {
-    char search[32];
-    char *pos, *end;
-    uint8_t len;
-
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    pos = strstr(json, search);
-    if (pos == NULL) return NULL;
-
-    pos += strlen(search);
-
-    /* 跳过冒号后的空格 */
-    while (*pos == ' ') pos++;
+    uint64_t ts;
 
-    /* 检查是否是字符串值（以引号开始） */
-    if (*pos != '"') return NULL;
-    pos++;  /* 跳过开始的引号 */
+    if (json_get_u64(json, tokens, count, "ts", &ts) != 0 || ts == 0) return;
+    if (ts < MY_TS_SEC_LIMIT) ts *= 1000;
 
-    end = strchr(pos, '"');
-    if (end == NULL) return NULL;
-
-    len = end - pos;
-    if (len >= max_len) len = max_len - 1;
-
-    strncpy(out, pos, len);
-    out[len] = '\0';
-
-    return out;
+    wallclock_sync(ts, rtt_ms, millis());
 }
 
 /**
@@ -616,20 +1705,44 @@ static uint8_t check_tcp_disconnected(void)
 /******************************************************************************************/
 /* 无线控制处理 */
 
+/**
+ * @brief  记录一条命令从帧到达到ack入队的延迟
+ */
+static void cmd_latency_record(void)
+{
+    uint32_t us = micros() - s_cmd_rx_us;
+
+    s_cmd_stats.count++;
+    s_cmd_stats.last_us = us;
+    s_cmd_total_us += us;
+    s_cmd_stats.avg_us = (uint32_t)(s_cmd_total_us / s_cmd_stats.count);
+    if (us > s_cmd_stats.max_us) s_cmd_stats.max_us = us;
+    if (us > MY_CMD_SLOW_US) s_cmd_stats.slow++;
+}
+
 /**
  * @brief  处理服务器下发的无线控制命令
+ * @note   继电器动作和ack在同一次调用中完成, 弹窗/界面刷新记录在s_ui中,
+ *         由界面任务调用myserver_ui_update()执行, 不占用命令路径的时间
  */
 void myserver_wireless_control(void)
 {
-    my_cmd_type_t cmd = myserver_receive_command();
+    my_cmd_type_t cmd;
+    uint8_t ok = 1;
+
+    if (s_lk.step != LK_IDLE) return;       /* 连接过程中接收帧是AT应答 */
+    cmd = myserver_receive_command();
+    if (cmd == CMD_NONE) return;
 
     /* 自动模式下，设备控制命令被忽略，只响应模式切换和状态查询 */
-    if (!mode && cmd != CMD_NONE) {
+    if (!mode) {
         /* 自动模式下允许的命令 */
         if (cmd != CMD_MODE_AUTO && cmd != CMD_MODE_MANUAL &&
-            cmd != CMD_GET_STATUS && cmd != CMD_SET_THRESHOLD && cmd != CMD_REBOOT) {
+            cmd != CMD_GET_STATUS && cmd != CMD_SET_THRESHOLD && cmd != CMD_REBOOT &&
+            cmd != CMD_GET_PERF && cmd != CMD_OVERLAY_ON && cmd != CMD_OVERLAY_OFF) {
             /* 其他控制命令在自动模式下忽略，但仍发送ACK */
             myserver_send_ack(g_received_cmd.cmd_id, 0);  /* 0表示未执行 */
+            cmd_latency_record();
             return;
         }
     }
@@ -638,91 +1751,55 @@ void myserver_wireless_control(void)
         case CMD_LIGHT_ON:
             light_status = 1;
             LED1 = 0;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Light ON", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Light ON";
             break;
 
         case CMD_LIGHT_OFF:
             light_status = 0;
             LED1 = 1;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Light OFF", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Light OFF";
             break;
 
         case CMD_WATER_ON:
             water_status = 1;
             BUMP_ON;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Water ON", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Water ON";
             break;
 
         case CMD_WATER_OFF:
             water_status = 0;
             BUMP_OFF;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Water OFF", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Water OFF";
             break;
 
         case CMD_FAN_ON:
             fun_status = 1;
             FUN_ON;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Fan ON", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Fan ON";
             break;
 
         case CMD_FAN_OFF:
             fun_status = 0;
             FUN_OFF;
-            if (get_current_screen() == SCREEN_MANUAL) {
-                update_manual_screen();
-            }
-            create_popup();
-            show_popup("Fan OFF", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MANUAL;
+            s_ui.popup = "Fan OFF";
             break;
 
         case CMD_MODE_AUTO:
             mode = 0;
-            if (get_current_screen() == SCREEN_MAIN) {
-                update_main_screen();
-            } else if (get_current_screen() == SCREEN_MENU) {
-                update_menu_screen();
-            }
-            create_popup();
-            show_popup("Auto Mode", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MODE;
+            s_ui.popup = "Auto Mode";
             break;
 
         case CMD_MODE_MANUAL:
             mode = 1;
-            if (get_current_screen() == SCREEN_MAIN) {
-                update_main_screen();
-            } else if (get_current_screen() == SCREEN_MENU) {
-                update_menu_screen();
-            }
-            create_popup();
-            show_popup("Manual Mode", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.flags |= UI_REFRESH_MODE;
+            s_ui.popup = "Manual Mode";
             break;
 
         case CMD_SET_THRESHOLD:
@@ -735,9 +1812,7 @@ void myserver_wireless_control(void)
             lim_value.shumi_lower = g_received_cmd.threshold.soil_lower;
             lim_value.light_upper = g_received_cmd.threshold.light_upper;
             lim_value.light_lower = g_received_cmd.threshold.light_lower;
-            create_popup();
-            show_popup("Threshold Updated", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            s_ui.popup = "Threshold Updated";
             break;
 
         case CMD_GET_STATUS:
@@ -750,21 +1825,73 @@ void myserver_wireless_control(void)
                 status.fan_status = fun_status;
                 myserver_send_device_status(&status);
             }
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            break;
+
+        case CMD_GET_PERF:
+            /* 发送队列放不下整张表时回复失败, 由服务器稍后重试 */
+            ok = (myserver_send_perf() == 0);
+            break;
+
+        case CMD_OVERLAY_ON:
+            s_ui.flags = (s_ui.flags & ~UI_OVERLAY_OFF) | UI_OVERLAY_ON;
+            break;
+
+        case CMD_OVERLAY_OFF:
+            s_ui.flags = (s_ui.flags & ~UI_OVERLAY_ON) | UI_OVERLAY_OFF;
             break;
 
         case CMD_REBOOT:
+            myserver_send_ack(g_received_cmd.cmd_id, 1);
+            cmd_latency_record();
             create_popup();
             show_popup("Rebooting...", 2000);
-            myserver_send_ack(g_received_cmd.cmd_id, 1);
             delay_ms(500);
             NVIC_SystemReset();
-            break;
+            return;
 
-        case CMD_NONE:
         default:
-            break;
+            return;
+    }
+
+    myserver_send_ack(g_received_cmd.cmd_id, ok);
+    cmd_latency_record();
+    printf("[MyServer] Command %s type=%d ok=%d, %luus\r\n",
+           s_cmd_id_str, cmd, ok, (unsigned long)s_cmd_stats.last_us);
+}
+
+/**
+ * @brief  是否有命令引起的界面更新等待执行
+ */
+uint8_t myserver_ui_pending(void)
+{
+    return s_ui.flags != 0 || s_ui.popup != NULL;
+}
+
+/**
+ * @brief  执行命令引起的界面更新
+ * @note   两次调用之间的多条命令合并: 界面各刷新一次, 弹窗只显示最后一条
+ */
+void myserver_ui_update(void)
+{
+    if ((s_ui.flags & UI_REFRESH_MANUAL) && get_current_screen() == SCREEN_MANUAL) {
+        update_manual_screen();
+    }
+    if (s_ui.flags & UI_REFRESH_MODE) {
+        if (get_current_screen() == SCREEN_MAIN) {
+            update_main_screen();
+        } else if (get_current_screen() == SCREEN_MENU) {
+            update_menu_screen();
+        }
+    }
+    if (s_ui.flags & (UI_OVERLAY_ON | UI_OVERLAY_OFF)) {
+        lv_port_disp_overlay((s_ui.flags & UI_OVERLAY_ON) != 0);
+    }
+    if (s_ui.popup != NULL) {
+        create_popup();
+        show_popup(s_ui.popup, 2000);
     }
+    s_ui.flags = 0;
+    s_ui.popup = NULL;
 }
 
 /******************************************************************************************/
@@ -845,8 +1972,8 @@ uint8_t myserver_send_sensor_data_dynamic(void)
 
     /* V2.0协议: {"v":"1.0","id":"xxx","ts":123,"t":"dat","d":"设备ID","p":{传感器数据}} */
     offset = snprintf(s_send_buf, sizeof(s_send_buf),
-        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%lu,\"t\":\"%s\",\"d\":\"%s\",\"p\":{",
-        (unsigned long)s_msg_seq++, (unsigned long)(s_msg_seq * 1000),
+        "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"%s\",\"d\":\"%s\",\"p\":{",
+        (unsigned long)s_msg_seq++, msg_ts(),
         MSG_TYPE_DAT, MY_DEVICE_ID);
 
     /* 动态构建传感器数据JSON */
@@ -24,6 +24,8 @@
 #define __MYSERVER_H
 
 #include "sys.h"
+#include "spool.h"
+#include "heartbeat.h"
 #include <stdint.h>
 
 /******************************************************************************************/
@@ -35,6 +37,33 @@
 #define MY_SERVER_PORT         "8003"              /* 服务器TCP端口 (设备连接) */
 #define MY_DEVICE_ID           "MyPot"             /* 设备ID (同一用户下唯一即可) */
 #define MY_USER_ID             "lockhart"          /* 绑定的用户ID (在"NK星云APP"注册的用户名) */
+#define MY_TLM_DB_TEMP         1                   /* 默认温度死区 (°C) */
+#define MY_TLM_DB_HUMI         2                   /* 默认空气湿度死区 (%) */
+#define MY_TLM_DB_SOIL         2                   /* 默认土壤湿度死区 (%) */
+#define MY_TLM_DB_LIGHT        3                   /* 默认光照强度死区 (%) */
+#define MY_TLM_KEYFRAME_MS     60000               /* 默认关键帧最大间隔 (ms) */
+#define MY_TLM_BATCH_MAX       8                   /* 批量上报最大样本数 (1表示不合并) */
+#define MY_TLM_BATCH_MS        10000               /* 批量上报最长攒批时间 (ms) */
+#define MY_TLM_REPLAY_MS       1000                /* 离线样本补发的最小间隔 (ms) */
+#define MY_TLM_REPLAY_MAX      8                   /* 每次补发的最大样本数 */
+#define MY_TLM_BIN_ENABLE      1                   /* 1: 注册时申请二进制上报 (bin1), 服务器在reg_ok中同意后启用 */
+#define MY_DEBUG_TX_ECHO       0                   /* 1: 发送的报文回显到调试串口 (USART1为轮询发送, 会阻塞主循环) */
+#define MY_WIFI_AUTOCONN_MS    6000                /* 等待模块自动连接已保存WiFi的最长时间 (ms) */
+#define MY_WIFI_POLL_MS        500                 /* 查询WiFi连接状态的间隔 (ms) */
+#define MY_WIFI_RESET_AFTER    3                   /* 连续失败该次数后才使用恢复出厂设置的完整连接流程 */
+#define MY_HB_IDLE_MS          15000               /* 上行无其他报文时的心跳间隔 (ms) */
+#define MY_HB_PROBE_MS         60000               /* 超过该时间未收到下行数据则必须发送心跳确认链路 (ms) */
+#define MY_HB_MIN_MS           5000                /* RTT变差时的心跳间隔 (ms) */
+#define MY_HB_RTT_BAD_MS       2000                /* 心跳RTT超过该值视为链路变差 (ms) */
+#define MY_HB_TIMEOUT_MIN_MS   10000               /* 心跳响应超时下限 (ms, 实际为平滑RTT的8倍) */
+#define MY_HB_TIMEOUT_MS       30000               /* 心跳响应超时上限 (ms, 尚无RTT样本时使用) */
+#define MY_CMD_SLOW_US         10000               /* 命令从帧到达到ack入队超过该时间计为慢命令 (us) */
+
+/******************************************************************************************/
+/* 上报编码定义 */
+
+#define MY_ENC_JSON             0   /* JSON文本 (默认, 服务器未同意二进制时回退) */
+#define MY_ENC_BIN              1   /* bin1紧凑二进制帧, 见 bin_codec.h */
 
 /******************************************************************************************/
 /* 连接状态定义 */
@@ -46,6 +75,12 @@
 #define MY_SERVER_DISCONNECTED  0   /* 服务器未连接 */
 #define MY_SERVER_CONNECTED     1   /* 服务器已连接 */
 
+/* WiFi连接方式 */
+#define MY_LINK_PATH_NONE       0   /* 尚未连接 */
+#define MY_LINK_PATH_FAST       1   /* 模块已自动连接保存的WiFi, 只确认状态 */
+#define MY_LINK_PATH_JOIN       2   /* 未自动连接, 发送AT+CWJAP加入 (不复位模块) */
+#define MY_LINK_PATH_FULL       3   /* 恢复出厂设置后重新配置并加入 */
+
 /******************************************************************************************/
 /* V2.0 消息类型定义 (精简字段名) */
 
@@ -55,6 +90,7 @@
 #define MSG_TYPE_DAT            "dat"           /* 传感器数据 */
 #define MSG_TYPE_STA            "sta"           /* 设备状态 */
 #define MSG_TYPE_ACK            "ack"           /* 命令确认 */
+#define MSG_TYPE_PERF           "perf"          /* 性能剖析表 */
 
 /* 下行消息类型 (服务器->设备) */
 #define MSG_TYPE_CTL            "ctl"           /* 开关控制 */
@@ -77,11 +113,16 @@ typedef enum {
     CMD_SET_THRESHOLD,      /* 设置阈值 */
     CMD_GET_STATUS,         /* 获取状态 */
     CMD_REBOOT,             /* 重启设备 */
+    CMD_GET_PERF,           /* 获取性能剖析表 */
+    CMD_OVERLAY_ON,         /* 显示性能浮层 */
+    CMD_OVERLAY_OFF,        /* 隐藏性能浮层 */
 } my_cmd_type_t;
 
 /******************************************************************************************/
 /* 数据结构定义 */
 
+#define MY_SENSOR_INVALID       0xFF    /* 传感器无效值 (失效或读数过期), JSON中为null, bin1中为127 */
+
 /* 传感器数据结构 */
 typedef struct {
     uint8_t temperature;        /* 温度 (°C) */
@@ -157,6 +198,58 @@ typedef struct {
     uint8_t config_loaded;                          /* 配置是否已加载 */
 } my_device_config_t;
 
+/* 上报策略 (变化驱动) */
+typedef struct {
+    uint8_t  db_temp;           /* 温度死区, 变化量达到该值才上报 */
+    uint8_t  db_humi;           /* 空气湿度死区 */
+    uint8_t  db_soil;           /* 土壤湿度死区 */
+    uint8_t  db_light;          /* 光照强度死区 */
+    uint32_t keyframe_ms;       /* 关键帧最大间隔 (ms), 到期时无论是否变化都发送完整数据 */
+    uint8_t  batch_max;         /* 批量上报样本数上限, 1表示每个样本单独发送 */
+    uint32_t batch_ms;          /* 最早样本等待超过该时间则立即发送 */
+    uint32_t replay_ms;         /* 离线样本补发的最小间隔 (ms) */
+    uint8_t  replay_max;        /* 每次补发的最大样本数 (不超过MY_TLM_REPLAY_MAX) */
+} my_telemetry_policy_t;
+
+/* 上报统计 */
+typedef struct {
+    uint32_t dat_sent;          /* 已发送的传感器数据消息 */
+    uint32_t dat_suppressed;    /* 因未超出死区而省略的传感器数据消息 */
+    uint32_t sta_sent;          /* 已发送的设备状态消息 */
+    uint32_t sta_suppressed;    /* 因状态未变化而省略的设备状态消息 */
+    uint32_t keyframes;         /* 关键帧次数 */
+    uint32_t send_failed;       /* 发送失败次数 (下个周期重试) */
+    uint32_t samples_sent;      /* 随dat消息发送的样本数 (单条或批量) */
+    uint32_t samples_dropped;   /* 离线缓存满时丢弃的样本数 */
+    uint8_t  batch_size;        /* 当前自适应批量大小 */
+    uint8_t  encoding;          /* 当前上报编码: MY_ENC_JSON/MY_ENC_BIN */
+    uint32_t bytes_sent;        /* dat/sta消息已发送的总字节数 */
+    uint32_t spooled;           /* 离线或发送失败时转入离线缓存的样本数 */
+    uint32_t replayed;          /* 重连后补发的样本数 */
+    uint32_t spool_pending;     /* 离线缓存中等待补发的样本数 */
+} my_telemetry_stats_t;
+
+/* 连接统计 */
+typedef struct {
+    uint32_t boot_online_ms;    /* 上电到首次上线 (收到reg_ok) 的时间, 0表示尚未上线 */
+    uint32_t wifi_ms;           /* 最近一次WiFi连接耗时 (ms) */
+    uint8_t  path;              /* 最近一次WiFi连接方式 MY_LINK_PATH_* */
+    uint8_t  fail_streak;       /* WiFi连续连接失败次数 */
+    uint32_t fast;              /* 快速连接成功次数 */
+    uint32_t joins;             /* 加入WiFi成功次数 */
+    uint32_t full_resets;       /* 完整连接流程次数 */
+    uint32_t failures;          /* WiFi连接失败次数 */
+} my_link_stats_t;
+
+/* 命令处理统计 (下行帧到达的空闲中断 -> ack入队) */
+typedef struct {
+    uint32_t count;             /* 已确认的命令数 */
+    uint32_t last_us;           /* 最近一次延迟 (us) */
+    uint32_t avg_us;            /* 平均延迟 (us) */
+    uint32_t max_us;            /* 最大延迟 (us) */
+    uint32_t slow;              /* 超过MY_CMD_SLOW_US的次数 */
+} my_cmd_stats_t;
+
 /******************************************************************************************/
 /* 全局变量声明 */
 
@@ -177,13 +270,34 @@ extern my_device_config_t g_device_config;  /* 设备动态配置 (V2.0新增) *
 uint8_t myserver_wifi_init(void);
 
 /**
- * @brief  连接WiFi路由器
+ * @brief  开始连接 (异步, 立即返回): 先连接WiFi (如未连接), want_server为1时再连接服务器并注册
+ * @note   先查询模块是否已自动连接保存的WiFi (AT+CWJAP?), 未连接则直接加入;
+ *         连续失败MY_WIFI_RESET_AFTER次后才恢复出厂设置并重新配置;
+ *         之前处于透传模式时先退出透传并关闭旧连接.
+ *         每一步是一条异步AT指令, 由myserver_link_poll()推进, 结果体现在连接状态中
+ * @retval 0:已开始或无需连接 1:连接正在进行
+ */
+uint8_t myserver_link_start(uint8_t want_server);
+
+/**
+ * @brief  推进连接过程 (与atk_mw8266d_at_poll()一起由调度器周期调用)
+ */
+void myserver_link_poll(void);
+
+/**
+ * @brief  连接是否正在进行
+ * @retval 0:空闲 1:进行中
+ */
+uint8_t myserver_link_busy(void);
+
+/**
+ * @brief  连接WiFi路由器 (同步, 阻塞到连接结束, 流程同myserver_link_start)
  * @retval 0:成功 其他:失败
  */
 uint8_t myserver_wifi_connect(void);
 
 /**
- * @brief  连接到自定义服务器
+ * @brief  连接到自定义服务器 (同步, 阻塞到连接结束)
  * @retval 0:成功 1:失败
  */
 uint8_t myserver_connect(void);
@@ -236,6 +350,85 @@ uint8_t myserver_send_device_status(my_device_status_t *status);
  */
 uint8_t myserver_send_ack(uint32_t cmd_id, uint8_t success);
 
+/**
+ * @brief  发送性能剖析表 (各剖析段的调用次数、最短/平均/最长耗时 (us) 和耗时直方图)
+ * @note   格式: {"v":"1.0","id":"xxx","ts":123,"t":"perf","d":"设备ID","p":{"hz":72000000,
+ *               "f":["n","min","avg","max","h"],"s":{"lvgl":[120,850,1900,9400,[0,0,0,0,31,89,0,0]],...},
+ *               "r":{"fr":812,"rnd":[6100,7400,21000],"fl":[9800,11200,30500],"px":3200,"ar":2,
+ *                    "mem":[21480,27672,24016,7]}}}
+ *         直方图第k格为 [4^k, 4^(k+1)) us, 段定义见 perf.h;
+ *         r为显示刷新统计: 帧数, 渲染/刷屏耗时[最近,平均,最大] (us), 最近一帧的像素数和无效区域数,
+ *         lv_mem[已用,空闲,峰值,碎片率%], 见 lv_port_disp_stats_t
+ * @retval 0:成功 1:未连接或发送队列空间不足
+ */
+uint8_t myserver_send_perf(void);
+
+/* ========== 变化驱动上报 ========== */
+
+/**
+ * @brief  按上报策略发送传感器数据和设备状态 (周期调用)
+ * @note   传感器数据任一字段变化量达到死区时记录一个dat样本, 设备状态任一字段变化时发送sta,
+ *         距上次关键帧超过keyframe_ms时两者都发送; 发送失败的消息在下次调用时重试。
+ *         dat样本攒满当前批量大小或最早样本超过batch_ms时合并为一帧发送,
+ *         批量大小随链路状况自适应: 发送队列拥塞或发送失败时加倍, 队列空闲时逐步减小。
+ *         服务器未连接时照常按死区/关键帧采样, 样本 (连同未发送的批量样本) 转入离线缓存;
+ *         连接后在本周期实时数据发送完之后补发离线样本, 每replay_ms最多一批且发送队列空闲时才补发,
+ *         补发消息带原始采集时间, 见 myserver_telemetry_set_spool
+ *         离线期间不发送sta, 重连后的关键帧会上报当前状态
+ * @param  data: 当前传感器数据
+ * @param  status: 当前设备状态
+ * @retval 本次发送的消息数
+ */
+uint8_t myserver_report(const my_sensor_data_t *data, const my_device_status_t *status);
+
+/**
+ * @brief  发送批量传感器数据 (共享消息头 + 紧凑样本数组)
+ * @note   格式: {"v":"1.0","id":"xxx","ts":123,"t":"dat","d":"设备ID",
+ *               "p":{"f":["temp","humi","soil","light"],"s":[[0,25,60,40,80],[1000,25,61,40,80]]}}
+ *         每个样本第一个元素为相对第一个样本的时间偏移 (ms)
+ * @param  samples: 样本数组
+ * @param  offsets_ms: 各样本时间偏移数组 (ms)
+ * @param  count: 样本数
+ * @retval 0:成功 1:失败
+ */
+uint8_t myserver_send_sensor_batch(const my_sensor_data_t *samples, const uint32_t *offsets_ms, uint8_t count);
+
+/**
+ * @brief  设置离线缓存的Flash溢出区 (未设置时只使用RAM队列, 最多缓存 SPOOL_RAM_SIZE 个样本)
+ * @note   补发格式 (总是JSON): {"v":"1.0","id":"xxx","ts":123,"t":"dat","d":"设备ID",
+ *               "p":{"bf":1,"q":17,"age":3600000,"f":["temp","humi","soil","light"],"s":[[0,25,60,40,80],...]}}
+ *         bf: 补发标记; q: 第一个样本的离线序号 (连续递增, 跳变表示有样本被丢弃);
+ *         age: 第一个样本采集距发送的时间 (ms), 各样本采集时间 = 收到时间 - age + 偏移
+ * @param  flash: Flash接口, NULL表示只使用RAM
+ * @param  sectors: 溢出区扇区数
+ */
+void myserver_telemetry_set_spool(const tslog_flash_t *flash, uint8_t sectors);
+
+/**
+ * @brief  获取当前上报编码
+ * @note   每次连接先使用JSON, 注册报文携带 "enc":["json","bin1"],
+ *         服务器在reg_ok中回复 "p":{"enc":"bin1"} 后dat/sta改用二进制帧, 其余消息仍为JSON
+ * @retval MY_ENC_JSON/MY_ENC_BIN
+ */
+uint8_t myserver_get_encoding(void);
+
+/**
+ * @brief  设置上报策略
+ * @param  policy: 上报策略
+ */
+void myserver_telemetry_set_policy(const my_telemetry_policy_t *policy);
+
+/**
+ * @brief  强制下一次上报为关键帧 (连接建立后自动调用)
+ */
+void myserver_telemetry_force_keyframe(void);
+
+/**
+ * @brief  获取上报统计
+ * @param  stats: 统计信息输出
+ */
+void myserver_telemetry_get_stats(my_telemetry_stats_t *stats);
+
 /* ========== 数据接收 ========== */
 
 /**
@@ -244,6 +437,23 @@ uint8_t myserver_send_ack(uint32_t cmd_id, uint8_t success);
  */
 my_cmd_type_t myserver_receive_command(void);
 
+/**
+ * @brief  下行帧到达事件 (在UART空闲中断的帧回调中调用)
+ * @note   记录命令延迟的起点, 只在已连接服务器时记录
+ */
+void myserver_rx_event(void);
+
+/**
+ * @brief  是否还有待处理的下行数据 (接收缓冲中剩余的报文或UART队列中的帧)
+ * @retval 0:没有 1:有, 应再调用一次myserver_wireless_control()
+ */
+uint8_t myserver_rx_pending(void);
+
+/**
+ * @brief  获取命令处理统计
+ */
+void myserver_cmd_get_stats(my_cmd_stats_t *stats);
+
 /**
  * @brief  获取接收到的阈值设置
  * @param  threshold: 阈值数据指针
@@ -265,6 +475,16 @@ uint8_t myserver_check_wifi(void);
  */
 uint8_t myserver_check_server(void);
 
+/**
+ * @brief  获取连接统计 (含上电到上线的时间)
+ */
+void myserver_link_get_stats(my_link_stats_t *stats);
+
+/**
+ * @brief  获取心跳统计 (含RTT最小/平均/最大值)
+ */
+void myserver_heartbeat_get_stats(hb_stats_t *stats);
+
 /* ========== 主处理函数 ========== */
 
 /**
@@ -275,10 +495,22 @@ void myserver_process(void);
 
 /**
  * @brief  处理服务器下发的无线控制命令
- * @note   在主循环中周期调用，接收并执行控制命令
+ * @note   由下行帧事件和周期调用驱动, 每次处理一条报文; 先执行继电器动作并将ack入队,
+ *         弹窗和界面刷新留给 myserver_ui_update()
  */
 void myserver_wireless_control(void);
 
+/**
+ * @brief  是否有命令引起的界面更新等待执行
+ * @retval 0:没有 1:有
+ */
+uint8_t myserver_ui_pending(void);
+
+/**
+ * @brief  执行命令引起的界面更新 (弹窗/状态标签/性能浮层), 在界面任务中调用
+ */
+void myserver_ui_update(void);
+
 /* ========== 动态配置相关函数 (V2.0新增) ========== */
 
 /**
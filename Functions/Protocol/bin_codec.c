@@ -0,0 +1,215 @@
+/**
+ ****************************************************************************************************
+ * @file        bin_codec.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       紧凑二进制遥测帧编解码 (bin1) 实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "bin_codec.h"
+#include "dataPointTools.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 位打包布局 (位偏移, 位长度) */
+
+#define BIN_DAT_BITS            7           /* 传感器字段位宽 */
+#define BIN_DAT_MAX             0x7F        /* 传感器字段最大值 */
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  写帧头, 返回负载起始位置
+ */
+static uint8_t *put_head(uint8_t *out, uint8_t type, uint16_t seq, uint8_t payload_len)
+{
+    out[0] = BIN_MAGIC;
+    out[1] = 3 + payload_len;
+    out[2] = type;
+    out[3] = (uint8_t)(seq >> 8);
+    out[4] = (uint8_t)seq;
+    return out + BIN_HEAD_SIZE;
+}
+
+/**
+ * @brief  计算校验并写入帧尾, 返回帧长度
+ */
+static uint16_t put_sum(uint8_t *out)
+{
+    uint8_t sum = 0;
+    uint16_t i, end = 2 + out[1];
+
+    for (i = 1; i < end; i++)
+    {
+        sum += out[i];
+    }
+    out[end] = sum;
+    return end + 1;
+}
+
+/**
+ * @brief  打包一个传感器样本 (4字节)
+ */
+static void pack_dat(uint8_t *buf, const bin_dat_t *dat)
+{
+    uint8_t v[4];
+    uint8_t i;
+
+    v[0] = dat->temp;
+    v[1] = dat->humi;
+    v[2] = dat->soil;
+    v[3] = dat->light;
+
+    memset(buf, 0, BIN_DAT_SIZE);
+    for (i = 0; i < 4; i++)
+    {
+        gizVarlenCompressValue(i * BIN_DAT_BITS, BIN_DAT_BITS, buf,
+                               v[i] > BIN_DAT_MAX ? BIN_DAT_MAX : v[i]);
+    }
+    gizByteOrderExchange(buf, BIN_DAT_SIZE);
+}
+
+/**
+ * @brief  解包一个传感器样本
+ */
+static void unpack_dat(const uint8_t *buf, bin_dat_t *dat)
+{
+    uint8_t tmp[BIN_DAT_SIZE];
+
+    memcpy(tmp, buf, BIN_DAT_SIZE);
+    dat->temp  = (uint8_t)gizVarlenDecompressionValue(0 * BIN_DAT_BITS, BIN_DAT_BITS, tmp, BIN_DAT_SIZE);
+    dat->humi  = (uint8_t)gizVarlenDecompressionValue(1 * BIN_DAT_BITS, BIN_DAT_BITS, tmp, BIN_DAT_SIZE);
+    dat->soil  = (uint8_t)gizVarlenDecompressionValue(2 * BIN_DAT_BITS, BIN_DAT_BITS, tmp, BIN_DAT_SIZE);
+    dat->light = (uint8_t)gizVarlenDecompressionValue(3 * BIN_DAT_BITS, BIN_DAT_BITS, tmp, BIN_DAT_SIZE);
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  编码传感器数据帧
+ */
+uint16_t bin_encode_dat(uint8_t *out, uint16_t size, uint16_t seq, const bin_dat_t *dat)
+{
+    if (size < BIN_FRAME_OVERHEAD + BIN_DAT_SIZE) return 0;
+
+    pack_dat(put_head(out, BIN_TYPE_DAT, seq, BIN_DAT_SIZE), dat);
+    return put_sum(out);
+}
+
+/**
+ * @brief  编码设备状态帧
+ */
+uint16_t bin_encode_sta(uint8_t *out, uint16_t size, uint16_t seq, const bin_sta_t *sta)
+{
+    uint8_t *p;
+
+    if (size < BIN_FRAME_OVERHEAD + BIN_STA_SIZE) return 0;
+
+    p = put_head(out, BIN_TYPE_STA, seq, BIN_STA_SIZE);
+    p[0] = 0;
+    gizVarlenCompressValue(0, 1, p, sta->mode ? 1 : 0);
+    gizVarlenCompressValue(1, 1, p, sta->light ? 1 : 0);
+    gizVarlenCompressValue(2, 1, p, sta->water ? 1 : 0);
+    gizVarlenCompressValue(3, 1, p, sta->fan ? 1 : 0);
+    return put_sum(out);
+}
+
+/**
+ * @brief  编码批量传感器数据帧
+ */
+uint16_t bin_encode_dat_batch(uint8_t *out, uint16_t size, uint16_t seq,
+                              const bin_dat_t *dat, const uint16_t *offset_10ms, uint8_t count)
+{
+    uint8_t *p;
+    uint8_t i, payload_len;
+
+    if (count == 0 || count > BIN_MAX_SAMPLES) return 0;
+
+    payload_len = 1 + count * (2 + BIN_DAT_SIZE);
+    if (size < BIN_FRAME_OVERHEAD + payload_len) return 0;
+
+    p = put_head(out, BIN_TYPE_DAT_BATCH, seq, payload_len);
+    *p++ = count;
+    for (i = 0; i < count; i++)
+    {
+        *p++ = (uint8_t)(offset_10ms[i] >> 8);
+        *p++ = (uint8_t)offset_10ms[i];
+        pack_dat(p, &dat[i]);
+        p += BIN_DAT_SIZE;
+    }
+    return put_sum(out);
+}
+
+/**
+ * @brief  解码一帧
+ */
+int bin_decode(const uint8_t *in, uint16_t len, bin_frame_t *frame)
+{
+    const uint8_t *p;
+    uint16_t frame_len, i;
+    uint8_t sum = 0, payload_len;
+
+    if (len < 2) return 0;
+    if (in[0] != BIN_MAGIC || in[1] < 3) return -1;
+
+    frame_len = in[1] + 3;
+    if (len < frame_len) return 0;
+
+    for (i = 1; i < frame_len - 1; i++)
+    {
+        sum += in[i];
+    }
+    if (sum != in[frame_len - 1]) return -1;
+
+    memset(frame, 0, sizeof(bin_frame_t));
+    frame->type = in[2];
+    frame->seq = ((uint16_t)in[3] << 8) | in[4];
+    payload_len = in[1] - 3;
+    p = in + BIN_HEAD_SIZE;
+
+    switch (frame->type)
+    {
+    case BIN_TYPE_DAT:
+        if (payload_len != BIN_DAT_SIZE) return -1;
+        unpack_dat(p, &frame->dat[0]);
+        frame->count = 1;
+        break;
+
+    case BIN_TYPE_STA:
+        if (payload_len != BIN_STA_SIZE) return -1;
+        frame->sta.mode  = (p[0] >> 0) & 1;
+        frame->sta.light = (p[0] >> 1) & 1;
+        frame->sta.water = (p[0] >> 2) & 1;
+        frame->sta.fan   = (p[0] >> 3) & 1;
+        break;
+
+    case BIN_TYPE_DAT_BATCH:
+        if (payload_len < 1 || p[0] == 0 || p[0] > BIN_MAX_SAMPLES ||
+            payload_len != 1 + p[0] * (2 + BIN_DAT_SIZE))
+        {
+            return -1;
+        }
+        frame->count = *p++;
+        for (i = 0; i < frame->count; i++)
+        {
+            frame->offset_10ms[i] = ((uint16_t)p[0] << 8) | p[1];
+            unpack_dat(p + 2, &frame->dat[i]);
+            p += 2 + BIN_DAT_SIZE;
+        }
+        break;
+
+    default:
+        return -1;
+    }
+
+    return frame_len;
+}
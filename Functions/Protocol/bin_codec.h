@@ -0,0 +1,120 @@
+/**
+ ****************************************************************************************************
+ * @file        bin_codec.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       紧凑二进制遥测帧编解码 (bin1)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 帧格式 (与JSON文本共用透传链路, 首字节0xA5不会出现在JSON报文开头):
+ *
+ *   | 0xA5 | len | type | seq_h | seq_l | payload ... | sum |
+ *
+ *   len : type + seq + payload 的字节数
+ *   sum : len 到 payload 最后一个字节的累加和 (低8位)
+ *
+ * 负载 (位打包, 使用 Utils/dataPointTools 的 gizVarlenCompressValue, 与机智云相同的字节序):
+ *   BIN_TYPE_DAT       4字节: temp/humi/soil/light 各7位 (0~127, 超出截断为127), 剩余4位保留
+ *   BIN_TYPE_STA       1字节: mode/light/water/fan 各1位, 剩余4位保留
+ *   BIN_TYPE_DAT_BATCH 1字节样本数n + n * (2字节时间偏移(10ms单位, 大端) + 4字节DAT)
+ *
+ * 二进制帧不带时间戳, 服务器以接收时间为准; 批量帧内的偏移相对第一个样本。
+ * 本模块不依赖任何硬件, 可在主机下编译验证。
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __BIN_CODEC_H
+#define __BIN_CODEC_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 帧定义 */
+
+#define BIN_MAGIC               0xA5        /* 帧头 */
+#define BIN_HEAD_SIZE           5           /* 帧头+长度+类型+序号 */
+#define BIN_FRAME_OVERHEAD      6           /* 帧头/长度/类型/序号/校验 */
+
+#define BIN_TYPE_DAT            0x01        /* 传感器数据 */
+#define BIN_TYPE_STA            0x02        /* 设备状态 */
+#define BIN_TYPE_DAT_BATCH      0x03        /* 批量传感器数据 */
+
+#define BIN_DAT_SIZE            4           /* 单个传感器样本负载字节数 */
+#define BIN_STA_SIZE            1           /* 设备状态负载字节数 */
+#define BIN_MAX_SAMPLES         16          /* 批量帧最大样本数 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 传感器样本 */
+typedef struct {
+    uint8_t temp;               /* 温度 (°C) */
+    uint8_t humi;               /* 空气湿度 (%) */
+    uint8_t soil;               /* 土壤湿度 (%) */
+    uint8_t light;              /* 光照强度 (%) */
+} bin_dat_t;
+
+/* 设备状态 */
+typedef struct {
+    uint8_t mode;               /* 模式: 0-自动, 1-手动 */
+    uint8_t light;              /* 灯 */
+    uint8_t water;              /* 水泵 */
+    uint8_t fan;                /* 风扇 */
+} bin_sta_t;
+
+/* 解码结果 */
+typedef struct {
+    uint8_t  type;                          /* 帧类型 */
+    uint16_t seq;                           /* 序号 */
+    uint8_t  count;                         /* 样本数 (DAT为1, STA为0) */
+    bin_dat_t dat[BIN_MAX_SAMPLES];         /* 传感器样本 */
+    uint16_t offset_10ms[BIN_MAX_SAMPLES];  /* 样本时间偏移 (10ms) */
+    bin_sta_t sta;                          /* 设备状态 */
+} bin_frame_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  编码传感器数据帧
+ * @param  out: 输出缓冲区
+ * @param  size: 输出缓冲区大小
+ * @param  seq: 序号
+ * @param  dat: 传感器样本
+ * @retval 帧长度, 0:缓冲区不足
+ */
+uint16_t bin_encode_dat(uint8_t *out, uint16_t size, uint16_t seq, const bin_dat_t *dat);
+
+/**
+ * @brief  编码设备状态帧
+ * @retval 帧长度, 0:缓冲区不足
+ */
+uint16_t bin_encode_sta(uint8_t *out, uint16_t size, uint16_t seq, const bin_sta_t *sta);
+
+/**
+ * @brief  编码批量传感器数据帧
+ * @param  dat: 样本数组
+ * @param  offset_10ms: 各样本相对第一个样本的时间偏移 (10ms单位)
+ * @param  count: 样本数 (1~BIN_MAX_SAMPLES)
+ * @retval 帧长度, 0:缓冲区不足或参数错误
+ */
+uint16_t bin_encode_dat_batch(uint8_t *out, uint16_t size, uint16_t seq,
+                              const bin_dat_t *dat, const uint16_t *offset_10ms, uint8_t count);
+
+/**
+ * @brief  解码一帧
+ * @param  in: 输入数据, 需以BIN_MAGIC开始
+ * @param  len: 输入数据长度
+ * @param  frame: 解码结果
+ * @retval >0: 消耗的字节数
+ *         0 : 数据不完整
+ *         -1: 帧头/长度/校验/负载错误
+ */
+int bin_decode(const uint8_t *in, uint16_t len, bin_frame_t *frame);
+
+#endif /* __BIN_CODEC_H */
@@ -0,0 +1,435 @@
+/**
+ ****************************************************************************************************
+ * @file        json_parser.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       单遍流式JSON分词器 (jsmn风格) 及路径查询实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 续传约定: 字符串/原始值没有结束时, pos 回退到该值的起始位置再返回 JSON_ERROR_PART,
+ * 下次调用重新扫描这个值; 已闭合的token和父子关系保存在 tokens 和 parser 中不再重复处理。
+ *
+ ****************************************************************************************************
+ */
+
+#include "json_parser.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  分配一个token
+ */
+static json_tok_t *alloc_token(json_parser_t *parser, json_tok_t *tokens, uint16_t num_tokens)
+{
+    json_tok_t *tok;
+
+    if (parser->toknext >= num_tokens) return NULL;
+
+    tok = &tokens[parser->toknext++];
+    tok->type = JSON_UNDEFINED;
+    tok->size = 0;
+    tok->start = -1;
+    tok->end = -1;
+    return tok;
+}
+
+/**
+ * @brief  查找最近的未闭合对象/数组 (键token的end在赋值时即确定, 因此不会被选中)
+ */
+static int16_t find_open_parent(const json_parser_t *parser, const json_tok_t *tokens)
+{
+    int16_t i;
+
+    for (i = (int16_t)parser->toknext - 1; i >= 0; i--)
+    {
+        if (tokens[i].start != -1 && tokens[i].end == -1) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief  解析原始值 (数字/true/false/null)
+ */
+static int parse_primitive(json_parser_t *parser, const char *js, uint16_t len,
+                           json_tok_t *tokens, uint16_t num_tokens)
+{
+    json_tok_t *tok;
+    uint16_t start = parser->pos;
+    char c;
+
+    for (; parser->pos < len; parser->pos++)
+    {
+        c = js[parser->pos];
+        if (c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ':')
+        {
+            break;
+        }
+        if (c < 32 || c >= 127)
+        {
+            parser->pos = start;
+            return JSON_ERROR_INVAL;
+        }
+    }
+
+    /* 原始值不能作为根元素, 未遇到结束符说明数据不完整 */
+    if (parser->pos >= len)
+    {
+        parser->pos = start;
+        return JSON_ERROR_PART;
+    }
+
+    tok = alloc_token(parser, tokens, num_tokens);
+    if (tok == NULL)
+    {
+        parser->pos = start;
+        return JSON_ERROR_NOMEM;
+    }
+    tok->type = JSON_PRIMITIVE;
+    tok->start = start;
+    tok->end = parser->pos;
+    parser->pos--;
+    return 0;
+}
+
+/**
+ * @brief  解析字符串 (只校验转义格式, 不做转换)
+ */
+static int parse_string(json_parser_t *parser, const char *js, uint16_t len,
+                        json_tok_t *tokens, uint16_t num_tokens)
+{
+    json_tok_t *tok;
+    uint16_t start = parser->pos;
+    char c;
+
+    parser->pos++;  /* 跳过开始的引号 */
+
+    for (; parser->pos < len; parser->pos++)
+    {
+        c = js[parser->pos];
+
+        if (c == '"')
+        {
+            tok = alloc_token(parser, tokens, num_tokens);
+            if (tok == NULL)
+            {
+                parser->pos = start;
+                return JSON_ERROR_NOMEM;
+            }
+            tok->type = JSON_STRING;
+            tok->start = start + 1;
+            tok->end = parser->pos;
+            return 0;
+        }
+
+        if (c == '\\')
+        {
+            if (parser->pos + 1 >= len) break;
+            parser->pos++;
+            c = js[parser->pos];
+            if (c == 'u')
+            {
+                if (parser->pos + 4 >= len) break;
+                parser->pos += 4;
+            }
+            else if (strchr("\"/\\bfnrt", c) == NULL)
+            {
+                parser->pos = start;
+                return JSON_ERROR_INVAL;
+            }
+        }
+    }
+
+    parser->pos = start;
+    return JSON_ERROR_PART;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化解析器
+ */
+void json_init(json_parser_t *parser)
+{
+    parser->pos = 0;
+    parser->toknext = 0;
+    parser->toksuper = -1;
+}
+
+/**
+ * @brief  分词 (可续传)
+ */
+int json_parse(json_parser_t *parser, const char *js, uint16_t len,
+               json_tok_t *tokens, uint16_t num_tokens)
+{
+    int ret;
+    int16_t i;
+    json_tok_t *tok;
+    char c;
+
+    for (; parser->pos < len; parser->pos++)
+    {
+        c = js[parser->pos];
+
+        switch (c)
+        {
+        case '{':
+        case '[':
+            tok = alloc_token(parser, tokens, num_tokens);
+            if (tok == NULL) return JSON_ERROR_NOMEM;
+            if (parser->toksuper != -1)
+            {
+                if (tokens[parser->toksuper].type == JSON_OBJECT) return JSON_ERROR_INVAL;
+                tokens[parser->toksuper].size++;
+            }
+            tok->type = (c == '{') ? JSON_OBJECT : JSON_ARRAY;
+            tok->start = parser->pos;
+            parser->toksuper = parser->toknext - 1;
+            break;
+
+        case '}':
+        case ']':
+            /* 向上找到对应的未闭合容器 */
+            for (i = (int16_t)parser->toknext - 1; i >= 0; i--)
+            {
+                if (tokens[i].start != -1 && tokens[i].end == -1) break;
+            }
+            if (i < 0) return JSON_ERROR_INVAL;
+            if (tokens[i].type != ((c == '}') ? JSON_OBJECT : JSON_ARRAY)) return JSON_ERROR_INVAL;
+            tokens[i].end = parser->pos + 1;
+            parser->toksuper = find_open_parent(parser, tokens);
+
+            if (parser->toksuper == -1)
+            {
+                parser->pos++;
+                return parser->toknext;
+            }
+            break;
+
+        case '"':
+            if (parser->toksuper == -1) return JSON_ERROR_INVAL;
+            ret = parse_string(parser, js, len, tokens, num_tokens);
+            if (ret < 0) return ret;
+            tokens[parser->toksuper].size++;
+            break;
+
+        case ':':
+            /* 刚才的字符串是键, 值挂在键下面 */
+            parser->toksuper = parser->toknext - 1;
+            break;
+
+        case ',':
+            if (parser->toksuper != -1 &&
+                tokens[parser->toksuper].type != JSON_ARRAY &&
+                tokens[parser->toksuper].type != JSON_OBJECT)
+            {
+                parser->toksuper = find_open_parent(parser, tokens);
+            }
+            break;
+
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            break;
+
+        default:
+            /* 原始值不能作为键, 也不能作为根元素 */
+            if (parser->toksuper == -1 || tokens[parser->toksuper].type == JSON_OBJECT)
+            {
+                return JSON_ERROR_INVAL;
+            }
+            ret = parse_primitive(parser, js, len, tokens, num_tokens);
+            if (ret < 0) return ret;
+            tokens[parser->toksuper].size++;
+            break;
+        }
+    }
+
+    return JSON_ERROR_PART;
+}
+
+/**
+ * @brief  判断token是否等于指定字符串
+ */
+uint8_t json_tok_equal(const char *js, const json_tok_t *tok, const char *s)
+{
+    uint16_t n = (uint16_t)(tok->end - tok->start);
+
+    return (strlen(s) == n && strncmp(js + tok->start, s, n) == 0) ? 1 : 0;
+}
+
+/**
+ * @brief  遍历对象的键
+ * @note   对象的子token依次为 键,值,键,值...; 跳过一个值的整个子树只需
+ *         向后找到第一个起始位置不在该值范围内的token
+ */
+int json_obj_next(const json_tok_t *tokens, int count, int obj, int key)
+{
+    int j;
+    int16_t val_end;
+
+    if (obj < 0 || obj >= count || tokens[obj].type != JSON_OBJECT) return -1;
+
+    if (key < 0)
+    {
+        j = obj + 1;
+    }
+    else
+    {
+        /* 跳过当前键的值及其子树 */
+        if (key + 1 >= count) return -1;
+        val_end = tokens[key + 1].end;
+        for (j = key + 2; j < count && tokens[j].start < val_end; j++);
+    }
+
+    if (j + 1 >= count || tokens[j].start >= tokens[obj].end) return -1;
+    return j;
+}
+
+/**
+ * @brief  按路径查找token
+ */
+int json_find(const char *js, const json_tok_t *tokens, int count, const char *path)
+{
+    int obj = 0, key;
+    const char *seg = path;
+    const char *dot;
+    uint16_t seg_len;
+
+    if (count <= 0) return -1;
+
+    while (1)
+    {
+        dot = strchr(seg, '.');
+        seg_len = dot ? (uint16_t)(dot - seg) : (uint16_t)strlen(seg);
+
+        for (key = json_obj_next(tokens, count, obj, -1); key >= 0; key = json_obj_next(tokens, count, obj, key))
+        {
+            if (tokens[key].end - tokens[key].start == seg_len &&
+                strncmp(js + tokens[key].start, seg, seg_len) == 0)
+            {
+                break;
+            }
+        }
+
+        if (key < 0) return -1;
+        if (dot == NULL) return key + 1;
+
+        obj = key + 1;
+        seg = dot + 1;
+    }
+}
+
+/**
+ * @brief  读取字符串token
+ */
+uint8_t json_tok_string(const char *js, const json_tok_t *tok, char *out, uint16_t max_len)
+{
+    uint16_t n;
+
+    if (tok->type != JSON_STRING || max_len == 0) return 1;
+
+    n = (uint16_t)(tok->end - tok->start);
+    if (n >= max_len) n = max_len - 1;
+    memcpy(out, js + tok->start, n);
+    out[n] = '\0';
+
+    return 0;
+}
+
+/**
+ * @brief  读取整数token
+ */
+uint8_t json_tok_int(const char *js, const json_tok_t *tok, int32_t *out)
+{
+    const char *p, *end;
+    int32_t val = 0;
+    uint8_t neg = 0;
+
+    if (tok->type != JSON_PRIMITIVE) return 1;
+
+    p = js + tok->start;
+    end = js + tok->end;
+
+    if (*p == 't') { *out = 1; return 0; }
+    if (*p == 'f') { *out = 0; return 0; }
+
+    if (*p == '-') { neg = 1; p++; }
+    if (p >= end || *p < '0' || *p > '9') return 1;
+
+    /* 小数部分直接截断 */
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        val = val * 10 + (*p - '0');
+    }
+
+    *out = neg ? -val : val;
+    return 0;
+}
+
+/**
+ * @brief  读取无符号64位整数token
+ */
+uint8_t json_tok_u64(const char *js, const json_tok_t *tok, uint64_t *out)
+{
+    const char *p, *end;
+    uint64_t val = 0;
+
+    if (tok->type != JSON_PRIMITIVE) return 1;
+
+    p = js + tok->start;
+    end = js + tok->end;
+
+    if (p >= end || *p < '0' || *p > '9') return 1;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        val = val * 10 + (uint64_t)(*p - '0');
+    }
+
+    *out = val;
+    return 0;
+}
+
+/**
+ * @brief  按路径读取字符串值
+ */
+uint8_t json_get_string(const char *js, const json_tok_t *tokens, int count,
+                        const char *path, char *out, uint16_t max_len)
+{
+    int i = json_find(js, tokens, count, path);
+
+    if (i < 0) return 1;
+    return json_tok_string(js, &tokens[i], out, max_len);
+}
+
+/**
+ * @brief  按路径读取整数值
+ */
+uint8_t json_get_int(const char *js, const json_tok_t *tokens, int count,
+                     const char *path, int32_t *out)
+{
+    int i = json_find(js, tokens, count, path);
+
+    if (i < 0) return 1;
+    return json_tok_int(js, &tokens[i], out);
+}
+
+/**
+ * @brief  按路径读取无符号64位整数
+ */
+uint8_t json_get_u64(const char *js, const json_tok_t *tokens, int count,
+                     const char *path, uint64_t *out)
+{
+    int i = json_find(js, tokens, count, path);
+
+    if (i < 0) return 1;
+    return json_tok_u64(js, &tokens[i], out);
+}
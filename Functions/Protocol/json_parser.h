@@ -0,0 +1,151 @@
+/**
+ ****************************************************************************************************
+ * @file        json_parser.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       单遍流式JSON分词器 (jsmn风格) 及路径查询
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 只扫描一遍报文, 生成 对象/数组/字符串/原始值 的token索引, 不分配内存, 不修改原文
+ * - token记录在原文中的起止位置和直接子元素个数, 查询时按路径逐层跳过子树
+ * - 路径用'.'分隔, 例如 "t"、"p.k"、"p.temp_upper"
+ * - 解析在根对象闭合后停止, parser.pos 即为已消耗的字节数, 便于处理粘包
+ * - 数据不完整时返回 JSON_ERROR_PART, 追加数据后用同一个parser再次调用即可从断点继续
+ * - 本模块不依赖任何硬件, 可在主机下编译验证
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __JSON_PARSER_H
+#define __JSON_PARSER_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 返回值定义 */
+
+#define JSON_ERROR_NOMEM        -1      /* token数组不够 */
+#define JSON_ERROR_INVAL        -2      /* 非法字符或结构错误 */
+#define JSON_ERROR_PART         -3      /* 数据不完整, 需要更多数据 */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* token类型 */
+typedef enum {
+    JSON_UNDEFINED = 0,
+    JSON_OBJECT,                /* {...} */
+    JSON_ARRAY,                 /* [...] */
+    JSON_STRING,                /* "..." (start/end不含引号) */
+    JSON_PRIMITIVE              /* 数字/true/false/null */
+} json_type_t;
+
+/* token */
+typedef struct {
+    uint8_t  type;              /* json_type_t */
+    uint8_t  size;              /* 直接子元素个数 (对象为键数, 键为1) */
+    int16_t  start;             /* 在原文中的起始位置, -1表示未确定 */
+    int16_t  end;               /* 在原文中的结束位置 (不含), -1表示未闭合 */
+} json_tok_t;
+
+/* 解析器状态 */
+typedef struct {
+    uint16_t pos;               /* 当前扫描位置 */
+    uint16_t toknext;           /* 下一个可用token */
+    int16_t  toksuper;          /* 当前父token, -1表示顶层 */
+} json_parser_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化解析器
+ * @param  parser: 解析器
+ */
+void json_init(json_parser_t *parser);
+
+/**
+ * @brief  分词 (可续传)
+ * @param  parser: 解析器, 续传时保持上次的状态
+ * @param  js: 报文
+ * @param  len: 报文当前长度, 续传时为追加后的总长度
+ * @param  tokens: token数组
+ * @param  num_tokens: token数组大小
+ * @retval >0: token数量 (根元素已完整)
+ *         JSON_ERROR_NOMEM/JSON_ERROR_INVAL/JSON_ERROR_PART
+ */
+int json_parse(json_parser_t *parser, const char *js, uint16_t len,
+               json_tok_t *tokens, uint16_t num_tokens);
+
+/**
+ * @brief  按路径查找token
+ * @param  js: 报文
+ * @param  tokens: json_parse生成的token数组
+ * @param  count: token数量
+ * @param  path: 以'.'分隔的键路径, 从根对象开始
+ * @retval token下标, -1:未找到
+ */
+int json_find(const char *js, const json_tok_t *tokens, int count, const char *path);
+
+/**
+ * @brief  遍历对象的键, 用于一次遍历读取多个字段
+ * @param  obj: 对象token下标
+ * @param  key: 当前键下标, 小于0时返回第一个键
+ * @retval 下一个键的下标 (值为下标+1), -1:没有更多键
+ */
+int json_obj_next(const json_tok_t *tokens, int count, int obj, int key);
+
+/**
+ * @brief  按路径读取字符串值 (不处理转义, 按原文拷贝)
+ * @param  out: 输出缓冲区, 超长时截断
+ * @param  max_len: 输出缓冲区大小
+ * @retval 0:成功 1:不存在或类型不是字符串
+ */
+uint8_t json_get_string(const char *js, const json_tok_t *tokens, int count,
+                        const char *path, char *out, uint16_t max_len);
+
+/**
+ * @brief  按路径读取整数值
+ * @param  out: 输出整数, true/false 分别读为 1/0
+ * @retval 0:成功 1:不存在或类型不是数字
+ */
+uint8_t json_get_int(const char *js, const json_tok_t *tokens, int count,
+                     const char *path, int32_t *out);
+
+/**
+ * @brief  按路径读取无符号64位整数 (毫秒时间戳等超出int32范围的值)
+ * @retval 0:成功 1:不存在、类型不是数字或为负数
+ */
+uint8_t json_get_u64(const char *js, const json_tok_t *tokens, int count,
+                     const char *path, uint64_t *out);
+
+/**
+ * @brief  读取字符串token (不处理转义, 按原文拷贝)
+ * @retval 0:成功 1:类型不是字符串
+ */
+uint8_t json_tok_string(const char *js, const json_tok_t *tok, char *out, uint16_t max_len);
+
+/**
+ * @brief  读取整数token, true/false 分别读为 1/0, 小数部分截断
+ * @retval 0:成功 1:类型不是数字
+ */
+uint8_t json_tok_int(const char *js, const json_tok_t *tok, int32_t *out);
+
+/**
+ * @brief  读取无符号64位整数token, 小数部分截断
+ * @retval 0:成功 1:类型不是数字或为负数
+ */
+uint8_t json_tok_u64(const char *js, const json_tok_t *tok, uint64_t *out);
+
+/**
+ * @brief  判断token是否等于指定字符串
+ * @retval 1:相等 0:不相等
+ */
+uint8_t json_tok_equal(const char *js, const json_tok_t *tok, const char *s);
+
+#endif /* __JSON_PARSER_H */
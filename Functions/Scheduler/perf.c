@@ -0,0 +1,117 @@
+/**
+ ****************************************************************************************************
+ * @file        perf.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       基于周期计数器的分段性能剖析实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "perf.h"
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+/* 段内部记录 (耗时以周期计, 读取时换算为us) */
+typedef struct {
+    uint32_t start;                         /* 本次开始时的计数, 0表示未开始 */
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t hist[PERF_HIST_BINS];
+} perf_scope_rec_t;
+
+/* 段名称, 与 perf_scope_t 一一对应 */
+static const char *const s_names[PERF_SCOPE_COUNT] = {
+    "lvgl", "flush", "input", "adc", "dht11", "control",
+    "tlm", "rx", "at", "ui", "history", "stats"
+};
+
+static perf_cycles_fn_t s_cycles = NULL;    /* 周期计数器 */
+static uint32_t s_cycles_per_us = 1;
+static perf_scope_rec_t s_scopes[PERF_SCOPE_COUNT];
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化
+ */
+void perf_init(perf_cycles_fn_t cycles, uint32_t cycles_per_us)
+{
+    s_cycles = cycles;
+    s_cycles_per_us = cycles_per_us ? cycles_per_us : 1;
+    perf_reset();
+}
+
+/**
+ * @brief  段开始
+ */
+void perf_begin(uint8_t id)
+{
+    if (s_cycles == NULL || id >= PERF_SCOPE_COUNT) return;
+    s_scopes[id].start = s_cycles() | 1;    /* 最低位置1, 与"未开始"区分 */
+}
+
+/**
+ * @brief  段结束
+ */
+void perf_end(uint8_t id)
+{
+    perf_scope_rec_t *r;
+    uint32_t dt, v;
+    uint8_t bin = 0;
+
+    if (s_cycles == NULL || id >= PERF_SCOPE_COUNT || s_scopes[id].start == 0) return;
+
+    r = &s_scopes[id];
+    dt = s_cycles() - (r->start & ~1UL);    /* 去掉标记位再相减, 最多多计1个周期, 不会下溢 */
+    r->start = 0;
+
+    if (r->count == 0 || dt < r->min) r->min = dt;
+    if (dt > r->max) r->max = dt;
+    r->sum += dt;
+    r->count++;
+
+    /* 每格跨4倍: 换算为us后每右移2位进一格 */
+    for (v = (dt / s_cycles_per_us) >> 2; v != 0 && bin < PERF_HIST_BINS - 1; v >>= 2)
+    {
+        bin++;
+    }
+    if (r->hist[bin] != 0xFFFF) r->hist[bin]++;
+}
+
+/**
+ * @brief  获取一个段的统计
+ */
+uint8_t perf_get(uint8_t id, perf_stats_t *stats)
+{
+    const perf_scope_rec_t *r;
+
+    if (id >= PERF_SCOPE_COUNT || stats == NULL) return 1;
+
+    r = &s_scopes[id];
+    stats->name = s_names[id];
+    stats->count = r->count;
+    stats->min_us = r->min / s_cycles_per_us;
+    stats->max_us = r->max / s_cycles_per_us;
+    stats->avg_us = r->count ? (uint32_t)(r->sum / r->count / s_cycles_per_us) : 0;
+    memcpy(stats->hist, r->hist, sizeof(stats->hist));
+    return 0;
+}
+
+/**
+ * @brief  清除全部统计
+ */
+void perf_reset(void)
+{
+    memset(s_scopes, 0, sizeof(s_scopes));
+}
@@ -0,0 +1,111 @@
+/**
+ ****************************************************************************************************
+ * @file        perf.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       基于周期计数器的分段性能剖析
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 在需要测量的代码段前后放置 PERF_BEGIN(id) / PERF_END(id), 每个段记录
+ *   调用次数、最短/最长/平均耗时和对数耗时直方图 (每格跨2个二进制数量级: <4us, <16us, ... , >=16ms)
+ * - 计时源为 Cortex-M3 DWT CYCCNT (72MHz下分辨率约14ns), 通过 perf_init() 注入,
+ *   单段耗时须小于计数器回绕周期 (72MHz下约59秒)
+ * - 段编号集中定义在 perf_scope_t 中, 名称表在 perf.c, 增删时两处同时修改
+ * - 同一个段不可嵌套或在中断中重入; 不同的段可以互相嵌套
+ * - PERF_ENABLE 为0时宏展开为空, 不占用运行时间
+ * - 本模块不依赖任何硬件, 可在主机下用任意时钟编译
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __PERF_H
+#define __PERF_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define PERF_ENABLE             1           /* 1: 启用剖析 */
+#define PERF_HIST_BINS          8           /* 直方图格数 */
+
+/******************************************************************************************/
+/* 定义 */
+
+/* 剖析段 */
+typedef enum {
+    PERF_LVGL = 0,                          /* lv_timer_handler */
+    PERF_FLUSH,                             /* LVGL刷屏回调 (CPU部分, DMA传输不计入) */
+    PERF_INPUT,                             /* 按键与触摸按键扫描 */
+    PERF_ADC,                               /* 传感器采集 (ADC多次采样取平均) */
+    PERF_DHT11,                             /* DHT11后台转换 */
+    PERF_CONTROL,                           /* 自动控制 */
+    PERF_TLM,                               /* 上报: JSON/bin格式化与入队 */
+    PERF_RX,                                /* 下行报文解析与命令处理 */
+    PERF_AT,                                /* AT指令引擎与连接状态机 */
+    PERF_UI,                                /* 界面数据刷新 */
+    PERF_HISTORY,                           /* 历史数据记录 (W25QXX写入) */
+    PERF_STATS,                             /* 统计打印 (USART1轮询发送) */
+    PERF_SCOPE_COUNT
+} perf_scope_t;
+
+typedef uint32_t (*perf_cycles_fn_t)(void); /* 周期计数器, 返回自由运行的计数 (允许回绕) */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 单个段的统计 */
+typedef struct {
+    const char *name;                       /* 段名称 */
+    uint32_t count;                         /* 调用次数 */
+    uint32_t min_us;                        /* 最短耗时 */
+    uint32_t avg_us;                        /* 平均耗时 */
+    uint32_t max_us;                        /* 最长耗时 */
+    uint16_t hist[PERF_HIST_BINS];          /* 耗时直方图, 第k格为 [4^k, 4^(k+1)) us, 计满后不再增加 */
+} perf_stats_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化 (清除全部统计)
+ * @param  cycles: 周期计数器
+ * @param  cycles_per_us: 每微秒的计数值 (72MHz下为72)
+ */
+void perf_init(perf_cycles_fn_t cycles, uint32_t cycles_per_us);
+
+/**
+ * @brief  段开始
+ */
+void perf_begin(uint8_t id);
+
+/**
+ * @brief  段结束, 累计本次耗时 (未初始化或未调用perf_begin时忽略)
+ */
+void perf_end(uint8_t id);
+
+/**
+ * @brief  获取一个段的统计
+ * @retval 0:成功 1:编号无效
+ */
+uint8_t perf_get(uint8_t id, perf_stats_t *stats);
+
+/**
+ * @brief  清除全部统计
+ */
+void perf_reset(void);
+
+#if PERF_ENABLE
+#define PERF_BEGIN(id)          perf_begin(id)
+#define PERF_END(id)            perf_end(id)
+#else
+#define PERF_BEGIN(id)
+#define PERF_END(id)
+#endif
+
+#endif /* __PERF_H */
@@ -0,0 +1,278 @@
+/**
+ ****************************************************************************************************
+ * @file        scheduler.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       协作式任务调度器实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 时间比较全部使用无符号差值的有符号解释, 时钟回绕 (约71分钟) 不影响调度,
+ * 但要求任意周期和截止时间小于约35分钟。
+ *
+ ****************************************************************************************************
+ */
+
+#include "scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static sched_task_t s_tasks[SCHED_MAX_TASKS];   /* 任务表 */
+static uint8_t s_task_count = 0;                /* 已添加任务数 */
+static sched_clock_fn_t s_clock = NULL;         /* 微秒时钟 */
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  判断时刻a是否已到达时刻b (处理回绕)
+ */
+static uint8_t time_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+/**
+ * @brief  任务的有效释放时刻: 有事件释放时为事件时刻, 否则为周期释放时刻
+ */
+static uint32_t task_release(const sched_task_t *t)
+{
+    return t->posted ? t->posted_at : t->next_release;
+}
+
+/******************************************************************************************/
+/* 接口函数 */
+
+/**
+ * @brief  初始化调度器
+ */
+void sched_init(sched_clock_fn_t clock_us)
+{
+    memset(s_tasks, 0, sizeof(s_tasks));
+    s_task_count = 0;
+    s_clock = clock_us;
+}
+
+/**
+ * @brief  添加周期任务
+ * @note   新任务立即释放, 第一次调用 sched_run_once() 时即可执行
+ */
+int8_t sched_add_task(const char *name, sched_task_fn_t fn, uint32_t period_ms,
+                      uint32_t deadline_ms, uint8_t priority)
+{
+    sched_task_t *task;
+
+    if (s_clock == NULL || fn == NULL || period_ms == 0 || s_task_count >= SCHED_MAX_TASKS)
+    {
+        return -1;
+    }
+
+    task = &s_tasks[s_task_count];
+    memset(task, 0, sizeof(sched_task_t));
+    task->name = name;
+    task->fn = fn;
+    task->period_us = period_ms * 1000;
+    task->deadline_us = (deadline_ms ? deadline_ms : period_ms) * 1000;
+    task->priority = priority;
+    task->enabled = 1;
+    task->next_release = s_clock();
+
+    return (int8_t)s_task_count++;
+}
+
+/**
+ * @brief  启用/禁用任务
+ */
+void sched_set_enabled(int8_t id, uint8_t enable)
+{
+    if (id < 0 || id >= s_task_count) return;
+
+    if (enable && !s_tasks[id].enabled)
+    {
+        s_tasks[id].next_release = s_clock();
+    }
+    s_tasks[id].enabled = enable ? 1 : 0;
+}
+
+/**
+ * @brief  事件释放任务
+ * @note   只写posted/posted_at/posts, 主循环只在执行前清除posted, 无需关中断
+ */
+void sched_post(int8_t id)
+{
+    sched_task_t *t;
+
+    if (id < 0 || id >= s_task_count) return;
+
+    t = &s_tasks[id];
+    if (!t->posted)
+    {
+        t->posted_at = s_clock();
+        t->posted = 1;
+    }
+    t->posts++;
+}
+
+/**
+ * @brief  执行一个就绪任务
+ * @note   选择已到释放时刻 (或有事件释放) 且优先级最高的任务; 执行完成后按周期推进释放时刻 (不累积漂移),
+ *         若任务落后超过一个周期, 直接跳到下一个未来的释放点并记录跳过次数, 避免连续补跑;
+ *         事件释放的执行在周期释放尚未到达时不推进释放时刻
+ */
+uint8_t sched_run_once(void)
+{
+    uint8_t i;
+    uint32_t now, start, end, release, elapsed, lag;
+    uint8_t periodic;
+    sched_task_t *task = NULL;
+
+    if (s_clock == NULL) return 0;
+
+    now = s_clock();
+
+    for (i = 0; i < s_task_count; i++)
+    {
+        sched_task_t *t = &s_tasks[i];
+
+        if (!t->enabled || (!t->posted && !time_reached(now, t->next_release))) continue;
+
+        if (task == NULL || t->priority < task->priority ||
+            (t->priority == task->priority && (int32_t)(task_release(t) - task_release(task)) < 0))
+        {
+            task = t;
+        }
+    }
+
+    if (task == NULL) return 0;
+
+    release = task_release(task);
+    periodic = time_reached(now, task->next_release);
+    task->posted = 0;                       /* 先清除, 执行期间的新事件会再释放一次 */
+    start = s_clock();
+    task->fn();
+    end = s_clock();
+
+    /* 运行时间统计 */
+    elapsed = end - start;
+    task->run_count++;
+    task->last_us = elapsed;
+    task->total_us += elapsed;
+    if (elapsed > task->max_us) task->max_us = elapsed;
+
+    lag = start - release;
+    if (lag > task->max_latency_us) task->max_latency_us = lag;
+
+    /* 截止时间检查: 从释放到完成 */
+    if (end - release > task->deadline_us)
+    {
+        task->deadline_miss++;
+    }
+
+    /* 推进释放时刻 */
+    if (!periodic) return 1;
+    task->next_release += task->period_us;
+    if (time_reached(end, task->next_release))
+    {
+        uint32_t behind = (end - task->next_release) / task->period_us + 1;
+        task->next_release += behind * task->period_us;
+        task->skipped += behind;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief  距离下一个任务释放的时间
+ */
+uint32_t sched_time_to_next_us(void)
+{
+    uint8_t i;
+    uint32_t now, wait, min_wait = 0xFFFFFFFF;
+
+    if (s_clock == NULL) return 0;
+
+    now = s_clock();
+    for (i = 0; i < s_task_count; i++)
+    {
+        if (!s_tasks[i].enabled) continue;
+        if (s_tasks[i].posted || time_reached(now, s_tasks[i].next_release)) return 0;
+
+        wait = s_tasks[i].next_release - now;
+        if (wait < min_wait) min_wait = wait;
+    }
+
+    return min_wait;
+}
+
+/**
+ * @brief  获取任务数量
+ */
+uint8_t sched_get_task_count(void)
+{
+    return s_task_count;
+}
+
+/**
+ * @brief  获取任务控制块
+ */
+const sched_task_t *sched_get_task(uint8_t id)
+{
+    if (id >= s_task_count) return NULL;
+    return &s_tasks[id];
+}
+
+/**
+ * @brief  获取任务平均运行时间
+ */
+uint32_t sched_get_avg_us(uint8_t id)
+{
+    if (id >= s_task_count || s_tasks[id].run_count == 0) return 0;
+    return (uint32_t)(s_tasks[id].total_us / s_tasks[id].run_count);
+}
+
+/**
+ * @brief  清零所有任务的统计信息
+ */
+void sched_reset_stats(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_task_count; i++)
+    {
+        s_tasks[i].run_count = 0;
+        s_tasks[i].last_us = 0;
+        s_tasks[i].max_us = 0;
+        s_tasks[i].total_us = 0;
+        s_tasks[i].max_latency_us = 0;
+        s_tasks[i].deadline_miss = 0;
+        s_tasks[i].skipped = 0;
+        s_tasks[i].posts = 0;
+    }
+}
+
+/**
+ * @brief  打印任务统计表
+ */
+void sched_print_stats(void)
+{
+    uint8_t i;
+
+    printf("[Sched] %-10s %3s %6s %8s %8s %8s %8s %6s %6s %8s\r\n",
+           "task", "pri", "per_ms", "runs", "avg_us", "max_us", "lat_us", "miss", "skip", "posts");
+
+    for (i = 0; i < s_task_count; i++)
+    {
+        const sched_task_t *t = &s_tasks[i];
+        printf("[Sched] %-10s %3u %6lu %8lu %8lu %8lu %8lu %6lu %6lu %8lu\r\n",
+               t->name, t->priority, (unsigned long)(t->period_us / 1000),
+               (unsigned long)t->run_count, (unsigned long)sched_get_avg_us(i),
+               (unsigned long)t->max_us, (unsigned long)t->max_latency_us,
+               (unsigned long)t->deadline_miss, (unsigned long)t->skipped, (unsigned long)t->posts);
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ ****************************************************************************************************
+ * @file        scheduler.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       协作式任务调度器 - 周期/截止时间/优先级驱动
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - 任务表中每个任务带有周期、相对截止时间和优先级, 按真实时钟释放
+ * - 同时就绪的任务按优先级执行 (数值越小优先级越高), 同优先级先释放的先执行
+ * - 每个任务记录最坏/平均运行时间和截止时间错过次数
+ * - sched_post() 可在中断中调用, 立即释放一次任务 (事件驱动), 不影响其周期释放
+ * - 本模块不依赖任何硬件, 时钟通过 sched_init() 注入,
+ *   可在 Linux 主机下使用伪时钟编译, 用于调度时序验证和基准测试
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include <stdint.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define SCHED_MAX_TASKS         16          /* 任务表最大任务数 (主程序使用12个, 留出余量) */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+typedef void (*sched_task_fn_t)(void);      /* 任务函数 */
+typedef uint32_t (*sched_clock_fn_t)(void); /* 时钟函数, 返回自由运行的微秒计数 (允许回绕) */
+
+/* 任务控制块 */
+typedef struct {
+    const char *name;               /* 任务名称 */
+    sched_task_fn_t fn;             /* 任务函数 */
+    uint32_t period_us;             /* 周期 (us) */
+    uint32_t deadline_us;           /* 相对截止时间 (us), 相对于释放时刻 */
+    uint8_t  priority;              /* 优先级, 0最高 */
+    uint8_t  enabled;               /* 是否启用 */
+
+    uint32_t next_release;          /* 下次释放时刻 (us) */
+    volatile uint8_t posted;        /* 1: 有事件释放等待执行 */
+    uint32_t posted_at;             /* 事件释放时刻 (us), 同一次执行前的多次释放取第一次 */
+
+    /* 统计信息 */
+    uint32_t run_count;             /* 运行次数 */
+    uint32_t last_us;               /* 最近一次运行时间 (us) */
+    uint32_t max_us;                /* 最坏运行时间 (us) */
+    uint64_t total_us;              /* 累计运行时间 (us), 用于计算平均值 */
+    uint32_t max_latency_us;        /* 最大释放延迟 (释放到开始执行, us) */
+    uint32_t deadline_miss;         /* 截止时间错过次数 (释放到执行完成超过截止时间) */
+    uint32_t skipped;               /* 因严重超时而跳过的释放次数 */
+    uint32_t posts;                 /* 事件释放次数 */
+} sched_task_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化调度器
+ * @param  clock_us: 微秒时钟函数
+ */
+void sched_init(sched_clock_fn_t clock_us);
+
+/**
+ * @brief  添加周期任务
+ * @param  name: 任务名称 (需为静态字符串)
+ * @param  fn: 任务函数
+ * @param  period_ms: 周期 (ms)
+ * @param  deadline_ms: 相对截止时间 (ms), 0表示等于周期
+ * @param  priority: 优先级, 0最高
+ * @retval 任务ID, -1:任务表已满或参数错误
+ */
+int8_t sched_add_task(const char *name, sched_task_fn_t fn, uint32_t period_ms,
+                      uint32_t deadline_ms, uint8_t priority);
+
+/**
+ * @brief  启用/禁用任务
+ * @param  id: 任务ID
+ * @param  enable: 0-禁用 1-启用 (启用时立即释放一次)
+ */
+void sched_set_enabled(int8_t id, uint8_t enable);
+
+/**
+ * @brief  事件释放任务: 下一次调度时按优先级立即执行一次 (可在中断中调用)
+ * @note   释放延迟和截止时间从事件时刻起算; 任务执行期间再次释放会再执行一次
+ * @param  id: 任务ID
+ */
+void sched_post(int8_t id);
+
+/**
+ * @brief  执行一个就绪任务 (在主循环中反复调用)
+ * @retval 0:没有就绪任务 1:执行了一个任务
+ */
+uint8_t sched_run_once(void);
+
+/**
+ * @brief  距离下一个任务释放的时间
+ * @retval 微秒数, 已有就绪任务时返回0
+ */
+uint32_t sched_time_to_next_us(void);
+
+/**
+ * @brief  获取任务数量
+ */
+uint8_t sched_get_task_count(void);
+
+/**
+ * @brief  获取任务控制块 (只读, 用于统计上报)
+ * @param  id: 任务ID
+ * @retval 任务控制块指针, NULL:ID无效
+ */
+const sched_task_t *sched_get_task(uint8_t id);
+
+/**
+ * @brief  获取任务平均运行时间
+ * @param  id: 任务ID
+ * @retval 平均运行时间 (us)
+ */
+uint32_t sched_get_avg_us(uint8_t id);
+
+/**
+ * @brief  清零所有任务的统计信息
+ */
+void sched_reset_stats(void);
+
+/**
+ * @brief  通过printf打印任务统计表
+ */
+void sched_print_stats(void);
+
+#endif /* __SCHEDULER_H */
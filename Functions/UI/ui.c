@@ -19,11 +19,16 @@
 #include "bump.h"
 #include "ts.h"
 #include "delay.h"
+#include "history.h"
+#include "downsample.h"
+#include "ctrl_rules.h"
+#include "lv_port_disp_template.h"
 
 /* 全局变量定义 */
 limits lim_value;
 uint8_t temp = 25;
 uint8_t humi = 60;
+uint8_t dht_stale = 1;
 uint8_t soil_humi = 40;
 uint8_t light_intensity = 80;
 uint8_t mode = 0;
@@ -55,6 +60,7 @@ static lv_obj_t *scr_main;
 static lv_obj_t *scr_menu;
 static lv_obj_t *scr_manual;
 static lv_obj_t *scr_limit;
+static lv_obj_t *scr_history;
 
 /* 标签对象 */
 static lv_obj_t *label_temp;
@@ -75,6 +81,45 @@ static lv_obj_t *popup_container;
 static lv_obj_t *popup_label;
 static lv_timer_t *popup_timer;  /* 弹窗定时器 */
 
+/* 历史曲线页面 */
+typedef struct {
+    const char *name;           /* 时间范围名称 */
+    uint16_t points;            /* 图表点数 (桶数) */
+    uint16_t bucket_s;          /* 每个点覆盖的时间 (秒) */
+} hist_range_t;
+
+typedef struct {
+    const char *name;           /* 传感器名称 */
+    const char *unit;           /* 单位 */
+    uint8_t y_max;              /* 纵轴上限 */
+    uint32_t color;             /* 曲线颜色 */
+} hist_channel_t;
+
+/* 点数不超过图表绘图区宽度 (约280像素); 1h范围受记录周期 (60s) 限制只有60个点 */
+static const hist_range_t hist_ranges[] = {
+    {"1h",  60,  60},
+    {"24h", 240, 360},
+    {"7d",  240, 2520},
+};
+
+/* 顺序与 HISTORY_CH_* 一致 */
+static const hist_channel_t hist_channels[] = {
+    {"Temp",      "C", 50,  UI_COLOR_BG_TEMP},
+    {"Humi",      "%", 100, UI_COLOR_BG_HUMI},
+    {"Soil Humi", "%", 100, UI_COLOR_BG_SOIL},
+    {"Light",     "%", 100, UI_COLOR_BG_LIGHT},
+};
+
+static lv_obj_t *hist_chart;
+static lv_chart_series_t *hist_ser_max;     /* 每个桶的最大值 */
+static lv_chart_series_t *hist_ser_min;     /* 每个桶的最小值 */
+static lv_obj_t *label_hist_title;
+static lv_obj_t *label_hist_info;
+static uint8_t hist_channel = 0;            /* 当前传感器 */
+static uint8_t hist_range = 1;              /* 当前时间范围 */
+static ds_minmax_t hist_ds;                 /* 降采样器 */
+static uint32_t hist_fed = 0;               /* 下一次查询的起始时间 (之前的样本已输入降采样器) */
+
 /* 阈值边界 */
 static uint8_t temp_max = 50;
 static uint8_t temp_min = 0;
@@ -101,6 +146,7 @@ void UI_Init(void) {
 
 /* 前向声明 */
 static void cleanup_popup(void);
+static void apply_level_color(uint8_t sensor, uint8_t level);
 
 /**
  * @brief  删除所有子对象
@@ -244,6 +290,12 @@ void create_main_screen(void) {
     lv_label_set_text(label_mode, "Mode: Auto");
     lv_obj_set_style_text_color(label_mode, lv_color_black(), 0);
     lv_obj_align(label_mode, LV_ALIGN_BOTTOM_MID, 0, 6);
+
+    /* 按当前告警等级着色 */
+    apply_level_color(CTRL_SENSOR_TEMP, ctrl_get_level(CTRL_SENSOR_TEMP));
+    apply_level_color(CTRL_SENSOR_HUMI, ctrl_get_level(CTRL_SENSOR_HUMI));
+    apply_level_color(CTRL_SENSOR_SOIL, ctrl_get_level(CTRL_SENSOR_SOIL));
+    apply_level_color(CTRL_SENSOR_LIGHT, ctrl_get_level(CTRL_SENSOR_LIGHT));
 }
 
 /**
@@ -252,8 +304,14 @@ void create_main_screen(void) {
  * @retval 无
  */
 void update_main_screen() {
-    lv_label_set_text_fmt(label_temp, "%d C", temp);
-    lv_label_set_text_fmt(label_humi, "%d %%", humi);
+    if (dht_stale) {
+        /* DHT11读数过期: 不显示旧值 */
+        lv_label_set_text(label_temp, "-- C");
+        lv_label_set_text(label_humi, "-- %");
+    } else {
+        lv_label_set_text_fmt(label_temp, "%d C", temp);
+        lv_label_set_text_fmt(label_humi, "%d %%", humi);
+    }
     lv_label_set_text_fmt(label_soil_humi,"%d %%", soil_humi);
     lv_label_set_text_fmt(label_light, "%d %%", light_intensity);
     lv_label_set_text_fmt(label_mode, mode==1 ?"Mode: Manual":"Mode: Auto");
@@ -603,6 +661,187 @@ void update_manual_screen() {
     }
 }
 
+/**
+ * @brief  降采样桶输出: 追加到图表末尾 (SHIFT模式, 最早的点移出)
+ */
+static void hist_emit(uint8_t valid, uint8_t min, uint8_t max, void *arg) {
+    lv_chart_set_next_value(hist_chart, hist_ser_max, valid ? max : LV_CHART_POINT_NONE);
+    lv_chart_set_next_value(hist_chart, hist_ser_min, valid ? min : LV_CHART_POINT_NONE);
+}
+
+/**
+ * @brief  历史样本输入降采样器
+ * @note   跳过无效值, 整个桶都无效时曲线留空
+ */
+static uint8_t hist_visit(const tslog_sample_t *sample, void *arg) {
+    if (sample->v[hist_channel] == HISTORY_VALUE_INVALID) return 0;
+    ds_minmax_add(&hist_ds, sample->ts, sample->v[hist_channel]);
+    return 0;
+}
+
+/**
+ * @brief  查询 [hist_fed, now) 内的新样本并输出已结束的桶
+ */
+static void hist_feed(uint32_t now) {
+    if (now > hist_fed) {
+        history_query(hist_fed, now - 1, hist_visit, NULL);
+        hist_fed = now;
+    }
+    ds_minmax_advance(&hist_ds, now);
+}
+
+/**
+ * @brief  刷新标题和统计信息 (窗口内最小/最大值与当前值)
+ */
+static void hist_update_labels(void) {
+    const hist_channel_t *ch = &hist_channels[hist_channel];
+    lv_coord_t *ymax = lv_chart_get_y_array(hist_chart, hist_ser_max);
+    lv_coord_t *ymin = lv_chart_get_y_array(hist_chart, hist_ser_min);
+    uint16_t cnt = lv_chart_get_point_count(hist_chart);
+    lv_coord_t lo = LV_CHART_POINT_NONE, hi = 0;
+    uint8_t now_val;
+    uint16_t i;
+
+    switch (hist_channel) {
+        case HISTORY_CH_TEMP: now_val = temp; break;
+        case HISTORY_CH_HUMI: now_val = humi; break;
+        case HISTORY_CH_SOIL: now_val = soil_humi; break;
+        default:              now_val = light_intensity; break;
+    }
+
+    lv_label_set_text_fmt(label_hist_title, "%s - %s", ch->name, hist_ranges[hist_range].name);
+
+    if (!history_ready()) {
+        lv_label_set_text(label_hist_info, "No history (W25QXX not found)");
+        return;
+    }
+
+    for (i = 0; i < cnt; i++) {
+        if (ymin[i] != LV_CHART_POINT_NONE && ymin[i] < lo) lo = ymin[i];
+        if (ymax[i] != LV_CHART_POINT_NONE && ymax[i] > hi) hi = ymax[i];
+    }
+
+    if (dht_stale && (hist_channel == HISTORY_CH_TEMP || hist_channel == HISTORY_CH_HUMI)) {
+        if (lo == LV_CHART_POINT_NONE) {
+            lv_label_set_text_fmt(label_hist_info, "No data    Now -- %s", ch->unit);
+        } else {
+            lv_label_set_text_fmt(label_hist_info, "Min %d  Max %d    Now -- %s", lo, hi, ch->unit);
+        }
+    } else if (lo == LV_CHART_POINT_NONE) {
+        lv_label_set_text_fmt(label_hist_info, "No data    Now %d %s", now_val, ch->unit);
+    } else {
+        lv_label_set_text_fmt(label_hist_info, "Min %d  Max %d    Now %d %s", lo, hi, now_val, ch->unit);
+    }
+}
+
+/**
+ * @brief  按当前传感器和时间范围重新装载曲线
+ * @note   从日志中读取整个窗口并降采样 (7d约1万个样本, 只解码与窗口相交的扇区),
+ *         之后由 update_history_screen 逐点追加
+ */
+static void hist_reload(void) {
+    const hist_range_t *r = &hist_ranges[hist_range];
+    const hist_channel_t *ch = &hist_channels[hist_channel];
+    uint32_t now = history_now();
+    uint32_t aligned = now - now % r->bucket_s;
+    uint32_t span = (uint32_t)r->points * r->bucket_s;
+
+    lv_chart_set_point_count(hist_chart, r->points);
+    lv_chart_set_range(hist_chart, LV_CHART_AXIS_PRIMARY_Y, 0, ch->y_max);
+    lv_chart_set_series_color(hist_chart, hist_ser_max, lv_color_hex(ch->color));
+    lv_chart_set_series_color(hist_chart, hist_ser_min, lv_color_mix(lv_color_hex(ch->color), lv_color_black(), LV_OPA_60));
+    lv_chart_set_all_value(hist_chart, hist_ser_max, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(hist_chart, hist_ser_min, LV_CHART_POINT_NONE);
+
+    /* 桶边界按桶宽对齐, 最后一个点为最近一个已结束的桶 */
+    hist_fed = (aligned > span) ? aligned - span : 0;
+    ds_minmax_init(&hist_ds, hist_fed, r->bucket_s, r->points, hist_emit, NULL);
+
+    if (history_ready()) {
+        hist_feed(now);
+    }
+    hist_update_labels();
+}
+
+/**
+ * @brief  创建历史曲线屏幕
+ * @note   显示一个传感器在1h/24h/7d范围内的曲线, 每个点为一个时间桶内的最小/最大值
+ * @retval 无
+ */
+void create_history_screen(void) {
+    scr_history = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(scr_history, lv_color_hex(UI_COLOR_BG_SCREEN), 0);
+    lv_obj_set_style_bg_opa(scr_history, LV_OPA_COVER, 0);
+
+    /* 创建标题栏 */
+    lv_obj_t *title_container = lv_obj_create(scr_history);
+    lv_obj_set_size(title_container, 320, 40);
+    lv_obj_align(title_container, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_bg_color(title_container, lv_color_hex(UI_COLOR_BG_TITLE), 0);
+    lv_obj_set_style_bg_opa(title_container, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(title_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    label_hist_title = lv_label_create(title_container);
+    lv_label_set_text(label_hist_title, "History");
+    lv_obj_set_style_text_color(label_hist_title, lv_color_white(), 0);
+    lv_obj_set_style_text_font(label_hist_title, &lv_font_montserrat_18, 0);
+    lv_obj_align(label_hist_title, LV_ALIGN_CENTER, 0, 0);
+
+    /* 统计信息 */
+    label_hist_info = lv_label_create(scr_history);
+    lv_label_set_text(label_hist_info, "");
+    lv_obj_set_style_text_color(label_hist_info, lv_color_black(), 0);
+    lv_obj_set_style_text_font(label_hist_info, &lv_font_montserrat_14, 0);
+    lv_obj_align(label_hist_info, LV_ALIGN_TOP_MID, 0, 46);
+
+    /* 曲线图: 不绘制数据点, 细线, 减少重绘开销 */
+    hist_chart = lv_chart_create(scr_history);
+    lv_obj_set_size(hist_chart, 300, 130);
+    lv_obj_align(hist_chart, LV_ALIGN_TOP_MID, 0, 68);
+    lv_chart_set_type(hist_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(hist_chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_div_line_count(hist_chart, 5, 0);
+    lv_obj_set_style_size(hist_chart, 0, LV_PART_INDICATOR);
+    lv_obj_set_style_line_width(hist_chart, 1, LV_PART_ITEMS);
+    lv_obj_clear_flag(hist_chart, LV_OBJ_FLAG_SCROLLABLE);
+
+    hist_ser_max = lv_chart_add_series(hist_chart, lv_color_hex(UI_COLOR_BG_TEMP), LV_CHART_AXIS_PRIMARY_Y);
+    hist_ser_min = lv_chart_add_series(hist_chart, lv_color_hex(UI_COLOR_BG_TEMP), LV_CHART_AXIS_PRIMARY_Y);
+
+    /* 底部操作提示栏 */
+    lv_obj_t *tip_container = lv_obj_create(scr_history);
+    lv_obj_set_size(tip_container, 320, 30);
+    lv_obj_align(tip_container, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_bg_color(tip_container, lv_color_hex(UI_COLOR_BG_TITLE), 0);
+    lv_obj_set_style_bg_opa(tip_container, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(tip_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *tip_label = lv_label_create(tip_container);
+    lv_label_set_text(tip_label, "KEY0:Sensor\tKEY1:Range\tTPAD:Back");
+    lv_obj_set_style_text_color(tip_label, lv_color_black(), 0);
+    lv_obj_set_style_text_font(tip_label, &lv_font_montserrat_14, 0);
+    lv_obj_align(tip_label, LV_ALIGN_BOTTOM_MID, 0, 6);
+
+    hist_reload();
+}
+
+/**
+ * @brief  更新历史曲线屏幕
+ * @note   当前桶结束时才读取新样本并用 lv_chart_set_next_value 追加, 不重建整条曲线
+ * @retval 无
+ */
+void update_history_screen(void) {
+    uint32_t now;
+
+    if (!history_ready()) return;
+
+    now = history_now();
+    if (now < hist_ds.end) return;
+
+    hist_feed(now);
+    hist_update_labels();
+}
+
 /**
  * @brief  隐藏并销毁弹窗（定时器回调）
  * @param  timer: LVGL定时器指针
@@ -645,7 +884,7 @@ void create_popup(void) {
         return;
     }
     /* 创建弹窗容器 */
-    popup_container = lv_obj_create(current_screen==SCREEN_MAIN?scr_main:(current_screen==SCREEN_MENU)?scr_menu:(current_screen==SCREEN_MANUAL)?scr_manual:scr_limit);
+    popup_container = lv_obj_create(current_screen==SCREEN_MAIN?scr_main:(current_screen==SCREEN_MENU)?scr_menu:(current_screen==SCREEN_MANUAL)?scr_manual:(current_screen==SCREEN_HISTORY)?scr_history:scr_limit);
     lv_obj_set_size(popup_container, 200, 40);
     lv_obj_align(popup_container, LV_ALIGN_BOTTOM_RIGHT, -10, -10);  /* 屏幕右下角 */
     lv_obj_set_style_bg_color(popup_container, lv_color_hex(UI_COLOR_BG_POPUP), 0);
@@ -757,12 +996,40 @@ void UI_Switch(uint8_t key){
                 lv_scr_load(scr_menu);
                 break;
             case KEY0_PRES:
+                /* 按下KEY0进入历史曲线 */
+                destory_active_screen();
+                create_history_screen();
+                current_screen = SCREEN_HISTORY;
+                lv_scr_load(scr_history);
                 break;
             case KEY1_PRES:
+                /* 按下KEY1显示/隐藏性能浮层 */
+                lv_port_disp_overlay(!lv_port_disp_overlay_is_on());
                 break;
             case 10:
                 break;
         }
+    }else if(current_screen==SCREEN_HISTORY){
+        /* 历史曲线界面按键处理 */
+        switch(key){
+            case KEY0_PRES:
+                /* 按下KEY0切换传感器 */
+                hist_channel = (hist_channel + 1) % 4;
+                hist_reload();
+                break;
+            case KEY1_PRES:
+                /* 按下KEY1切换时间范围 */
+                hist_range = (hist_range + 1) % 3;
+                hist_reload();
+                break;
+            case 10:
+                /* 按下TPAD返回主界面 */
+                destory_active_screen();
+                create_main_screen();
+                lv_scr_load(scr_main);
+                current_screen = SCREEN_MAIN;
+                break;
+        }
     }else if(current_screen==SCREEN_MENU){
         /* 菜单界面按键处理 */
         switch(key){
@@ -891,91 +1158,41 @@ void UI_Switch(uint8_t key){
 }
 
 /**
- * @brief  告警与自动控制功能
- * @note   根据传感器数据和阈值进行告警显示和自动控制
+ * @brief  按告警等级设置主界面传感器数值颜色
+ * @param  sensor: 传感器编号 (CTRL_SENSOR_*)
+ * @param  level: 告警等级 (CTRL_LEVEL_*)
  * @retval 无
  */
-void Warn_function(void){
-    if(current_screen!=SCREEN_MAIN)
-        return;
-
-    /* 温度告警处理 */
-    if(temp>lim_value.temp_upper){
-        /* 温度超上限，开启风扇，文字变红 */
-				if(!mode&&!fun_status){
-            FUN_ON;
-            fun_status=1;
-        }
-        lv_obj_set_style_text_color(label_temp, lv_color_hex(UI_COLOR_WARN_HIGH), 0);
-    }else if(temp<lim_value.temp_lower){
-        /* 温度低于下限，关闭风扇，文字变蓝 */
-        if(!mode&&fun_status){
-            FUN_OFF;
-            fun_status=0;
-        }
-        lv_obj_set_style_text_color(label_temp, lv_color_hex(UI_COLOR_WARN_LOW), 0);
-    }else{
-        /* 温度正常，关闭风扇，文字白色 */
-        if(!mode&&fun_status){
-            FUN_OFF;
-            fun_status=0;
-        }
-        lv_obj_set_style_text_color(label_temp, lv_color_white(), 0);
+static void apply_level_color(uint8_t sensor, uint8_t level) {
+    lv_obj_t *label;
+
+    switch (sensor) {
+        case CTRL_SENSOR_TEMP:  label = label_temp; break;
+        case CTRL_SENSOR_HUMI:  label = label_humi; break;
+        case CTRL_SENSOR_SOIL:  label = label_soil_humi; break;
+        case CTRL_SENSOR_LIGHT: label = label_light; break;
+        default: return;
     }
 
-    /* 空气湿度告警处理 */
-    if(humi>lim_value.humi_upper){
-        lv_obj_set_style_text_color(label_humi, lv_color_hex(UI_COLOR_WARN_HIGH), 0);
-    }else if(humi<lim_value.humi_lower){
-        lv_obj_set_style_text_color(label_humi, lv_color_hex(UI_COLOR_WARN_LOW), 0);
-    }else{
-        lv_obj_set_style_text_color(label_humi, lv_color_white(), 0);
-    }
-
-    /* 土壤湿度告警处理及自动浇水 */
-    if(soil_humi>lim_value.shumi_upper){
-        /* 土壤湿度超上限，自动模式下关闭水泵 */
-        if(!mode&&water_status){
-            BUMP_OFF;
-            water_status=0;
-        }
-        lv_obj_set_style_text_color(label_soil_humi, lv_color_hex(UI_COLOR_WARN_HIGH), 0);
-    }else if(soil_humi<lim_value.shumi_lower){
-        /* 土壤湿度低于下限，自动模式下开启水泵 */
-        if(!mode&&!water_status){
-            BUMP_ON;
-            water_status=1;
-        }
-        lv_obj_set_style_text_color(label_soil_humi, lv_color_hex(UI_COLOR_WARN_LOW), 0);
-    }else{
-				if(!mode&&water_status){
-            BUMP_OFF;
-            water_status=0;
-        }
-        lv_obj_set_style_text_color(label_soil_humi, lv_color_white(), 0);
+    if (level == CTRL_LEVEL_HIGH) {
+        lv_obj_set_style_text_color(label, lv_color_hex(UI_COLOR_WARN_HIGH), 0);
+    } else if (level == CTRL_LEVEL_LOW) {
+        lv_obj_set_style_text_color(label, lv_color_hex(UI_COLOR_WARN_LOW), 0);
+    } else {
+        lv_obj_set_style_text_color(label, lv_color_white(), 0);
     }
+}
 
-    /* 光照强度告警处理及自动补光 */
-    if(light_intensity>lim_value.light_upper){
-        /* 光照超上限，自动模式下关闭补光灯 */
-        lv_obj_set_style_text_color(label_light, lv_color_hex(UI_COLOR_WARN_HIGH), 0);
-        if(!mode&&light_status){
-            LED1=1;
-            light_status=0;
-        }
-    }else if(light_intensity<lim_value.light_lower){
-        /* 光照低于下限，自动模式下开启补光灯 */
-        lv_obj_set_style_text_color(label_light, lv_color_hex(UI_COLOR_WARN_LOW), 0);
-        if(!mode&&!light_status){
-            LED1=0;
-            light_status=1;
-        }
-    }else{
-				if(!mode&&light_status){
-            LED1=1;
-            light_status=0;
-        }
-        lv_obj_set_style_text_color(label_light, lv_color_white(), 0);
+/**
+ * @brief  控制引擎事件订阅: 告警等级变化时更新主界面颜色
+ * @note   自动控制由控制引擎 (ctrl_rules.c) 在每个控制周期执行, 与当前界面无关;
+ *         界面只在主界面显示时着色, 主界面重建时按当前等级重新着色
+ * @param  evt: 控制引擎事件
+ * @retval 无
+ */
+void ui_ctrl_event(const ctrl_event_t *evt) {
+    if (evt->type == CTRL_EVT_LEVEL && current_screen == SCREEN_MAIN) {
+        apply_level_color(evt->index, evt->value);
     }
 }
 
@@ -20,6 +20,7 @@
 #include "sys.h"
 #include "lvgl/lvgl.h"
 #include "key.h"
+#include "control.h"
 
 /*------------------------------------------------------------------------------
  * UI颜色宏定义 - 统一管理所有UI颜色配置
@@ -67,7 +68,8 @@ typedef enum {
     SCREEN_MAIN,
     SCREEN_MENU,
     SCREEN_MANUAL,
-    SCREEN_LIMIT
+    SCREEN_LIMIT,
+    SCREEN_HISTORY
 } screen_t;
 
 //阈值结构体
@@ -86,6 +88,7 @@ typedef struct{
 extern limits lim_value;
 extern uint8_t temp;
 extern uint8_t humi;
+extern uint8_t dht_stale;           /* 1: DHT11尚无读数或读数过期, temp/humi为旧值 */
 extern uint8_t soil_humi;
 extern uint8_t light_intensity;
 extern uint8_t mode;
@@ -108,12 +111,14 @@ void create_limit_screen(void);
 void update_limit_screen(void);
 void create_manual_screen(void);
 void update_manual_screen(void);
+void create_history_screen(void);
+void update_history_screen(void);
 void create_popup(void);
 void show_popup(const char *message, uint32_t duration_ms);
 void hide_popup(lv_timer_t *timer);
 void hide_and_destroy_popup(lv_timer_t *timer);
 void UI_Switch(uint8_t key);
-void Warn_function(void);
+void ui_ctrl_event(const ctrl_event_t *evt);
 void wireless_control(void);
 void destroy_all_children(lv_obj_t *parent);
 void destory_active_screen(void);
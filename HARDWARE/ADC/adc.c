@@ -217,28 +217,147 @@ u16 Get_Adc3(u8 ch)
 	return ADC_GetConversionValue(ADC3);	//һADC3ת
 } 
 
+//////////////////////////////////////////////////////////////////////////////////
+//ʱ+DMĄɼ
+//TIM1_CC3ÿADC_DMA_PERIOD_MSһADC1ADC3ת,DMAѭд뻺,
+//ȡʱֱӶԻƽ,ռCPUȴת,ҲҪʱ
+//ADC1 -> DMA1ͨ1, ADC3 -> DMA2ͨ5
+//ע:DMAɼ,ӦADCٵGet_Adc/Get_Adc3
+
+static volatile u16 g_adc1_dma_buf[ADC_DMA_SAMPLES];	//ADC1 DMAѭ
+static volatile u16 g_adc3_dma_buf[ADC_DMA_SAMPLES];	//ADC3 DMAѭ
+static u8 g_adc_dma_trig_inited=0;						//ʱǷѳʼ
+
+//ʼADCʱTIM1
+//TIM1ʱ72M,10KƵ,ÿADC_DMA_PERIOD_MSһCC3¼
+//CC3PA10ΪUSART1_RXʹ,ᱻʱ
+static void Adc_Dma_Trig_Init(void)
+{
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	TIM_OCInitTypeDef TIM_OCInitStructure;
+
+	if(g_adc_dma_trig_inited)return;
+	g_adc_dma_trig_inited=1;
+
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1,ENABLE);
+
+	TIM_TimeBaseStructure.TIM_Period=ADC_DMA_PERIOD_MS*10-1;	//10K,ADC_DMA_PERIOD_MS
+	TIM_TimeBaseStructure.TIM_Prescaler=7199;					//72M/7200=10K
+	TIM_TimeBaseStructure.TIM_ClockDivision=TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode=TIM_CounterMode_Up;
+	TIM_TimeBaseStructure.TIM_RepetitionCounter=0;
+	TIM_TimeBaseInit(TIM1,&TIM_TimeBaseStructure);
+
+	TIM_OCInitStructure.TIM_OCMode=TIM_OCMode_PWM1;				//PWMģʽ,ÿڲһCC3¼
+	TIM_OCInitStructure.TIM_OutputState=TIM_OutputState_Enable;
+	TIM_OCInitStructure.TIM_OutputNState=TIM_OutputNState_Disable;
+	TIM_OCInitStructure.TIM_Pulse=ADC_DMA_PERIOD_MS*5;			//ռձ50%
+	TIM_OCInitStructure.TIM_OCPolarity=TIM_OCPolarity_Low;
+	TIM_OCInitStructure.TIM_OCNPolarity=TIM_OCNPolarity_High;
+	TIM_OCInitStructure.TIM_OCIdleState=TIM_OCIdleState_Reset;
+	TIM_OCInitStructure.TIM_OCNIdleState=TIM_OCNIdleState_Reset;
+	TIM_OC3Init(TIM1,&TIM_OCInitStructure);
+
+	TIM_CtrlPWMOutputs(TIM1,ENABLE);	//߼ʱҪʹMOE,CC¼ܴADC
+	TIM_Cmd(TIM1,ENABLE);
+}
 
+//ADCΪTIM1_CC3ĵͨDMAģʽ
+//adcx:ADC1ADC3
+//ch:ֵͨ
+//buf:DMAѭ
+//dma_ch:ӦDMAͨ
+static void Adc_Dma_Start(ADC_TypeDef* adcx,u8 ch,volatile u16* buf,DMA_Channel_TypeDef* dma_ch)
+{
+	ADC_InitTypeDef ADC_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
+	u16 first;
+	u8 t;
 
+	ADC_DeInit(adcx);
+	ADC_InitStructure.ADC_Mode=ADC_Mode_Independent;			//ģʽ
+	ADC_InitStructure.ADC_ScanConvMode=DISABLE;					//ͨģʽ
+	ADC_InitStructure.ADC_ContinuousConvMode=DISABLE;			//ÿδתһ
+	ADC_InitStructure.ADC_ExternalTrigConv=ADC_ExternalTrigConv_None;	//һԤ仺
+	ADC_InitStructure.ADC_DataAlign=ADC_DataAlign_Right;
+	ADC_InitStructure.ADC_NbrOfChannel=1;
+	ADC_Init(adcx,&ADC_InitStructure);
+	ADC_RegularChannelConfig(adcx,ch,1,ADC_SampleTime_239Cycles5);
+
+	ADC_Cmd(adcx,ENABLE);
+	ADC_ResetCalibration(adcx);
+	while(ADC_GetResetCalibrationStatus(adcx));
+	ADC_StartCalibration(adcx);
+	while(ADC_GetCalibrationStatus(adcx));
+
+	//Ԥ:׸DMAڶ0
+	ADC_SoftwareStartConvCmd(adcx,ENABLE);
+	while(!ADC_GetFlagStatus(adcx,ADC_FLAG_EOC));
+	first=ADC_GetConversionValue(adcx);
+	for(t=0;t<ADC_DMA_SAMPLES;t++)buf[t]=first;
+
+	//DMA:ADCݼĴ -> ѭ
+	DMA_DeInit(dma_ch);
+	DMA_InitStructure.DMA_PeripheralBaseAddr=(u32)&adcx->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr=(u32)buf;
+	DMA_InitStructure.DMA_DIR=DMA_DIR_PeripheralSRC;
+	DMA_InitStructure.DMA_BufferSize=ADC_DMA_SAMPLES;
+	DMA_InitStructure.DMA_PeripheralInc=DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc=DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize=DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize=DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode=DMA_Mode_Circular;				//ѭģʽ,дصͷ
+	DMA_InitStructure.DMA_Priority=DMA_Priority_Low;
+	DMA_InitStructure.DMA_M2M=DMA_M2M_Disable;
+	DMA_Init(dma_ch,&DMA_InitStructure);
+	DMA_Cmd(dma_ch,ENABLE);
+
+	//лΪTIM1_CC3ⲿ
+	ADC_InitStructure.ADC_ExternalTrigConv=ADC_ExternalTrigConv_T1_CC3;
+	ADC_Init(adcx,&ADC_InitStructure);
+	ADC_DMACmd(adcx,ENABLE);
+	ADC_ExternalTrigConvCmd(adcx,ENABLE);
+
+	Adc_Dma_Trig_Init();
+}
 
+//DMAѭƽ
+static u16 Adc_Dma_Average(volatile u16* buf)
+{
+	u32 sum=0;
+	u8 t;
+	for(t=0;t<ADC_DMA_SAMPLES;t++)sum+=buf[t];
+	return sum/ADC_DMA_SAMPLES;
+}
 
+//ʼADC1ĳͨDMĄɼ
+//ch:ֵͨ 0~16,ӦΪģ
+void Adc1_Dma_Init(u8 ch)
+{
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1,ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1,ENABLE);
+	RCC_ADCCLKConfig(RCC_PCLK2_Div6);	//72M/6=12M
+	Adc_Dma_Start(ADC1,ch,g_adc1_dma_buf,DMA1_Channel1);
+}
 
+//ʼADC3ĳͨDMĄɼ
+//ch:ֵͨ 0~16,ӦΪģ
+void Adc3_Dma_Init(u8 ch)
+{
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC3,ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA2,ENABLE);
+	RCC_ADCCLKConfig(RCC_PCLK2_Div6);
+	Adc_Dma_Start(ADC3,ch,g_adc3_dma_buf,DMA2_Channel5);
+}
 
+//ȡADC1ADC_DMA_SAMPLESβƽֵ,
+u16 Adc1_Dma_Get_Average(void)
+{
+	return Adc_Dma_Average(g_adc1_dma_buf);
+}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+//ȡADC3ADC_DMA_SAMPLESβƽֵ,
+u16 Adc3_Dma_Get_Average(void)
+{
+	return Adc_Dma_Average(g_adc3_dma_buf);
+}
@@ -23,4 +23,13 @@ u16  T_Get_Adc_Average(u8 ch,u8 times);//
 
 void Adc3_Init(void); 				//ADC3ʼ
 u16  Get_Adc3(u8 ch); 				//ADC3ĳֵͨ   
+
+//ʱ+DMĄɼ
+#define ADC_DMA_SAMPLES		16		//ÿ·ѭ
+#define ADC_DMA_PERIOD_MS	10		//(ms),ƽ=ADC_DMA_SAMPLES*ADC_DMA_PERIOD_MS
+
+void Adc1_Dma_Init(u8 ch);			//ADC1ĳͨDMĄɼʼ
+void Adc3_Dma_Init(u8 ch);			//ADC3ĳͨDMĄɼʼ
+u16  Adc1_Dma_Get_Average(void);	//ȡADC1ƽֵ()
+u16  Adc3_Dma_Get_Average(void);	//ȡADC3ƽֵ()
 #endif 
@@ -21,6 +21,7 @@
 #include "atk_mw8266d.h"
 #include "atk_mw8266d_uart.h"
 #include "delay.h"
+#include "timer.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -62,47 +63,84 @@ void atk_mw8266d_hw_reset(void)
     delay_ms(500);
 }
 
+/******************************************************************************************/
+/* ͬ: ύ첽ָѯֱ (ֻ׶λǵʹ) */
+
+static const atk_mw8266d_at_port_t g_atk_mw8266d_at_port =
+{
+    atk_mw8266d_uart_send,
+    atk_mw8266d_uart_rx_get_frame,
+    atk_mw8266d_uart_rx_restart,
+    atk_mw8266d_uart_rx_flush,
+    millis,
+};
+
+static volatile uint8_t g_sync_done = 0;                        /* ָͬ */
+static uint8_t g_sync_result = ATK_MW8266D_EOK;                 /* ָͬ */
+static uint8_t (*g_sync_parse)(const char *resp, char *out) = NULL;    /* ɹʱӦ */
+static char *g_sync_out = NULL;                                 /*  */
+
 /**
- * @brief       ATK-MW8266DATָ
- * @param       cmd    : ͵ATָ
- *              ack    : ȴӦ
- *              timeout: ȴʱʱ
- * @retval      ATK_MW8266D_EOK     : ִгɹ
- *              ATK_MW8266D_ETIMEOUT: ȴӦʱִʧ
+ * @brief       ָͬɻص
  */
-uint8_t atk_mw8266d_send_at_cmd(char *cmd, char *ack, uint32_t timeout)
+static void at_sync_done(uint8_t result, const char *resp, void *arg)
 {
-    uint8_t *ret = NULL;
+    (void)arg;
     
-    atk_mw8266d_uart_rx_restart();
-    atk_mw8266d_uart_printf("%s\r\n", cmd);
-    
-    if ((ack == NULL) || (timeout == 0))
+    if (result == ATK_MW8266D_AT_EOK && g_sync_parse != NULL && g_sync_parse(resp, g_sync_out) != 0)
     {
-        return ATK_MW8266D_EOK;
+        result = ATK_MW8266D_AT_ERROR;
     }
-    else
+    g_sync_result = result;
+    g_sync_done = 1;
+}
+
+/**
+ * @brief       ȴύָͬ
+ * @param       rejected: ύķֵ (0ʾδ)
+ * @retval      ATK_MW8266D_EOK     : յӦ
+ *              ATK_MW8266D_ERROR   : δӻģӦ
+ *              ATK_MW8266D_ETIMEOUT: ȴӦʱ
+ */
+static uint8_t at_sync_wait(uint8_t rejected)
+{
+    if (rejected != 0)
+    {
+        g_sync_parse = NULL;
+        return ATK_MW8266D_ERROR;
+    }
+    
+    g_sync_done = 0;                /* صֻatk_mw8266d_at_poll()е */
+    while (g_sync_done == 0)
     {
-        while (timeout > 0)
+        atk_mw8266d_at_poll();
+        if (g_sync_done == 0)
         {
-            ret = atk_mw8266d_uart_rx_get_frame();
-            if (ret != NULL)
-            {
-                if (strstr((const char *)ret, ack) != NULL)
-                {
-                    return ATK_MW8266D_EOK;
-                }
-                else
-                {
-                    atk_mw8266d_uart_rx_restart();
-                }
-            }
-            timeout--;
             delay_ms(1);
         }
-        
-        return ATK_MW8266D_ETIMEOUT;
     }
+    g_sync_parse = NULL;
+    
+    return (g_sync_result == ATK_MW8266D_AT_ETIMEOUT) ? ATK_MW8266D_ETIMEOUT :
+           (g_sync_result == ATK_MW8266D_AT_EOK) ? ATK_MW8266D_EOK : ATK_MW8266D_ERROR;
+}
+
+/**
+ * @brief       ATK-MW8266DATָ (ͬ, ȴڼֻѯAT)
+ * @param       cmd    : ͵ATָ
+ *              ack    : ȴӦ
+ *              timeout: ȴʱʱ
+ * @retval      ATK_MW8266D_EOK     : ִгɹ
+ *              ATK_MW8266D_ERROR   : ģӦ󣬺ִʧ
+ *              ATK_MW8266D_ETIMEOUT: ȴӦʱִʧ
+ */
+uint8_t atk_mw8266d_send_at_cmd(char *cmd, char *ack, uint32_t timeout)
+{
+    if (timeout == 0)
+    {
+        ack = NULL;
+    }
+    return at_sync_wait(atk_mw8266d_at_submit(cmd, ack, timeout, at_sync_done, NULL));
 }
 
 /**
@@ -116,6 +154,7 @@ uint8_t atk_mw8266d_init(uint32_t baudrate)
     atk_mw8266d_hw_init();                          /* ATK-MW8266DӲʼ */
     atk_mw8266d_hw_reset();                         /* ATK-MW8266DӲλ */
     atk_mw8266d_uart_init(baudrate);                /* ATK-MW8266D UARTʼ */
+    atk_mw8266d_at_init(&g_atk_mw8266d_at_port);    /* ATָʼ */
     if (atk_mw8266d_at_test() != ATK_MW8266D_EOK)   /* ATK-MW8266D ATָ */
     {
         return ATK_MW8266D_ERROR;
@@ -124,25 +163,214 @@ uint8_t atk_mw8266d_init(uint32_t baudrate)
     return ATK_MW8266D_EOK;
 }
 
+/******************************************************************************************/
+/* 첽ӿ: ύָ, ͨص֪ͨ; ֵ 0: 1: */
+
 /**
- * @brief       ATK-MW8266Dָ
- * @param       
- * @retval      ATK_MW8266D_EOK  : ָóɹ
- *              ATK_MW8266D_ERROR: ָʧ
+ * @brief       ATK-MW8266Dָ (ȴģɵready)
  */
-uint8_t atk_mw8266d_restore(void)
+uint8_t atk_mw8266d_restore_async(atk_mw8266d_at_done_t done, void *arg)
 {
-    uint8_t ret;
+    return atk_mw8266d_at_submit("AT+RESTORE", "ready", 3000, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266D ATָ ()
+ */
+uint8_t atk_mw8266d_at_test_async(atk_mw8266d_at_done_t done, void *arg)
+{
+    return atk_mw8266d_at_submit("AT", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266Dģʽ
+ * @param       mode: 1Stationģʽ
+ *                    2APģʽ
+ *                    3AP+Stationģʽ
+ */
+uint8_t atk_mw8266d_set_mode_async(uint8_t mode, atk_mw8266d_at_done_t done, void *arg)
+{
+    char cmd[16];
     
-    ret = atk_mw8266d_send_at_cmd("AT+RESTORE", "ready", 3000);
-    if (ret == ATK_MW8266D_EOK)
+    if ((mode < 1) || (mode > 3))
     {
-        return ATK_MW8266D_EOK;
+        return 1;
     }
-    else
+    sprintf(cmd, "AT+CWMODE=%d", mode);
+    return atk_mw8266d_at_submit(cmd, "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266Dλ (ӦOKģ黹Լ1ָܽ)
+ */
+uint8_t atk_mw8266d_sw_reset_async(atk_mw8266d_at_done_t done, void *arg)
+{
+    return atk_mw8266d_at_submit("AT+RST", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266Dûģʽ
+ * @param       cfg: 0رջ
+ *                   1򿪻
+ */
+uint8_t atk_mw8266d_ate_config_async(uint8_t cfg, atk_mw8266d_at_done_t done, void *arg)
+{
+    if (cfg > 1)
+    {
+        return 1;
+    }
+    return atk_mw8266d_at_submit(cfg ? "ATE1" : "ATE0", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266DWIFI
+ * @param       ssid: WIFI
+ *              pwd : WIFI
+ */
+uint8_t atk_mw8266d_join_ap_async(char *ssid, char *pwd, atk_mw8266d_at_done_t done, void *arg)
+{
+    char cmd[ATK_MW8266D_AT_CMD_MAX + 1];
+    
+    snprintf(cmd, sizeof(cmd), "AT+CWJAP=\"%s\",\"%s\"", ssid, pwd);
+    return atk_mw8266d_at_submit(cmd, "WIFI GOT IP", 10000, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266DѯǰӵWIFI (AT+CWJAP?), Ӧatk_mw8266d_parse_ap()
+ */
+uint8_t atk_mw8266d_query_ap_async(atk_mw8266d_at_done_t done, void *arg)
+{
+    return atk_mw8266d_at_submit("AT+CWJAP?", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266DϵԶѱWIFI (ģFlash)
+ * @param       en: 0رԶ
+ *                  1Զ
+ */
+uint8_t atk_mw8266d_set_autoconn_async(uint8_t en, atk_mw8266d_at_done_t done, void *arg)
+{
+    return atk_mw8266d_at_submit(en ? "AT+CWAUTOCONN=1" : "AT+CWAUTOCONN=0", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266DȡIPַ (AT+CIFSR), Ӧatk_mw8266d_parse_ip()
+ */
+uint8_t atk_mw8266d_get_ip_async(atk_mw8266d_at_done_t done, void *arg)
+{
+    return atk_mw8266d_at_submit("AT+CIFSR", "OK", 500, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266DTCP
+ * @param       server_ip  : TCPIPַ
+ *              server_port: TCP˿ں
+ */
+uint8_t atk_mw8266d_connect_tcp_server_async(char *server_ip, char *server_port, atk_mw8266d_at_done_t done, void *arg)
+{
+    char cmd[64];
+    
+    sprintf(cmd, "AT+CIPSTART=\"TCP\",\"%s\",%s", server_ip, server_port);
+    return atk_mw8266d_at_submit(cmd, "CONNECT", 5000, done, arg);
+}
+
+/**
+ * @brief       ATK-MW8266D͸ (ָһ, صڵڶʱ)
+ */
+uint8_t atk_mw8266d_enter_unvarnished_async(atk_mw8266d_at_done_t done, void *arg)
+{
+    if (atk_mw8266d_at_submit("AT+CIPMODE=1", "OK", 500, NULL, NULL) != 0)
+    {
+        return 1;
+    }
+    return atk_mw8266d_at_submit("AT+CIPSEND", ">", 500, done, arg);
+}
+
+/******************************************************************************************/
+/* Ӧ */
+
+/**
+ * @brief       AT+CWJAP?Ӧ
+ * @param       resp: Ӧı
+ *              ssid: ǰӵWIFI, Ҫ33ֽڴռ
+ * @retval      ATK_MW8266D_EOK  : WIFI
+ *              ATK_MW8266D_ERROR: δWIFI (No AP)
+ */
+uint8_t atk_mw8266d_parse_ap(const char *resp, char *ssid)
+{
+    const char *p_start;
+    const char *p_end;
+    size_t len;
+    
+    /* ʱӦΪ +CWJAP:"ssid","bssid",channel,rssi */
+    p_start = strstr(resp, "+CWJAP:\"");
+    if (p_start == NULL)
+    {
+        return ATK_MW8266D_ERROR;
+    }
+    p_start += 8;
+    p_end = strstr(p_start, "\"");
+    if (p_end == NULL)
     {
         return ATK_MW8266D_ERROR;
     }
+    len = p_end - p_start;
+    if (len > 32)
+    {
+        len = 32;
+    }
+    strncpy(ssid, p_start, len);
+    ssid[len] = '\0';
+    
+    return ATK_MW8266D_EOK;
+}
+
+/**
+ * @brief       AT+CIFSRӦ (һΪStation IP)
+ * @param       resp: Ӧı
+ *              buf : IPַҪ16ֽڴռ
+ * @retval      ATK_MW8266D_EOK  : ɹ
+ *              ATK_MW8266D_ERROR: Ӧʽ
+ */
+uint8_t atk_mw8266d_parse_ip(const char *resp, char *buf)
+{
+    const char *p_start;
+    const char *p_end;
+    size_t len;
+    
+    p_start = strstr(resp, "\"");
+    if (p_start == NULL)
+    {
+        return ATK_MW8266D_ERROR;
+    }
+    p_end = strstr(p_start + 1, "\"");
+    if (p_end == NULL)
+    {
+        return ATK_MW8266D_ERROR;
+    }
+    len = p_end - p_start - 1;
+    if (len > 15)
+    {
+        len = 15;
+    }
+    strncpy(buf, p_start + 1, len);
+    buf[len] = '\0';
+    
+    return ATK_MW8266D_EOK;
+}
+
+/******************************************************************************************/
+/* ͬӿ: 첽ӿڵװ */
+
+/**
+ * @brief       ATK-MW8266Dָ
+ * @param       
+ * @retval      ATK_MW8266D_EOK  : ָóɹ
+ *              ATK_MW8266D_ERROR: ָʧ
+ */
+uint8_t atk_mw8266d_restore(void)
+{
+    return at_sync_wait(atk_mw8266d_restore_async(at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -153,13 +381,11 @@ uint8_t atk_mw8266d_restore(void)
  */
 uint8_t atk_mw8266d_at_test(void)
 {
-    uint8_t ret;
     uint8_t i;
     
     for (i=0; i<10; i++)
     {
-        ret = atk_mw8266d_send_at_cmd("AT", "OK", 500);
-        if (ret == ATK_MW8266D_EOK)
+        if (at_sync_wait(atk_mw8266d_at_test_async(at_sync_done, NULL)) == ATK_MW8266D_EOK)
         {
             return ATK_MW8266D_EOK;
         }
@@ -179,39 +405,11 @@ uint8_t atk_mw8266d_at_test(void)
  */
 uint8_t atk_mw8266d_set_mode(uint8_t mode)
 {
-    uint8_t ret;
-    
-    switch (mode)
-    {
-        case 1:
-        {
-            ret = atk_mw8266d_send_at_cmd("AT+CWMODE=1", "OK", 500);    /* Stationģʽ */
-            break;
-        }
-        case 2:
-        {
-            ret = atk_mw8266d_send_at_cmd("AT+CWMODE=2", "OK", 500);    /* APģʽ */
-            break;
-        }
-        case 3:
-        {
-            ret = atk_mw8266d_send_at_cmd("AT+CWMODE=3", "OK", 500);    /* AP+Stationģʽ */
-            break;
-        }
-        default:
-        {
-            return ATK_MW8266D_EINVAL;
-        }
-    }
-    
-    if (ret == ATK_MW8266D_EOK)
+    if ((mode < 1) || (mode > 3))
     {
-        return ATK_MW8266D_EOK;
-    }
-    else
-    {
-        return ATK_MW8266D_ERROR;
+        return ATK_MW8266D_EINVAL;
     }
+    return at_sync_wait(atk_mw8266d_set_mode_async(mode, at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -222,18 +420,12 @@ uint8_t atk_mw8266d_set_mode(uint8_t mode)
  */
 uint8_t atk_mw8266d_sw_reset(void)
 {
-    uint8_t ret;
-    
-    ret = atk_mw8266d_send_at_cmd("AT+RST", "OK", 500);
-    if (ret == ATK_MW8266D_EOK)
-    {
-        delay_ms(1000);
-        return ATK_MW8266D_EOK;
-    }
-    else
+    if (at_sync_wait(atk_mw8266d_sw_reset_async(at_sync_done, NULL)) != ATK_MW8266D_EOK)
     {
         return ATK_MW8266D_ERROR;
     }
+    delay_ms(1000);
+    return ATK_MW8266D_EOK;
 }
 
 /**
@@ -242,37 +434,15 @@ uint8_t atk_mw8266d_sw_reset(void)
  *                   1򿪻
  * @retval      ATK_MW8266D_EOK  : ûģʽɹ
  *              ATK_MW8266D_ERROR: ûģʽʧ
+ *              ATK_MW8266D_EINVAL: cfg
  */
 uint8_t atk_mw8266d_ate_config(uint8_t cfg)
 {
-    uint8_t ret;
-    
-    switch (cfg)
-    {
-        case 0:
-        {
-            ret = atk_mw8266d_send_at_cmd("ATE0", "OK", 500);   /* رջ */
-            break;
-        }
-        case 1:
-        {
-            ret = atk_mw8266d_send_at_cmd("ATE1", "OK", 500);   /* 򿪻 */
-            break;
-        }
-        default:
-        {
-            return ATK_MW8266D_EINVAL;
-        }
-    }
-    
-    if (ret == ATK_MW8266D_EOK)
-    {
-        return ATK_MW8266D_EOK;
-    }
-    else
+    if (cfg > 1)
     {
-        return ATK_MW8266D_ERROR;
+        return ATK_MW8266D_EINVAL;
     }
+    return at_sync_wait(atk_mw8266d_ate_config_async(cfg, at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -284,19 +454,32 @@ uint8_t atk_mw8266d_ate_config(uint8_t cfg)
  */
 uint8_t atk_mw8266d_join_ap(char *ssid, char *pwd)
 {
-    uint8_t ret;
-    char cmd[64];
-    
-    sprintf(cmd, "AT+CWJAP=\"%s\",\"%s\"", ssid, pwd);
-    ret = atk_mw8266d_send_at_cmd(cmd, "WIFI GOT IP", 10000);
-    if (ret == ATK_MW8266D_EOK)
-    {
-        return ATK_MW8266D_EOK;
-    }
-    else
-    {
-        return ATK_MW8266D_ERROR;
-    }
+    return at_sync_wait(atk_mw8266d_join_ap_async(ssid, pwd, at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
+}
+
+/**
+ * @brief       ATK-MW8266DѯǰӵWIFI (AT+CWJAP?)
+ * @param       ssid: ǰӵWIFI, Ҫ33ֽڴռ
+ * @retval      ATK_MW8266D_EOK  : WIFI
+ *              ATK_MW8266D_ERROR: δWIFI (No AP) ѯʧ
+ */
+uint8_t atk_mw8266d_query_ap(char *ssid)
+{
+    g_sync_parse = atk_mw8266d_parse_ap;
+    g_sync_out = ssid;
+    return at_sync_wait(atk_mw8266d_query_ap_async(at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
+}
+
+/**
+ * @brief       ATK-MW8266DϵԶѱWIFI (ģFlash)
+ * @param       en: 0رԶ
+ *                  1Զ
+ * @retval      ATK_MW8266D_EOK  : óɹ
+ *              ATK_MW8266D_ERROR: ʧ
+ */
+uint8_t atk_mw8266d_set_autoconn(uint8_t en)
+{
+    return at_sync_wait(atk_mw8266d_set_autoconn_async(en, at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -307,21 +490,9 @@ uint8_t atk_mw8266d_join_ap(char *ssid, char *pwd)
  */
 uint8_t atk_mw8266d_get_ip(char *buf)
 {
-    uint8_t ret;
-    char *p_start;
-    char *p_end;
-    ret = atk_mw8266d_send_at_cmd("AT+CIFSR", "OK", 500);
-    if (ret != ATK_MW8266D_EOK)
-    {
-        return ATK_MW8266D_ERROR;
-    }
-    p_start = strstr((const char *)atk_mw8266d_uart_rx_get_frame(), "\"");
-    p_end = strstr(p_start + 1, "\"");
-		size_t len = p_end - p_start - 1;
-		strncpy(buf, p_start + 1, len);
-		buf[len] = '\0'; // ȷַ '\0' β
-    printf("ip:%s",buf);
-    return ATK_MW8266D_EOK;
+    g_sync_parse = atk_mw8266d_parse_ip;
+    g_sync_out = buf;
+    return at_sync_wait(atk_mw8266d_get_ip_async(at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -333,19 +504,8 @@ uint8_t atk_mw8266d_get_ip(char *buf)
  */
 uint8_t atk_mw8266d_connect_tcp_server(char *server_ip, char *server_port)
 {
-    uint8_t ret;
-    char cmd[64];
-    
-    sprintf(cmd, "AT+CIPSTART=\"TCP\",\"%s\",%s", server_ip, server_port);
-    ret = atk_mw8266d_send_at_cmd(cmd, "CONNECT", 5000);
-    if (ret == ATK_MW8266D_EOK)
-    {
-        return ATK_MW8266D_EOK;
-    }
-    else
-    {
-        return ATK_MW8266D_ERROR;
-    }
+    return at_sync_wait(atk_mw8266d_connect_tcp_server_async(server_ip, server_port, at_sync_done, NULL)) ?
+           ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -356,18 +516,7 @@ uint8_t atk_mw8266d_connect_tcp_server(char *server_ip, char *server_port)
  */
 uint8_t atk_mw8266d_enter_unvarnished(void)
 {
-    uint8_t ret;
-    
-    ret  = atk_mw8266d_send_at_cmd("AT+CIPMODE=1", "OK", 500);
-    ret += atk_mw8266d_send_at_cmd("AT+CIPSEND", ">", 500);
-    if (ret == ATK_MW8266D_EOK)
-    {
-        return ATK_MW8266D_EOK;
-    }
-    else
-    {
-        return ATK_MW8266D_ERROR;
-    }
+    return at_sync_wait(atk_mw8266d_enter_unvarnished_async(at_sync_done, NULL)) ? ATK_MW8266D_ERROR : ATK_MW8266D_EOK;
 }
 
 /**
@@ -23,6 +23,7 @@
 #define __ATK_MW8266D_H
 
 #include "stm32f10x.h"
+#include "atk_mw8266d_at.h"
 
 /* Ŷ */
 #define ATK_MW8266D_RST_GPIO_PORT           GPIOA
@@ -49,6 +50,8 @@ uint8_t atk_mw8266d_set_mode(uint8_t mode);                                 /* 
 uint8_t atk_mw8266d_sw_reset(void);                                         /* ATK-MW8266Dλ */
 uint8_t atk_mw8266d_ate_config(uint8_t cfg);                                /* ATK-MW8266Dûģʽ */
 uint8_t atk_mw8266d_join_ap(char *ssid, char *pwd);                         /* ATK-MW8266DWIFI */
+uint8_t atk_mw8266d_query_ap(char *ssid);                                  /* ATK-MW8266DѯǰӵWIFI */
+uint8_t atk_mw8266d_set_autoconn(uint8_t en);                              /* ATK-MW8266DϵԶWIFI */
 uint8_t atk_mw8266d_get_ip(char *buf);                                      /* ATK-MW8266DȡIPַ */
 uint8_t atk_mw8266d_connect_tcp_server(char *server_ip, char *server_port); /* ATK-MW8266DTCP */
 uint8_t atk_mw8266d_enter_unvarnished(void);                                /* ATK-MW8266D͸ */
@@ -56,4 +59,22 @@ void atk_mw8266d_exit_unvarnished(void);                                    /* A
 uint8_t atk_mw8266d_connect_atkcld(char *id, char *pwd);                    /* ATK-MW8266DԭƷ */
 uint8_t atk_mw8266d_disconnect_atkcld(void);                                /* ATK-MW8266DϿԭƷ */
 
+/* 첽 (ύ, ͨص֪ͨ;  0: 1:) */
+uint8_t atk_mw8266d_restore_async(atk_mw8266d_at_done_t done, void *arg);                       /* ָ */
+uint8_t atk_mw8266d_at_test_async(atk_mw8266d_at_done_t done, void *arg);                       /* ATָ () */
+uint8_t atk_mw8266d_set_mode_async(uint8_t mode, atk_mw8266d_at_done_t done, void *arg);        /* ùģʽ */
+uint8_t atk_mw8266d_sw_reset_async(atk_mw8266d_at_done_t done, void *arg);                      /* λ */
+uint8_t atk_mw8266d_ate_config_async(uint8_t cfg, atk_mw8266d_at_done_t done, void *arg);       /* ûģʽ */
+uint8_t atk_mw8266d_join_ap_async(char *ssid, char *pwd, atk_mw8266d_at_done_t done, void *arg);    /* WIFI */
+uint8_t atk_mw8266d_query_ap_async(atk_mw8266d_at_done_t done, void *arg);                      /* ѯǰӵWIFI */
+uint8_t atk_mw8266d_set_autoconn_async(uint8_t en, atk_mw8266d_at_done_t done, void *arg);      /* ϵԶWIFI */
+uint8_t atk_mw8266d_get_ip_async(atk_mw8266d_at_done_t done, void *arg);                        /* ȡIPַ */
+uint8_t atk_mw8266d_connect_tcp_server_async(char *server_ip, char *server_port,
+                                             atk_mw8266d_at_done_t done, void *arg);            /* TCP */
+uint8_t atk_mw8266d_enter_unvarnished_async(atk_mw8266d_at_done_t done, void *arg);             /* ͸ */
+
+/* Ӧ */
+uint8_t atk_mw8266d_parse_ap(const char *resp, char *ssid);                 /* AT+CWJAP?Ӧ, ssid33ֽ */
+uint8_t atk_mw8266d_parse_ip(const char *resp, char *buf);                  /* AT+CIFSRӦ, buf16ֽ */
+
 #endif
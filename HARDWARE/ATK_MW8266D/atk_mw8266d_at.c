@@ -0,0 +1,255 @@
+/**
+ ****************************************************************************************************
+ * @file        atk_mw8266d_at.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       ATK-MW8266D异步AT指令引擎实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ ****************************************************************************************************
+ */
+
+#include "atk_mw8266d_at.h"
+#include <string.h>
+
+/* 队列中的一条指令 */
+typedef struct
+{
+    char cmd[ATK_MW8266D_AT_CMD_MAX + 3];   /* 指令, 入队时已追加\r\n */
+    uint8_t len;                            /* 含\r\n的长度 */
+    const char *ack;                        /* 期望应答 (需长期有效), NULL表示发送后立即完成 */
+    uint32_t timeout;                       /* 超时时间 (ms) */
+    atk_mw8266d_at_done_t done;             /* 完成回调, 可为NULL */
+    void *arg;                              /* 回调参数 */
+} atk_mw8266d_at_entry_t;
+
+static const atk_mw8266d_at_port_t *g_at_port = NULL;
+static atk_mw8266d_at_entry_t g_at_queue[ATK_MW8266D_AT_QUEUE_SIZE];
+static uint8_t g_at_head = 0;                           /* 队首 (正在执行或下一条) */
+static uint8_t g_at_count = 0;                          /* 队列中的指令数 */
+static uint8_t g_at_active = 0;                         /* 1: 队首指令已发送, 等待应答 */
+static uint32_t g_at_start = 0;                         /* 队首指令发送时间 */
+static char g_at_resp[ATK_MW8266D_AT_RESP_MAX];         /* 队首指令的应答 */
+static uint16_t g_at_resp_len = 0;
+static atk_mw8266d_at_stats_t g_at_stats = {0};
+
+/**
+ * @brief       结束队首指令并调用完成回调
+ * @param       result: 完成结果
+ * @retval      无
+ */
+static void at_finish(uint8_t result)
+{
+    atk_mw8266d_at_done_t done = g_at_queue[g_at_head].done;
+    void *arg = g_at_queue[g_at_head].arg;
+    uint32_t elapsed = g_at_active ? g_at_port->now_ms() - g_at_start : 0;
+
+    /* 先出队, 回调中可以继续提交指令 */
+    g_at_head = (g_at_head + 1) % ATK_MW8266D_AT_QUEUE_SIZE;
+    g_at_count--;
+    g_at_active = 0;
+
+    if (elapsed > g_at_stats.max_ms)
+    {
+        g_at_stats.max_ms = elapsed;
+    }
+    switch (result)
+    {
+        case ATK_MW8266D_AT_EOK:      g_at_stats.ok++;       break;
+        case ATK_MW8266D_AT_ERROR:    g_at_stats.errors++;   break;
+        case ATK_MW8266D_AT_ETIMEOUT: g_at_stats.timeouts++; break;
+        default:                      g_at_stats.aborted++;  break;
+    }
+
+    if (done != NULL)
+    {
+        done(result, g_at_resp, arg);
+    }
+}
+
+/**
+ * @brief       发送队首指令
+ * @note        指令和\r\n一次入队, 发送队列空间不足时整条不发, 不会只发出半条指令
+ * @retval      0: 已发送 1: 发送队列已满, 下次再试
+ */
+static uint8_t at_start(void)
+{
+    atk_mw8266d_at_entry_t *e = &g_at_queue[g_at_head];
+
+    g_at_port->rx_flush();                  /* 丢弃之前未读的帧，避免旧应答被误匹配 */
+    if (g_at_port->send((const uint8_t *)e->cmd, e->len) != 0)
+    {
+        return 1;
+    }
+
+    g_at_active = 1;
+    g_at_start = g_at_port->now_ms();
+    g_at_resp_len = 0;
+    g_at_resp[0] = '\0';
+    return 0;
+}
+
+/**
+ * @brief       处理队首指令的应答
+ * @retval      0: 仍在等待 1: 已完成
+ */
+static uint8_t at_process(void)
+{
+    const char *ack = g_at_queue[g_at_head].ack;
+    char *frame;
+    uint16_t len;
+    uint8_t result = 0xFF;
+
+    if (ack == NULL)
+    {
+        at_finish(ATK_MW8266D_AT_EOK);
+        return 1;
+    }
+
+    while (result == 0xFF && (frame = (char *)g_at_port->rx_get_frame()) != NULL)
+    {
+        /* 拼接到应答缓冲, 用于回调解析和跨帧匹配 */
+        len = strlen(frame);
+        if (len > ATK_MW8266D_AT_RESP_MAX - 1 - g_at_resp_len)
+        {
+            len = ATK_MW8266D_AT_RESP_MAX - 1 - g_at_resp_len;
+        }
+        memcpy(&g_at_resp[g_at_resp_len], frame, len);
+        g_at_resp_len += len;
+        g_at_resp[g_at_resp_len] = '\0';
+
+        if (strstr(frame, ack) != NULL || strstr(g_at_resp, ack) != NULL)
+        {
+            result = ATK_MW8266D_AT_EOK;
+        }
+        else if (strstr(frame, "ERROR") != NULL || strstr(frame, "FAIL") != NULL)
+        {
+            result = ATK_MW8266D_AT_ERROR;
+        }
+        g_at_port->rx_release();
+    }
+
+    if (result == 0xFF)
+    {
+        if (g_at_port->now_ms() - g_at_start < g_at_queue[g_at_head].timeout)
+        {
+            return 0;
+        }
+        result = ATK_MW8266D_AT_ETIMEOUT;
+    }
+
+    at_finish(result);
+    return 1;
+}
+
+/**
+ * @brief       初始化引擎并清空队列 (不调用未完成指令的回调)
+ * @param       port: 硬件接口 (需长期有效)
+ * @retval      无
+ */
+void atk_mw8266d_at_init(const atk_mw8266d_at_port_t *port)
+{
+    g_at_port = port;
+    g_at_head = 0;
+    g_at_count = 0;
+    g_at_active = 0;
+    memset(&g_at_stats, 0, sizeof(g_at_stats));
+}
+
+/**
+ * @brief       提交指令
+ * @param       cmd    : AT指令 (不含\r\n, 会被复制)
+ *              ack    : 期望应答 (需长期有效, 通常为字符串常量), NULL表示发送后立即完成
+ *              timeout: 从发送开始计算的超时时间 (ms)
+ *              done   : 完成回调, 可为NULL
+ *              arg    : 回调参数
+ * @retval      0: 已入队 1: 队列已满、指令过长或引擎未初始化
+ */
+uint8_t atk_mw8266d_at_submit(const char *cmd, const char *ack, uint32_t timeout,
+                              atk_mw8266d_at_done_t done, void *arg)
+{
+    atk_mw8266d_at_entry_t *e;
+    uint16_t len = strlen(cmd);
+
+    if (g_at_port == NULL || g_at_count >= ATK_MW8266D_AT_QUEUE_SIZE || len > ATK_MW8266D_AT_CMD_MAX)
+    {
+        g_at_stats.rejected++;
+        return 1;
+    }
+
+    e = &g_at_queue[(g_at_head + g_at_count) % ATK_MW8266D_AT_QUEUE_SIZE];
+    memcpy(e->cmd, cmd, len);
+    memcpy(&e->cmd[len], "\r\n", 3);
+    e->len = (uint8_t)(len + 2);
+    e->ack = ack;
+    e->timeout = timeout;
+    e->done = done;
+    e->arg = arg;
+    g_at_count++;
+    g_at_stats.submitted++;
+    return 0;
+}
+
+/**
+ * @brief       推进引擎: 发送队首指令、匹配应答、检查超时, 一条指令完成后立即开始下一条
+ * @param       无
+ * @retval      无
+ */
+void atk_mw8266d_at_poll(void)
+{
+    uint8_t n;
+
+    for (n = 0; n < ATK_MW8266D_AT_QUEUE_SIZE && g_at_count > 0; n++)
+    {
+        if (!g_at_active && at_start() != 0)
+        {
+            return;
+        }
+        if (at_process() == 0)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief       是否有未完成的指令
+ * @param       无
+ * @retval      0: 空闲 1: 忙
+ */
+uint8_t atk_mw8266d_at_busy(void)
+{
+    return g_at_count > 0;
+}
+
+/**
+ * @brief       取消所有未完成的指令, 依次以ATK_MW8266D_AT_EABORT调用其回调
+ * @param       无
+ * @retval      无
+ */
+void atk_mw8266d_at_abort(void)
+{
+    uint8_t n = g_at_count;
+
+    g_at_resp_len = 0;
+    g_at_resp[0] = '\0';
+    while (n-- > 0 && g_at_count > 0)
+    {
+        at_finish(ATK_MW8266D_AT_EABORT);
+    }
+}
+
+/**
+ * @brief       获取统计
+ * @param       stats: 统计信息输出
+ * @retval      无
+ */
+void atk_mw8266d_at_get_stats(atk_mw8266d_at_stats_t *stats)
+{
+    *stats = g_at_stats;
+    stats->pending = g_at_count;
+}
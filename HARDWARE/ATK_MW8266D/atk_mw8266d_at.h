@@ -0,0 +1,75 @@
+/**
+ ****************************************************************************************************
+ * @file        atk_mw8266d_at.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       ATK-MW8266D异步AT指令引擎
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: 正点原子 STM32F103开发板
+ *
+ * 说明:
+ * - AT指令连同期望应答、超时时间和完成回调放入队列, 按顺序逐条发送
+ * - atk_mw8266d_at_poll()由主调度器周期调用: 发送队首指令, 从UART接收帧队列取出应答逐帧匹配,
+ *   收到期望应答、ERROR/FAIL或超时即调用完成回调并开始下一条, 从不阻塞等待
+ * - 回调中可以继续提交指令 (用于串联多步操作), 但不能调用同步接口
+ * - 空闲时不读取接收帧, 透传模式下的服务器数据仍由上层直接读取
+ * - 本模块不依赖任何硬件, 收发和时钟通过atk_mw8266d_at_port_t注入, 可在主机下对接模拟的ESP8266测试
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ATK_MW8266D_AT_H
+#define __ATK_MW8266D_AT_H
+
+#include <stdint.h>
+
+/* 配置参数 */
+#define ATK_MW8266D_AT_QUEUE_SIZE       4       /* 待发送指令队列深度 (含正在执行的) */
+#define ATK_MW8266D_AT_CMD_MAX          80      /* 单条指令最大长度 (不含\r\n) */
+#define ATK_MW8266D_AT_RESP_MAX         128     /* 应答缓冲 (同一条指令的多帧应答依次拼接, 超出部分截断) */
+
+/* 完成结果 (与ATK_MW8266D_EOK/ERROR/ETIMEOUT取值一致) */
+#define ATK_MW8266D_AT_EOK              0       /* 收到期望应答 */
+#define ATK_MW8266D_AT_ERROR            1       /* 模块应答ERROR或FAIL */
+#define ATK_MW8266D_AT_ETIMEOUT         2       /* 等待期望应答超时 */
+#define ATK_MW8266D_AT_EABORT           4       /* 被atk_mw8266d_at_abort()取消 */
+
+/* 完成回调: resp为该指令收到的全部应答文本, 仅在回调期间有效 */
+typedef void (*atk_mw8266d_at_done_t)(uint8_t result, const char *resp, void *arg);
+
+/* 硬件接口 */
+typedef struct
+{
+    uint8_t (*send)(const uint8_t *data, uint16_t len);     /* 非阻塞发送, 0:成功 */
+    uint8_t *(*rx_get_frame)(void);                         /* 获取一帧接收数据 ('\0'结尾), NULL:无 */
+    void (*rx_release)(void);                               /* 释放当前帧 */
+    void (*rx_flush)(void);                                 /* 丢弃所有未读帧 */
+    uint32_t (*now_ms)(void);                               /* 毫秒时钟 */
+} atk_mw8266d_at_port_t;
+
+/* 统计信息 */
+typedef struct
+{
+    uint32_t submitted;         /* 已提交指令数 */
+    uint32_t rejected;          /* 队列满或指令过长被拒绝的次数 */
+    uint32_t ok;                /* 收到期望应答的指令数 */
+    uint32_t errors;            /* 应答ERROR/FAIL的指令数 */
+    uint32_t timeouts;          /* 超时的指令数 */
+    uint32_t aborted;           /* 被取消的指令数 */
+    uint32_t max_ms;            /* 单条指令从发送到完成的最长时间 */
+    uint8_t  pending;           /* 当前队列中的指令数 (含正在执行的) */
+} atk_mw8266d_at_stats_t;
+
+/* 操作函数 */
+void atk_mw8266d_at_init(const atk_mw8266d_at_port_t *port);    /* 初始化引擎并清空队列 */
+uint8_t atk_mw8266d_at_submit(const char *cmd, const char *ack, uint32_t timeout,
+                              atk_mw8266d_at_done_t done, void *arg);   /* 提交指令 */
+void atk_mw8266d_at_poll(void);                                 /* 推进引擎 (主调度器周期调用) */
+uint8_t atk_mw8266d_at_busy(void);                              /* 是否有未完成的指令 */
+void atk_mw8266d_at_abort(void);                                /* 取消所有未完成的指令 */
+void atk_mw8266d_at_get_stats(atk_mw8266d_at_stats_t *stats);   /* 获取统计 */
+
+#endif
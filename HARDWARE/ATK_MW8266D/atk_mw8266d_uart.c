@@ -17,68 +17,340 @@
 
 static struct
 {
-    uint8_t buf[ATK_MW8266D_UART_RX_BUF_SIZE];              /* ֡ջ */
+    uint8_t buf[ATK_MW8266D_UART_RX_BUF_SIZE];              /* ǰ֡Ի壨'\0'β */
+    uint16_t len;                                           /* ǰ֡ */
+    uint8_t hold;                                           /* Ƿһ֡δͷ */
+} g_uart_rx_frame = {0};                                    /* ATK-MW8266D UARTǰ֡ */
+
+static struct
+{
+    uint8_t buf[ATK_MW8266D_UART_RX_RING_SIZE];             /* DMAѭջ */
+    uint16_t dma_pos;                                       /* ϴδDMAдλ */
+    volatile uint32_t total;                                /* ۼƽֽλеľλã */
+    uint32_t frame_start;                                   /* ڽյ֡ʼλ */
     struct
     {
-        uint16_t len    : 15;                               /* ֡ճȣsta[14:0] */
-        uint16_t finsh  : 1;                                /* ֡ɱ־sta[15] */
-    } sta;                                                  /* ֡״̬Ϣ */
-} g_uart_rx_frame = {0};                                    /* ATK-MW8266D UART֡Ϣṹ */
+        uint32_t start;                                     /* ֡ʼλ */
+        uint16_t len;                                       /* ֡ */
+    } desc[ATK_MW8266D_UART_RX_QUEUE_SIZE];                 /* ֡ */
+    volatile uint8_t head;                                  /* дλãж޸ */
+    volatile uint8_t tail;                                  /* λãѭ޸ */
+    atk_mw8266d_uart_rx_stats_t stats;                      /* ͳ */
+} g_uart_rx_ring = {0};                                     /* ATK-MW8266D UART DMAն */
 
-static uint8_t g_uart_tx_buf[ATK_MW8266D_UART_TX_BUF_SIZE]; /* ATK-MW8266D UARTͻ */
+static uint8_t g_uart_tx_buf[ATK_MW8266D_UART_TX_BUF_SIZE]; /* ATK-MW8266D UART printfʽ */
+
+static atk_mw8266d_uart_rx_cb_t g_uart_rx_cb = NULL;        /* ֡¼ص (же) */
+
+static struct
+{
+    uint8_t buf[ATK_MW8266D_UART_TX_RING_SIZE];             /* ͻλ */
+    volatile uint16_t head;                                 /* дλã޸ */
+    volatile uint16_t tail;                                 /* λãDMAж޸ */
+    volatile uint16_t dma_len;                              /* ǰDMA䳤ȣ0ʾDMA */
+    atk_mw8266d_uart_tx_stats_t stats;                      /* ͳ */
+} g_uart_tx_ring = {0};                                     /* ATK-MW8266D UART DMAͶ */
 
 /**
- * @brief       ATK-MW8266D UART printf
- * @param       fmt: ӡ
+ * @brief       Ͷֽ
+ * @param       
+ * @retval      ֽ
+ */
+static uint16_t uart_tx_used(void)
+{
+    return (uint16_t)((g_uart_tx_ring.head - g_uart_tx_ring.tail + ATK_MW8266D_UART_TX_RING_SIZE) % ATK_MW8266D_UART_TX_RING_SIZE);
+}
+
+/**
+ * @brief       DMAҶзǿʱһݵķ
+ * @note        DMAжлDMAжϺ
+ * @param       
  * @retval      
  */
-void atk_mw8266d_uart_printf(char *fmt, ...)
+static void uart_tx_dma_kick(void)
 {
-    va_list ap;
+    uint16_t head = g_uart_tx_ring.head;
+    uint16_t tail = g_uart_tx_ring.tail;
     uint16_t len;
 
+    if ((g_uart_tx_ring.dma_len != 0) || (head == tail))
+    {
+        return;
+    }
+
+    /* ֻ͵ĩβƲһжз */
+    len = (head > tail) ? (head - tail) : (ATK_MW8266D_UART_TX_RING_SIZE - tail);
+    g_uart_tx_ring.dma_len = len;
+
+    DMA_Cmd(ATK_MW8266D_UART_TX_DMA_CHANNEL, DISABLE);
+    ATK_MW8266D_UART_TX_DMA_CHANNEL->CMAR = (uint32_t)&g_uart_tx_ring.buf[tail];
+    ATK_MW8266D_UART_TX_DMA_CHANNEL->CNDTR = len;
+    DMA_Cmd(ATK_MW8266D_UART_TX_DMA_CHANNEL, ENABLE);
+}
+
+/**
+ * @brief       ATK-MW8266D UARTݣ
+ * @note        忽ͶкأDMAں̨ͣ
+ *              ʣռ䲻ʱֻܾ֡Ͱ֡
+ * @param       data: ͵
+ *              len : ݳ
+ * @retval      0: 
+ *              1: пռ䲻㣬ݱܾ
+ */
+uint8_t atk_mw8266d_uart_send(const uint8_t *data, uint16_t len)
+{
+    uint16_t head, first, used;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    if (len > atk_mw8266d_uart_tx_free())
+    {
+        g_uart_tx_ring.stats.rejected++;
+        g_uart_tx_ring.stats.rejected_bytes += len;
+        return 1;
+    }
+
+    /* ݣ */
+    head = g_uart_tx_ring.head;
+    first = ATK_MW8266D_UART_TX_RING_SIZE - head;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&g_uart_tx_ring.buf[head], data, first);
+    memcpy(&g_uart_tx_ring.buf[0], data + first, len - first);
+
+    NVIC_DisableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+    g_uart_tx_ring.head = (head + len) % ATK_MW8266D_UART_TX_RING_SIZE;
+    g_uart_tx_ring.stats.queued_bytes += len;
+    used = uart_tx_used();
+    if (used > g_uart_tx_ring.stats.high_water)
+    {
+        g_uart_tx_ring.stats.high_water = used;
+    }
+    uart_tx_dma_kick();
+    NVIC_EnableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+
+    return 0;
+}
+
+/**
+ * @brief       ATK-MW8266D UART printf
+ * @note        ʽATK_MW8266D_UART_TX_BUF_SIZE-1ʱضϣ
+ *              ֱʹatk_mw8266d_uart_send()
+ * @param       fmt: ӡ
+ * @retval      0: 
+ *              1: пռ䲻㣬ݱܾ
+ */
+uint8_t atk_mw8266d_uart_printf(char *fmt, ...)
+{
+    va_list ap;
+    int len;
+
     va_start(ap, fmt);
-    vsprintf((char *)g_uart_tx_buf, fmt, ap);
+    len = vsnprintf((char *)g_uart_tx_buf, sizeof(g_uart_tx_buf), fmt, ap);
     va_end(ap);
 
-    len = strlen((const char *)g_uart_tx_buf);
+    if (len < 0)
+    {
+        return 1;
+    }
+    if (len >= (int)sizeof(g_uart_tx_buf))
+    {
+        len = sizeof(g_uart_tx_buf) - 1;
+    }
+
+    return atk_mw8266d_uart_send(g_uart_tx_buf, (uint16_t)len);
+}
+
+/**
+ * @brief       ȡͶʣռ
+ * @param       
+ * @retval      ӵֽ
+ */
+uint16_t atk_mw8266d_uart_tx_free(void)
+{
+    return ATK_MW8266D_UART_TX_RING_SIZE - 1 - uart_tx_used();
+}
+
+/**
+ * @brief       ͶǷȫ
+ * @param       
+ * @retval      0: ݴ
+ *              1: ΪһֽƳλĴ
+ */
+uint8_t atk_mw8266d_uart_tx_idle(void)
+{
+    return (g_uart_tx_ring.head == g_uart_tx_ring.tail) &&
+           (USART_GetFlagStatus(ATK_MW8266D_UART_INTERFACE, USART_FLAG_TC) != RESET);
+}
+
+/**
+ * @brief       ȡͳ
+ * @param       stats: ͳϢusedΪǰֽ
+ * @retval      
+ */
+void atk_mw8266d_uart_tx_get_stats(atk_mw8266d_uart_tx_stats_t *stats)
+{
+    NVIC_DisableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+    *stats = g_uart_tx_ring.stats;
+    stats->used = uart_tx_used();
+    NVIC_EnableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+}
+
+/**
+ * @brief       㷢ͳƣˮλΪǰֽ
+ * @param       
+ * @retval      
+ */
+void atk_mw8266d_uart_tx_reset_stats(void)
+{
+    NVIC_DisableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+    memset(&g_uart_tx_ring.stats, 0, sizeof(g_uart_tx_ring.stats));
+    g_uart_tx_ring.stats.high_water = uart_tx_used();
+    NVIC_EnableIRQ(ATK_MW8266D_UART_TX_DMA_IRQn);
+}
+
+/**
+ * @brief       ATK-MW8266D UARTDMAж
+ * @param       
+ * @retval      
+ */
+void ATK_MW8266D_UART_TX_DMA_IRQHandler(void)
+{
+    if (DMA_GetITStatus(ATK_MW8266D_UART_TX_DMA_IT_TC) != RESET)
+    {
+        DMA_ClearITPendingBit(ATK_MW8266D_UART_TX_DMA_IT_TC);
+
+        g_uart_tx_ring.tail = (g_uart_tx_ring.tail + g_uart_tx_ring.dma_len) % ATK_MW8266D_UART_TX_RING_SIZE;
+        g_uart_tx_ring.stats.sent_bytes += g_uart_tx_ring.dma_len;
+        g_uart_tx_ring.dma_len = 0;
+        uart_tx_dma_kick();
+    }
+}
 
-    for (uint16_t i = 0; i < len; i++)
+/**
+ * @brief       DMAʣۼƽֽ
+ * @note        USART/DMAжеã/жϱ֤θ֮䲻һȦ
+ * @param       
+ * @retval      
+ */
+static void uart_rx_update(void)
+{
+    uint16_t pos = ATK_MW8266D_UART_RX_RING_SIZE - ATK_MW8266D_UART_RX_DMA_CHANNEL->CNDTR;
+
+    if (pos >= ATK_MW8266D_UART_RX_RING_SIZE)
     {
-        while (USART_GetFlagStatus(ATK_MW8266D_UART_INTERFACE, USART_FLAG_TXE) == RESET)
-            ; /* ȴͻ */
-        USART_SendData(ATK_MW8266D_UART_INTERFACE, g_uart_tx_buf[i]);
+        pos = 0;
     }
+    g_uart_rx_ring.total += (uint16_t)(pos - g_uart_rx_ring.dma_pos + ATK_MW8266D_UART_RX_RING_SIZE) % ATK_MW8266D_UART_RX_RING_SIZE;
+    g_uart_rx_ring.dma_pos = pos;
 }
 
 /**
- * @brief       ATK-MW8266D UART¿ʼ
+ * @brief       ǰʵʱۼƽֽѭʹã
+ * @param       
+ * @retval      ۼƽֽ
+ */
+static uint32_t uart_rx_live_total(void)
+{
+    uint32_t total;
+    uint16_t pos;
+
+    NVIC_DisableIRQ(ATK_MW8266D_UART_IRQn);
+    NVIC_DisableIRQ(ATK_MW8266D_UART_RX_DMA_IRQn);
+    pos = ATK_MW8266D_UART_RX_RING_SIZE - ATK_MW8266D_UART_RX_DMA_CHANNEL->CNDTR;
+    if (pos >= ATK_MW8266D_UART_RX_RING_SIZE)
+    {
+        pos = 0;
+    }
+    total = g_uart_rx_ring.total + (uint16_t)(pos - g_uart_rx_ring.dma_pos + ATK_MW8266D_UART_RX_RING_SIZE) % ATK_MW8266D_UART_RX_RING_SIZE;
+    NVIC_EnableIRQ(ATK_MW8266D_UART_RX_DMA_IRQn);
+    NVIC_EnableIRQ(ATK_MW8266D_UART_IRQn);
+
+    return total;
+}
+
+/**
+ * @brief       ATK-MW8266D UARTͷŵǰ֡´λȡʱضеһ֡
  * @param       
  * @retval      
  */
 void atk_mw8266d_uart_rx_restart(void)
 {
-    g_uart_rx_frame.sta.len = 0;
-    g_uart_rx_frame.sta.finsh = 0;
+    g_uart_rx_frame.len = 0;
+    g_uart_rx_frame.hold = 0;
+}
+
+/**
+ * @brief       ATK-MW8266D UARTǰ֡Ͷδ֡
+ * @note        ATָǰãɵӦΪָӦ
+ * @param       
+ * @retval      
+ */
+void atk_mw8266d_uart_rx_flush(void)
+{
+    atk_mw8266d_uart_rx_restart();
+    g_uart_rx_ring.tail = g_uart_rx_ring.head;
 }
 
 /**
  * @brief       ȡATK-MW8266D UARTյһ֡
+ * @note        ˳򷵻أͬһ֡ڵatk_mw8266d_uart_rx_restart()ǰظء
+ *              ATK_MW8266D_UART_RX_BUF_SIZE-1Ĳֱضϣ
+ *              ȡǰѱDMAǵ֡ͳ
  * @param       
  * @retval      NULL: δյһ֡
  *              : յһ֡
  */
 uint8_t *atk_mw8266d_uart_rx_get_frame(void)
 {
-    if (g_uart_rx_frame.sta.finsh == 1)
+    uint32_t start;
+    uint16_t len, copy, offset, first;
+    uint8_t tail;
+
+    if (g_uart_rx_frame.hold == 1)
     {
-        g_uart_rx_frame.buf[g_uart_rx_frame.sta.len] = '\0';
         return g_uart_rx_frame.buf;
     }
-    else
+
+    while (g_uart_rx_ring.tail != g_uart_rx_ring.head)
     {
-        return NULL;
+        tail = g_uart_rx_ring.tail;
+        start = g_uart_rx_ring.desc[tail].start;
+        len = g_uart_rx_ring.desc[tail].len;
+
+        copy = (len < ATK_MW8266D_UART_RX_BUF_SIZE) ? len : (ATK_MW8266D_UART_RX_BUF_SIZE - 1);
+        offset = start % ATK_MW8266D_UART_RX_RING_SIZE;
+        first = ATK_MW8266D_UART_RX_RING_SIZE - offset;
+        if (first > copy)
+        {
+            first = copy;
+        }
+        memcpy(g_uart_rx_frame.buf, &g_uart_rx_ring.buf[offset], first);
+        memcpy(g_uart_rx_frame.buf + first, g_uart_rx_ring.buf, copy - first);
+
+        g_uart_rx_ring.tail = (tail + 1) % ATK_MW8266D_UART_RX_QUEUE_SIZE;
+
+        /* ɺټ飬ȷڼ֡ʼûбݸ */
+        if (uart_rx_live_total() - start > ATK_MW8266D_UART_RX_RING_SIZE)
+        {
+            g_uart_rx_ring.stats.overrun++;
+            g_uart_rx_ring.stats.dropped_bytes += len;
+            continue;
+        }
+
+        g_uart_rx_ring.stats.dropped_bytes += len - copy;
+        g_uart_rx_frame.buf[copy] = '\0';
+        g_uart_rx_frame.len = copy;
+        g_uart_rx_frame.hold = 1;
+        return g_uart_rx_frame.buf;
     }
+
+    return NULL;
 }
 
 /**
@@ -89,9 +361,9 @@ uint8_t *atk_mw8266d_uart_rx_get_frame(void)
  */
 uint16_t atk_mw8266d_uart_rx_get_frame_len(void)
 {
-    if (g_uart_rx_frame.sta.finsh == 1)
+    if (atk_mw8266d_uart_rx_get_frame() != NULL)
     {
-        return g_uart_rx_frame.sta.len;
+        return g_uart_rx_frame.len;
     }
     else
     {
@@ -99,6 +371,31 @@ uint16_t atk_mw8266d_uart_rx_get_frame_len(void)
     }
 }
 
+/**
+ * @brief       ֡¼ص
+ * @note        صUSARTжСһ֡кãֻӦñ־/ͷȼ̲
+ *              ڻصжȡ֡
+ * @param       cb: صNULLʾȡ
+ * @retval      
+ */
+void atk_mw8266d_uart_rx_set_callback(atk_mw8266d_uart_rx_cb_t cb)
+{
+    g_uart_rx_cb = cb;
+}
+
+/**
+ * @brief       ȡͳ
+ * @param       stats: ͳϢpendingΪδ֡
+ * @retval      
+ */
+void atk_mw8266d_uart_rx_get_stats(atk_mw8266d_uart_rx_stats_t *stats)
+{
+    NVIC_DisableIRQ(ATK_MW8266D_UART_IRQn);
+    *stats = g_uart_rx_ring.stats;
+    stats->pending = (g_uart_rx_ring.head - g_uart_rx_ring.tail + ATK_MW8266D_UART_RX_QUEUE_SIZE) % ATK_MW8266D_UART_RX_QUEUE_SIZE;
+    NVIC_EnableIRQ(ATK_MW8266D_UART_IRQn);
+}
+
 /**
  * @brief       ATK-MW8266D UARTʼ
  * @param       baudrate: UARTͨѶ
@@ -108,6 +405,7 @@ void atk_mw8266d_uart_init(uint32_t baudrate)
 {
     USART_InitTypeDef USART_InitStructure;
     GPIO_InitTypeDef GPIO_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
 
     /* ʹUSARTGPIOʱ */
     RCC_APB2PeriphClockCmd(ATK_MW8266D_UART_TX_GPIO_CLK | RCC_APB2Periph_AFIO, ENABLE);
@@ -134,11 +432,48 @@ void atk_mw8266d_uart_init(uint32_t baudrate)
     USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
     USART_Init(ATK_MW8266D_UART_INTERFACE, &USART_InitStructure);
 
+    /* ÷DMAڴ -> USART_DRÿδuart_tx_dma_kick()õַͳ */
+    RCC_AHBPeriphClockCmd(ATK_MW8266D_UART_TX_DMA_CLK, ENABLE);
+    DMA_DeInit(ATK_MW8266D_UART_TX_DMA_CHANNEL);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ATK_MW8266D_UART_INTERFACE->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)g_uart_tx_ring.buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 1;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(ATK_MW8266D_UART_TX_DMA_CHANNEL, &DMA_InitStructure);
+    DMA_ITConfig(ATK_MW8266D_UART_TX_DMA_CHANNEL, DMA_IT_TC, ENABLE);
+    USART_DMACmd(ATK_MW8266D_UART_INTERFACE, USART_DMAReq_Tx, ENABLE);
+
+    /* ýDMAUSART_DR -> ѭ壬/жڸдȦ */
+    DMA_DeInit(ATK_MW8266D_UART_RX_DMA_CHANNEL);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ATK_MW8266D_UART_INTERFACE->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)g_uart_rx_ring.buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = ATK_MW8266D_UART_RX_RING_SIZE;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_Init(ATK_MW8266D_UART_RX_DMA_CHANNEL, &DMA_InitStructure);
+    DMA_ITConfig(ATK_MW8266D_UART_RX_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    USART_DMACmd(ATK_MW8266D_UART_INTERFACE, USART_DMAReq_Rx, ENABLE);
+
+    memset(&g_uart_rx_ring, 0, sizeof(g_uart_rx_ring));
+    atk_mw8266d_uart_rx_restart();
+    DMA_Cmd(ATK_MW8266D_UART_RX_DMA_CHANNEL, ENABLE);
+
+    g_uart_tx_ring.head = 0;
+    g_uart_tx_ring.tail = 0;
+    g_uart_tx_ring.dma_len = 0;
+
     /* ʹUSART */
     USART_Cmd(ATK_MW8266D_UART_INTERFACE, ENABLE);
 
-    /* ʹUSARTж */
-    USART_ITConfig(ATK_MW8266D_UART_INTERFACE, USART_IT_RXNE, ENABLE);
+    /* ʹUSARTжϣ֡DMA */
     USART_ITConfig(ATK_MW8266D_UART_INTERFACE, USART_IT_IDLE, ENABLE);
 
     /* жȼ */
@@ -148,37 +483,82 @@ void atk_mw8266d_uart_init(uint32_t baudrate)
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
+
+    /* DMAжUSARTжͬһռȼ߲໥ */
+    NVIC_InitStructure.NVIC_IRQChannel = ATK_MW8266D_UART_RX_DMA_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = ATK_MW8266D_UART_TX_DMA_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
 }
 
 /**
  * @brief       ATK-MW8266D UARTжϻص
+ * @note        жϱʾһ֡һ֡յΪһ֡У
+ *              Ȼ֡¼ص
  * @param       
  * @retval      
  */
 void ATK_MW8266D_UART_IRQHandler(void)
 {
-    uint8_t tmp;
+    uint32_t len;
+    uint8_t next;
 
-    /* ж */
-    if (USART_GetITStatus(ATK_MW8266D_UART_INTERFACE, USART_IT_RXNE) != RESET)
+    /* жϣ֡ */
+    if (USART_GetITStatus(ATK_MW8266D_UART_INTERFACE, USART_IT_IDLE) != RESET)
     {
-        tmp = USART_ReceiveData(ATK_MW8266D_UART_INTERFACE);
+        if (USART_GetFlagStatus(ATK_MW8266D_UART_INTERFACE, USART_FLAG_ORE) != RESET)
+        {
+            g_uart_rx_ring.stats.uart_ore++;
+        }
+        (void)USART_ReceiveData(ATK_MW8266D_UART_INTERFACE); /* жϱ־ */
 
-        if (g_uart_rx_frame.sta.len < (ATK_MW8266D_UART_RX_BUF_SIZE - 1))
+        uart_rx_update();
+        len = g_uart_rx_ring.total - g_uart_rx_ring.frame_start;
+        if (len == 0)
         {
-            g_uart_rx_frame.buf[g_uart_rx_frame.sta.len++] = tmp;
+            return;
+        }
+
+        next = (g_uart_rx_ring.head + 1) % ATK_MW8266D_UART_RX_QUEUE_SIZE;
+        if (next == g_uart_rx_ring.tail)
+        {
+            g_uart_rx_ring.stats.dropped_frames++;
+            g_uart_rx_ring.stats.dropped_bytes += len;
         }
         else
         {
-            g_uart_rx_frame.sta.len = 0; /* ʱǻ */
-            g_uart_rx_frame.buf[g_uart_rx_frame.sta.len++] = tmp;
+            g_uart_rx_ring.desc[g_uart_rx_ring.head].start = g_uart_rx_ring.frame_start;
+            g_uart_rx_ring.desc[g_uart_rx_ring.head].len = (len > 0xFFFF) ? 0xFFFF : (uint16_t)len;
+            g_uart_rx_ring.head = next;
+            g_uart_rx_ring.stats.frames++;
+        }
+        g_uart_rx_ring.frame_start = g_uart_rx_ring.total;
+
+        if (g_uart_rx_cb != NULL)
+        {
+            g_uart_rx_cb();
         }
     }
+}
 
-    /* жϣ֡ */
-    if (USART_GetITStatus(ATK_MW8266D_UART_INTERFACE, USART_IT_IDLE) != RESET)
+/**
+ * @brief       ATK-MW8266D UARTDMA/ж
+ * @param       
+ * @retval      
+ */
+void ATK_MW8266D_UART_RX_DMA_IRQHandler(void)
+{
+    if (DMA_GetITStatus(ATK_MW8266D_UART_RX_DMA_IT_HT) != RESET)
     {
-        (void)USART_ReceiveData(ATK_MW8266D_UART_INTERFACE); /* жϱ־ */
-        g_uart_rx_frame.sta.finsh = 1;
+        DMA_ClearITPendingBit(ATK_MW8266D_UART_RX_DMA_IT_HT);
+    }
+    if (DMA_GetITStatus(ATK_MW8266D_UART_RX_DMA_IT_TC) != RESET)
+    {
+        DMA_ClearITPendingBit(ATK_MW8266D_UART_RX_DMA_IT_TC);
     }
+    uart_rx_update();
 }
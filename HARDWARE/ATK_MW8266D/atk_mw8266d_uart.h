@@ -37,16 +37,66 @@
 #define ATK_MW8266D_UART_IRQn                   USART3_IRQn
 #define ATK_MW8266D_UART_IRQHandler             USART3_IRQHandler
 
-/* UART�շ������С */
-#define ATK_MW8266D_UART_RX_BUF_SIZE            512
-#define ATK_MW8266D_UART_TX_BUF_SIZE            64
-
-/* �������� */
-void atk_mw8266d_uart_printf(char *fmt, ...);       /* ATK-MW8266D UART printf */
-void atk_mw8266d_uart_rx_restart(void);             /* ATK-MW8266D UART���¿�ʼ�������� */
-uint8_t *atk_mw8266d_uart_rx_get_frame(void);       /* ��ȡATK-MW8266D UART���յ���һ֡���� */
-uint16_t atk_mw8266d_uart_rx_get_frame_len(void);   /* ��ȡATK-MW8266D UART���յ���һ֡���ݵĳ��� */
-void atk_mw8266d_uart_init(uint32_t baudrate);      /* ATK-MW8266D UART��ʼ�� */
+/* 发送DMA定义 (USART3_TX 固定对应 DMA1通道2) */
+#define ATK_MW8266D_UART_TX_DMA_CLK             RCC_AHBPeriph_DMA1
+#define ATK_MW8266D_UART_TX_DMA_CHANNEL         DMA1_Channel2
+#define ATK_MW8266D_UART_TX_DMA_IT_TC           DMA1_IT_TC2
+#define ATK_MW8266D_UART_TX_DMA_IRQn            DMA1_Channel2_IRQn
+#define ATK_MW8266D_UART_TX_DMA_IRQHandler      DMA1_Channel2_IRQHandler
+
+/* 接收DMA定义 (USART3_RX 固定对应 DMA1通道3) */
+#define ATK_MW8266D_UART_RX_DMA_CHANNEL         DMA1_Channel3
+#define ATK_MW8266D_UART_RX_DMA_IT_HT           DMA1_IT_HT3
+#define ATK_MW8266D_UART_RX_DMA_IT_TC           DMA1_IT_TC3
+#define ATK_MW8266D_UART_RX_DMA_IRQn            DMA1_Channel3_IRQn
+#define ATK_MW8266D_UART_RX_DMA_IRQHandler      DMA1_Channel3_IRQHandler
+
+/* UART收发缓冲大小 */
+#define ATK_MW8266D_UART_RX_BUF_SIZE            512     /* 单帧线性缓冲 */
+#define ATK_MW8266D_UART_RX_RING_SIZE           1024    /* DMA循环接收缓冲 */
+#define ATK_MW8266D_UART_RX_QUEUE_SIZE          8       /* 帧描述符队列深度 (可缓存QUEUE_SIZE-1帧) */
+#define ATK_MW8266D_UART_TX_BUF_SIZE            256     /* printf格式化缓冲 */
+#define ATK_MW8266D_UART_TX_RING_SIZE           1024    /* DMA发送环形队列 */
+
+/* 发送队列统计 */
+typedef struct
+{
+    uint32_t queued_bytes;      /* 累计入队字节数 */
+    uint32_t sent_bytes;        /* 累计DMA发送完成字节数 */
+    uint32_t rejected;          /* 因队列空间不足被拒绝的次数 */
+    uint32_t rejected_bytes;    /* 被拒绝的字节数 */
+    uint16_t high_water;        /* 队列占用最高水位 (字节) */
+    uint16_t used;              /* 当前已用字节数 */
+} atk_mw8266d_uart_tx_stats_t;
+
+/* 接收队列统计 */
+typedef struct
+{
+    uint32_t frames;            /* 累计入队帧数 */
+    uint32_t dropped_frames;    /* 描述符队列满而丢弃的帧数 */
+    uint32_t dropped_bytes;     /* 丢弃的字节数 (队列满/被覆盖/超长截断) */
+    uint32_t overrun;           /* 取出前已被DMA覆盖的帧数 */
+    uint32_t uart_ore;          /* USART硬件溢出次数 */
+    uint8_t pending;            /* 当前队列中未读帧数 */
+} atk_mw8266d_uart_rx_stats_t;
+
+/* 帧接收事件回调 (在USART空闲中断中调用) */
+typedef void (*atk_mw8266d_uart_rx_cb_t)(void);
+
+/* 操作函数 */
+uint8_t atk_mw8266d_uart_send(const uint8_t *data, uint16_t len);      /* ATK-MW8266D UART发送数据(非阻塞入队) */
+uint8_t atk_mw8266d_uart_printf(char *fmt, ...);                        /* ATK-MW8266D UART printf(非阻塞入队) */
+uint16_t atk_mw8266d_uart_tx_free(void);                                /* 获取发送队列剩余空间 */
+uint8_t atk_mw8266d_uart_tx_idle(void);                                 /* 发送队列是否已全部发出 */
+void atk_mw8266d_uart_tx_get_stats(atk_mw8266d_uart_tx_stats_t *stats); /* 获取发送统计 */
+void atk_mw8266d_uart_tx_reset_stats(void);                             /* 清零发送统计 */
+void atk_mw8266d_uart_rx_restart(void);             /* ATK-MW8266D UART释放当前帧 */
+void atk_mw8266d_uart_rx_flush(void);               /* ATK-MW8266D UART丢弃所有未读帧 */
+uint8_t *atk_mw8266d_uart_rx_get_frame(void);       /* 获取ATK-MW8266D UART接收到的一帧数据 */
+uint16_t atk_mw8266d_uart_rx_get_frame_len(void);   /* 获取ATK-MW8266D UART接收到的一帧数据的长度 */
+void atk_mw8266d_uart_rx_get_stats(atk_mw8266d_uart_rx_stats_t *stats); /* 获取接收统计 */
+void atk_mw8266d_uart_rx_set_callback(atk_mw8266d_uart_rx_cb_t cb);    /* 设置帧接收事件回调 */
+void atk_mw8266d_uart_init(uint32_t baudrate);      /* ATK-MW8266D UART初始化 */
 
 #endif
 
@@ -2,8 +2,8 @@
  ****************************************************************************************************
  * @file        dht11.c
  * @author      NixStudio(NixLockhart)
- * @version     V1.3
- * @lastupdate  2025-01-02
+ * @version     V1.4
+ * @lastupdate  2026-10-17
  * @date        2026-01-14
  * @brief       DHT11ز
  ****************************************************************************************************
@@ -11,14 +11,44 @@
  *
  * ʵƽ̨:ԭ STM32F103
  *
+ * V1.4 Ϊ첽ȡ:
+ * - DHT11_Process() ɵڵ, زʼź, ÿһת
+ * - λ PG11 ½ж(EXTI11) ں̨, ʱȡ TIM6 (1MHzɼ)
+ * - ½ؼ = 50us͵ƽ + ߵƽ(0:26~28us, 1:70us), 100usΪж0/1
+ * - Уͨ», DHT11_Get_Data() ֻػֵǷ
+ *
  ****************************************************************************************************
  */
 
 
 #include "dht11.h"
 #include "delay.h"
+#include "timer.h"
+
+//ת״̬
+#define DHT11_STATE_IDLE		0	//,ȴһת
+#define DHT11_STATE_START		1	//ʼź
+#define DHT11_STATE_RECV		2	//ȴжϽ
+#define DHT11_STATE_DONE		3	//,ȴУ
+
+#define DHT11_EDGE_TOTAL		42	//һ֡½:Ӧ1+ʼ1+40
+#define DHT11_BIT_THRESHOLD_US	100	//½ؼڸֵΪ1
+#define DHT11_EDGE_MAX_US		200	//λ½ؼ,Ϊ֡
+
+#define DHT11_EXTI_ENABLE()		(EXTI->IMR |= EXTI_Line11)
+#define DHT11_EXTI_DISABLE()	(EXTI->IMR &= ~EXTI_Line11)
 
- //͸λźŸ DHT11ͨ
+static volatile uint8_t  g_dht11_state = DHT11_STATE_IDLE;
+static volatile uint8_t  g_dht11_edge;				//յ½
+static volatile uint8_t  g_dht11_error;				//֡Ƿִ
+static volatile uint16_t g_dht11_last_cnt;			//һ½صTIM6ֵ
+static volatile uint8_t  g_dht11_buf[5];			//ջ
+static uint32_t g_dht11_start_ms;					//תʼʱ
+static uint8_t  g_dht11_started = 0;				//Ƿת
+
+static dht11_stats_t g_dht11_stats;					//ͳ
+
+ //͸λźŸ DHT11ͨ (ʼʱʹ)
 void DHT11_Rst(void)
 {
     DHT11_IO_OUT();
@@ -49,62 +79,170 @@ uint8_t DHT11_Check(void)
     return 0;
 }
 
-//ȡ DHT11  1 λ
-uint8_t DHT11_Read_Bit(void)
+//TIM6 ʼΪ 1MHz ɼڲ
+static void DHT11_Timer_Init(void)
 {
-    uint8_t retry = 0;
-    while (DHT11_DQ_IN && retry < 100)
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM6, ENABLE);
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFF;
+    TIM_TimeBaseStructure.TIM_Prescaler = 71;      //72M/72=1MHz
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(TIM6, &TIM_TimeBaseStructure);
+    TIM_Cmd(TIM6, ENABLE);
+}
+
+//PG11 ½жϳʼĬΣս׶βŴ
+static void DHT11_EXTI_Init(void)
+{
+    EXTI_InitTypeDef EXTI_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO, ENABLE);
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOG, GPIO_PinSource11);
+
+    EXTI_InitStructure.EXTI_Line = EXTI_Line11;
+    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&EXTI_InitStructure);
+    DHT11_EXTI_DISABLE();
+
+    //жTIM6õжӳֱӰжʹȼ
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI15_10_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+//PG11 ½жϣ½ؼλ
+void EXTI15_10_IRQHandler(void)
+{
+    uint16_t cnt, width;
+    uint8_t bit;
+
+    if (EXTI_GetITStatus(EXTI_Line11) == RESET) return;
+    EXTI_ClearITPendingBit(EXTI_Line11);
+
+    cnt = TIM6->CNT;
+    width = cnt - g_dht11_last_cnt;     //16λԶ
+    g_dht11_last_cnt = cnt;
+
+    if (g_dht11_state != DHT11_STATE_RECV) return;
+
+    //0ΪӦź½,1Ϊʼ½,֮ÿ½ؽһλ
+    if (g_dht11_edge >= 2)
     {
-        retry++;
-        delay_us(1);
+        bit = g_dht11_edge - 2;
+        if (width > DHT11_EDGE_MAX_US) g_dht11_error = 1;
+        g_dht11_buf[bit >> 3] <<= 1;
+        if (width > DHT11_BIT_THRESHOLD_US) g_dht11_buf[bit >> 3] |= 1;
     }
-    retry = 0;
-    while (!DHT11_DQ_IN && retry < 100)
+
+    if (++g_dht11_edge >= DHT11_EDGE_TOTAL)
     {
-        retry++;
-        delay_us(1);
+        DHT11_EXTI_DISABLE();
+        g_dht11_state = DHT11_STATE_DONE;
     }
-    delay_us(40);
-    if (DHT11_DQ_IN)return 1;
-    else return 0;
 }
 
-//ȡ DHT11  1 ֽڣ8 λ
-uint8_t DHT11_Read_Byte(void)
+//Уյһ֡ͨ»
+static void DHT11_Finish(uint32_t now)
 {
-    uint8_t i, dat;
-    dat = 0;
-    for (i = 0; i < 8; i++)
+    uint8_t sum;
+
+    sum = g_dht11_buf[0] + g_dht11_buf[1] + g_dht11_buf[2] + g_dht11_buf[3];
+    if (g_dht11_error || sum != g_dht11_buf[4])
     {
-        dat <<= 1;
-        dat |= DHT11_Read_Bit();
+        g_dht11_stats.checksum_err++;
+        return;
     }
-    return dat;
+
+    g_dht11_stats.humi = g_dht11_buf[0];
+    g_dht11_stats.temp = g_dht11_buf[2];
+    g_dht11_stats.valid = 1;
+    g_dht11_stats.update_ms = now;
+    g_dht11_stats.ok_count++;
 }
 
-// DHT11 ʪݣ洢ָ
-uint8_t DHT11_Read_Data(uint8_t* temp, uint8_t* humi)
+//DHT11 ̨ת״̬ڵã10ms
+//ʼźԼDHT11_START_MSһεͷ
+void DHT11_Process(void)
 {
-    uint8_t buf[5];
-    uint8_t i;
-    DHT11_Rst();
-    if (DHT11_Check() == 0)
+    uint32_t now = millis();
+
+    switch (g_dht11_state)
     {
-        for (i = 0; i < 5; i++)
-        {
-            buf[i] = DHT11_Read_Byte();
-        }
-        if ((buf[0] + buf[1] + buf[2] + buf[3]) == buf[4])
-        {
-            *humi = buf[0];
-            *temp = buf[2];
-        }
+    case DHT11_STATE_IDLE:
+        //ÿһת
+        if (g_dht11_started && now - g_dht11_start_ms < DHT11_INTERVAL_MS) break;
+        g_dht11_started = 1;
+        g_dht11_start_ms = now;
+        DHT11_EXTI_DISABLE();
+        DHT11_IO_OUT();
+        DHT11_DQ_OUT(0);                //18ms
+        g_dht11_state = DHT11_STATE_START;
+        break;
+
+    case DHT11_STATE_START:
+        if (now - g_dht11_start_ms < DHT11_START_MS) break;
+        g_dht11_edge = 0;
+        g_dht11_error = 0;
+        g_dht11_buf[0] = g_dht11_buf[1] = g_dht11_buf[2] = g_dht11_buf[3] = g_dht11_buf[4] = 0;
+        g_dht11_state = DHT11_STATE_RECV;
+        EXTI_ClearITPendingBit(EXTI_Line11);
+        DHT11_DQ_OUT(1);                //ͷ,ָߵƽ
+        DHT11_IO_IN();
+        DHT11_EXTI_ENABLE();
+        break;
+
+    case DHT11_STATE_RECV:
+        //һ֡Լ4ms,ʱ˵Ӧʧ
+        if (now - g_dht11_start_ms < DHT11_START_MS + DHT11_TIMEOUT_MS) break;
+        DHT11_EXTI_DISABLE();
+        g_dht11_stats.timeout_err++;
+        g_dht11_state = DHT11_STATE_IDLE;
+        break;
+
+    case DHT11_STATE_DONE:
+        DHT11_Finish(now);
+        g_dht11_state = DHT11_STATE_IDLE;
+        break;
+
+    default:
+        g_dht11_state = DHT11_STATE_IDLE;
+        break;
     }
-    else return 1;
-    return 0;
 }
 
-//ʼ DHT11 źͨ׼
+//ȡʪȣ
+//ֵ0,Чδڣ1,δЧݻѳDHT11_STALE_MSδ
+//δЧʱ޸*temp*humi
+uint8_t DHT11_Get_Data(uint8_t* temp, uint8_t* humi)
+{
+    if (!g_dht11_stats.valid) return 1;
+
+    *temp = g_dht11_stats.temp;
+    *humi = g_dht11_stats.humi;
+    return DHT11_Is_Stale();
+}
+
+//Ƿ
+uint8_t DHT11_Is_Stale(void)
+{
+    if (!g_dht11_stats.valid) return 1;
+    return (millis() - g_dht11_stats.update_ms) > DHT11_STALE_MS;
+}
+
+//ȡͳϢ
+const dht11_stats_t* DHT11_Get_Stats(void)
+{
+    return &g_dht11_stats;
+}
+
+//ʼ DHT11 Ƿڣ0ʾ
 uint8_t DHT11_Init(void)
 {
     GPIO_InitTypeDef  GPIO_InitStructure;
@@ -116,6 +254,11 @@ uint8_t DHT11_Init(void)
     GPIO_Init(GPIOG, &GPIO_InitStructure);
 
     GPIO_SetBits(GPIOG, GPIO_Pin_11);
+
+    DHT11_Timer_Init();
+    DHT11_EXTI_Init();
+    g_dht11_state = DHT11_STATE_IDLE;
+
     DHT11_Rst();
     return DHT11_Check();
 }
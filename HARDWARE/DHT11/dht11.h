@@ -11,10 +11,27 @@
 #define    DHT11_DQ_OUT(X)  GPIO_WriteBit(GPIOG, GPIO_Pin_11, X)
 #define    DHT11_DQ_IN  GPIO_ReadInputDataBit(GPIOG, GPIO_Pin_11)
 
+#define DHT11_INTERVAL_MS   1000    // 两次转换最小间隔, DHT11 每秒最多更新一次
+#define DHT11_START_MS      20      // 起始信号拉低时间
+#define DHT11_TIMEOUT_MS    20      // 释放总线后等待一帧数据的超时时间
+#define DHT11_STALE_MS      5000    // 超过该时间未更新则认为数据过期
+
+// 缓存读数和统计
+typedef struct {
+    uint8_t  temp;          // 温度
+    uint8_t  humi;          // 湿度
+    uint8_t  valid;         // 是否读到过有效数据
+    uint32_t update_ms;     // 最近一次有效数据时间
+    uint32_t ok_count;      // 有效帧数
+    uint32_t checksum_err;  // 校验或脉宽错误帧数
+    uint32_t timeout_err;   // 超时帧数
+} dht11_stats_t;
+
 uint8_t DHT11_Init(void);
-uint8_t DHT11_Read_Data(uint8_t *temp,uint8_t *humi);
-uint8_t DHT11_Read_Byte(void);
-uint8_t DHT11_Read_Bit(void);
+void DHT11_Process(void);
+uint8_t DHT11_Get_Data(uint8_t *temp,uint8_t *humi);
+uint8_t DHT11_Is_Stale(void);
+const dht11_stats_t* DHT11_Get_Stats(void);
 uint8_t DHT11_Check(void);
 void DHT11_Rst(void);   
 
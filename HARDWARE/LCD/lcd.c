@@ -2,8 +2,8 @@
  ****************************************************************************************************
  * @file        lcd.c
  * @author      ԭŶ(ALIENTEK)
- * @version     V1.2
- * @date        2023-05-31
+ * @version     V1.3
+ * @date        2026-10-17
  * @brief       2.8/3.5/4.3/7 TFTLCD(MCU) 
  *              ֧ICͺŰ:ILI9341/NT35310/NT35510/SSD1963/ST7789/ST7796/ILI9806 
  *
@@ -25,6 +25,10 @@
  * 2, 򻯲ִ, ⳤж
  * V1.2 20230531
  * 1, ST7796ILI9806 IC֧
+ * V1.3 20261017
+ * 1, lcd_color_fill_dma, һδںDMA2ͨ1ɫ˵LCD->LCD_RAM, ɺص
+ * 2, lcd_blit/lcd_blit_solid, һδں8չд, lcd_color_fill/lcd_fill/lcd_clearø÷ʽ
+ * 3, lcd_benchmarkˢٶȲ
  *
  ****************************************************************************************************
  */
@@ -49,6 +53,12 @@ uint32_t g_back_color  = 0XFFFF;    /* 
 /* LCDҪ */
 _lcd_dev lcddev;
 
+/* DMAˢ״̬ */
+static volatile uint8_t g_lcd_dma_busy = 0;     /* 1:  */
+static const uint16_t *g_lcd_dma_src;           /* һεԴַ */
+static uint32_t g_lcd_dma_remain;               /* ʣδ */
+static lcd_dma_done_cb_t g_lcd_dma_done;        /* ɻص */
+
 
 /**
  * @brief       LCDд
@@ -787,6 +797,160 @@ void lcd_init(void)
     lcd_clear(WHITE);
 }
 
+/**
+ * @brief       д (8չ, ָ)
+ * @param       src: 
+ * @param       n: 
+ * @retval      
+ */
+static void lcd_write_pixels(const uint16_t *src, uint32_t n)
+{
+    volatile uint16_t *ram = &LCD->LCD_RAM;
+    uint32_t k = n >> 3;
+
+    while (k--)
+    {
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+        *ram = *src++;
+    }
+
+    n &= 7;
+    while (n--)
+    {
+        *ram = *src++;
+    }
+}
+
+/**
+ * @brief       дͬһɫ (8չ)
+ * @param       color: ɫ
+ * @param       n: 
+ * @retval      
+ */
+static void lcd_write_solid(uint16_t color, uint32_t n)
+{
+    volatile uint16_t *ram = &LCD->LCD_RAM;
+    uint32_t k = n >> 3;
+
+    while (k--)
+    {
+        *ram = color;
+        *ram = color;
+        *ram = color;
+        *ram = color;
+        *ram = color;
+        *ram = color;
+        *ram = color;
+        *ram = color;
+    }
+
+    n &= 7;
+    while (n--)
+    {
+        *ram = color;
+    }
+}
+
+/**
+ * @brief       ǰĻܷôд
+ *   @note      SSD1963ĴҪx, ԰ùд
+ * @param       
+ * @retval      1, ; 0, Ҫд
+ */
+static uint8_t lcd_window_supported(void)
+{
+    return (lcddev.id == 0X1963 && lcddev.dir != 1) ? 0 : 1;
+}
+
+/**
+ * @brief       ʼһδд: ȴDMAˢ, ôڲ׼дGRAM
+ * @param       sx,sy:ʼ(Ͻ)
+ * @param       width,height:ڿȺ͸߶
+ * @retval      
+ */
+static void lcd_window_begin(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height)
+{
+    while (g_lcd_dma_busy);                 /* ܴڽеDMAˢ */
+
+    lcd_set_window(sx, sy, width, height);  /* дλԶصϽ */
+    lcd_write_ram_prepare();
+}
+
+/**
+ * @brief       һδд: ָȫ, ֻ֤Ļ㺯
+ * @param       
+ * @retval      
+ */
+static void lcd_window_end(void)
+{
+    lcd_set_window(0, 0, lcddev.width, lcddev.height);
+}
+
+/**
+ * @brief       ο鴫: һδںд
+ * @param       sx,sy:ʼ(Ͻ)
+ * @param       width,height:Ⱥ͸߶,0
+ * @param       color: ɫ׵ַ,  width*height 
+ * @retval      
+ */
+void lcd_blit(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height, const uint16_t *color)
+{
+    uint16_t i;
+
+    if (lcd_window_supported())
+    {
+        lcd_window_begin(sx, sy, width, height);
+        lcd_write_pixels(color, (uint32_t)width * height);
+        lcd_window_end();
+        return;
+    }
+
+    while (g_lcd_dma_busy);
+
+    for (i = 0; i < height; i++)
+    {
+        lcd_set_cursor(sx, sy + i);
+        lcd_write_ram_prepare();
+        lcd_write_pixels(color, width);
+        color += width;
+    }
+}
+
+/**
+ * @brief       δɫ: һδںдͬһɫ
+ * @param       sx,sy:ʼ(Ͻ)
+ * @param       width,height:Ⱥ͸߶,0
+ * @param       color: ɫ
+ * @retval      
+ */
+void lcd_blit_solid(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height, uint16_t color)
+{
+    uint16_t i;
+
+    if (lcd_window_supported())
+    {
+        lcd_window_begin(sx, sy, width, height);
+        lcd_write_solid(color, (uint32_t)width * height);
+        lcd_window_end();
+        return;
+    }
+
+    while (g_lcd_dma_busy);
+
+    for (i = 0; i < height; i++)
+    {
+        lcd_set_cursor(sx, sy + i);
+        lcd_write_ram_prepare();
+        lcd_write_solid(color, width);
+    }
+}
+
 /**
  * @brief       
  * @param       color: Ҫɫ
@@ -794,16 +958,7 @@ void lcd_init(void)
  */
 void lcd_clear(uint16_t color)
 {
-    uint32_t index = 0;
-    uint32_t totalpoint = lcddev.width;
-    totalpoint *= lcddev.height;    /* õܵ */
-    lcd_set_cursor(0x00, 0x0000);   /* ùλ */
-    lcd_write_ram_prepare();        /* ʼдGRAM */
-
-    for (index = 0; index < totalpoint; index++)
-    {
-        LCD->LCD_RAM = color;
-   }
+    lcd_blit_solid(0, 0, lcddev.width, lcddev.height, color);
 }
 
 /**
@@ -814,20 +969,7 @@ void lcd_clear(uint16_t color)
  */
 void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint32_t color)
 {
-    uint16_t i, j;
-    uint16_t xlen = 0;
-    xlen = ex - sx + 1;
-
-    for (i = sy; i <= ey; i++)
-    {
-        lcd_set_cursor(sx, i);      /* ùλ */
-        lcd_write_ram_prepare();    /* ʼдGRAM */
-
-        for (j = 0; j < xlen; j++)
-        {
-            LCD->LCD_RAM = color;   /* ʾɫ */
-        }
-    }
+    lcd_blit_solid(sx, sy, ex - sx + 1, ey - sy + 1, (uint16_t)color);
 }
 
 /**
@@ -838,21 +980,237 @@ void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint32_t color
  */
 void lcd_color_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t *color)
 {
-    uint16_t height, width;
+    lcd_blit(sx, sy, ex - sx + 1, ey - sy + 1, color);
+}
+
+/**
+ * @brief       ɵд뷽ʽ (ÿһι, ±д), ڻ׼ԶԱ
+ * @param       sx,sy:ʼ(Ͻ)
+ * @param       width,height:Ⱥ͸߶
+ * @param       color: ɫ׵ַ
+ * @retval      
+ */
+static void lcd_bench_row_fill(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height, const uint16_t *color)
+{
     uint16_t i, j;
-    width = ex - sx + 1;            /* õĿ */
-    height = ey - sy + 1;           /* ߶ */
 
     for (i = 0; i < height; i++)
     {
-        lcd_set_cursor(sx, sy + i); /* ùλ */
-        lcd_write_ram_prepare();    /* ʼдGRAM */
+        lcd_set_cursor(sx, sy + i);
+        lcd_write_ram_prepare();
 
         for (j = 0; j < width; j++)
         {
-            LCD->LCD_RAM = color[i * width + j]; /* д */
+            LCD->LCD_RAM = color[i * width + j];
+        }
+    }
+}
+
+/**
+ * @brief       
+ * @param       px: 
+ * @param       us: ʱ(us)
+ * @retval      /
+ */
+static uint32_t lcd_bench_pps(uint32_t px, uint32_t us)
+{
+    return us ? (uint32_t)((uint64_t)px * 1000000 / us) : 0;
+}
+
+/**
+ * @brief       ˢٶȻ׼ (ḲĻ)
+ *   @note      ԵǰĻICͷ, IC(9341/7789/5310)ֱڶӦ.
+ *              ɫ: ȫlcd_clear; 鴫: scratchƴȫlcd_blit, ɵдԱ;
+ *              DMA: lcd_color_fill_dma ͬ (ѵlcd_dma_init, Ϊ0)
+ * @param       clock_us: ΢ʱ
+ * @param       scratch: Դݻ, һ
+ * @param       scratch_px: 
+ * @param       result: Խ
+ * @retval      
+ */
+void lcd_benchmark(uint32_t (*clock_us)(void), uint16_t *scratch, uint32_t scratch_px, lcd_bench_t *result)
+{
+    uint32_t i, t, px, rows, y;
+    uint32_t screen = (uint32_t)lcddev.width * lcddev.height;
+
+    result->id = lcddev.id;
+    result->width = lcddev.width;
+    result->height = lcddev.height;
+    result->solid_pps = 0;
+    result->blit_pps = 0;
+    result->row_pps = 0;
+    result->dma_pps = 0;
+
+    rows = scratch_px / lcddev.width;
+    if (rows == 0) return;
+    if (rows > lcddev.height) rows = lcddev.height;
+
+    for (i = 0; i < rows * lcddev.width; i++)
+    {
+        scratch[i] = (uint16_t)(i * 0x0841);    /* , ȫͬ */
+    }
+
+    /* ɫ */
+    t = clock_us();
+    for (i = 0; i < LCD_BENCH_LOOPS; i++)
+    {
+        lcd_clear(i & 1 ? BLACK : WHITE);
+    }
+    result->solid_pps = lcd_bench_pps(screen * LCD_BENCH_LOOPS, clock_us() - t);
+
+    /* 鴫 */
+    px = 0;
+    t = clock_us();
+    for (i = 0; i < LCD_BENCH_LOOPS; i++)
+    {
+        for (y = 0; y + rows <= lcddev.height; y += rows)
+        {
+            lcd_blit(0, y, lcddev.width, rows, scratch);
+            px += rows * lcddev.width;
         }
     }
+    result->blit_pps = lcd_bench_pps(px, clock_us() - t);
+
+    /* ɵд */
+    px = 0;
+    t = clock_us();
+    for (i = 0; i < LCD_BENCH_LOOPS; i++)
+    {
+        for (y = 0; y + rows <= lcddev.height; y += rows)
+        {
+            lcd_bench_row_fill(0, y, lcddev.width, rows, scratch);
+            px += rows * lcddev.width;
+        }
+    }
+    result->row_pps = lcd_bench_pps(px, clock_us() - t);
+
+    /* DMA */
+    if (LCD_DMA_CHANNEL->CMAR == (uint32_t)&LCD->LCD_RAM)
+    {
+        px = 0;
+        t = clock_us();
+        for (i = 0; i < LCD_BENCH_LOOPS; i++)
+        {
+            for (y = 0; y + rows <= lcddev.height; y += rows)
+            {
+                lcd_color_fill_dma(0, y, lcddev.width - 1, y + rows - 1, scratch, NULL);
+                while (g_lcd_dma_busy);
+                px += rows * lcddev.width;
+            }
+        }
+        result->dma_pps = lcd_bench_pps(px, clock_us() - t);
+    }
+
+    lcd_clear(WHITE);
+}
+
+/**
+ * @brief       ʼDMAˢ (lcd_init֮)
+ * @param       
+ * @retval      
+ */
+void lcd_dma_init(void)
+{
+    LCD_DMA_CLK_ENABLE();
+    LCD_DMA_CHANNEL->CCR = 0;
+    LCD_DMA_CHANNEL->CMAR = (uint32_t)&LCD->LCD_RAM;    /* Ŀ̶ΪLCDݿ */
+    sys_nvic_init(2, 0, LCD_DMA_IRQn, 2);               /* 2, ռ2, ȼ0 */
+}
+
+/**
+ * @brief       һDMA
+ * @param       
+ * @retval      
+ */
+static void lcd_dma_start_chunk(void)
+{
+    uint16_t n = (g_lcd_dma_remain > LCD_DMA_MAX_COUNT) ? LCD_DMA_MAX_COUNT : (uint16_t)g_lcd_dma_remain;
+
+    LCD_DMA_CHANNEL->CCR &= ~DMA_CCR1_EN;
+    LCD_DMA_CHANNEL->CPAR = (uint32_t)g_lcd_dma_src;
+    LCD_DMA_CHANNEL->CNDTR = n;
+    g_lcd_dma_src += n;
+    g_lcd_dma_remain -= n;
+
+    /* 洢洢, ȼ, 16λ, Դַ, /ж */
+    LCD_DMA_CHANNEL->CCR = DMA_CCR1_MEM2MEM | DMA_CCR1_PL_1 | DMA_CCR1_MSIZE_0 | DMA_CCR1_PSIZE_0 |
+                           DMA_CCR1_PINC | DMA_CCR1_TEIE | DMA_CCR1_TCIE | DMA_CCR1_EN;
+}
+
+/**
+ * @brief       DMAָָɫ
+ *   @note      ֻһδ, ذд; , ɺжеdone.
+ *              ǰ޸color, ҲܵLCD
+ * @param       (sx,sy),(ex,ey):ζԽ,СΪ:(ex - sx + 1) * (ey - sy + 1)
+ * @param       color: Ҫɫ׵ַ
+ * @param       done: ɻص, ΪNULL
+ * @retval      0, ; 1, һδδ
+ */
+uint8_t lcd_color_fill_dma(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint16_t *color, lcd_dma_done_cb_t done)
+{
+    uint16_t width, height;
+
+    if (g_lcd_dma_busy) return 1;
+
+    width = ex - sx + 1;
+    height = ey - sy + 1;
+
+    if (!lcd_window_supported())    /* ôд, ֱCPUд */
+    {
+        lcd_blit(sx, sy, width, height, color);
+        if (done) done();
+        return 0;
+    }
+
+    lcd_set_window(sx, sy, width, height);  /* дλԶصϽ */
+    lcd_write_ram_prepare();
+
+    g_lcd_dma_busy = 1;
+    g_lcd_dma_src = color;
+    g_lcd_dma_remain = (uint32_t)width * height;
+    g_lcd_dma_done = done;
+    lcd_dma_start_chunk();
+
+    return 0;
+}
+
+/**
+ * @brief       DMAˢǷ
+ * @param       
+ * @retval      1, ; 0, 
+ */
+uint8_t lcd_dma_busy(void)
+{
+    return g_lcd_dma_busy;
+}
+
+/**
+ * @brief       DMAˢжϷ
+ *   @note      δһ; ȫ()ָȫ,
+ *              ֻ֤Ļ/亯Ȼ, Ȼɻص
+ * @param       
+ * @retval      
+ */
+void LCD_DMA_IRQHandler(void)
+{
+    uint32_t isr = DMA2->ISR;
+
+    DMA2->IFCR = DMA_IFCR_CGIF1;
+
+    if ((isr & DMA_ISR_TEIF1) == 0 && g_lcd_dma_remain)
+    {
+        lcd_dma_start_chunk();
+        return;
+    }
+
+    LCD_DMA_CHANNEL->CCR &= ~DMA_CCR1_EN;
+    lcd_set_window(0, 0, lcddev.width, lcddev.height);
+    g_lcd_dma_busy = 0;
+
+    if (g_lcd_dma_done)
+    {
+        g_lcd_dma_done();
+    }
 }
 
 /**
@@ -2,8 +2,8 @@
  ****************************************************************************************************
  * @file        lcd.h
  * @author      ԭŶ(ALIENTEK)
- * @version     V1.2
- * @date        2023-05-31
+ * @version     V1.3
+ * @date        2026-10-17
  * @brief       2.8/3.5/4.3/7 TFTLCD(MCU) 
  *              ֧ICͺŰ:ILI9341/NT35310/NT35510/SSD1963/ST7789/ST7796/ILI9806 
  *
@@ -25,6 +25,10 @@
  * 2, 򻯲ִ, ⳤж
  * V1.2 20230531
  * 1, ST7796ILI9806 IC֧
+ * V1.3 20261017
+ * 1, lcd_color_fill_dma, һδںDMA2ͨ1ɫ˵LCD->LCD_RAM, ɺص
+ * 2, lcd_blit/lcd_blit_solid, һδں8չд, lcd_color_fill/lcd_fill/lcd_clearø÷ʽ
+ * 3, lcd_benchmarkˢٶȲ
  *
  ****************************************************************************************************
  */
@@ -200,6 +204,33 @@ typedef struct
 #define SSD_VT          (SSD_VER_RESOLUTION + SSD_VER_BACK_PORCH + SSD_VER_FRONT_PORCH)
 #define SSD_VPS         (SSD_VER_BACK_PORCH)
    
+/******************************************************************************************/
+/* LCD DMAˢ 
+ * 洢洢ģʽ: Դ(ַ)Ϊɫ, ַ; Ŀ(洢ַ)ΪLCD->LCD_RAM, ̶ַ
+ * ഫ65535, ڴжֶ
+ */
+#define LCD_DMA_CHANNEL         DMA2_Channel1
+#define LCD_DMA_IRQn            DMA2_Channel1_IRQn
+#define LCD_DMA_IRQHandler      DMA2_Channel1_IRQHandler
+#define LCD_DMA_CLK_ENABLE()    do{ RCC->AHBENR |= 1 << 1; }while(0)    /* DMA2ʱʹ */
+#define LCD_DMA_MAX_COUNT       0XFFFF
+
+typedef void (*lcd_dma_done_cb_t)(void);    /* DMAˢɻص (же) */
+
+/* ˢٶȲԽ (/) */
+#define LCD_BENCH_LOOPS         4       /* ÿظˢȫĴ */
+
+typedef struct
+{
+    uint16_t id;            /* LCDIC */
+    uint16_t width;         /* ʱĻ */
+    uint16_t height;        /* ʱĻ߶ */
+    uint32_t solid_pps;     /* ɫ (lcd_clear/lcd_fill) */
+    uint32_t blit_pps;      /* ڿ鴫 (lcd_blit/lcd_color_fill) */
+    uint32_t row_pps;       /* ɵùд, Ա */
+    uint32_t dma_pps;       /* DMAˢ (δʼDMAʱΪ0) */
+} lcd_bench_t;
+
 /******************************************************************************************/
 /*  */
 
@@ -227,6 +258,12 @@ void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t len, uint16_t color);
 void lcd_set_window(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height);             /* ô */
 void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint32_t color);          /* ɫ(32λɫ,LTDC) */
 void lcd_color_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t *color);   /* ɫ */
+void lcd_blit(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height, const uint16_t *color);      /* ο鴫 */
+void lcd_blit_solid(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height, uint16_t color);      /* δɫ */
+void lcd_benchmark(uint32_t (*clock_us)(void), uint16_t *scratch, uint32_t scratch_px, lcd_bench_t *result);   /* ˢٶȲ */
+void lcd_dma_init(void);                                                                    /* ʼDMAˢ */
+uint8_t lcd_color_fill_dma(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint16_t *color, lcd_dma_done_cb_t done);   /* DMAɫ */
+uint8_t lcd_dma_busy(void);                                                                 /* DMAˢǷ */
 void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);     /* ֱ */
 void lcd_draw_rectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);/*  */
 
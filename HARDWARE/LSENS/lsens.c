@@ -23,7 +23,6 @@
 
 #include "adc.h"
 #include "lsens.h"
-#include "delay.h"
 
 
 /**
@@ -38,7 +37,7 @@ void Lsens_Init(void)
     sys_gpio_set(LSENS_ADC3_CHX_GPIO_PORT, LSENS_ADC3_CHX_GPIO_PIN,
                  SYS_GPIO_MODE_AIN, SYS_GPIO_OTYPE_PP, SYS_GPIO_SPEED_MID, SYS_GPIO_PUPD_PU);   /* ADɼģʽ,ģ */
 
-    Adc3_Init();   /* ʼADC */
+    Adc3_Dma_Init(LSENS_ADC3_CHX);   /* ʼADC3, TIM1+DMĄѭ */
 }
 
 /**
@@ -48,14 +47,9 @@ void Lsens_Init(void)
  */
 void Lsens_Get_Val(uint8_t* li)
 {
-    uint32_t temp_val = 0;
-		uint8_t t;
-		for(t=0;t<LSENS_READ_TIMES;t++)
-		{
-				temp_val+=Get_Adc3(LSENS_ADC3_CHX);	//ȡADCֵ
-				delay_ms(5);
-		}
-		temp_val/=LSENS_READ_TIMES;
+    uint32_t temp_val;
+
+    temp_val = Adc3_Dma_Get_Average();  /* DMAƽֵ,  */
     temp_val /= 40;
     if (temp_val > 100)temp_val = 100;
     *li = (uint8_t)(100 - temp_val);
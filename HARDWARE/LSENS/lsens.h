@@ -36,7 +36,6 @@
 
 
 #define LSENS_ADC3_CHX                      ADC_Channel_6       /* ͨY,  0 <= Y <= 17 */ 
-#define LSENS_READ_TIMES										10
 
 /******************************************************************************************/
  
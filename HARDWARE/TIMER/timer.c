@@ -1,6 +1,11 @@
 #include "timer.h"
 #include "led.h"
-#include "lvgl.h" 
+
+static volatile u32 g_tim3_ms=0;	//TIM3,ÿθжϼ1
+
+//DWTڼĴ(CMSIS V1.30core_cm3.hδDWT)
+#define DWT_CTRL		(*(volatile u32 *)0xE0001000)
+#define DWT_CYCCNT		(*(volatile u32 *)0xE0001004)
 
 //ͨöʱ3жϳʼ
 //ʱѡΪAPB12APB1Ϊ36M
@@ -39,18 +44,62 @@ void TIM3_IRQHandler(void)   //TIM3
 		if(TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET)  //TIM3жϷ
 		{
 			TIM_ClearITPendingBit(TIM3, TIM_IT_Update  );  //TIMxжϱ־ 
-			lv_tick_inc(1);
+			g_tim3_ms++;			//LVGLͨLV_TICK_CUSTOMֱӶȡmillis(),жеlv_tick_inc
 		}
 }
 
+//ȡϵͳк(TIM3жϼ)
+//ֵ:ϵĺ,Լ49.7һ
+u32 TIM3_Get_Ms(void)
+{
+	return g_tim3_ms;
+}
 
+//ȡϵͳ΢
+//TIM372M/(psc+1)¼,һΪ1ms,CNT²
+//ע:1msڵ(delay_initΪTIM3_Int_Init(999,71),CNTÿ1us1),Լ71ӻһ,ֻڼʱ
+//ڲܱTIM3ռж(ͬȼUSART3)еʱ,CNTѻƶg_tim3_msû1,
+//CNT֮UIF:־λCNTǰ,˵λδ,1ms
+u32 TIM3_Get_Us(void)
+{
+	u32 ms,cnt,arr;
+	u16 sr;
+	do
+	{
+		ms=g_tim3_ms;
+		cnt=TIM3->CNT;
+		sr=TIM3->SR;
+	}while(ms!=g_tim3_ms);		//ȡڼ䷢˸ж,¶ȡ
+	arr=TIM3->ARR+1;
+	if((sr&TIM_SR_UIF)&&cnt<arr/2)ms++;	//CNT֮ǰѻ,жϻδִ
+	return ms*1000+cnt*1000/arr;
+}
 
+//ϵͳʱ:ʱ(delay_us/delay_ms)LVGLġͨЭ鹲TIM3
+//TIM3delay_init,˺κģ鶼Ե
+//ֵ:ϵĺ,Լ49.7һ,ʱʱ޷ż
+u32 millis(void)
+{
+	return g_tim3_ms;
+}
 
+//ֵ:ϵ΢,Լ71ӻһ,ֻڼʱ
+u32 micros(void)
+{
+	return TIM3_Get_Us();
+}
 
+//DWTڼ,
+//CYCCNTںʱ(72MHz),Լ59.6һ,ֻڼʱ
+void DWT_Init(void)
+{
+	CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;	//ʹDWT
+	DWT_CYCCNT=0;
+	DWT_CTRL|=1;									//CYCCNTENA
+}
 
-
-
-
-
-
-
+//ȡDWTڼ
+u32 DWT_Get_Cycles(void)
+{
+	return DWT_CYCCNT;
+}
@@ -16,5 +16,14 @@
 
 
 void TIM3_Int_Init(u16 arr,u16 psc);
+u32 TIM3_Get_Ms(void);		//ȡϵͳк
+u32 TIM3_Get_Us(void);		//ȡϵͳ΢
+
+//ϵͳʱ (TIM3, delay_init, ȫģ鹲)
+u32 millis(void);			//ϵĺ
+u32 micros(void);			//ϵ΢
+
+void DWT_Init(void);		//DWTڼ
+u32 DWT_Get_Cycles(void);	//ȡDWTڼ(ںʱ)
  
 #endif
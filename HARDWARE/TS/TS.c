@@ -25,25 +25,14 @@ void TS_Init(void)
 		
 		GPIO_Init(TS_GPIO_PORT, &GPIO_InitStructure);				// ʼ ADC IO
 
-		ADCx_Init();
-}
-
-uint16_t TS_ADC_Read(void)
-{
-	//ָADCĹͨʱ
-	return ADC_GetValue(ADC_CHANNEL, ADC_SampleTime_55Cycles5);
+		Adc1_Dma_Init(ADC_CHANNEL);	// ADC1TIM1,DMĄѭ
 }
 
 void TS_GetData(uint8_t* st)
 {
-	uint32_t  tempData = 0;
-	for (int i = 0; i < TS_READ_TIMES; i++)
-	{
-		tempData += TS_ADC_Read();
-		delay_ms(5);
-	}
-
-	tempData /= TS_READ_TIMES;
+	uint32_t  tempData;
+
+	tempData = Adc1_Dma_Get_Average();	// DMAƽֵ,
 	*st = 100 - (float)tempData/40.96;
 }
 
@@ -1,7 +1,7 @@
 #ifndef __TS_H
 #define	__TS_H
 #include "stm32f10x.h"
-#include "adcx.h"
+#include "adc.h"
 #include "delay.h"
 #include "math.h"
 
@@ -18,7 +18,6 @@
 
 **********************BEGIN***********************/
 
-#define TS_READ_TIMES	10  //ʪADCѭȡ
 
 
 /***************Լ****************/
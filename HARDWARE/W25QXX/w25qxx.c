@@ -169,6 +169,7 @@ void W25QXX_Write_NoCheck(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
 		}
 	};	    
 } 
+#if W25QXX_RMW_WRITE
 //дSPI FLASH  
 //ַָʼдָȵ
 //ú!
@@ -220,6 +221,7 @@ void W25QXX_Write(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite)
 		}	 
 	};	 
 }
+#endif
 //оƬ		  
 //ȴʱ䳬...
 void W25QXX_Erase_Chip(void)   
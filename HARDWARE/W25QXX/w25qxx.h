@@ -33,6 +33,7 @@
 #define NM25Q128	0X5217
 #define NM25Q256 	0X5218
 
+#define W25QXX_RMW_WRITE	0			//1:W25QXX_Write (Ҫ4KֽRAM), ʷ־ֻðҳд
 extern u16 W25QXX_TYPE;					//W25QXXоƬͺ		   
 
 #define	W25QXX_CS 		PBout(12)  		//W25QXXƬѡź
@@ -65,7 +66,9 @@ void W25QXX_Write_Enable(void);  		//дʹ
 void W25QXX_Write_Disable(void);		//д
 void W25QXX_Write_NoCheck(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite);
 void W25QXX_Read(u8* pBuffer,u32 ReadAddr,u16 NumByteToRead);   //ȡflash
+#if W25QXX_RMW_WRITE
 void W25QXX_Write(u8* pBuffer,u32 WriteAddr,u16 NumByteToWrite);//дflash
+#endif
 void W25QXX_Erase_Chip(void);    	  	//Ƭ
 void W25QXX_Erase_Sector(u32 Dst_Addr);	//
 void W25QXX_Wait_Busy(void);           	//ȴ
@@ -12,9 +12,12 @@
 #include "lv_port_disp_template.h"
 #include "../../lvgl.h"
 #include "lcd.h"
+#include "timer.h"
+#include "perf.h"
 /*********************
  *      DEFINES
  *********************/
+#define DISP_BUF_PX         (320 * 10)      /*Total draw buffer size in pixels (split in two when DMA is used)*/
 
 /**********************
  *      TYPEDEFS
@@ -26,12 +29,33 @@
 static void disp_init(void);
 
 static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+static void disp_flush_done(lv_disp_drv_t * disp_drv);
+static void disp_wait(lv_disp_drv_t * disp_drv);
+static void disp_refr_timer(lv_timer_t * timer);
+static void overlay_update(lv_timer_t * timer);
+#if LV_PORT_DISP_USE_DMA
+static void disp_dma_done(void);
+#endif
 //static void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
 //        const lv_area_t * fill_area, lv_color_t color);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_disp_drv_t disp_drv;              /*Descriptor of a display driver*/
+static lv_port_disp_stats_t disp_stats;     /*Flush timing statistics*/
+static uint32_t frame_start_us;             /*When the first area of the current frame started flushing*/
+static uint32_t frame_cpu_us;               /*CPU time spent in flush_cb during the current frame*/
+static uint32_t frame_px;                   /*Pixels flushed during the current frame*/
+static uint32_t flush_start_us;             /*When the current area started flushing*/
+static uint8_t frame_open;                  /*1: the current frame has started flushing*/
+static uint32_t frame_wait_us;              /*Time LVGL waited for a free buffer during the current refresh*/
+static uint32_t wait_last_us;               /*Previous wait_cb call of the current wait*/
+static volatile uint8_t wait_open;          /*1: LVGL is spinning in wait_cb, cleared when an area is written*/
+static lv_obj_t * overlay_label;            /*Performance overlay, NULL when hidden*/
+static lv_timer_t * overlay_timer;
+static uint32_t overlay_frames;             /*Frame counter at the previous overlay update*/
+static uint32_t overlay_ms;                 /*Time of the previous overlay update*/
 
 /**********************
  *      MACROS
@@ -73,10 +97,19 @@ void lv_port_disp_init(void)
      *      and you only need to change the frame buffer's address.
      */
 
+#if LV_PORT_DISP_USE_DMA
+    /* Example for 2): same RAM as before, split into two 5-row buffers.
+     * LVGL renders the next stripe into one buffer while DMA streams the other to the LCD*/
+    static lv_disp_draw_buf_t draw_buf_dsc_1;
+    static lv_color_t buf_2_1[DISP_BUF_PX / 2];                 /*A buffer for 5 rows*/
+    static lv_color_t buf_2_2[DISP_BUF_PX / 2];                 /*An other buffer for 5 rows*/
+    lv_disp_draw_buf_init(&draw_buf_dsc_1, buf_2_1, buf_2_2, DISP_BUF_PX / 2);   /*Initialize the display buffer*/
+#else
     /* Example for 1) */
     static lv_disp_draw_buf_t draw_buf_dsc_1;
-    static lv_color_t buf_1[320 * 10];                          /*A buffer for 10 rows*/
-    lv_disp_draw_buf_init(&draw_buf_dsc_1, buf_1, NULL, 320 * 10);   /*Initialize the display buffer*/
+    static lv_color_t buf_1[DISP_BUF_PX];                       /*A buffer for 10 rows*/
+    lv_disp_draw_buf_init(&draw_buf_dsc_1, buf_1, NULL, DISP_BUF_PX);   /*Initialize the display buffer*/
+#endif
 
     /* Example for 2) */
 //    static lv_disp_draw_buf_t draw_buf_dsc_2;
@@ -94,7 +127,6 @@ void lv_port_disp_init(void)
      * Register the display in LVGL
      *----------------------------------*/
 
-    static lv_disp_drv_t disp_drv;                         /*Descriptor of a display driver*/
     lv_disp_drv_init(&disp_drv);                    /*Basic initialization*/
 
     /*Set up the functions to access to your display*/
@@ -106,6 +138,9 @@ void lv_port_disp_init(void)
     /*Used to copy the buffer's content to the display*/
     disp_drv.flush_cb = disp_flush;
 
+    /*Called while LVGL waits for a draw buffer, used to separate waiting from rendering*/
+    disp_drv.wait_cb = disp_wait;
+
     /*Set a display buffer*/
     disp_drv.draw_buf = &draw_buf_dsc_1;
 
@@ -118,7 +153,84 @@ void lv_port_disp_init(void)
     //disp_drv.gpu_fill_cb = gpu_fill;
 
     /*Finally register the driver*/
-    lv_disp_drv_register(&disp_drv);
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    /*Wrap the refresh timer to time each refresh and count its invalidated areas*/
+    lv_timer_set_cb(disp->refr_timer, disp_refr_timer);
+}
+
+/**
+ * Get the flush timing statistics.
+ * A frame is every area flushed by one refresh, from the start of the first area
+ * until the last area is written to the LCD.
+ * @param stats pointer to store the statistics
+ */
+void lv_port_disp_get_stats(lv_port_disp_stats_t * stats)
+{
+    if(stats == NULL) return;
+    *stats = disp_stats;
+    stats->dma = LV_PORT_DISP_USE_DMA;
+
+#if LV_MEM_CUSTOM == 0
+    /*Walking the heap takes a while, so the memory figures are sampled here instead of every frame*/
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    stats->mem_used = mon.total_size - mon.free_size;
+    stats->mem_free = mon.free_size;
+    /*lv_mem_monitor() of this LVGL version leaves max_used at 0, so keep the peak of the samples*/
+    if(stats->mem_used > disp_stats.mem_max_used) disp_stats.mem_max_used = stats->mem_used;
+    stats->mem_max_used = disp_stats.mem_max_used;
+    stats->mem_frag_pct = mon.frag_pct;
+#endif
+}
+
+/**
+ * Clear the flush timing statistics.
+ */
+void lv_port_disp_reset_stats(void)
+{
+    lv_memset_00(&disp_stats, sizeof(disp_stats));
+    overlay_frames = 0;
+}
+
+/**
+ * Show or hide the performance overlay in the bottom right corner.
+ * It shows the frame rate, render and flush time, the size of the last frame and lv_mem usage,
+ * refreshed every LV_PORT_DISP_OVERLAY_PERIOD ms.
+ * @param en true: show, false: hide
+ */
+void lv_port_disp_overlay(bool en)
+{
+    if(en == (overlay_label != NULL)) return;
+
+    if(en) {
+        overlay_label = lv_label_create(lv_layer_sys());
+        lv_obj_set_style_bg_opa(overlay_label, LV_OPA_50, 0);
+        lv_obj_set_style_bg_color(overlay_label, lv_color_black(), 0);
+        lv_obj_set_style_text_color(overlay_label, lv_color_white(), 0);
+        lv_obj_set_style_pad_all(overlay_label, 3, 0);
+        lv_obj_align(overlay_label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+        lv_label_set_text(overlay_label, "");
+
+        overlay_frames = disp_stats.frames;
+        overlay_ms = lv_tick_get();
+        overlay_timer = lv_timer_create(overlay_update, LV_PORT_DISP_OVERLAY_PERIOD, NULL);
+    }
+    else {
+        lv_timer_del(overlay_timer);
+        lv_obj_del(overlay_label);
+        overlay_timer = NULL;
+        overlay_label = NULL;
+    }
+}
+
+/**
+ * Check whether the performance overlay is shown.
+ * @return true: shown
+ */
+bool lv_port_disp_overlay_is_on(void)
+{
+    return overlay_label != NULL;
 }
 
 /**********************
@@ -131,6 +243,9 @@ static void disp_init(void)
     /*You code here*/
 		lcd_init();
 		lcd_display_dir(1);
+#if LV_PORT_DISP_USE_DMA
+		lcd_dma_init();
+#endif
 }
 
 /*Flush the content of the internal buffer the specific area on the display
@@ -138,10 +253,124 @@ static void disp_init(void)
  *'lv_disp_flush_ready()' has to be called when finished.*/
 static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
 {
-		lcd_color_fill(area->x1,area->y1,area->x2,area->y2,(uint16_t *)color_p);
+    PERF_BEGIN(PERF_FLUSH);
+    flush_start_us = micros();
+    if(!frame_open) {
+        frame_open = 1;
+        frame_start_us = flush_start_us;
+        frame_cpu_us = 0;
+        frame_px = 0;
+    }
+    frame_px += (uint32_t)lv_area_get_size(area);
+    disp_stats.flushes++;
+
+#if LV_PORT_DISP_USE_DMA
+    /*Only the window setup runs here, the pixels are moved by DMA and
+     *'lv_disp_flush_ready()' is called from the transfer complete interrupt*/
+    lcd_color_fill_dma(area->x1, area->y1, area->x2, area->y2, (const uint16_t *)color_p, disp_dma_done);
+    frame_cpu_us += micros() - flush_start_us;
+#else
+    lcd_color_fill(area->x1, area->y1, area->x2, area->y2, (uint16_t *)color_p);
+    frame_cpu_us += micros() - flush_start_us;
+    disp_flush_done(disp_drv);
+#endif
+    PERF_END(PERF_FLUSH);
+}
+
+#if LV_PORT_DISP_USE_DMA
+/*Called from the LCD DMA interrupt when an area has been written*/
+static void disp_dma_done(void)
+{
+    disp_flush_done(&disp_drv);
+}
+#endif
+
+/*Account the finished area and tell LVGL the buffer is free again*/
+static void disp_flush_done(lv_disp_drv_t * disp_drv)
+{
+    uint32_t now = micros();
+    uint32_t frame_us;
+
+    wait_open = 0;
+    disp_stats.busy_us += now - flush_start_us;
+
+    if(lv_disp_flush_is_last(disp_drv)) {
+        frame_us = now - frame_start_us;
+        frame_open = 0;
+        disp_stats.frames++;
+        disp_stats.last_frame_us = frame_us;
+        disp_stats.last_cpu_us = frame_cpu_us;
+        disp_stats.last_px = frame_px;
+        disp_stats.total_frame_us += frame_us;
+        disp_stats.total_cpu_us += frame_cpu_us;
+        if(frame_us > disp_stats.max_frame_us) disp_stats.max_frame_us = frame_us;
+    }
+
     lv_disp_flush_ready(disp_drv);
 }
 
+/*LVGL spins here until a draw buffer is free. The time from the first call of a spin to the
+ *last one is counted as waiting; the part after the last call is below one loop iteration*/
+static void disp_wait(lv_disp_drv_t * disp_drv)
+{
+    uint32_t now = micros();
+
+    LV_UNUSED(disp_drv);
+    if(wait_open) frame_wait_us += now - wait_last_us;
+    wait_last_us = now;
+    wait_open = 1;
+}
+
+/*Replaces the refresh timer callback: render time is what remains of the refresh
+ *after the CPU part of flush_cb and the waits for a free buffer*/
+static void disp_refr_timer(lv_timer_t * timer)
+{
+    lv_disp_t * disp = timer->user_data;
+    uint16_t areas = disp->inv_p;
+    uint32_t flushes = disp_stats.flushes;
+    uint32_t start = micros();
+    uint32_t refr_us, busy_us, render_us;
+
+    frame_wait_us = 0;
+    wait_open = 0;
+    _lv_disp_refr_timer(timer);
+    if(areas == 0) return;
+
+    refr_us = micros() - start;
+    busy_us = (disp_stats.flushes != flushes ? frame_cpu_us : 0) + frame_wait_us;
+    render_us = refr_us > busy_us ? refr_us - busy_us : 0;
+
+    disp_stats.last_render_us = render_us;
+    disp_stats.total_render_us += render_us;
+    if(render_us > disp_stats.max_render_us) disp_stats.max_render_us = render_us;
+    disp_stats.last_wait_us = frame_wait_us;
+    disp_stats.last_areas = areas;
+}
+
+/*Redraw the overlay text from the latest statistics*/
+static void overlay_update(lv_timer_t * timer)
+{
+    lv_port_disp_stats_t st;
+    uint32_t now = lv_tick_get();
+    uint32_t elaps = now - overlay_ms;
+    uint32_t fps;
+
+    LV_UNUSED(timer);
+    lv_port_disp_get_stats(&st);
+    fps = elaps ? (st.frames - overlay_frames) * 1000 / elaps : 0;
+    overlay_frames = st.frames;
+    overlay_ms = now;
+
+    /*Times in 0.1 ms, lv_snprintf is built without float support*/
+    lv_label_set_text_fmt(overlay_label,
+                          "%" LV_PRIu32 " FPS  rnd %" LV_PRIu32 ".%" LV_PRIu32 " ms\n"
+                          "flush %" LV_PRIu32 ".%" LV_PRIu32 " ms  %" LV_PRIu32 " px/%d\n"
+                          "mem %" LV_PRIu32 "/%" LV_PRIu32 " B  frag %d%%",
+                          fps, st.last_render_us / 1000, st.last_render_us / 100 % 10,
+                          st.last_frame_us / 1000, st.last_frame_us / 100 % 10, st.last_px, st.last_areas,
+                          st.mem_used, st.mem_used + st.mem_free, st.mem_frag_pct);
+}
+
 /*OPTIONAL: GPU INTERFACE*/
 
 /*If your MCU has hardware accelerator (GPU) then you can use it to fill a memory with a color*/
@@ -21,15 +21,47 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/*1: stream areas to the LCD with DMA and render into two buffers in parallel,
+ *0: write every pixel from the CPU with one buffer (kept to compare flush time)*/
+#define LV_PORT_DISP_USE_DMA    1
+
+/*Refresh period of the performance overlay [ms]. The overlay redraws itself at this rate,
+ *so while it is shown it accounts for at least 1000 / period frames per second*/
+#define LV_PORT_DISP_OVERLAY_PERIOD     500
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    uint32_t frames;            /*Refreshes flushed completely*/
+    uint32_t flushes;           /*Areas passed to flush_cb*/
+    uint32_t last_frame_us;     /*Last frame: first area start -> last area written*/
+    uint32_t max_frame_us;      /*Longest frame*/
+    uint64_t total_frame_us;    /*Sum of frame times, divide by frames for the average*/
+    uint32_t last_cpu_us;       /*Last frame: CPU time spent inside flush_cb*/
+    uint64_t total_cpu_us;      /*Sum of CPU time spent inside flush_cb*/
+    uint64_t busy_us;           /*Sum of area transfer times (flush_cb -> area written)*/
+    uint32_t last_px;           /*Pixels in the last frame*/
+    uint32_t last_render_us;    /*Last frame: refresh time minus flush_cb and buffer waits*/
+    uint32_t max_render_us;     /*Longest render time*/
+    uint64_t total_render_us;   /*Sum of render times*/
+    uint32_t last_wait_us;      /*Last frame: time LVGL waited for a free draw buffer*/
+    uint16_t last_areas;        /*Invalidated areas in the last frame (before joining)*/
+    uint32_t mem_used;          /*lv_mem bytes in use (sampled by lv_port_disp_get_stats)*/
+    uint32_t mem_free;          /*lv_mem bytes free*/
+    uint32_t mem_max_used;      /*lv_mem high-water mark*/
+    uint8_t mem_frag_pct;       /*lv_mem fragmentation: 100 - biggest free block / free size*/
+    uint8_t dma;                /*1: DMA flush is compiled in*/
+} lv_port_disp_stats_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void lv_port_disp_init(void);
+void lv_port_disp_get_stats(lv_port_disp_stats_t * stats);
+void lv_port_disp_reset_stats(void);
+void lv_port_disp_overlay(bool en);
+bool lv_port_disp_overlay_is_on(void);
 
 /**********************
  *      MACROS
@@ -1,4 +1,5 @@
 #include "delay.h"
+#include "timer.h"
 ////////////////////////////////////////////////////////////////////////////////// 	 
 //ҪʹOS,ͷļ.
 #if SYSTEM_SUPPORT_OS
@@ -41,6 +42,9 @@
 //UCOSIII֧ʱ2bug
 //delay_tickspersecΪdelay_ostickspersec
 //delay_intnestingΪdelay_osintnesting
+//V1.9޸˵ 20261017
+//OS²ÿʱSysTick,ΪTIM3ϵͳʱļʱ,
+//delay_initͬʱTIM3(1us,1ms),ʱLVGLġͨЭ鹲ͬһʱ
 //////////////////////////////////////////////////////////////////////////////////  
 
 static u8  fac_us=0;							//usʱ			   
@@ -145,6 +149,7 @@ void delay_init()
 #else
 	fac_ms=(u16)fac_us*1000;					//OS,ÿmsҪsystickʱ   
 #endif
+	TIM3_Int_Init(999,71);						//ϵͳʱ:72M/72=1MHz,1000θһμ1ms
 }								    
 
 #if SYSTEM_SUPPORT_OS  							//Ҫ֧OS.
@@ -188,39 +193,31 @@ void delay_ms(u16 nms)
 }
 #else //OSʱ
 //ʱnus
-//nusΪҪʱus.		    								   
+//nusΪҪʱus.
+//TIM3(1us1,0~999ѭ)ʱ,ж,жϻжʱҲʹ
+//ǰζȡļ1ms(æѭ,жϴʱʱӦ䳤)
 void delay_us(u32 nus)
-{		
-	u32 temp;	    	 
-	SysTick->LOAD=nus*fac_us; 					//ʱ	  		 
-	SysTick->VAL=0x00;        					//ռ
-	SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//ʼ	  
-	do
+{
+	u32 told,tnow,tcnt=0;
+	u32 reload=TIM3->ARR+1;						//һڵļֵ
+	told=TIM3->CNT;								//սʱļֵ
+	while(tcnt<nus)
 	{
-		temp=SysTick->CTRL;
-	}while((temp&0x01)&&!(temp&(1<<16)));		//ȴʱ䵽   
-	SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//رռ
-	SysTick->VAL =0X00;      					 //ռ	 
+		tnow=TIM3->CNT;
+		if(tnow!=told)
+		{
+			if(tnow>told)tcnt+=tnow-told;		//TIM3ǵ
+			else tcnt+=reload-told+tnow;		//˸¼
+			told=tnow;
+		}
+	}
 }
 //ʱnms
-//עnmsķΧ
-//SysTick->LOADΪ24λĴ,,ʱΪ:
-//nms<=0xffffff*8*1000/SYSCLK
-//SYSCLKλΪHz,nmsλΪms
-//72M,nms<=1864 
+//nms:Ҫʱms
 void delay_ms(u16 nms)
-{	 		  	  
-	u32 temp;		   
-	SysTick->LOAD=(u32)nms*fac_ms;				//ʱ(SysTick->LOADΪ24bit)
-	SysTick->VAL =0x00;							//ռ
-	SysTick->CTRL|=SysTick_CTRL_ENABLE_Msk ;	//ʼ  
-	do
-	{
-		temp=SysTick->CTRL;
-	}while((temp&0x01)&&!(temp&(1<<16)));		//ȴʱ䵽   
-	SysTick->CTRL&=~SysTick_CTRL_ENABLE_Msk;	//رռ
-	SysTick->VAL =0X00;       					//ռ	  	    
-} 
+{
+	delay_us((u32)nms*1000);
+}
 #endif 
 
 
@@ -0,0 +1,29 @@
+#!/bin/sh
+# 端到端协议基准: 每个场景用模拟器 (--mock) 运行一次, 输出一个JSON对象 {"场景名": 模拟器结果, ...}
+# 模拟器结果中的 "mock" 为服务器侧统计 (命令->动作/ack延迟分位数, 重连, 心跳超时检测, 吞吐)
+#
+# 用法: Simulator/bench.sh [模拟器路径] [时长ms] > bench.json
+
+SIM=${1:-build-sim/flowerpot_sim}
+DURATION=${2:-180000}
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+run() {
+    name=$1
+    shift
+    "$SIM" --duration "$DURATION" --mock -q --json "$TMP/$name.json" "$@" || exit 1
+    printf '%s"%s": ' "$SEP" "$name"
+    cat "$TMP/$name.json"
+    SEP=','
+}
+
+SEP=''
+echo '{'
+run base
+run delay100    --delay 100
+run loss5       --loss 5
+run drop30s     --drop-every 30000
+run stall       --stall 30000:120000
+run bin1        --bin
+echo '}'
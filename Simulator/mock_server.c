@@ -0,0 +1,702 @@
+/**
+ ****************************************************************************************************
+ * @file        mock_server.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       V2.0协议模拟服务器 (协议处理/故障注入/延迟统计)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 上行报文按 '\n' 结尾的JSON或 0xA5 开头的bin1帧切分, 经过注入的链路延迟后才被"服务器"处理;
+ *   下行报文同样在链路上排队, 到达时间之前 mock_server_output() 不会取出
+ * - 命令循环: 注册后先下发一次 ctl mode=1 (手动模式, 否则继电器命令只回复ok=0),
+ *   然后每 ctl_every_ms (加随机抖动) 依次下发 灯/风扇/水泵 开, get_status, 灯/风扇/水泵 关, cfg (默认阈值)
+ * - 延迟统计: 命令->继电器动作 (只有模拟器能报告动作时刻), 命令->收到ack, 断开->重新注册;
+ *   时间都从服务器写出命令算起, 包含注入的链路延迟
+ *
+ ****************************************************************************************************
+ */
+
+#include "mock_server.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+/******************************************************************************************/
+/* 私有类型 */
+
+/* 在途报文 */
+typedef struct {
+    uint64_t due_us;                                        /* 到达对端的时间 */
+    uint16_t len;
+    uint8_t  data[MOCK_MSG_MAX];
+} mock_msg_t;
+
+/* 单向链路 (按序到达, 丢包重传阻塞后面的报文) */
+typedef struct {
+    mock_msg_t q[MOCK_QUEUE_SIZE];
+    uint8_t  head;
+    uint8_t  count;
+    uint64_t last_due_us;
+    uint32_t msgs;                                          /* 已送达报文数 */
+    uint32_t bytes;
+    uint32_t retx;                                          /* 重传次数 */
+    uint32_t overflow;                                      /* 队列满丢弃 */
+} mock_link_t;
+
+/* 等待ack的命令 */
+typedef struct {
+    uint32_t id;
+    int8_t   key;                                           /* 继电器编号, -1不是继电器命令 */
+    uint8_t  on;
+    uint8_t  acted;
+    uint8_t  manual;                                        /* 切换手动模式的命令 */
+    uint64_t sent_us;
+} mock_pending_t;
+
+/* 延迟样本 (us) */
+typedef struct {
+    uint32_t n;
+    uint32_t v[MOCK_SAMPLES_MAX];
+} mock_samples_t;
+
+/* 下发的命令 */
+typedef struct {
+    const char *type;
+    const char *payload;
+    int8_t      key;
+    uint8_t     on;
+} mock_cmd_t;
+
+static const mock_cmd_t s_cmds[] = {
+    { "ctl", "\"k\":\"light\",\"s\":1", MOCK_KEY_LIGHT, 1 },
+    { "ctl", "\"k\":\"fan\",\"s\":1",   MOCK_KEY_FAN,   1 },
+    { "ctl", "\"k\":\"water\",\"s\":1", MOCK_KEY_WATER, 1 },
+    { "act", "\"k\":\"get_status\"",    -1, 0 },
+    { "ctl", "\"k\":\"light\",\"s\":0", MOCK_KEY_LIGHT, 0 },
+    { "ctl", "\"k\":\"fan\",\"s\":0",   MOCK_KEY_FAN,   0 },
+    { "ctl", "\"k\":\"water\",\"s\":0", MOCK_KEY_WATER, 0 },
+    { "cfg", "\"temp_upper\":30,\"temp_lower\":10,\"humi_upper\":70,\"humi_lower\":40,"
+             "\"soil_upper\":65,\"soil_lower\":40,\"light_upper\":90,\"light_lower\":50", -1, 0 },
+};
+static const mock_cmd_t s_cmd_manual = { "ctl", "\"k\":\"mode\",\"s\":1", -1, 0 };
+
+static const char *const s_up_types[] = { "reg", "hb", "dat", "sta", "ack", "perf", "bin", "other" };
+#define MOCK_UP_TYPES           (sizeof(s_up_types) / sizeof(s_up_types[0]))
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static mock_server_cfg_t s_cfg;
+static uint64_t s_init_us;
+static uint64_t s_unix_ms;                                  /* s_init_us 时刻的Unix时间 */
+static uint32_t s_rand;                                     /* 丢包 */
+static uint32_t s_rand_cmd;                                 /* 命令间隔抖动 */
+
+static mock_link_t s_up;                                    /* 设备->服务器 */
+static mock_link_t s_down;                                  /* 服务器->设备 */
+
+/* 上行报文拼接 */
+static struct {
+    uint8_t  buf[MOCK_MSG_MAX];
+    uint16_t len;
+    uint16_t need;                                          /* bin1帧的总长度, 0表示JSON */
+} s_rx;
+
+/* 当前连接 */
+static struct {
+    uint8_t  open;
+    uint8_t  registered;                                    /* 已回复reg_ok */
+    uint8_t  reg_seen;                                      /* 收到了reg (停顿期间收到的在停顿结束后回复) */
+    uint64_t open_us;
+    uint64_t next_cmd_us;                                   /* 下次下发命令的时间 */
+    char     dev[32];                                       /* 设备ID (reg中的"d") */
+} s_conn;
+
+static mock_pending_t s_pending[MOCK_PENDING_MAX];
+static uint8_t  s_pending_count;
+static uint32_t s_next_id = 1000;
+static uint32_t s_msg_seq;
+static uint8_t  s_cycle;
+static uint8_t  s_manual;                                   /* 设备已切换到手动模式 */
+
+static struct {
+    uint32_t connects;
+    uint32_t server_drops;
+    uint32_t device_closes;
+    uint64_t last_close_us;                                 /* 0: 还没有断开过 */
+    uint64_t conn_us;                                       /* 已关闭连接的累计时长 */
+    uint32_t up_by_type[MOCK_UP_TYPES];
+    uint32_t stall_ignored;                                 /* 停顿期间丢弃的上行报文 */
+    uint32_t cmds;
+    uint32_t acked;
+    uint32_t failed;                                        /* ack的ok为0 */
+    uint32_t lost;                                          /* 超时没有ack */
+    uint32_t acts;
+    uint32_t hb;
+    uint32_t hb_in_stall;                                   /* 停顿期间设备发出的心跳 */
+    int64_t  stall_detect_us;                               /* 停顿开始到设备断开, -1表示未检测到 */
+} s_st;
+
+static mock_samples_t s_lat_act;                            /* 命令->继电器动作 */
+static mock_samples_t s_lat_ack;                            /* 命令->ack */
+static mock_samples_t s_lat_reconn;                         /* 断开->重新注册 */
+
+/******************************************************************************************/
+/* 私有函数 */
+
+static uint32_t lcg(uint32_t *state)
+{
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+static uint8_t rand_pct(void)
+{
+    return (uint8_t)(lcg(&s_rand) % 100);
+}
+
+/**
+ * @brief  安排下一条命令: 间隔加上最多1/4间隔的随机抖动, 避免与设备的任务周期锁相
+ */
+static void cmd_schedule(uint64_t now_us)
+{
+    uint32_t jitter_us = s_cfg.ctl_every_ms * 250;
+
+    s_conn.next_cmd_us = now_us + s_cfg.ctl_every_ms * 1000ULL + (jitter_us ? (lcg(&s_rand_cmd) << 8 | lcg(&s_rand_cmd)) % jitter_us : 0);
+}
+
+static void sample_add(mock_samples_t *s, uint64_t us)
+{
+    if (s->n < MOCK_SAMPLES_MAX) s->v[s->n++] = us > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)us;
+}
+
+static uint8_t stall_active(uint64_t now_us)
+{
+    uint64_t t = (now_us - s_init_us) / 1000;
+
+    return s_cfg.stall_ms != 0 && t >= s_cfg.stall_at_ms && t < (uint64_t)s_cfg.stall_at_ms + s_cfg.stall_ms;
+}
+
+static void link_reset(mock_link_t *l)
+{
+    l->head = 0;
+    l->count = 0;
+    l->last_due_us = 0;
+}
+
+/**
+ * @brief  报文进入链路: 固定延迟 + 丢包重传, 不早于前一条报文到达 (TCP按序交付)
+ */
+static void link_push(mock_link_t *l, uint64_t now_us, const uint8_t *data, uint16_t len)
+{
+    uint64_t due = now_us + (uint64_t)s_cfg.delay_ms * 1000;
+    uint32_t rto = MOCK_RTO_MS;
+    mock_msg_t *m;
+
+    if (l->count >= MOCK_QUEUE_SIZE)
+    {
+        l->overflow++;
+        return;
+    }
+    while (s_cfg.loss_pct != 0 && rand_pct() < s_cfg.loss_pct && rto <= MOCK_RTO_MS * 8)
+    {
+        due += (uint64_t)rto * 1000;
+        rto *= 2;
+        l->retx++;
+    }
+    if (due < l->last_due_us) due = l->last_due_us;
+    l->last_due_us = due;
+
+    if (len > MOCK_MSG_MAX) len = MOCK_MSG_MAX;
+    m = &l->q[(l->head + l->count) % MOCK_QUEUE_SIZE];
+    m->due_us = due;
+    m->len = len;
+    memcpy(m->data, data, len);
+    l->count++;
+}
+
+/**
+ * @brief  取出已到达的一条报文
+ */
+static mock_msg_t *link_pop(mock_link_t *l, uint64_t now_us)
+{
+    mock_msg_t *m;
+
+    if (l->count == 0 || l->q[l->head].due_us > now_us) return NULL;
+    m = &l->q[l->head];
+    l->head = (l->head + 1) % MOCK_QUEUE_SIZE;
+    l->count--;
+    l->msgs++;
+    l->bytes += m->len;
+    return m;
+}
+
+/**
+ * @brief  下发一条V2.0报文
+ */
+static void send_msg(uint64_t now_us, uint32_t id, const char *type, const char *fmt, ...)
+{
+    char buf[MOCK_MSG_MAX];
+    char payload[MOCK_MSG_MAX - 128];
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    vsnprintf(payload, sizeof(payload), fmt, ap);
+    va_end(ap);
+
+    n = snprintf(buf, sizeof(buf), "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%llu,\"t\":\"%s\",\"d\":\"%s\",\"p\":{%s}}\n",
+                 (unsigned long)id, (unsigned long long)(s_unix_ms + (now_us - s_init_us) / 1000),
+                 type, s_conn.dev, payload);
+    if (n > (int)sizeof(buf) - 1) n = sizeof(buf) - 1;
+    link_push(&s_down, now_us, (const uint8_t *)buf, (uint16_t)n);
+}
+
+/**
+ * @brief  下发命令并登记等待ack
+ */
+static void send_cmd(uint64_t now_us, const mock_cmd_t *cmd)
+{
+    mock_pending_t *p;
+
+    if (s_pending_count >= MOCK_PENDING_MAX) return;
+
+    p = &s_pending[s_pending_count++];
+    p->id = s_next_id++;
+    p->key = cmd->key;
+    p->on = cmd->on;
+    p->acted = 0;
+    p->manual = (cmd == &s_cmd_manual);
+    p->sent_us = now_us;
+    send_msg(now_us, p->id, cmd->type, "%s", cmd->payload);
+    s_st.cmds++;
+    cmd_schedule(now_us);
+}
+
+static void pending_remove(uint8_t i)
+{
+    s_pending_count--;
+    memmove(&s_pending[i], &s_pending[i + 1], (size_t)(s_pending_count - i) * sizeof(s_pending[0]));
+}
+
+/**
+ * @brief  取JSON报文中字符串字段的值 (模拟服务器只需要顶层的t/d和p.ref, 简单查找即可)
+ */
+static uint8_t json_str(const char *json, const char *key, char *out, uint16_t size)
+{
+    char pat[24];
+    const char *p;
+    uint16_t i;
+
+    snprintf(pat, sizeof(pat), "\"%s\":\"", key);
+    p = strstr(json, pat);
+    if (p == NULL) return 1;
+    p += strlen(pat);
+    for (i = 0; i + 1 < size && p[i] != '"' && p[i] != '\0'; i++) out[i] = p[i];
+    out[i] = '\0';
+    return 0;
+}
+
+static void on_ack(uint64_t now_us, const char *json)
+{
+    char ref[16];
+    const char *ok;
+    uint32_t id;
+    uint8_t i;
+
+    if (json_str(json, "ref", ref, sizeof(ref)) != 0) return;
+    id = (uint32_t)strtoul(ref, NULL, 10);
+    ok = strstr(json, "\"ok\":");
+
+    for (i = 0; i < s_pending_count; i++)
+    {
+        if (s_pending[i].id != id) continue;
+        sample_add(&s_lat_ack, now_us - s_pending[i].sent_us);
+        if (ok != NULL && ok[5] == '1')
+        {
+            s_st.acked++;
+            if (s_pending[i].manual) s_manual = 1;
+        }
+        else
+        {
+            s_st.failed++;
+        }
+        pending_remove(i);
+        return;
+    }
+}
+
+/**
+ * @brief  回复注册, 未切换手动模式时先下发模式命令
+ */
+static void on_register(uint64_t now_us)
+{
+    s_conn.registered = 1;
+    send_msg(now_us, s_msg_seq++, "reg_ok", s_cfg.bin ? "\"enc\":\"bin1\"" : "");
+    if (!s_manual) send_cmd(now_us, &s_cmd_manual);
+    else cmd_schedule(now_us);
+}
+
+/**
+ * @brief  处理一条到达服务器的上行报文
+ */
+static void on_uplink(uint64_t now_us, mock_msg_t *m)
+{
+    char type[8] = "bin";
+    char *json = (char *)m->data;
+    uint8_t i;
+
+    if (m->data[0] == '{')
+    {
+        m->data[m->len < MOCK_MSG_MAX ? m->len : MOCK_MSG_MAX - 1] = '\0';
+        if (json_str(json, "t", type, sizeof(type)) != 0) type[0] = '\0';
+    }
+    for (i = 0; i < MOCK_UP_TYPES - 1 && strcmp(type, s_up_types[i]) != 0; i++);
+    s_st.up_by_type[i]++;
+
+    if (strcmp(type, "reg") == 0 && !s_conn.reg_seen)
+    {
+        s_conn.reg_seen = 1;
+        json_str(json, "d", s_conn.dev, sizeof(s_conn.dev));
+        if (s_st.last_close_us != 0) sample_add(&s_lat_reconn, now_us - s_st.last_close_us);
+    }
+
+    if (stall_active(now_us))
+    {
+        if (strcmp(type, "hb") == 0) s_st.hb_in_stall++;
+        s_st.stall_ignored++;
+        return;
+    }
+
+    if (strcmp(type, "reg") == 0)
+    {
+        on_register(now_us);
+    }
+    else if (strcmp(type, "hb") == 0)
+    {
+        s_st.hb++;
+        send_msg(now_us, s_msg_seq++, "hb_ok", "");
+    }
+    else if (strcmp(type, "ack") == 0)
+    {
+        on_ack(now_us, json);
+    }
+}
+
+/**
+ * @brief  连接结束 (任一方关闭)
+ */
+static void conn_end(uint64_t now_us)
+{
+    s_st.conn_us += now_us - s_conn.open_us;
+    s_st.last_close_us = now_us ? now_us : 1;
+    s_conn.open = 0;
+    s_conn.registered = 0;
+    s_conn.reg_seen = 0;
+    s_rx.len = 0;
+    link_reset(&s_up);
+    link_reset(&s_down);
+}
+
+/**
+ * @brief  百分位 (最近秩法), 样本已排序
+ */
+static double pct_ms(const uint32_t *v, uint32_t n, uint32_t pct)
+{
+    uint32_t k;
+
+    if (n == 0) return 0;
+    k = (n * pct + 99) / 100;
+    return v[k ? k - 1 : 0] / 1000.0;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void report_samples(FILE *fp, const char *name, const mock_samples_t *s)
+{
+    static uint32_t v[MOCK_SAMPLES_MAX];
+
+    memcpy(v, s->v, s->n * sizeof(v[0]));
+    qsort(v, s->n, sizeof(v[0]), cmp_u32);
+    fprintf(fp, "\"%s\": {\"n\": %lu, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}",
+            name, (unsigned long)s->n, pct_ms(v, s->n, 50), pct_ms(v, s->n, 90), pct_ms(v, s->n, 99),
+            s->n ? v[s->n - 1] / 1000.0 : 0.0);
+}
+
+/******************************************************************************************/
+/* 接口 */
+
+void mock_server_default_cfg(mock_server_cfg_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->ctl_every_ms = 2000;
+    cfg->seed = 1;
+}
+
+const char *mock_server_usage(void)
+{
+    return "          [--ctl-every MS] [--delay MS] [--loss PCT] [--drop-every MS] [--stall AT_MS:MS]\n"
+           "          [--bin] [--seed N]\n";
+}
+
+/**
+ * @brief  解析模拟服务器的选项 (独立服务器和模拟器共用)
+ */
+int mock_server_parse_opt(mock_server_cfg_t *cfg, const char *opt, const char *val)
+{
+    unsigned long a, b;
+
+    if (strcmp(opt, "--bin") == 0)
+    {
+        cfg->bin = 1;
+        return 1;
+    }
+    if (strcmp(opt, "--ctl-every") != 0 && strcmp(opt, "--delay") != 0 && strcmp(opt, "--loss") != 0 &&
+        strcmp(opt, "--drop-every") != 0 && strcmp(opt, "--stall") != 0 && strcmp(opt, "--seed") != 0)
+    {
+        return 0;
+    }
+    if (val == NULL) return -1;
+
+    if (strcmp(opt, "--stall") == 0)
+    {
+        if (sscanf(val, "%lu:%lu", &a, &b) != 2) return -1;
+        cfg->stall_at_ms = (uint32_t)a;
+        cfg->stall_ms = (uint32_t)b;
+        return 2;
+    }
+
+    a = strtoul(val, NULL, 0);
+    if (strcmp(opt, "--ctl-every") == 0) cfg->ctl_every_ms = (uint32_t)a;
+    else if (strcmp(opt, "--delay") == 0) cfg->delay_ms = (uint32_t)a;
+    else if (strcmp(opt, "--drop-every") == 0) cfg->drop_every_ms = (uint32_t)a;
+    else if (strcmp(opt, "--seed") == 0) cfg->seed = (uint32_t)a;
+    else if (a > 100) return -1;
+    else cfg->loss_pct = (uint8_t)a;
+    return 2;
+}
+
+/**
+ * @brief  初始化
+ * @param  now_us:  当前时间
+ * @param  unix_ms: 当前Unix时间 (reg_ok/hb_ok的ts)
+ */
+void mock_server_init(const mock_server_cfg_t *cfg, uint64_t now_us, uint64_t unix_ms)
+{
+    s_cfg = *cfg;
+    s_init_us = now_us;
+    s_unix_ms = unix_ms;
+    s_rand = cfg->seed;
+    s_rand_cmd = cfg->seed ^ 0x5A5A5A5Au;
+    memset(&s_st, 0, sizeof(s_st));
+    s_st.stall_detect_us = -1;
+}
+
+/**
+ * @brief  设备建立连接
+ * @retval 0:接受 1:已有连接
+ */
+uint8_t mock_server_open(uint64_t now_us)
+{
+    if (s_conn.open) return 1;
+
+    memset(&s_conn, 0, sizeof(s_conn));
+    s_conn.open = 1;
+    s_conn.open_us = now_us;
+    s_rx.len = 0;
+    link_reset(&s_up);
+    link_reset(&s_down);
+    s_st.connects++;
+    return 0;
+}
+
+/**
+ * @brief  设备关闭连接 (心跳超时重连, 或设备复位)
+ */
+void mock_server_close(uint64_t now_us)
+{
+    uint64_t stall_us = s_init_us + (uint64_t)s_cfg.stall_at_ms * 1000;
+
+    if (!s_conn.open) return;
+    s_st.device_closes++;
+    if (s_st.stall_detect_us < 0 && stall_active(now_us)) s_st.stall_detect_us = (int64_t)(now_us - stall_us);
+    conn_end(now_us);
+}
+
+/**
+ * @brief  设备发来的字节, 切分成报文后进入上行链路
+ */
+void mock_server_input(uint64_t now_us, const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+    uint8_t c;
+
+    if (!s_conn.open) return;
+
+    for (i = 0; i < len; i++)
+    {
+        c = data[i];
+        if (s_rx.len == 0)
+        {
+            if (c != '{' && c != 0xA5) continue;            /* 报文之间的空白 */
+            s_rx.need = 0;
+        }
+        if (s_rx.len < MOCK_MSG_MAX) s_rx.buf[s_rx.len] = c;
+        s_rx.len++;
+
+        if (s_rx.buf[0] == 0xA5 && s_rx.len == 2) s_rx.need = (uint16_t)(c + 3);   /* 帧头+len+内容+校验和 */
+
+        if ((s_rx.need == 0 && c == '\n') || (s_rx.need != 0 && s_rx.len >= s_rx.need))
+        {
+            link_push(&s_up, now_us, s_rx.buf, s_rx.len < MOCK_MSG_MAX ? s_rx.len : MOCK_MSG_MAX);
+            s_rx.len = 0;
+        }
+    }
+}
+
+/**
+ * @brief  取出一条已到达设备的下行报文
+ * @retval 长度, 0表示没有
+ */
+uint16_t mock_server_output(uint64_t now_us, uint8_t *buf, uint16_t size)
+{
+    mock_msg_t *m;
+    uint16_t len;
+
+    if (!s_conn.open) return 0;
+    m = link_pop(&s_down, now_us);
+    if (m == NULL) return 0;
+    len = m->len < size ? m->len : size;
+    memcpy(buf, m->data, len);
+    return len;
+}
+
+/**
+ * @brief  定时处理: 上行报文到达, 命令下发与超时, 主动断开
+ * @retval 1:服务器断开了连接
+ */
+uint8_t mock_server_poll(uint64_t now_us)
+{
+    mock_msg_t *m;
+    uint8_t i;
+
+    while ((m = link_pop(&s_up, now_us)) != NULL)
+    {
+        on_uplink(now_us, m);
+    }
+
+    for (i = 0; i < s_pending_count; )
+    {
+        if (now_us - s_pending[i].sent_us > MOCK_ACK_TIMEOUT_MS * 1000ULL)
+        {
+            s_st.lost++;
+            pending_remove(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (!s_conn.open) return 0;
+
+    if (s_conn.reg_seen && !s_conn.registered && !stall_active(now_us)) on_register(now_us);
+    if (s_conn.registered && s_cfg.ctl_every_ms != 0 && !stall_active(now_us) &&
+        now_us >= s_conn.next_cmd_us)
+    {
+        send_cmd(now_us, s_manual ? &s_cmds[s_cycle++ % (sizeof(s_cmds) / sizeof(s_cmds[0]))] : &s_cmd_manual);
+    }
+
+    if (s_cfg.drop_every_ms != 0 && now_us - s_conn.open_us >= s_cfg.drop_every_ms * 1000ULL)
+    {
+        s_st.server_drops++;
+        conn_end(now_us);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  建立连接的耗时: 三次握手的一个往返
+ */
+uint32_t mock_server_connect_us(void)
+{
+    return s_cfg.delay_ms * 2000 + 1000;
+}
+
+/**
+ * @brief  继电器动作: 匹配最早下发的同一继电器, 同一状态且尚未动作的命令
+ */
+void mock_server_actuated(uint64_t now_us, uint8_t key, uint8_t on)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_pending_count; i++)
+    {
+        if (s_pending[i].key == (int8_t)key && s_pending[i].on == on && !s_pending[i].acted)
+        {
+            s_pending[i].acted = 1;
+            s_st.acts++;
+            sample_add(&s_lat_act, now_us - s_pending[i].sent_us);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief  输出统计 (一个JSON对象, 不含结尾换行)
+ * @param  indent: 除第一行外每行的缩进
+ */
+void mock_server_report(FILE *fp, uint64_t now_us, const char *indent)
+{
+    double conn_s = (s_st.conn_us + (s_conn.open ? now_us - s_conn.open_us : 0)) / 1e6;
+    uint32_t up_msgs = 0;
+    uint8_t i;
+
+    for (i = 0; i < MOCK_UP_TYPES; i++) up_msgs += s_st.up_by_type[i];
+
+    fprintf(fp, "{\"config\": {\"ctl_every_ms\": %lu, \"delay_ms\": %lu, \"loss_pct\": %u, \"drop_every_ms\": %lu, "
+            "\"stall_at_ms\": %lu, \"stall_ms\": %lu, \"bin\": %u},\n",
+            (unsigned long)s_cfg.ctl_every_ms, (unsigned long)s_cfg.delay_ms, s_cfg.loss_pct,
+            (unsigned long)s_cfg.drop_every_ms, (unsigned long)s_cfg.stall_at_ms, (unsigned long)s_cfg.stall_ms, s_cfg.bin);
+
+    fprintf(fp, "%s \"commands\": {\"sent\": %lu, \"acked\": %lu, \"failed\": %lu, \"lost\": %lu, \"pending\": %u, \"actuated\": %lu,\n%s  ",
+            indent, (unsigned long)s_st.cmds, (unsigned long)s_st.acked, (unsigned long)s_st.failed,
+            (unsigned long)s_st.lost, s_pending_count, (unsigned long)s_st.acts, indent);
+    report_samples(fp, "cmd_to_act_ms", &s_lat_act);
+    fprintf(fp, ",\n%s  ", indent);
+    report_samples(fp, "cmd_to_ack_ms", &s_lat_ack);
+    fprintf(fp, "},\n");
+
+    fprintf(fp, "%s \"connection\": {\"connects\": %lu, \"server_drops\": %lu, \"device_closes\": %lu, \"connected_s\": %.1f, ",
+            indent, (unsigned long)s_st.connects, (unsigned long)s_st.server_drops,
+            (unsigned long)s_st.device_closes, conn_s);
+    report_samples(fp, "reconnect_ms", &s_lat_reconn);
+    fprintf(fp, "},\n");
+
+    fprintf(fp, "%s \"heartbeat\": {\"received\": %lu, \"in_stall\": %lu, \"stall_ignored\": %lu, \"stall_detect_ms\": %.1f},\n",
+            indent, (unsigned long)s_st.hb, (unsigned long)s_st.hb_in_stall, (unsigned long)s_st.stall_ignored,
+            s_st.stall_detect_us < 0 ? -1.0 : s_st.stall_detect_us / 1000.0);
+
+    fprintf(fp, "%s \"uplink\": {\"msgs\": %lu, \"bytes\": %lu, \"msgs_per_s\": %.2f, \"bytes_per_s\": %.1f, \"retransmits\": %lu, \"by_type\": {",
+            indent, (unsigned long)up_msgs, (unsigned long)s_up.bytes, conn_s > 0 ? up_msgs / conn_s : 0.0,
+            conn_s > 0 ? s_up.bytes / conn_s : 0.0, (unsigned long)s_up.retx);
+    for (i = 0; i < MOCK_UP_TYPES; i++)
+    {
+        fprintf(fp, "%s\"%s\": %lu", i ? ", " : "", s_up_types[i], (unsigned long)s_st.up_by_type[i]);
+    }
+    fprintf(fp, "}},\n");
+
+    fprintf(fp, "%s \"downlink\": {\"msgs\": %lu, \"bytes\": %lu, \"retransmits\": %lu}}",
+            indent, (unsigned long)s_down.msgs, (unsigned long)s_down.bytes, (unsigned long)s_down.retx);
+}
@@ -0,0 +1,79 @@
+/**
+ ****************************************************************************************************
+ * @file        mock_server.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       V2.0协议模拟服务器 (协议处理/故障注入/延迟统计)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 代替 myserver.h 中的生产服务器: 回复 reg_ok/hb_ok (带服务器时间戳), 周期下发 ctl/act/cfg,
+ *   按 ack 的 ref 匹配命令, 统计命令->执行->确认的延迟分位数、心跳超时和上行吞吐
+ * - 与传输无关: 上行字节由 mock_server_input() 送入, 下行报文由 mock_server_output() 取出,
+ *   时间由调用者给出 (us). mock_server_main.c 用TCP套接字和主机时钟运行,
+ *   模拟器 (--mock) 在进程内经ESP8266透传模型连接, 使用虚拟时钟, 并报告继电器动作时刻
+ * - 故障注入 (双向):
+ *   延迟: 每条报文固定增加单向延迟
+ *   丢包: 按概率丢失一次报文段, 表现为TCP重传 (200ms起, 连续丢失加倍), 后续报文被队头阻塞
+ *   断开: 连接建立一段时间后服务器主动关闭
+ *   停顿: 某时刻起服务器停止处理和发送 (连接保持), 用于测量心跳超时检测时间
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __MOCK_SERVER_H
+#define __MOCK_SERVER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define MOCK_MSG_MAX            512         /* 一条报文的最大长度 */
+#define MOCK_QUEUE_SIZE         32          /* 每个方向在途的报文数 */
+#define MOCK_PENDING_MAX        16          /* 等待ack的命令数 */
+#define MOCK_SAMPLES_MAX        4096        /* 每项延迟统计保存的样本数 */
+#define MOCK_ACK_TIMEOUT_MS     10000       /* 命令超过此时间没有ack计为丢失 */
+#define MOCK_RTO_MS             200         /* 丢包后的首次重传时间 */
+
+#define MOCK_KEY_LIGHT          0           /* 继电器编号 (与 mock_server_actuated() 一致) */
+#define MOCK_KEY_WATER          1
+#define MOCK_KEY_FAN            2
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+typedef struct {
+    uint32_t ctl_every_ms;                  /* 下发命令的间隔, 0不下发 */
+    uint32_t delay_ms;                      /* 单向传输延迟 */
+    uint8_t  loss_pct;                      /* 报文段丢失率 (%) */
+    uint32_t drop_every_ms;                 /* 连接保持该时间后服务器断开, 0不断开 */
+    uint32_t stall_at_ms;                   /* 停顿开始时间 (从mock_server_init起算) */
+    uint32_t stall_ms;                      /* 停顿时长, 0不停顿 */
+    uint8_t  bin;                           /* 1: reg_ok协商bin1二进制上报 */
+    uint32_t seed;                          /* 随机数种子 (丢包, 命令间隔抖动) */
+} mock_server_cfg_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+void mock_server_default_cfg(mock_server_cfg_t *cfg);
+int mock_server_parse_opt(mock_server_cfg_t *cfg, const char *opt, const char *val);  /* 0:不是本模块的选项 1:已处理(无参数) 2:已处理(用掉参数) -1:参数错误 */
+const char *mock_server_usage(void);        /* 选项说明 */
+
+void mock_server_init(const mock_server_cfg_t *cfg, uint64_t now_us, uint64_t unix_ms);
+uint8_t mock_server_open(uint64_t now_us);  /* 设备建立连接, 0:接受 */
+void mock_server_close(uint64_t now_us);    /* 设备关闭连接 */
+void mock_server_input(uint64_t now_us, const uint8_t *data, uint16_t len);   /* 设备发来的字节 */
+uint16_t mock_server_output(uint64_t now_us, uint8_t *buf, uint16_t size);    /* 取出一条已到达设备的下行报文 */
+uint8_t mock_server_poll(uint64_t now_us);  /* 定时处理, 1:服务器断开连接 */
+uint32_t mock_server_connect_us(void);      /* 建立连接的耗时 (一个往返) */
+void mock_server_actuated(uint64_t now_us, uint8_t key, uint8_t on);          /* 继电器动作 (只有模拟器能观测) */
+void mock_server_report(FILE *fp, uint64_t now_us, const char *indent);       /* 输出统计 (JSON对象) */
+
+#endif /* __MOCK_SERVER_H */
@@ -0,0 +1,189 @@
+/**
+ ****************************************************************************************************
+ * @file        mock_server_main.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       独立的本地模拟服务器: TCP监听, 主机时钟, 结束时输出JSON统计
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 用法: flowerpot_server [选项]
+ *   --port N             监听端口 (默认8003, 与MY_SERVER_PORT一致)
+ *   --bind ADDR          监听地址 (默认127.0.0.1; 接真实开发板时用0.0.0.0并修改MY_SERVER_IP)
+ *   --duration MS        运行时长, 0表示直到Ctrl+C (默认0)
+ *   --json FILE          统计输出到文件 (默认标准输出)
+ *   以及 mock_server.h 中的故障注入选项 (--ctl-every/--delay/--loss/--drop-every/--stall/--bin/--seed)
+ *
+ * 同一时间只服务一个设备连接; 真实开发板无法报告继电器动作时刻, 只统计命令->ack延迟
+ *
+ ****************************************************************************************************
+ */
+
+#include "mock_server.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+static uint64_t mono_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint64_t unix_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [--port N] [--bind ADDR] [--duration MS] [--json FILE]\n%s", prog, mock_server_usage());
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    mock_server_cfg_t cfg;
+    const char *bind_addr = "127.0.0.1";
+    const char *json_path = NULL;
+    unsigned long port = 8003, duration_ms = 0;
+    struct sockaddr_in addr;
+    struct pollfd pfd[2];
+    uint8_t buf[MOCK_MSG_MAX];
+    uint64_t start_us, now_us;
+    int lfd, cfd = -1, one = 1, i, r;
+    ssize_t n;
+    uint16_t len;
+    FILE *fp = stdout;
+
+    mock_server_default_cfg(&cfg);
+    for (i = 1; i < argc; i++)
+    {
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        r = mock_server_parse_opt(&cfg, argv[i], v);
+        if (r < 0) usage(argv[0]);
+        if (r > 0)
+        {
+            i += r - 1;
+            continue;
+        }
+        if (v == NULL) usage(argv[0]);
+        if (strcmp(argv[i], "--port") == 0) port = strtoul(v, NULL, 0);
+        else if (strcmp(argv[i], "--bind") == 0) bind_addr = v;
+        else if (strcmp(argv[i], "--duration") == 0) duration_ms = strtoul(v, NULL, 0);
+        else if (strcmp(argv[i], "--json") == 0) json_path = v;
+        else usage(argv[0]);
+        i++;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (port == 0 || port > 65535 || inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1) usage(argv[0]);
+
+    lfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (lfd < 0 || setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(lfd, 1) != 0)
+    {
+        fprintf(stderr, "mock: cannot listen on %s:%lu: %s\n", bind_addr, port, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "mock: listening on %s:%lu\n", bind_addr, port);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    start_us = mono_us();
+    mock_server_init(&cfg, start_us, unix_ms());
+
+    while (!s_stop)
+    {
+        now_us = mono_us();
+        if (duration_ms != 0 && now_us - start_us >= duration_ms * 1000ULL) break;
+
+        pfd[0].fd = lfd;
+        pfd[0].events = (cfd < 0) ? POLLIN : 0;
+        pfd[1].fd = cfd;
+        pfd[1].events = POLLIN;
+        poll(pfd, cfd < 0 ? 1 : 2, 1);                      /* 1ms: 链路延迟和命令间隔的精度 */
+        now_us = mono_us();
+
+        if (cfd < 0 && (pfd[0].revents & POLLIN))
+        {
+            cfd = accept(lfd, NULL, NULL);
+            if (cfd >= 0)
+            {
+                setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                mock_server_open(now_us);
+                fprintf(stderr, "mock: device connected\n");
+            }
+        }
+
+        if (cfd >= 0 && (pfd[1].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            n = recv(cfd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n > 0)
+            {
+                mock_server_input(now_us, buf, (uint16_t)n);
+            }
+            else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                mock_server_close(now_us);
+                close(cfd);
+                cfd = -1;
+                fprintf(stderr, "mock: device disconnected\n");
+            }
+        }
+
+        if (mock_server_poll(now_us) && cfd >= 0)
+        {
+            close(cfd);
+            cfd = -1;
+            fprintf(stderr, "mock: dropped connection\n");
+        }
+
+        while (cfd >= 0 && (len = mock_server_output(now_us, buf, sizeof(buf))) != 0)
+        {
+            if (send(cfd, buf, len, MSG_NOSIGNAL) < 0) break;
+        }
+    }
+
+    if (cfd >= 0) close(cfd);
+    close(lfd);
+
+    if (json_path != NULL && (fp = fopen(json_path, "w")) == NULL)
+    {
+        fprintf(stderr, "mock: cannot write %s\n", json_path);
+        fp = stdout;
+    }
+    mock_server_report(fp, mono_us(), "");
+    fprintf(fp, "\n");
+    if (fp != stdout) fclose(fp);
+    return 0;
+}
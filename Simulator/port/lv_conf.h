@@ -0,0 +1,20 @@
+/**
+ * @file lv_conf.h
+ * Host simulator wrapper around the firmware's lv_conf.h.
+ * Found before the real one through the include path order set in CMakeLists.txt.
+ */
+
+#ifndef SIM_LV_CONF_H
+#define SIM_LV_CONF_H
+
+#include "../../Middlewares/LVGL/GUI/lvgl/lv_conf.h"
+
+/*Pointers and most LVGL structs are about twice as large on a 64-bit host, so the
+ *48 KB pool of the target would run out. Scale it; lv_mem_monitor() in the summary
+ *reports host sizes and is only comparable between simulator runs.*/
+#define SIM_LV_MEM_SCALE    2U
+
+#undef LV_MEM_SIZE
+#define LV_MEM_SIZE         (48U * 1024U * SIM_LV_MEM_SCALE)
+
+#endif /*SIM_LV_CONF_H*/
@@ -0,0 +1,29 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_port.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       固件源码在主机下编译时强制包含的头文件 (-include)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 先包含原版stm32f10x.h, 外设基址/结构体/位带宏保持不变, 寄存器访问落在sim_periph.c映射的内存上
+ * - core_cm3.h中只有NVIC_SystemReset()会展开成ARM指令 (dsb), 改为调用模拟实现
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SIM_PORT_H
+#define __SIM_PORT_H
+
+#include "stm32f10x.h"
+
+void sim_system_reset(void);                /* 软件复位: 输出结果后退出 */
+
+#define NVIC_SystemReset    sim_system_reset
+
+#endif /* __SIM_PORT_H */
@@ -0,0 +1,2 @@
+/* main.c 以 "ts.h" 包含土壤湿度传感器头文件, Linux下文件名区分大小写 */
+#include "TS.h"
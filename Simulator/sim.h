@@ -0,0 +1,125 @@
+/**
+ ****************************************************************************************************
+ * @file        sim.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机模拟器内部接口 (虚拟时钟/外设模型/运行参数)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 固件源码 (USER/main.c, Functions/, AT引擎, LVGL移植层, LVGL 8.2) 原样编译,
+ *   只有直接操作寄存器的驱动 (.c) 由本目录的模拟实现替换, 头文件仍使用原来的
+ * - 虚拟时钟 = 主机上实际经过的时间 + 空闲时跳过的时间: 任务执行耗时是主机上的真实耗时,
+ *   WFI和延时不真正等待, 所以运行速度远快于实时; --realtime 时按实时运行
+ * - "中断" (LCD DMA完成, ESP8266应答/服务器数据到达, 按键/触摸脚本) 在读取时钟和空闲时派发
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "mock_server.h"
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define SIM_LCD_WIDTH           320         /* 横屏分辨率 */
+#define SIM_LCD_HEIGHT          240
+#define SIM_LCD_DMA_PPS         9000000     /* 模拟DMA刷屏速度 (像素/秒, FSMC 16位总线的估计值) */
+#define SIM_FLASH_SIZE          (16UL * 1024 * 1024)    /* W25Q128 */
+#define SIM_MAX_EVENTS          64          /* 按键/触摸脚本事件数上限 */
+#define SIM_KEY_HOLD_MS         100         /* 脚本按键/触摸的按下时长 */
+#define SIM_UNIX_MS             1760000000000ULL    /* 虚拟时钟0点对应的Unix时间 (--mock的服务器时间戳) */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+/* 脚本输入事件 */
+typedef struct {
+    uint32_t at_ms;                         /* 触发时间 (虚拟时钟) */
+    uint8_t  key;                           /* KEY0_PRES/KEY1_PRES/WKUP_PRES, SIM_KEY_TPAD, SIM_KEY_TAP */
+    uint16_t x, y;                          /* 触摸坐标 (SIM_KEY_TAP) */
+} sim_event_t;
+
+#define SIM_KEY_TPAD            10          /* 与UI_Switch中TPAD的编码一致 */
+#define SIM_KEY_TAP             20          /* 触摸屏点击 */
+
+/* 运行参数 */
+typedef struct {
+    uint32_t duration_ms;                   /* 运行时长 (虚拟时钟), 到时输出结果并退出 */
+    uint8_t  realtime;                      /* 1: 按实时运行, 空闲时真正等待 */
+    uint8_t  quiet;                         /* 1: 不输出固件的调试串口打印 */
+    const char *out_dir;                    /* 截屏输出目录, NULL不截屏 */
+    uint32_t shot_every_ms;                 /* 周期截屏间隔, 0只在结束时截屏 */
+    const char *json_path;                  /* 结果JSON输出文件, NULL输出到标准输出 */
+    const char *flash_path;                 /* W25QXX镜像文件, 启动时载入, 结束时写回 */
+    const char *server_host;                /* CIPSTART实际连接的主机, NULL表示不联网 (连接失败) */
+    uint16_t server_port;
+    uint8_t  mock;                          /* 1: CIPSTART连接进程内的模拟服务器 (虚拟时钟) */
+    mock_server_cfg_t mock_cfg;
+    uint8_t  wifi_saved;                    /* 1: 模块已保存WiFi并自动连接 */
+    uint8_t  wifi_ap;                       /* 1: 路由器可用 */
+    uint32_t day_ms;                        /* 环境模型的一天 (光照/温度周期) */
+    uint32_t dht_fail_ms;                   /* DHT11从该时刻起不再更新 (传感器失效), 0表示不失效 */
+    double   soil_pct;                      /* 土壤 (根区) 初始湿度 (%) */
+    sim_event_t events[SIM_MAX_EVENTS];
+    uint8_t  event_count;
+} sim_config_t;
+
+/* 网络统计 (ESP8266透传数据) */
+typedef struct {
+    uint32_t tx_bytes;                      /* 设备发给服务器的字节数 */
+    uint32_t rx_bytes;                      /* 服务器发给设备的字节数 */
+    uint32_t tx_msgs;                       /* 上行JSON消息数 */
+    uint32_t connects;                      /* TCP连接成功次数 */
+    uint32_t at_cmds;                       /* AT指令数 */
+    uint32_t by_type[8];                    /* 按类型的上行消息数, 顺序见 sim_msg_types */
+} sim_net_stats_t;
+
+extern sim_config_t sim_cfg;
+extern const char *const sim_msg_types[8];
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/* sim_clock.c: 虚拟时钟 */
+void sim_clock_init(void);
+uint64_t sim_now_us(void);                  /* 当前虚拟时间 (us, 不派发事件) */
+void sim_advance_us(uint64_t us);           /* 跳过一段时间 (延时/空闲), 期间按毫秒派发事件 */
+uint32_t sim_host_ms(void);                 /* 主机上实际经过的时间 */
+
+/* 各模型的事件处理, 由时钟在读取时间和空闲时调用 */
+void sim_board_poll(uint64_t now_us);
+void sim_lcd_poll(uint64_t now_us);
+void sim_esp_poll(uint64_t now_us);
+
+/* sim_periph.c: 寄存器内存 */
+void sim_periph_init(void);
+uint8_t sim_gpio_out(char port, uint8_t pin);   /* 读取输出引脚 (GPIO_SetBits或位带写入) */
+void sim_gpio_set_input(char port, uint8_t pin, uint8_t level);   /* 设置输入引脚 */
+
+/* sim_board.c: 板级外设与环境 */
+void sim_board_init(void);
+void sim_board_save(void);                  /* 写回Flash镜像 */
+void sim_board_report(FILE *fp);            /* 输出执行器与环境状态 (JSON片段) */
+
+/* sim_lcd.c: 显示 */
+uint8_t sim_lcd_save_ppm(const char *path); /* 0:成功 */
+uint32_t sim_lcd_pixels_written(void);
+
+/* sim_esp8266.c: WiFi模块 */
+void sim_esp_init(void);
+void sim_esp_get_stats(sim_net_stats_t *stats);
+
+/* sim_main.c */
+void sim_finish(int code);                  /* 输出结果并退出 */
+void sim_check_end(void);                   /* 到达运行时长时结束 (只在安全点调用: 空闲/延时) */
+
+#endif /* __SIM_H */
@@ -0,0 +1,518 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_board.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       板级外设模拟: 按键/TPAD/触摸屏/传感器/继电器/W25QXX, 以及花盆环境模型
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 替换 LED/KEY/TPAD/TOUCH/ADC/LSENS/TS/DHT11/BUMP/W25QXX/USART1 驱动, 接口与原驱动一致
+ * - 继电器状态从GPIO输出读取: 水泵PA7, 风扇PA6 (高电平开), 补光灯LED1=PE5 (低电平亮)
+ * - 环境模型: 光照/温度/湿度按 day_ms 为周期变化, 补光灯提高光照, 风扇降低温度;
+ *   土壤湿度随时间下降, 水泵工作时上升, 自动控制可以据此闭环
+ * - 按键/触摸按 --key/--tap 脚本在指定时间按下, 保持 SIM_KEY_HOLD_MS
+ * - W25QXX为16MB内存, 按芯片的典型耗时推进虚拟时钟, 可从文件载入并在结束时写回
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "sim_soil.h"
+#include "led.h"
+#include "key.h"
+#include "tpad.h"
+#include "touch.h"
+#include "adc.h"
+#include "lsens.h"
+#include "TS.h"
+#include "dht11.h"
+#include "bump.h"
+#include "w25qxx.h"
+#include "usart.h"
+#include "timer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_PI                  3.14159265358979
+
+/******************************************************************************************/
+/* 环境模型 */
+
+typedef struct {
+    double temp;                            /* 温度 (°C) */
+    double humi;                            /* 空气湿度 (%) */
+    double light;                           /* 光照 (%) */
+} sim_env_t;
+
+static sim_env_t s_env = { 24.0, 60.0, 50.0 };
+static sim_soil_t s_soil;                                   /* 土壤 (两层滞后模型, 见sim_soil.h) */
+static uint64_t s_env_us;                                   /* 上次更新环境的时间 */
+static uint32_t s_rand = 12345;                             /* 传感器噪声 (固定种子, 运行可复现) */
+
+/* 执行器统计 */
+static struct {
+    uint8_t  on;
+    uint32_t switches;
+    uint64_t on_us;
+} s_act[3];                                                 /* 0:补光灯 1:水泵 2:风扇 */
+static const char *const s_act_names[3] = { "light", "pump", "fan" };
+
+/* 输入 */
+static uint8_t s_next_event;                                /* 下一个待触发的脚本事件 */
+static uint64_t s_release_us[5];                            /* KEY0/KEY1/WK_UP/TPAD/触摸屏松开时间, 0表示未按下 */
+static uint16_t s_tap_x, s_tap_y;
+
+/* W25QXX */
+static uint8_t *s_flash;
+u16 W25QXX_TYPE = W25Q128;
+
+/* 驱动中定义的全局变量 */
+volatile uint16_t g_tpad_default_val = 100;
+u8  USART_RX_BUF[USART_REC_LEN];
+u16 USART_RX_STA;
+
+static dht11_stats_t s_dht11;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  均匀噪声 [-amp, amp]
+ */
+static double noise(double amp)
+{
+    s_rand = s_rand * 1103515245 + 12345;
+    return ((double)((s_rand >> 16) & 0x7FFF) / 16383.5 - 1.0) * amp;
+}
+
+static double clampd(double v, double lo, double hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/**
+ * @brief  读取执行器输出
+ */
+static uint8_t actuator(uint8_t idx)
+{
+    switch (idx)
+    {
+        case 0:  return !sim_gpio_out('E', 5);
+        case 1:  return sim_gpio_out('A', 7);
+        default: return sim_gpio_out('A', 6);
+    }
+}
+
+/**
+ * @brief  推进环境模型和执行器统计
+ */
+static void env_step(uint64_t now_us)
+{
+    double dt = (double)(now_us - s_env_us) / 1e6;          /* s */
+    double phase = sim_cfg.day_ms ? (double)(now_us / 1000 % sim_cfg.day_ms) / sim_cfg.day_ms : 0.5;
+    double sun = sin(2 * SIM_PI * (phase - 0.25));          /* phase=0.5为正午 */
+    double k;
+    uint8_t i, on;
+
+    for (i = 0; i < 3; i++)
+    {
+        on = actuator(i);
+        if (s_act[i].on) s_act[i].on_us += now_us - s_env_us;
+        if (on != s_act[i].on)
+        {
+            s_act[i].switches++;
+            if (sim_cfg.mock) mock_server_actuated(now_us, i, on);  /* 顺序 (灯/水泵/风扇) 与MOCK_KEY_xxx一致 */
+        }
+        s_act[i].on = on;
+    }
+    s_env_us = now_us;
+    if (dt <= 0) return;
+
+    /* 一阶惯性趋向目标值, 时间常数30s */
+    k = 1.0 - exp(-dt / 30.0);
+    s_env.temp += ((24.0 + 6.0 * sun - (s_act[2].on ? 3.0 : 0.0)) - s_env.temp) * k;
+    s_env.humi += ((60.0 - 15.0 * sun) - s_env.humi) * k;
+    s_env.light = clampd(5.0 + 80.0 * (sun > 0 ? sun : 0) + (s_act[0].on ? 40.0 : 0.0), 0, 100);
+
+    /* 土壤: 水泵的水经表层滞后渗入根区 */
+    sim_soil_step(&s_soil, s_act[1].on, dt);
+}
+
+/**
+ * @brief  按下脚本事件中的按键
+ */
+static void input_step(uint64_t now_us)
+{
+    sim_event_t *e;
+    uint8_t slot;
+
+    while (s_next_event < sim_cfg.event_count &&
+           (uint64_t)sim_cfg.events[s_next_event].at_ms * 1000 <= now_us)
+    {
+        e = &sim_cfg.events[s_next_event++];
+        switch (e->key)
+        {
+            case KEY0_PRES:     slot = 0; break;
+            case KEY1_PRES:     slot = 1; break;
+            case WKUP_PRES:     slot = 2; break;
+            case SIM_KEY_TPAD:  slot = 3; break;
+            default:            slot = 4; s_tap_x = e->x; s_tap_y = e->y; break;
+        }
+        s_release_us[slot] = now_us + SIM_KEY_HOLD_MS * 1000;
+    }
+
+    for (slot = 0; slot < 5; slot++)
+    {
+        if (s_release_us[slot] != 0 && now_us >= s_release_us[slot]) s_release_us[slot] = 0;
+    }
+
+    /* 按键引脚: KEY0=PE4, KEY1=PE3 低电平按下, WK_UP=PA0 高电平按下 */
+    sim_gpio_set_input('E', 4, s_release_us[0] == 0);
+    sim_gpio_set_input('E', 3, s_release_us[1] == 0);
+    sim_gpio_set_input('A', 0, s_release_us[2] != 0);
+}
+
+/**
+ * @brief  W25QXX操作耗时 (SPI 18MHz约2.25字节/us, 页编程0.7ms, 扇区擦除45ms)
+ */
+static void flash_busy(uint32_t us)
+{
+    sim_advance_us(us);
+}
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  初始化板级模型 (载入Flash镜像)
+ */
+void sim_board_init(void)
+{
+    FILE *fp;
+
+    s_flash = malloc(SIM_FLASH_SIZE);
+    if (s_flash == NULL)
+    {
+        fprintf(stderr, "sim: out of memory\n");
+        exit(2);
+    }
+    memset(s_flash, 0xFF, SIM_FLASH_SIZE);
+
+    if (sim_cfg.flash_path != NULL && (fp = fopen(sim_cfg.flash_path, "rb")) != NULL)
+    {
+        if (fread(s_flash, 1, SIM_FLASH_SIZE, fp) != SIM_FLASH_SIZE)
+        {
+            fprintf(stderr, "sim: %s is shorter than %lu bytes, rest is erased\n",
+                    sim_cfg.flash_path, SIM_FLASH_SIZE);
+        }
+        fclose(fp);
+    }
+
+    sim_gpio_set_input('E', 4, 1);
+    sim_gpio_set_input('E', 3, 1);
+    sim_gpio_set_input('A', 0, 0);
+
+    sim_soil_init(&s_soil, sim_cfg.soil_pct);
+}
+
+/**
+ * @brief  写回Flash镜像
+ */
+void sim_board_save(void)
+{
+    FILE *fp;
+
+    if (sim_cfg.flash_path == NULL || s_flash == NULL) return;
+    fp = fopen(sim_cfg.flash_path, "wb");
+    if (fp == NULL || fwrite(s_flash, 1, SIM_FLASH_SIZE, fp) != SIM_FLASH_SIZE)
+    {
+        fprintf(stderr, "sim: cannot write %s\n", sim_cfg.flash_path);
+    }
+    if (fp != NULL) fclose(fp);
+}
+
+/**
+ * @brief  事件处理: 环境与输入
+ */
+void sim_board_poll(uint64_t now_us)
+{
+    if (now_us / 1000 == s_env_us / 1000) return;
+    env_step(now_us);
+    input_step(now_us);
+}
+
+/**
+ * @brief  输出执行器与环境状态
+ */
+void sim_board_report(FILE *fp)
+{
+    uint8_t i;
+
+    env_step(sim_now_us());
+    fprintf(fp, "  \"actuators\": {");
+    for (i = 0; i < 3; i++)
+    {
+        fprintf(fp, "%s\"%s\": {\"on\": %u, \"switches\": %lu, \"on_ms\": %lu}", i ? ", " : "",
+                s_act_names[i], s_act[i].on, (unsigned long)s_act[i].switches,
+                (unsigned long)(s_act[i].on_us / 1000));
+    }
+    fprintf(fp, "},\n");
+    fprintf(fp, "  \"environment\": {\"temp\": %.1f, \"humi\": %.1f, \"soil\": %.1f, \"light\": %.1f, "
+            "\"soil_top\": %.1f, \"soil_peak\": %.1f, \"soil_runoff\": %.1f},\n",
+            s_env.temp, s_env.humi, s_soil.root, s_env.light, s_soil.top, s_soil.peak, s_soil.runoff);
+}
+
+/******************************************************************************************/
+/* LED / 继电器 */
+
+void LED_Init(void)
+{
+    LED0 = 1;                                               /* 位带写入, 与固件的LED1=x一致 */
+    LED1 = 1;
+}
+
+void BUMP_Init(void)
+{
+    BUMP_OFF;
+}
+
+void FUN_Init(void)
+{
+    FUN_OFF;
+}
+
+/******************************************************************************************/
+/* 按键 */
+
+void KEY_Init(void)
+{
+}
+
+/**
+ * @brief  按键扫描, 与key.c相同 (含10ms去抖延时)
+ */
+u8 KEY_Scan(u8 mode)
+{
+    static u8 key_up = 1;
+
+    if (mode) key_up = 1;
+    if (key_up && (KEY0 == 0 || KEY1 == 0 || WK_UP == 1))
+    {
+        delay_ms(10);
+        key_up = 0;
+        if (KEY0 == 0) return KEY0_PRES;
+        else if (KEY1 == 0) return KEY1_PRES;
+        else if (WK_UP == 1) return WKUP_PRES;
+    }
+    else if (KEY0 == 1 && KEY1 == 1 && WK_UP == 0)
+    {
+        key_up = 1;
+    }
+    return 0;
+}
+
+/******************************************************************************************/
+/* TPAD */
+
+/**
+ * @brief  初始化 (原驱动采样10次, 耗时100ms)
+ */
+uint8_t tpad_init(uint16_t psc)
+{
+    (void)psc;
+    delay_ms(100);
+    return 0;
+}
+
+/**
+ * @brief  扫描: 按下沿返回1, 有效触摸需连续3次检测 (每次10ms)
+ */
+uint8_t tpad_scan(uint8_t mode)
+{
+    static uint8_t keyen = 0;
+
+    if (s_release_us[3] == 0)
+    {
+        keyen = 0;
+        return 0;
+    }
+    if (keyen && !mode) return 0;
+
+    delay_ms(30);
+    keyen = 1;
+    return 1;
+}
+
+/******************************************************************************************/
+/* 触摸屏 */
+
+static uint8_t sim_tp_init(void)
+{
+    tp_dev.touchtype = 0x80 | 1;                            /* 电容屏, 横屏 */
+    return 0;
+}
+
+static uint8_t sim_tp_scan(uint8_t mode)
+{
+    (void)mode;
+    if (s_release_us[4] == 0)
+    {
+        tp_dev.sta &= ~TP_PRES_DOWN;
+        return 0;
+    }
+    tp_dev.sta = TP_PRES_DOWN | TP_CATH_PRES | 1;
+    tp_dev.x[0] = s_tap_x;
+    tp_dev.y[0] = s_tap_y;
+    return 1;
+}
+
+static void sim_tp_adjust(void)
+{
+}
+
+_m_tp_dev tp_dev = { .init = sim_tp_init, .scan = sim_tp_scan, .adjust = sim_tp_adjust };
+
+/******************************************************************************************/
+/* ADC / 光敏 / 土壤湿度 */
+
+void Adc_Init(void)
+{
+}
+
+void Lsens_Init(void)
+{
+}
+
+void TS_Init(void)
+{
+}
+
+void Lsens_Get_Val(uint8_t *li)
+{
+    *li = (uint8_t)clampd(s_env.light + noise(1.0) + 0.5, 0, 100);
+}
+
+void TS_GetData(uint8_t *st)
+{
+    *st = (uint8_t)clampd(s_soil.root + noise(0.5) + 0.5, 0, 100);
+}
+
+/******************************************************************************************/
+/* DHT11 (后台转换, 每秒更新一次缓存) */
+
+uint8_t DHT11_Init(void)
+{
+    return 0;
+}
+
+void DHT11_Process(void)
+{
+    static uint32_t last_try;
+    uint32_t now = millis();
+
+    if (s_dht11.valid && now - s_dht11.update_ms < DHT11_INTERVAL_MS) return;
+    if (sim_cfg.dht_fail_ms != 0 && now >= sim_cfg.dht_fail_ms)
+    {
+        /* 模拟传感器掉线: 每个采样周期记一次超时, 缓存值不再更新 */
+        if (now - last_try >= DHT11_INTERVAL_MS)
+        {
+            last_try = now;
+            s_dht11.timeout_err++;
+        }
+        return;
+    }
+    s_dht11.temp = (uint8_t)clampd(s_env.temp + noise(0.5) + 0.5, 0, 50);
+    s_dht11.humi = (uint8_t)clampd(s_env.humi + noise(1.0) + 0.5, 20, 90);
+    s_dht11.valid = 1;
+    s_dht11.update_ms = now;
+    s_dht11.ok_count++;
+}
+
+uint8_t DHT11_Is_Stale(void)
+{
+    if (!s_dht11.valid) return 1;
+    return (millis() - s_dht11.update_ms) > DHT11_STALE_MS;
+}
+
+uint8_t DHT11_Get_Data(uint8_t *temp, uint8_t *humi)
+{
+    if (!s_dht11.valid) return 1;
+    *temp = s_dht11.temp;
+    *humi = s_dht11.humi;
+    return DHT11_Is_Stale();
+}
+
+const dht11_stats_t *DHT11_Get_Stats(void)
+{
+    return &s_dht11;
+}
+
+/******************************************************************************************/
+/* W25QXX */
+
+void W25QXX_Init(void)
+{
+}
+
+u16 W25QXX_ReadID(void)
+{
+    return W25QXX_TYPE;
+}
+
+void W25QXX_Read(u8 *pBuffer, u32 ReadAddr, u16 NumByteToRead)
+{
+    if (ReadAddr >= SIM_FLASH_SIZE) return;
+    if (NumByteToRead > SIM_FLASH_SIZE - ReadAddr) NumByteToRead = SIM_FLASH_SIZE - ReadAddr;
+    memcpy(pBuffer, &s_flash[ReadAddr], NumByteToRead);
+    flash_busy(5 + NumByteToRead / 2);
+}
+
+/**
+ * @brief  页编程: NOR Flash只能把1写成0
+ */
+void W25QXX_Write_NoCheck(u8 *pBuffer, u32 WriteAddr, u16 NumByteToWrite)
+{
+    uint32_t pages = (WriteAddr % 256 + NumByteToWrite + 255) / 256;
+    u16 i;
+
+    if (WriteAddr >= SIM_FLASH_SIZE) return;
+    if (NumByteToWrite > SIM_FLASH_SIZE - WriteAddr) NumByteToWrite = SIM_FLASH_SIZE - WriteAddr;
+    for (i = 0; i < NumByteToWrite; i++)
+    {
+        s_flash[WriteAddr + i] &= pBuffer[i];
+    }
+    flash_busy(pages * 700 + NumByteToWrite / 2);
+}
+
+void W25QXX_Erase_Sector(u32 Dst_Addr)
+{
+    uint32_t addr = Dst_Addr * 4096;
+
+    if (addr >= SIM_FLASH_SIZE) return;
+    memset(&s_flash[addr], 0xFF, 4096);
+    flash_busy(45000);
+}
+
+void W25QXX_Erase_Chip(void)
+{
+    memset(s_flash, 0xFF, SIM_FLASH_SIZE);
+    flash_busy(40000000);
+}
+
+void W25QXX_Wait_Busy(void)
+{
+}
+
+/******************************************************************************************/
+/* 调试串口: printf直接输出到标准输出 */
+
+void uart_init(u32 bound)
+{
+    (void)bound;
+}
@@ -0,0 +1,192 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_clock.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       虚拟时钟: 替换TIM3系统时基/DWT周期计数器/延时函数/WFI
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 虚拟时间 = 主机单调时钟经过的时间 + 空闲/延时跳过的时间, 任务执行耗时取主机上的实际耗时
+ * - WFI_SET() 相当于睡眠到下一个1ms节拍 (TIM3中断唤醒), delay_ms/us 跳过指定时间,
+ *   非实时模式下都不真正等待; 实时模式 (--realtime) 下睡眠到对应的主机时间
+ * - 各模型的事件 (相当于中断) 在读取时钟和跳过时间时派发, 派发过程中再读取时钟不会重入
+ * - DWT周期计数按72MHz由虚拟时间换算
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "timer.h"
+#include "delay.h"
+#include <time.h>
+
+/******************************************************************************************/
+/* 私有变量 */
+
+static uint64_t s_host_start_ns;                            /* 启动时的主机时间 */
+static uint64_t s_skipped_us;                               /* 空闲/延时跳过的时间 */
+static uint8_t  s_dispatching;                              /* 1: 正在派发事件, 防止重入 */
+static uint64_t s_last_dispatch_us;                         /* 上次派发的时间 */
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  主机单调时钟 (ns)
+ */
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  派发到期的事件 (同一微秒内只派发一次)
+ */
+static void dispatch(void)
+{
+    uint64_t now;
+
+    if (s_dispatching) return;
+    now = sim_now_us();
+    if (now == s_last_dispatch_us) return;
+
+    s_dispatching = 1;
+    s_last_dispatch_us = now;
+    sim_lcd_poll(now);
+    sim_esp_poll(now);
+    sim_board_poll(now);
+    s_dispatching = 0;
+}
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  初始化虚拟时钟 (时间从0开始)
+ */
+void sim_clock_init(void)
+{
+    s_host_start_ns = host_ns();
+    s_skipped_us = 0;
+}
+
+/**
+ * @brief  当前虚拟时间 (us)
+ */
+uint64_t sim_now_us(void)
+{
+    return (host_ns() - s_host_start_ns) / 1000 + s_skipped_us;
+}
+
+/**
+ * @brief  主机上实际经过的时间 (ms)
+ */
+uint32_t sim_host_ms(void)
+{
+    return (uint32_t)((host_ns() - s_host_start_ns) / 1000000);
+}
+
+/**
+ * @brief  跳过一段时间, 每经过1ms派发一次事件
+ * @note   实时模式下睡眠等待; 事件处理中可能再次调用 (如回调中的延时), 此时只推进时间
+ */
+void sim_advance_us(uint64_t us)
+{
+    uint64_t end = sim_now_us() + us;
+    uint64_t now, step;
+    struct timespec ts;
+
+    while ((now = sim_now_us()) < end)
+    {
+        step = 1000 - now % 1000;
+        if (step > end - now) step = end - now;
+
+        if (sim_cfg.realtime)
+        {
+            ts.tv_sec = 0;
+            ts.tv_nsec = (long)step * 1000;
+            nanosleep(&ts, NULL);
+        }
+        else
+        {
+            s_skipped_us += step;
+        }
+        dispatch();
+    }
+}
+
+/******************************************************************************************/
+/* 替换 HARDWARE/TIMER/timer.c */
+
+void TIM3_Int_Init(u16 arr, u16 psc)
+{
+    (void)arr;
+    (void)psc;
+}
+
+u32 TIM3_Get_Ms(void)
+{
+    dispatch();
+    return (u32)(sim_now_us() / 1000);
+}
+
+u32 TIM3_Get_Us(void)
+{
+    dispatch();
+    return (u32)sim_now_us();
+}
+
+u32 millis(void)
+{
+    return TIM3_Get_Ms();
+}
+
+u32 micros(void)
+{
+    return TIM3_Get_Us();
+}
+
+void DWT_Init(void)
+{
+}
+
+u32 DWT_Get_Cycles(void)
+{
+    return (u32)(sim_now_us() * (SystemCoreClock / 1000000));
+}
+
+/******************************************************************************************/
+/* 替换 SYSTEM/delay/delay.c 与 SYSTEM/sys/sys.c 中的WFI */
+
+void delay_init(void)
+{
+}
+
+void delay_ms(u16 nms)
+{
+    sim_advance_us((uint64_t)nms * 1000);
+    sim_check_end();
+}
+
+void delay_us(u32 nus)
+{
+    sim_advance_us(nus);
+    sim_check_end();
+}
+
+/**
+ * @brief  睡眠到下一个TIM3节拍 (1ms)
+ */
+void WFI_SET(void)
+{
+    sim_advance_us(1000 - sim_now_us() % 1000);
+    sim_check_end();
+}
@@ -0,0 +1,846 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_esp8266.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       ATK-MW8266D (ESP8266) 模拟: UART收发队列 + AT指令模型 + TCP透传
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 替换 atk_mw8266d_uart.c, 接口与统计含义不变:
+ *   发送为非阻塞入队, 按115200波特率 (约87us/字节) 逐字节交给模块; 模块的输出按同样的速率
+ *   逐帧进入接收帧队列, 一次输出 (一条应答/一段TCP数据) 为一帧, 相当于一次UART空闲中断
+ * - AT指令模型覆盖myserver连接流程用到的指令, 回显/自动连接/加入耗时与实际模块接近
+ * - AT+CIPSTART 不会连接指令中的服务器地址, 而是连接 --server 指定的主机 (通常是本地模拟服务器),
+ *   --mock 时连接进程内的模拟服务器 (mock_server.c, 使用虚拟时钟);
+ *   都未指定时按服务器不可达处理: 连接超时后应答"ERROR/CLOSED", 与实际模块连不上公网服务器时一致
+ * - 透传模式下上行数据原样转发到TCP连接, 单独发送的"+++"退出透传; 连接断开时输出"CLOSED"
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "atk_mw8266d_uart.h"
+#include "myserver.h"
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/******************************************************************************************/
+/* 配置参数 */
+
+#define ESP_US_PER_BYTE         87          /* 115200bps, 10位/字节 */
+#define ESP_OUT_QUEUE           16          /* 模块待输出的帧数 */
+#define ESP_CMD_MAX             128         /* AT指令缓冲 */
+#define ESP_PASS_MAX            1024        /* 透传上行缓冲 */
+#define ESP_REPLY_US            1000        /* 模块处理一条指令的时间 */
+#define ESP_BOOT_MS             300         /* 复位到输出ready的时间 */
+#define ESP_AUTOCONN_MS         1500        /* 上电/复位后自动连接保存的WiFi的时间 */
+#define ESP_JOIN_MS             2000        /* AT+CWJAP加入WiFi的时间 */
+#define ESP_CONNECT_TIMEOUT_MS  5000        /* TCP连接超时 */
+
+static const char s_sta_ip[] = "192.168.1.50";
+
+/******************************************************************************************/
+/* 私有变量 */
+
+/* MCU->模块: 发送环形队列 */
+static uint8_t  s_tx_ring[ATK_MW8266D_UART_TX_RING_SIZE];
+static uint16_t s_tx_head;                                  /* 下一个发出的字节 */
+static uint16_t s_tx_used;
+static uint64_t s_tx_clock_us;                              /* 已按波特率发送到的时间 */
+static atk_mw8266d_uart_tx_stats_t s_tx_stats;
+
+/* 模块->MCU: 接收帧队列 */
+static struct {
+    char     buf[ATK_MW8266D_UART_RX_BUF_SIZE];
+    uint16_t len;
+} s_rx_q[ATK_MW8266D_UART_RX_QUEUE_SIZE];
+static uint8_t s_rx_head;
+static uint8_t s_rx_count;
+static atk_mw8266d_uart_rx_stats_t s_rx_stats;
+static atk_mw8266d_uart_rx_cb_t s_rx_cb;                    /* 帧接收事件回调 */
+
+/* 模块待输出的帧 (按时间顺序) */
+static struct {
+    uint64_t due_us;
+    uint16_t len;
+    char     data[ATK_MW8266D_UART_RX_BUF_SIZE];
+} s_out[ESP_OUT_QUEUE];
+static uint8_t  s_out_head;
+static uint8_t  s_out_count;
+static uint64_t s_wire_us;                                  /* 模块->MCU方向线路空闲的时间 */
+
+/* 模块状态 */
+static struct {
+    uint8_t  echo;                                          /* ATE1 */
+    uint8_t  joined;                                        /* 已连接WiFi */
+    uint8_t  saved;                                         /* 保存了WiFi, 复位后自动连接 */
+    uint64_t join_us;                                       /* 正在连接WiFi: 完成时间, 0表示无 */
+    uint8_t  join_ok;
+    uint8_t  cipmode;                                       /* AT+CIPMODE=1 */
+    uint8_t  passthrough;
+    int      sock;                                          /* TCP连接, -1表示无 */
+    uint8_t  mock;                                          /* 1: 连接的是进程内模拟服务器 */
+    uint8_t  connecting;                                    /* 非阻塞connect进行中 */
+    uint64_t connect_us;                                    /* connect开始时间 */
+    uint64_t poll_ms;                                       /* 上次读取TCP数据的时间 (ms) */
+    char     cmd[ESP_CMD_MAX];
+    uint16_t cmd_len;
+    uint8_t  pass[ESP_PASS_MAX];
+    uint16_t pass_len;
+} s_esp;
+
+/* 上行消息解析 (统计消息数) */
+static struct {
+    uint8_t  state;                                         /* 0:消息之间 1:JSON 2:二进制长度 3:二进制内容 */
+    uint16_t remain;
+    char     head[80];                                      /* JSON开头, 用于取"t"字段 (在id/ts之后) */
+    uint8_t  head_len;
+} s_msg;
+
+static sim_net_stats_t s_net;
+
+const char *const sim_msg_types[8] = { "reg", "hb", "dat", "sta", "ack", "perf", "bin", "other" };
+
+/******************************************************************************************/
+/* 模块输出 */
+
+/**
+ * @brief  模块输出一帧, 在 delay_us 之后按波特率传输完成时进入接收队列
+ */
+static void esp_emit_after(uint64_t delay_us, const char *data, uint16_t len)
+{
+    uint64_t start = sim_now_us() + delay_us;
+    uint8_t idx;
+
+    if (len > ATK_MW8266D_UART_RX_BUF_SIZE - 1) len = ATK_MW8266D_UART_RX_BUF_SIZE - 1;
+    if (s_out_count >= ESP_OUT_QUEUE)
+    {
+        s_rx_stats.dropped_frames++;
+        s_rx_stats.dropped_bytes += len;
+        return;
+    }
+
+    if (start < s_wire_us) start = s_wire_us;
+    s_wire_us = start + (uint64_t)len * ESP_US_PER_BYTE;
+
+    idx = (s_out_head + s_out_count) % ESP_OUT_QUEUE;
+    memcpy(s_out[idx].data, data, len);
+    s_out[idx].data[len] = '\0';
+    s_out[idx].len = len;
+    s_out[idx].due_us = s_wire_us;
+    s_out_count++;
+}
+
+static void esp_emit(uint64_t delay_us, const char *text)
+{
+    esp_emit_after(delay_us, text, (uint16_t)strlen(text));
+}
+
+/**
+ * @brief  应答一条指令 (回显打开时带上指令本身)
+ */
+static void esp_reply(const char *cmd, const char *resp)
+{
+    char buf[ATK_MW8266D_UART_RX_BUF_SIZE];
+
+    if (!s_esp.echo && resp[0] == '\0') return;
+    if (s_esp.echo) snprintf(buf, sizeof(buf), "%s\r\n%s", cmd, resp);
+    else snprintf(buf, sizeof(buf), "%s", resp);
+    esp_emit(ESP_REPLY_US, buf);
+}
+
+/**
+ * @brief  到期的输出帧进入接收帧队列, 并调用帧接收事件回调 (相当于UART空闲中断)
+ */
+static void esp_deliver(uint64_t now_us)
+{
+    uint8_t idx;
+
+    while (s_out_count > 0 && s_out[s_out_head].due_us <= now_us)
+    {
+        if (s_rx_count >= ATK_MW8266D_UART_RX_QUEUE_SIZE - 1)
+        {
+            s_rx_stats.dropped_frames++;
+            s_rx_stats.dropped_bytes += s_out[s_out_head].len;
+        }
+        else
+        {
+            idx = (s_rx_head + s_rx_count) % ATK_MW8266D_UART_RX_QUEUE_SIZE;
+            memcpy(s_rx_q[idx].buf, s_out[s_out_head].data, s_out[s_out_head].len + 1);
+            s_rx_q[idx].len = s_out[s_out_head].len;
+            s_rx_count++;
+            s_rx_stats.frames++;
+        }
+        s_out_head = (s_out_head + 1) % ESP_OUT_QUEUE;
+        s_out_count--;
+        if (s_rx_cb != NULL) s_rx_cb();
+    }
+}
+
+/******************************************************************************************/
+/* TCP连接 */
+
+static void esp_close(void)
+{
+    if (s_esp.sock >= 0) close(s_esp.sock);
+    if (s_esp.mock && !s_esp.connecting) mock_server_close(sim_now_us());
+    s_esp.sock = -1;
+    s_esp.mock = 0;
+    s_esp.connecting = 0;
+    s_esp.passthrough = 0;
+}
+
+/**
+ * @brief  连接被对端断开: 输出"CLOSED"; 透传模式保持, 之后的上行数据丢弃, 直到"+++"退出
+ * @note   实际模块此时还会自动重连, 模型不重连, 由固件按断开处理
+ */
+static void esp_lost(void)
+{
+    uint8_t pass = s_esp.passthrough;
+
+    esp_close();
+    s_esp.passthrough = pass;
+    esp_emit(0, "CLOSED\r\n");
+}
+
+/**
+ * @brief  开始连接 --server 指定的服务器
+ * @retval 0:连接进行中 1:失败
+ */
+static uint8_t esp_connect(void)
+{
+    struct addrinfo hints, *res = NULL;
+    char port[8];
+    int fd, one = 1;
+
+    s_esp.connect_us = sim_now_us();
+    if (sim_cfg.mock || sim_cfg.server_host == NULL)
+    {
+        s_esp.mock = sim_cfg.mock;
+        s_esp.connecting = 1;                               /* 模拟服务器在一个往返后接受; 不可达时等待超时 */
+        return 0;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port, sizeof(port), "%u", sim_cfg.server_port);
+    if (getaddrinfo(sim_cfg.server_host, port, &hints, &res) != 0 || res == NULL) return 1;
+
+    fd = socket(res->ai_family, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        freeaddrinfo(res);
+        return 1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, res->ai_addr, res->ai_addrlen) != 0 && errno != EINPROGRESS)
+    {
+        close(fd);
+        freeaddrinfo(res);
+        return 1;
+    }
+    freeaddrinfo(res);
+
+    s_esp.sock = fd;
+    s_esp.connecting = 1;
+    return 0;
+}
+
+static uint8_t esp_linked(void)
+{
+    return s_esp.sock >= 0 || s_esp.mock;
+}
+
+/**
+ * @brief  服务器发来的数据: 透传模式原样输出, 否则加上"+IPD,n:"
+ */
+static void esp_tcp_data(const char *data, uint16_t n)
+{
+    char ipd[ATK_MW8266D_UART_RX_BUF_SIZE];
+    int hdr;
+
+    s_net.rx_bytes += n;
+    if (s_esp.passthrough)
+    {
+        esp_emit_after(0, data, n);
+    }
+    else
+    {
+        hdr = snprintf(ipd, sizeof(ipd), "\r\n+IPD,%u:", n);
+        if (n > sizeof(ipd) - 1 - hdr) n = (uint16_t)(sizeof(ipd) - 1 - hdr);
+        memcpy(ipd + hdr, data, n);
+        esp_emit_after(0, ipd, (uint16_t)(hdr + n));
+    }
+}
+
+/**
+ * @brief  进程内模拟服务器: 连接在一个往返后建立, 每次派发都处理 (延迟统计精确到us)
+ */
+static void esp_mock_poll(uint64_t now_us)
+{
+    char buf[ATK_MW8266D_UART_RX_BUF_SIZE - 16];
+    uint16_t n;
+
+    if (s_esp.mock && s_esp.connecting)
+    {
+        if (now_us < s_esp.connect_us + mock_server_connect_us()) return;
+        s_esp.connecting = 0;
+        if (mock_server_open(now_us) == 0)
+        {
+            s_net.connects++;
+            esp_emit(0, "CONNECT\r\n\r\nOK\r\n");
+        }
+        else
+        {
+            s_esp.mock = 0;
+            esp_close();
+            esp_emit(0, "ERROR\r\nCLOSED\r\n");
+        }
+    }
+
+    if (mock_server_poll(now_us) && s_esp.mock)
+    {
+        esp_lost();                                         /* 服务器断开 */
+        return;
+    }
+
+    while (s_esp.mock && s_out_count < ESP_OUT_QUEUE / 2 &&
+           (n = mock_server_output(now_us, (uint8_t *)buf, sizeof(buf))) != 0)
+    {
+        esp_tcp_data(buf, n);
+    }
+}
+
+/**
+ * @brief  检查连接结果, 读取服务器数据
+ */
+static void esp_socket_poll(uint64_t now_us)
+{
+    char buf[ATK_MW8266D_UART_RX_BUF_SIZE - 16];
+    struct pollfd pfd;
+    socklen_t len = sizeof(int);
+    int err = 0;
+    ssize_t n;
+
+    if (s_esp.connecting)
+    {
+        pfd.fd = s_esp.sock;
+        pfd.events = POLLOUT;
+        if (s_esp.sock >= 0 && poll(&pfd, 1, 0) > 0) getsockopt(s_esp.sock, SOL_SOCKET, SO_ERROR, &err, &len);
+        else err = EINPROGRESS;
+        if (err == 0)
+        {
+            s_esp.connecting = 0;
+            s_net.connects++;
+            esp_emit(0, "CONNECT\r\n\r\nOK\r\n");
+        }
+        else if ((err != 0 && err != EINPROGRESS) || now_us > s_esp.connect_us + ESP_CONNECT_TIMEOUT_MS * 1000ULL)
+        {
+            esp_close();
+            esp_emit(0, "ERROR\r\nCLOSED\r\n");
+        }
+        return;
+    }
+    if (s_esp.sock < 0) return;
+
+    /* 只在接收队列有空间时读取, 其余数据留在内核缓冲 (相当于TCP流控) */
+    while (s_out_count < ESP_OUT_QUEUE / 2)
+    {
+        n = recv(s_esp.sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0)
+        {
+            esp_tcp_data(buf, (uint16_t)n);
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            esp_lost();                                     /* 服务器关闭连接 */
+        }
+        break;
+    }
+}
+
+/******************************************************************************************/
+/* 上行数据 */
+
+/**
+ * @brief  统计上行消息: JSON按"t"字段分类, 二进制帧 (0xA5开头) 计为bin
+ */
+static void msg_count(const char *type)
+{
+    uint8_t i;
+
+    s_net.tx_msgs++;
+    for (i = 0; i < 7; i++)
+    {
+        if (strcmp(type, sim_msg_types[i]) == 0) break;
+    }
+    s_net.by_type[i]++;
+}
+
+static void msg_parse(uint8_t c)
+{
+    char type[8];
+    const char *p;
+    uint8_t i;
+
+    switch (s_msg.state)
+    {
+        case 0:
+            if (c == '{')
+            {
+                s_msg.state = 1;
+                s_msg.head_len = 0;
+                s_msg.head[s_msg.head_len++] = (char)c;
+            }
+            else if (c == 0xA5)
+            {
+                s_msg.state = 2;
+            }
+            break;
+        case 1:
+            if (c == '\n')
+            {
+                s_msg.head[s_msg.head_len] = '\0';
+                p = strstr(s_msg.head, "\"t\":\"");
+                type[0] = '\0';
+                if (p != NULL)
+                {
+                    p += 5;
+                    for (i = 0; i < sizeof(type) - 1 && p[i] != '"' && p[i] != '\0'; i++) type[i] = p[i];
+                    type[i] = '\0';
+                }
+                msg_count(type);
+                s_msg.state = 0;
+            }
+            else if (s_msg.head_len < sizeof(s_msg.head) - 1)
+            {
+                s_msg.head[s_msg.head_len++] = (char)c;
+            }
+            break;
+        case 2:
+            s_msg.remain = (uint16_t)c + 1;                 /* type+seq+payload 加校验和 */
+            s_msg.state = 3;
+            break;
+        default:
+            if (--s_msg.remain == 0)
+            {
+                msg_count("bin");
+                s_msg.state = 0;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief  透传上行数据发往服务器
+ */
+static void esp_pass_flush(void)
+{
+    uint16_t i;
+
+    if (s_esp.pass_len == 0) return;
+
+    if (s_esp.pass_len == 3 && memcmp(s_esp.pass, "+++", 3) == 0)
+    {
+        s_esp.passthrough = 0;                              /* 退出透传, 连接保持 */
+    }
+    else if (s_esp.mock && !s_esp.connecting)
+    {
+        mock_server_input(sim_now_us(), s_esp.pass, s_esp.pass_len);
+        s_net.tx_bytes += s_esp.pass_len;
+        for (i = 0; i < s_esp.pass_len; i++) msg_parse(s_esp.pass[i]);
+    }
+    else if (s_esp.sock >= 0 && !s_esp.connecting)
+    {
+        if (send(s_esp.sock, s_esp.pass, s_esp.pass_len, MSG_NOSIGNAL) < 0)
+        {
+            esp_lost();
+        }
+        else
+        {
+            s_net.tx_bytes += s_esp.pass_len;
+            for (i = 0; i < s_esp.pass_len; i++) msg_parse(s_esp.pass[i]);
+        }
+    }
+    s_esp.pass_len = 0;
+}
+
+/******************************************************************************************/
+/* AT指令 */
+
+/**
+ * @brief  复位后重新启动: 输出ready, 保存了WiFi时自动连接
+ */
+static void esp_boot(uint64_t delay_us)
+{
+    esp_close();
+    s_esp.echo = 1;
+    s_esp.joined = 0;
+    s_esp.cipmode = 0;
+    s_esp.join_us = 0;
+    esp_emit(delay_us, "\r\nready\r\n");
+    if (s_esp.saved && sim_cfg.wifi_ap)
+    {
+        s_esp.join_us = sim_now_us() + ESP_AUTOCONN_MS * 1000ULL;
+        s_esp.join_ok = 1;
+    }
+}
+
+/**
+ * @brief  执行一条AT指令 (不含\r\n)
+ */
+static void esp_command(const char *cmd)
+{
+    char buf[ATK_MW8266D_UART_RX_BUF_SIZE];
+    char ssid[40], pwd[40];
+
+    s_net.at_cmds++;
+
+    if (strcmp(cmd, "AT") == 0 || strncmp(cmd, "AT+CWMODE=", 10) == 0 ||
+        strncmp(cmd, "AT+CWAUTOCONN=", 14) == 0)
+    {
+        esp_reply(cmd, "\r\nOK\r\n");
+    }
+    else if (strcmp(cmd, "ATE0") == 0 || strcmp(cmd, "ATE1") == 0)
+    {
+        esp_reply(cmd, "\r\nOK\r\n");
+        s_esp.echo = (cmd[3] == '1');
+    }
+    else if (strcmp(cmd, "AT+RST") == 0)
+    {
+        esp_reply(cmd, "\r\nOK\r\n");
+        esp_boot(ESP_BOOT_MS * 1000ULL);
+    }
+    else if (strcmp(cmd, "AT+RESTORE") == 0)
+    {
+        esp_reply(cmd, "\r\nOK\r\n");
+        s_esp.saved = 0;
+        esp_boot(ESP_BOOT_MS * 1000ULL);
+    }
+    else if (strcmp(cmd, "AT+CWJAP?") == 0)
+    {
+        if (s_esp.joined)
+        {
+            snprintf(buf, sizeof(buf), "+CWJAP:\"%s\",\"a4:39:b3:12:6e:01\",6,-52\r\n\r\nOK\r\n", MY_WIFI_SSID);
+            esp_reply(cmd, buf);
+        }
+        else
+        {
+            esp_reply(cmd, "No AP\r\n\r\nOK\r\n");
+        }
+    }
+    else if (sscanf(cmd, "AT+CWJAP=\"%39[^\"]\",\"%39[^\"]\"", ssid, pwd) == 2)
+    {
+        esp_reply(cmd, "");
+        esp_close();
+        s_esp.joined = 0;
+        s_esp.join_us = sim_now_us() + ESP_JOIN_MS * 1000ULL;
+        s_esp.join_ok = sim_cfg.wifi_ap && strcmp(ssid, MY_WIFI_SSID) == 0 && strcmp(pwd, MY_WIFI_PWD) == 0;
+        if (s_esp.join_ok) s_esp.saved = 1;
+    }
+    else if (strcmp(cmd, "AT+CIFSR") == 0)
+    {
+        snprintf(buf, sizeof(buf), "+CIFSR:STAIP,\"%s\"\r\n+CIFSR:STAMAC,\"5c:cf:7f:80:21:9a\"\r\n\r\nOK\r\n",
+                 s_esp.joined ? s_sta_ip : "0.0.0.0");
+        esp_reply(cmd, buf);
+    }
+    else if (strncmp(cmd, "AT+CIPSTART=", 12) == 0)
+    {
+        if (!s_esp.joined)
+        {
+            esp_reply(cmd, "\r\nERROR\r\n");
+        }
+        else if (esp_linked() || s_esp.connecting)
+        {
+            esp_reply(cmd, "ALREADY CONNECTED\r\n\r\nERROR\r\n");
+        }
+        else if (esp_connect() != 0)
+        {
+            esp_reply(cmd, "\r\nERROR\r\nCLOSED\r\n");
+        }
+        else
+        {
+            esp_reply(cmd, "");
+            if (sim_cfg.mock) printf("[Sim] %s -> mock server\r\n", cmd);
+            else if (sim_cfg.server_host != NULL) printf("[Sim] %s -> %s:%u\r\n", cmd, sim_cfg.server_host, sim_cfg.server_port);
+            else printf("[Sim] %s -> unreachable\r\n", cmd);
+        }
+    }
+    else if (strcmp(cmd, "AT+CIPMODE=1") == 0 || strcmp(cmd, "AT+CIPMODE=0") == 0)
+    {
+        s_esp.cipmode = (cmd[11] == '1');
+        esp_reply(cmd, "\r\nOK\r\n");
+    }
+    else if (strcmp(cmd, "AT+CIPSEND") == 0)
+    {
+        if (esp_linked() && !s_esp.connecting && s_esp.cipmode)
+        {
+            esp_reply(cmd, "\r\nOK\r\n\r\n>");
+            s_esp.passthrough = 1;
+            s_esp.pass_len = 0;
+        }
+        else
+        {
+            esp_reply(cmd, "\r\nERROR\r\n");
+        }
+    }
+    else if (strcmp(cmd, "AT+CIPCLOSE") == 0)
+    {
+        if (esp_linked() || s_esp.connecting)
+        {
+            esp_close();
+            esp_reply(cmd, "CLOSED\r\n\r\nOK\r\n");
+        }
+        else
+        {
+            esp_reply(cmd, "\r\nERROR\r\n");
+        }
+    }
+    else
+    {
+        esp_reply(cmd, "\r\nERROR\r\n");
+    }
+}
+
+/**
+ * @brief  模块收到一个字节
+ */
+static void esp_input(uint8_t c)
+{
+    if (s_esp.passthrough)
+    {
+        if (s_esp.pass_len >= ESP_PASS_MAX) esp_pass_flush();
+        s_esp.pass[s_esp.pass_len++] = c;
+        return;
+    }
+
+    if (s_esp.cmd_len >= ESP_CMD_MAX - 1) s_esp.cmd_len = 0;  /* 不成指令的数据丢弃 */
+    s_esp.cmd[s_esp.cmd_len++] = (char)c;
+    if (s_esp.cmd_len >= 2 && s_esp.cmd[s_esp.cmd_len - 2] == '\r' && s_esp.cmd[s_esp.cmd_len - 1] == '\n')
+    {
+        s_esp.cmd[s_esp.cmd_len - 2] = '\0';
+        s_esp.cmd_len = 0;
+        if (s_esp.cmd[0] != '\0') esp_command(s_esp.cmd);
+    }
+}
+
+/**
+ * @brief  发送队列空闲: 透传数据打包发出, 命令模式下丢弃不成指令的"+++"
+ */
+static void esp_tx_idle(void)
+{
+    if (s_esp.passthrough)
+    {
+        esp_pass_flush();
+    }
+    else if (s_esp.cmd_len == 3 && memcmp(s_esp.cmd, "+++", 3) == 0)
+    {
+        s_esp.cmd_len = 0;
+    }
+}
+
+/**
+ * @brief  按波特率把发送队列中的字节交给模块
+ */
+static void esp_tx_drain(uint64_t now_us)
+{
+    uint64_t n;
+
+    if (s_tx_used == 0)
+    {
+        s_tx_clock_us = now_us;
+        return;
+    }
+
+    n = (now_us - s_tx_clock_us) / ESP_US_PER_BYTE;
+    if (n == 0) return;
+    if (n > s_tx_used) n = s_tx_used;
+    s_tx_clock_us += n * ESP_US_PER_BYTE;
+
+    while (n-- > 0)
+    {
+        esp_input(s_tx_ring[s_tx_head]);
+        s_tx_head = (s_tx_head + 1) % ATK_MW8266D_UART_TX_RING_SIZE;
+        s_tx_used--;
+        s_tx_stats.sent_bytes++;
+    }
+    s_tx_stats.used = s_tx_used;
+    if (s_tx_used == 0) esp_tx_idle();
+}
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  上电
+ */
+void sim_esp_init(void)
+{
+    s_esp.sock = -1;
+    s_esp.saved = sim_cfg.wifi_saved;
+    esp_boot(ESP_BOOT_MS * 1000ULL);
+}
+
+/**
+ * @brief  事件处理: 串口收发, WiFi连接, TCP数据
+ */
+void sim_esp_poll(uint64_t now_us)
+{
+    esp_tx_drain(now_us);
+
+    if (s_esp.join_us != 0 && now_us >= s_esp.join_us)
+    {
+        s_esp.join_us = 0;
+        if (s_esp.join_ok)
+        {
+            s_esp.joined = 1;
+            esp_emit(0, "WIFI CONNECTED\r\n");
+            esp_emit(200000, "WIFI GOT IP\r\n\r\nOK\r\n");
+        }
+        else
+        {
+            esp_emit(0, "+CWJAP:3\r\n\r\nFAIL\r\n");
+        }
+    }
+
+    if (sim_cfg.mock)
+    {
+        esp_mock_poll(now_us);
+    }
+    else if (now_us / 1000 != s_esp.poll_ms)
+    {
+        s_esp.poll_ms = now_us / 1000;
+        esp_socket_poll(now_us);
+    }
+    esp_deliver(now_us);
+}
+
+void sim_esp_get_stats(sim_net_stats_t *stats)
+{
+    *stats = s_net;
+}
+
+/******************************************************************************************/
+/* 替换 atk_mw8266d_uart.c */
+
+void atk_mw8266d_uart_init(uint32_t baudrate)
+{
+    (void)baudrate;
+    s_tx_head = 0;
+    s_tx_used = 0;
+    s_rx_head = 0;
+    s_rx_count = 0;
+}
+
+/**
+ * @brief  非阻塞发送: 整帧放入发送队列, 空间不足时整帧拒绝
+ * @retval 0:已入队 1:队列空间不足
+ */
+uint8_t atk_mw8266d_uart_send(const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+
+    esp_tx_drain(sim_now_us());
+    if (len > ATK_MW8266D_UART_TX_RING_SIZE - 1 - s_tx_used)
+    {
+        s_tx_stats.rejected++;
+        s_tx_stats.rejected_bytes += len;
+        return 1;
+    }
+    for (i = 0; i < len; i++)
+    {
+        s_tx_ring[(s_tx_head + s_tx_used + i) % ATK_MW8266D_UART_TX_RING_SIZE] = data[i];
+    }
+    s_tx_used += len;
+    s_tx_stats.queued_bytes += len;
+    s_tx_stats.used = s_tx_used;
+    if (s_tx_used > s_tx_stats.high_water) s_tx_stats.high_water = s_tx_used;
+    return 0;
+}
+
+uint8_t atk_mw8266d_uart_printf(char *fmt, ...)
+{
+    char buf[ATK_MW8266D_UART_TX_BUF_SIZE];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (len < 0) return 1;
+    if (len > (int)sizeof(buf) - 1) len = sizeof(buf) - 1;
+    return atk_mw8266d_uart_send((const uint8_t *)buf, (uint16_t)len);
+}
+
+uint16_t atk_mw8266d_uart_tx_free(void)
+{
+    esp_tx_drain(sim_now_us());
+    return ATK_MW8266D_UART_TX_RING_SIZE - 1 - s_tx_used;
+}
+
+uint8_t atk_mw8266d_uart_tx_idle(void)
+{
+    esp_tx_drain(sim_now_us());
+    return s_tx_used == 0;
+}
+
+void atk_mw8266d_uart_tx_get_stats(atk_mw8266d_uart_tx_stats_t *stats)
+{
+    *stats = s_tx_stats;
+    stats->used = s_tx_used;
+}
+
+void atk_mw8266d_uart_tx_reset_stats(void)
+{
+    memset(&s_tx_stats, 0, sizeof(s_tx_stats));
+}
+
+void atk_mw8266d_uart_rx_restart(void)
+{
+    if (s_rx_count == 0) return;
+    s_rx_head = (s_rx_head + 1) % ATK_MW8266D_UART_RX_QUEUE_SIZE;
+    s_rx_count--;
+}
+
+void atk_mw8266d_uart_rx_flush(void)
+{
+    s_rx_count = 0;
+}
+
+uint8_t *atk_mw8266d_uart_rx_get_frame(void)
+{
+    if (s_rx_count == 0) return NULL;
+    return (uint8_t *)s_rx_q[s_rx_head].buf;
+}
+
+uint16_t atk_mw8266d_uart_rx_get_frame_len(void)
+{
+    return s_rx_count ? s_rx_q[s_rx_head].len : 0;
+}
+
+void atk_mw8266d_uart_rx_set_callback(atk_mw8266d_uart_rx_cb_t cb)
+{
+    s_rx_cb = cb;
+}
+
+void atk_mw8266d_uart_rx_get_stats(atk_mw8266d_uart_rx_stats_t *stats)
+{
+    *stats = s_rx_stats;
+    stats->pending = s_rx_count;
+}
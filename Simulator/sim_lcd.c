@@ -0,0 +1,177 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_lcd.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       LCD模拟: RGB565帧缓冲 + DMA刷屏耗时模型, 截屏输出PPM
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 替换 HARDWARE/LCD/lcd.c 中LVGL移植层用到的接口, 横屏320x240
+ * - lcd_color_fill_dma() 立即把像素写入帧缓冲, 按 SIM_LCD_DMA_PPS 计算传输时间,
+ *   到时 (虚拟时钟) 调用完成回调, 与DMA传输完成中断的时序一致
+ * - lcd_color_fill() 是CPU写屏, 按同样的速度推进虚拟时钟
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "lcd.h"
+#include <string.h>
+
+_lcd_dev lcddev;
+uint32_t g_point_color = 0xF800;
+uint32_t g_back_color = 0xFFFF;
+
+static uint16_t s_fb[SIM_LCD_WIDTH * SIM_LCD_HEIGHT];      /* 帧缓冲 (按当前方向的行优先) */
+static uint8_t  s_dma_ready;                                /* 1: 已调用lcd_dma_init */
+static uint8_t  s_dma_busy;
+static uint64_t s_dma_done_us;                              /* 当前传输完成时间 */
+static lcd_dma_done_cb_t s_dma_cb;
+static uint32_t s_pixels;                                   /* 累计写入像素数 */
+static uint64_t s_next_shot_us;                             /* 下次周期截屏时间 */
+static uint32_t s_shots;
+
+/******************************************************************************************/
+/* 私有函数 */
+
+/**
+ * @brief  把一块像素写入帧缓冲 (超出屏幕的部分裁剪)
+ */
+static void fb_blit(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint16_t *color)
+{
+    uint16_t w = ex - sx + 1;
+    uint16_t y, cw;
+
+    if (sx >= lcddev.width || sy >= lcddev.height || ex < sx || ey < sy) return;
+    cw = (ex < lcddev.width) ? w : (uint16_t)(lcddev.width - sx);
+    for (y = sy; y <= ey && y < lcddev.height; y++)
+    {
+        memcpy(&s_fb[(uint32_t)y * lcddev.width + sx], &color[(uint32_t)(y - sy) * w], (size_t)cw * 2);
+    }
+    s_pixels += (uint32_t)w * (ey - sy + 1);
+}
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  事件处理: DMA传输完成, 周期截屏
+ */
+void sim_lcd_poll(uint64_t now_us)
+{
+    lcd_dma_done_cb_t cb;
+    char path[512];
+
+    if (s_dma_busy && now_us >= s_dma_done_us)
+    {
+        s_dma_busy = 0;
+        cb = s_dma_cb;
+        if (cb != NULL) cb();
+    }
+
+    if (sim_cfg.out_dir != NULL && sim_cfg.shot_every_ms != 0 && now_us >= s_next_shot_us)
+    {
+        if (s_next_shot_us != 0)
+        {
+            snprintf(path, sizeof(path), "%s/frame_%07lu.ppm", sim_cfg.out_dir, (unsigned long)(now_us / 1000));
+            if (sim_lcd_save_ppm(path) == 0) s_shots++;
+        }
+        s_next_shot_us = now_us - now_us % (sim_cfg.shot_every_ms * 1000ULL) + sim_cfg.shot_every_ms * 1000ULL;
+    }
+}
+
+/**
+ * @brief  帧缓冲保存为PPM (P6, 24位)
+ */
+uint8_t sim_lcd_save_ppm(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    uint32_t i, n = (uint32_t)lcddev.width * lcddev.height;
+    uint8_t rgb[3];
+
+    if (fp == NULL) return 1;
+    fprintf(fp, "P6\n%u %u\n255\n", lcddev.width, lcddev.height);
+    for (i = 0; i < n; i++)
+    {
+        rgb[0] = (uint8_t)(((s_fb[i] >> 11) & 0x1F) * 255 / 31);
+        rgb[1] = (uint8_t)(((s_fb[i] >> 5) & 0x3F) * 255 / 63);
+        rgb[2] = (uint8_t)((s_fb[i] & 0x1F) * 255 / 31);
+        fwrite(rgb, 1, 3, fp);
+    }
+    fclose(fp);
+    return 0;
+}
+
+uint32_t sim_lcd_pixels_written(void)
+{
+    return s_pixels;
+}
+
+/******************************************************************************************/
+/* LCD驱动接口 */
+
+void lcd_init(void)
+{
+    lcddev.id = 0x9341;
+    lcd_display_dir(0);
+    memset(s_fb, 0, sizeof(s_fb));
+}
+
+/**
+ * @brief  设置显示方向: 0竖屏240x320, 1横屏320x240
+ */
+void lcd_display_dir(uint8_t dir)
+{
+    lcddev.dir = dir;
+    lcddev.width = dir ? SIM_LCD_WIDTH : SIM_LCD_HEIGHT;
+    lcddev.height = dir ? SIM_LCD_HEIGHT : SIM_LCD_WIDTH;
+}
+
+void lcd_dma_init(void)
+{
+    s_dma_ready = 1;
+}
+
+uint8_t lcd_dma_busy(void)
+{
+    return s_dma_busy;
+}
+
+/**
+ * @brief  CPU彩色填充 (阻塞)
+ */
+void lcd_color_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t *color)
+{
+    fb_blit(sx, sy, ex, ey, color);
+    sim_advance_us((uint64_t)(ex - sx + 1) * (ey - sy + 1) * 1000000 / SIM_LCD_DMA_PPS);
+}
+
+/**
+ * @brief  DMA彩色填充: 像素立即可见, 完成回调在传输时间之后调用
+ * @retval 0:已启动 1:DMA未初始化或忙
+ */
+uint8_t lcd_color_fill_dma(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, const uint16_t *color,
+                           lcd_dma_done_cb_t done)
+{
+    uint64_t px = (uint64_t)(ex - sx + 1) * (ey - sy + 1);
+
+    if (!s_dma_ready || s_dma_busy) return 1;
+
+    fb_blit(sx, sy, ex, ey, color);
+    s_dma_cb = done;
+    s_dma_done_us = sim_now_us() + 1 + px * 1000000 / SIM_LCD_DMA_PPS;
+    s_dma_busy = 1;
+    return 0;
+}
+
+void lcd_clear(uint16_t color)
+{
+    uint32_t i;
+
+    for (i = 0; i < (uint32_t)lcddev.width * lcddev.height; i++) s_fb[i] = color;
+}
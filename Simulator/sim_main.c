@@ -0,0 +1,296 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_main.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       主机模拟器入口: 解析参数, 运行固件主程序, 结束时输出JSON结果
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 用法: flowerpot_sim [选项]
+ *   --duration MS        运行时长 (虚拟时间, 默认10000)
+ *   --realtime           按实时运行 (默认空闲时间直接跳过)
+ *   --out DIR            结束时保存 DIR/final.ppm
+ *   --shot-every MS      每隔MS保存一帧 DIR/frame_<ms>.ppm (需要--out)
+ *   --key MS:NAME        在MS时按下按键, NAME为 key0/key1/wkup/tpad, 可重复
+ *   --tap MS:X,Y         在MS时点击触摸屏, 可重复
+ *   --server HOST:PORT   AT+CIPSTART实际连接的服务器 (不指定则服务器不可达)
+ *   --mock               AT+CIPSTART连接进程内的模拟服务器 (mock_server.c), 结果中增加"mock"统计;
+ *                        可加 mock_server.h 中的选项 (--ctl-every/--delay/--loss/--drop-every/--stall/--bin/--seed)
+ *   --no-wifi            路由器不可用
+ *   --wifi-unsaved       模块未保存WiFi, 需要AT+CWJAP加入
+ *   --day MS             环境模型一天的长度 (默认600000)
+ *   --dht-fail MS        DHT11从该时刻起不再更新 (读数过期)
+ *   --soil PCT           土壤初始湿度 (默认45)
+ *   --flash FILE         W25QXX镜像, 启动时载入, 结束时写回
+ *   --json FILE          结果输出到文件 (默认标准输出)
+ *   -q                   不输出固件的调试打印
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "key.h"
+#include "scheduler.h"
+#include "perf.h"
+#include "myserver.h"
+#include "lv_port_disp_template.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int app_main(void);                                         /* USER/main.c 的 main() */
+
+sim_config_t sim_cfg = {
+    .duration_ms = 10000,
+    .wifi_saved = 1,
+    .wifi_ap = 1,
+    .day_ms = 600000,
+    .soil_pct = 45.0,
+};
+
+static FILE *s_result;                                      /* 结果输出 (-q时标准输出被重定向) */
+
+/******************************************************************************************/
+/* 参数解析 */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--duration MS] [--realtime] [--out DIR] [--shot-every MS]\n"
+            "          [--key MS:key0|key1|wkup|tpad] [--tap MS:X,Y] [--server HOST:PORT] [--mock]\n"
+            "          [--no-wifi] [--wifi-unsaved] [--day MS] [--dht-fail MS] [--soil PCT]\n"
+            "          [--flash FILE] [--json FILE] [-q]\n%s",
+            prog, mock_server_usage());
+    exit(2);
+}
+
+/**
+ * @brief  添加一个输入事件 (按时间插入排序)
+ */
+static uint8_t add_event(const char *arg, uint8_t tap)
+{
+    sim_event_t e = {0};
+    char name[8];
+    unsigned long at;
+    unsigned x, y;
+    int i;
+
+    if (sim_cfg.event_count >= SIM_MAX_EVENTS) return 1;
+
+    if (tap)
+    {
+        if (sscanf(arg, "%lu:%u,%u", &at, &x, &y) != 3) return 1;
+        e.key = SIM_KEY_TAP;
+        e.x = (uint16_t)x;
+        e.y = (uint16_t)y;
+    }
+    else
+    {
+        if (sscanf(arg, "%lu:%7s", &at, name) != 2) return 1;
+        if (strcmp(name, "key0") == 0) e.key = KEY0_PRES;
+        else if (strcmp(name, "key1") == 0) e.key = KEY1_PRES;
+        else if (strcmp(name, "wkup") == 0) e.key = WKUP_PRES;
+        else if (strcmp(name, "tpad") == 0) e.key = SIM_KEY_TPAD;
+        else return 1;
+    }
+    e.at_ms = (uint32_t)at;
+
+    for (i = sim_cfg.event_count; i > 0 && sim_cfg.events[i - 1].at_ms > e.at_ms; i--)
+    {
+        sim_cfg.events[i] = sim_cfg.events[i - 1];
+    }
+    sim_cfg.events[i] = e;
+    sim_cfg.event_count++;
+    return 0;
+}
+
+static void parse_args(int argc, char **argv)
+{
+    static char host[128];
+    unsigned port;
+    int i, r;
+
+    mock_server_default_cfg(&sim_cfg.mock_cfg);
+    for (i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        r = mock_server_parse_opt(&sim_cfg.mock_cfg, a, v);
+        if (r < 0) usage(argv[0]);
+        if (r > 0)
+        {
+            i += r - 1;
+            continue;
+        }
+
+        if (strcmp(a, "--realtime") == 0) sim_cfg.realtime = 1;
+        else if (strcmp(a, "--mock") == 0) sim_cfg.mock = 1;
+        else if (strcmp(a, "--no-wifi") == 0) sim_cfg.wifi_ap = 0;
+        else if (strcmp(a, "--wifi-unsaved") == 0) sim_cfg.wifi_saved = 0;
+        else if (strcmp(a, "-q") == 0) sim_cfg.quiet = 1;
+        else if (v == NULL) usage(argv[0]);
+        else if (strcmp(a, "--duration") == 0) sim_cfg.duration_ms = (uint32_t)strtoul(v, NULL, 0), i++;
+        else if (strcmp(a, "--out") == 0) sim_cfg.out_dir = v, i++;
+        else if (strcmp(a, "--shot-every") == 0) sim_cfg.shot_every_ms = (uint32_t)strtoul(v, NULL, 0), i++;
+        else if (strcmp(a, "--day") == 0) sim_cfg.day_ms = (uint32_t)strtoul(v, NULL, 0), i++;
+        else if (strcmp(a, "--dht-fail") == 0) sim_cfg.dht_fail_ms = (uint32_t)strtoul(v, NULL, 0), i++;
+        else if (strcmp(a, "--soil") == 0) sim_cfg.soil_pct = strtod(v, NULL), i++;
+        else if (strcmp(a, "--flash") == 0) sim_cfg.flash_path = v, i++;
+        else if (strcmp(a, "--json") == 0) sim_cfg.json_path = v, i++;
+        else if (strcmp(a, "--key") == 0 || strcmp(a, "--tap") == 0)
+        {
+            if (add_event(v, a[2] == 't') != 0) usage(argv[0]);
+            i++;
+        }
+        else if (strcmp(a, "--server") == 0)
+        {
+            if (sscanf(v, "%127[^:]:%u", host, &port) != 2 || port == 0 || port > 65535) usage(argv[0]);
+            sim_cfg.server_host = host;
+            sim_cfg.server_port = (uint16_t)port;
+            i++;
+        }
+        else usage(argv[0]);
+    }
+}
+
+/******************************************************************************************/
+/* 结果输出 */
+
+static uint32_t avg(uint64_t total, uint32_t n)
+{
+    return n ? (uint32_t)(total / n) : 0;
+}
+
+static void report(FILE *fp)
+{
+    uint64_t now_us = sim_now_us();
+    uint32_t host_ms = sim_host_ms();
+    lv_port_disp_stats_t disp;
+    sim_net_stats_t net;
+    my_telemetry_stats_t tlm;
+    hb_stats_t hb;
+    my_cmd_stats_t cmd;
+    perf_stats_t perf;
+    const sched_task_t *t;
+    uint8_t i;
+
+    lv_port_disp_get_stats(&disp);
+    sim_esp_get_stats(&net);
+    myserver_telemetry_get_stats(&tlm);
+    myserver_heartbeat_get_stats(&hb);
+    myserver_cmd_get_stats(&cmd);
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"sim\": {\"virtual_ms\": %lu, \"host_ms\": %lu, \"realtime\": %u},\n",
+            (unsigned long)(now_us / 1000), (unsigned long)host_ms, sim_cfg.realtime);
+
+    fprintf(fp, "  \"display\": {\"frames\": %lu, \"fps\": %.2f, \"flushes\": %lu, \"pixels\": %lu,\n",
+            (unsigned long)disp.frames, now_us ? disp.frames * 1e6 / now_us : 0.0,
+            (unsigned long)disp.flushes, (unsigned long)sim_lcd_pixels_written());
+    fprintf(fp, "              \"frame_us\": {\"avg\": %lu, \"max\": %lu}, \"render_us\": {\"avg\": %lu, \"max\": %lu},\n",
+            (unsigned long)avg(disp.total_frame_us, disp.frames), (unsigned long)disp.max_frame_us,
+            (unsigned long)avg(disp.total_render_us, disp.frames), (unsigned long)disp.max_render_us);
+    fprintf(fp, "              \"flush_cpu_us\": {\"avg\": %lu}, \"mem\": {\"used\": %lu, \"free\": %lu, \"max_used\": %lu, \"frag_pct\": %u}},\n",
+            (unsigned long)avg(disp.total_cpu_us, disp.frames), (unsigned long)disp.mem_used,
+            (unsigned long)disp.mem_free, (unsigned long)disp.mem_max_used, disp.mem_frag_pct);
+
+    fprintf(fp, "  \"net\": {\"connects\": %lu, \"at_cmds\": %lu, \"tx_bytes\": %lu, \"rx_bytes\": %lu, \"tx_msgs\": %lu, \"by_type\": {",
+            (unsigned long)net.connects, (unsigned long)net.at_cmds, (unsigned long)net.tx_bytes,
+            (unsigned long)net.rx_bytes, (unsigned long)net.tx_msgs);
+    for (i = 0; i < 8; i++)
+    {
+        fprintf(fp, "%s\"%s\": %lu", i ? ", " : "", sim_msg_types[i], (unsigned long)net.by_type[i]);
+    }
+    fprintf(fp, "},\n          \"telemetry\": {\"dat_sent\": %lu, \"dat_suppressed\": %lu, \"sta_sent\": %lu, \"bytes\": %lu, \"spooled\": %lu},\n",
+            (unsigned long)tlm.dat_sent, (unsigned long)tlm.dat_suppressed, (unsigned long)tlm.sta_sent,
+            (unsigned long)tlm.bytes_sent, (unsigned long)tlm.spooled);
+    fprintf(fp, "          \"heartbeat\": {\"sent\": %lu, \"acked\": %lu, \"lost\": %lu, \"rtt_avg\": %lu},\n",
+            (unsigned long)hb.sent, (unsigned long)hb.acked, (unsigned long)hb.lost, (unsigned long)hb.rtt_avg);
+    fprintf(fp, "          \"cmd\": {\"acked\": %lu, \"last_us\": %lu, \"avg_us\": %lu, \"max_us\": %lu, \"slow\": %lu}},\n",
+            (unsigned long)cmd.count, (unsigned long)cmd.last_us, (unsigned long)cmd.avg_us,
+            (unsigned long)cmd.max_us, (unsigned long)cmd.slow);
+
+    sim_board_report(fp);
+    if (sim_cfg.mock)
+    {
+        fprintf(fp, "  \"mock\": ");
+        mock_server_report(fp, now_us, "  ");
+        fprintf(fp, ",\n");
+    }
+
+    fprintf(fp, "  \"tasks\": {");
+    for (i = 0; i < sched_get_task_count(); i++)
+    {
+        t = sched_get_task(i);
+        fprintf(fp, "%s\n    \"%s\": {\"runs\": %lu, \"posts\": %lu, \"avg_us\": %lu, \"max_us\": %lu, \"max_latency_us\": %lu, \"deadline_miss\": %lu}",
+                i ? "," : "", t->name, (unsigned long)t->run_count, (unsigned long)t->posts, (unsigned long)sched_get_avg_us(i),
+                (unsigned long)t->max_us, (unsigned long)t->max_latency_us, (unsigned long)t->deadline_miss);
+    }
+    fprintf(fp, "\n  },\n  \"perf\": {");
+    for (i = 0; perf_get(i, &perf) == 0; i++)
+    {
+        fprintf(fp, "%s\n    \"%s\": {\"n\": %lu, \"min_us\": %lu, \"avg_us\": %lu, \"max_us\": %lu}",
+                i ? "," : "", perf.name, (unsigned long)perf.count, (unsigned long)perf.min_us,
+                (unsigned long)perf.avg_us, (unsigned long)perf.max_us);
+    }
+    fprintf(fp, "\n  }\n}\n");
+}
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  输出结果并退出
+ */
+void sim_finish(int code)
+{
+    char path[512];
+    FILE *fp = s_result;
+
+    fflush(stdout);
+    if (sim_cfg.out_dir != NULL)
+    {
+        snprintf(path, sizeof(path), "%s/final.ppm", sim_cfg.out_dir);
+        if (sim_lcd_save_ppm(path) != 0) fprintf(stderr, "sim: cannot write %s\n", path);
+    }
+    sim_board_save();
+
+    if (sim_cfg.json_path != NULL && (fp = fopen(sim_cfg.json_path, "w")) == NULL)
+    {
+        fprintf(stderr, "sim: cannot write %s\n", sim_cfg.json_path);
+        fp = s_result;
+    }
+    report(fp);
+    fclose(fp);
+    exit(code);
+}
+
+/**
+ * @brief  到达运行时长时结束
+ */
+void sim_check_end(void)
+{
+    if (sim_now_us() >= (uint64_t)sim_cfg.duration_ms * 1000) sim_finish(0);
+}
+
+int main(int argc, char **argv)
+{
+    parse_args(argc, argv);
+
+    s_result = fdopen(dup(STDOUT_FILENO), "w");
+    if (sim_cfg.quiet && freopen("/dev/null", "w", stdout) == NULL) return 2;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    sim_periph_init();
+    sim_clock_init();
+    sim_board_init();
+    sim_esp_init();
+    if (sim_cfg.mock) mock_server_init(&sim_cfg.mock_cfg, sim_now_us(), SIM_UNIX_MS + sim_now_us() / 1000);
+
+    return app_main();
+}
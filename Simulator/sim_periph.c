@@ -0,0 +1,166 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_periph.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       外设寄存器内存与标准外设库的模拟实现
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 在STM32的外设地址上映射普通内存, 固件中直接访问寄存器的代码 (GPIOA->BSRR, 位带写LED1等)
+ *   不用修改即可运行: 写入只是改写内存, 读出的是上次写入的值
+ * - 映射区域: 外设 0x40000000, 外设位带别名区 0x42000000, 内核外设 0xE0000000 (DWT/NVIC/SCB)
+ * - 标准外设库只实现固件用到的函数, GPIO输出状态保存在ODR中供板级模型读取
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim.h"
+#include "sys.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE     0x100000
+#endif
+
+/******************************************************************************************/
+/* 映射区域 */
+
+typedef struct {
+    uintptr_t base;
+    size_t    size;
+} sim_region_t;
+
+static const sim_region_t s_regions[] = {
+    { PERIPH_BASE,    0x00030000 },                         /* APB1/APB2/AHB外设 */
+    { PERIPH_BB_BASE, 0x00600000 },                         /* 外设位带别名区 (覆盖到AHB) */
+    { 0xE0000000,     0x00100000 },                         /* 内核外设 (ITM/DWT/SCS) */
+};
+
+uint32_t SystemCoreClock = 72000000;                        /* 替换system_stm32f10x.c */
+
+/******************************************************************************************/
+/* 模拟器接口 */
+
+/**
+ * @brief  映射外设寄存器内存
+ */
+void sim_periph_init(void)
+{
+    size_t i;
+    void *p;
+
+    for (i = 0; i < sizeof(s_regions) / sizeof(s_regions[0]); i++)
+    {
+        p = mmap((void *)s_regions[i].base, s_regions[i].size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (p != (void *)s_regions[i].base)
+        {
+            fprintf(stderr, "sim: cannot map peripheral region 0x%08lx\n", (unsigned long)s_regions[i].base);
+            exit(2);
+        }
+    }
+}
+
+/**
+ * @brief  GPIO端口
+ */
+static GPIO_TypeDef *gpio_port(char port)
+{
+    return (GPIO_TypeDef *)(uintptr_t)(APB2PERIPH_BASE + 0x0800 + (uint32_t)(port - 'A') * 0x0400);
+}
+
+/**
+ * @brief  读取输出引脚: ODR (GPIO_SetBits/BSRR) 与位带别名 (PxOUT(n)) 任一为1即为高电平
+ * @note   固件对同一引脚只使用其中一种方式, 位带写入不会同步到ODR
+ */
+uint8_t sim_gpio_out(char port, uint8_t pin)
+{
+    GPIO_TypeDef *gpio = gpio_port(port);
+    uint32_t odr = (uint32_t)(uintptr_t)&gpio->ODR;
+
+    if (gpio->ODR & (1U << pin)) return 1;
+    return MEM_ADDR(BITBAND(odr, pin)) & 1;
+}
+
+/**
+ * @brief  设置输入引脚 (按键)
+ */
+void sim_gpio_set_input(char port, uint8_t pin, uint8_t level)
+{
+    GPIO_TypeDef *gpio = gpio_port(port);
+
+    if (level) gpio->IDR |= (1U << pin);
+    else gpio->IDR &= ~(1U << pin);
+}
+
+/******************************************************************************************/
+/* 标准外设库 */
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct)
+{
+    (void)GPIOx;
+    (void)GPIO_InitStruct;
+}
+
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR |= GPIO_Pin;
+}
+
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+}
+
+void GPIO_WriteBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, BitAction BitVal)
+{
+    if (BitVal != Bit_RESET) GPIO_SetBits(GPIOx, GPIO_Pin);
+    else GPIO_ResetBits(GPIOx, GPIO_Pin);
+}
+
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? Bit_SET : Bit_RESET;
+}
+
+uint8_t GPIO_ReadOutputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->ODR & GPIO_Pin) ? Bit_SET : Bit_RESET;
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+    (void)RCC_APB2Periph;
+    (void)NewState;
+}
+
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+    (void)RCC_APB1Periph;
+    (void)NewState;
+}
+
+void NVIC_PriorityGroupConfig(uint32_t NVIC_PriorityGroup)
+{
+    (void)NVIC_PriorityGroup;
+}
+
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct)
+{
+    (void)NVIC_InitStruct;
+}
+
+/**
+ * @brief  软件复位 (服务器下发reboot): 模拟器在此结束运行
+ */
+void sim_system_reset(void)
+{
+    printf("[Sim] system reset requested\r\n");
+    sim_finish(0);
+}
@@ -0,0 +1,52 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_soil.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       两层滞后土壤湿度模型
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ ****************************************************************************************************
+ */
+
+#include "sim_soil.h"
+#include <math.h>
+
+/**
+ * @brief  初始化
+ */
+void sim_soil_init(sim_soil_t *s, double root)
+{
+    s->top = 0;
+    s->root = root;
+    s->runoff = 0;
+    s->peak = root;
+}
+
+/**
+ * @brief  推进模型
+ * @note   渗透按指数衰减计算, 步长较大 (空闲时跳过的时间) 时也不会超调
+ */
+void sim_soil_step(sim_soil_t *s, int pump_on, double dt)
+{
+    double infil;
+
+    if (dt <= 0) return;
+
+    if (pump_on) s->top += SIM_SOIL_PUMP_PCT_S * dt;
+    infil = s->top * (1.0 - exp(-dt / SIM_SOIL_INFIL_S));
+    s->top -= infil;
+    s->root += infil - SIM_SOIL_DRY_PCT_MIN / 60.0 * dt;
+
+    if (s->root > 100.0)
+    {
+        s->runoff += s->root - 100.0;
+        s->root = 100.0;
+    }
+    if (s->root < 0) s->root = 0;
+    if (s->root > s->peak) s->peak = s->root;
+}
@@ -0,0 +1,59 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_soil.h
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       两层滞后土壤湿度模型 (模拟器环境模型和浇水控制器测试共用)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 说明:
+ * - 水泵的水先进入表层, 表层按时间常数 SIM_SOIL_INFIL_S 向根区渗透, 传感器读的是根区,
+ *   所以读数在关泵后还会继续上升, 开泵直到读数达标必然浇多
+ * - 根区按固定速率干燥; 超过100%的水从盆底流失, 计入 runoff
+ * - 湿度单位为根区的百分比, 表层的值表示尚未渗入根区的水量
+ * - 不依赖模拟器其他部分, 可单独链接到主机测试
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SIM_SOIL_H
+#define __SIM_SOIL_H
+
+/******************************************************************************************/
+/* 模型参数 */
+
+#define SIM_SOIL_PUMP_PCT_S     2.0         /* 开泵时每秒进入表层的水量 (%), 与WATER_MS_PER_PCT一致 */
+#define SIM_SOIL_INFIL_S        60.0        /* 表层向根区渗透的时间常数 (s) */
+#define SIM_SOIL_DRY_PCT_MIN    0.2         /* 根区每分钟干燥 (%) */
+
+/******************************************************************************************/
+/* 数据结构定义 */
+
+typedef struct {
+    double top;                             /* 表层尚未渗入的水量 (%) */
+    double root;                            /* 根区湿度 (%), 传感器读数 */
+    double runoff;                          /* 累计从盆底流失的水量 (%) */
+    double peak;                            /* 根区湿度最大值 (%) */
+} sim_soil_t;
+
+/******************************************************************************************/
+/* 函数声明 */
+
+/**
+ * @brief  初始化, 表层无积水
+ * @param  root: 根区初始湿度 (%)
+ */
+void sim_soil_init(sim_soil_t *s, double root);
+
+/**
+ * @brief  推进模型
+ * @param  pump_on: 本段时间内水泵是否开启
+ * @param  dt: 时长 (s)
+ */
+void sim_soil_step(sim_soil_t *s, int pump_on, double dt);
+
+#endif /* __SIM_SOIL_H */
@@ -0,0 +1,180 @@
+/**
+ ****************************************************************************************************
+ * @file        bench_bin_codec.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       bin1 遥测帧基准: 每帧字节数对比JSON dat/sta, 编码/解码吞吐
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 用法: bench_bin_codec [循环次数]   (默认200000)
+ *
+ * JSON报文按 myserver.c 的格式生成 (设备ID、毫秒时间戳、典型的序号位数), 与bin1帧携带相同的数据;
+ * sta的JSON额外携带心跳RTT, bin1状态帧没有这些字段。
+ * 计时前先核对解码结果与输入一致, 不一致时返回非0
+ *
+ ****************************************************************************************************
+ */
+
+#include "bin_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEVICE_ID       "MyPot"             /* 与MY_DEVICE_ID一致 */
+#define BATCH_N         8                   /* 与遥测批量上报的样本数一致 */
+
+static const char s_head[] = "{\"v\":\"1.0\",\"id\":\"%lu\",\"ts\":%s,\"t\":\"%s\",\"d\":\"" DEVICE_ID "\",";
+static const char s_ts[] = "1760000012345";
+
+static bin_dat_t s_dat[BATCH_N];
+static uint16_t s_off_10ms[BATCH_N];
+static const bin_sta_t s_sta = { 0, 1, 0, 1 };
+
+/******************************************************************************************/
+/* JSON报文 (与myserver.c相同的格式) */
+
+static int json_dat(char *buf, int size)
+{
+    int n = snprintf(buf, size, s_head, 12345UL, s_ts, "dat");
+
+    return n + snprintf(buf + n, size - n, "\"p\":{\"temp\":%d,\"humi\":%d,\"soil\":%d,\"light\":%d}}\n",
+                        s_dat[0].temp, s_dat[0].humi, s_dat[0].soil, s_dat[0].light);
+}
+
+static int json_batch(char *buf, int size)
+{
+    int n = snprintf(buf, size, s_head, 12345UL, s_ts, "dat");
+    int i;
+
+    n += snprintf(buf + n, size - n, "\"p\":{\"f\":[\"temp\",\"humi\",\"soil\",\"light\"],\"s\":[");
+    for (i = 0; i < BATCH_N; i++)
+    {
+        n += snprintf(buf + n, size - n, "%s[%u,%d,%d,%d,%d]", i ? "," : "", s_off_10ms[i] * 10U,
+                      s_dat[i].temp, s_dat[i].humi, s_dat[i].soil, s_dat[i].light);
+    }
+    return n + snprintf(buf + n, size - n, "]}}\n");
+}
+
+static int json_sta(char *buf, int size)
+{
+    int n = snprintf(buf, size, s_head, 12345UL, s_ts, "sta");
+
+    return n + snprintf(buf + n, size - n,
+                        "\"p\":{\"mode\":%d,\"light\":%d,\"water\":%d,\"fan\":%d,"
+                        "\"rtt_min\":%d,\"rtt_avg\":%d,\"rtt_max\":%d}}\n",
+                        s_sta.mode, s_sta.light, s_sta.water, s_sta.fan, 38, 52, 140);
+}
+
+/******************************************************************************************/
+/* bin1帧 */
+
+static uint16_t bin_dat(uint8_t *buf, uint16_t size, uint16_t seq)
+{
+    return bin_encode_dat(buf, size, seq, &s_dat[0]);
+}
+
+static uint16_t bin_batch(uint8_t *buf, uint16_t size, uint16_t seq)
+{
+    return bin_encode_dat_batch(buf, size, seq, s_dat, s_off_10ms, BATCH_N);
+}
+
+static uint16_t bin_sta(uint8_t *buf, uint16_t size, uint16_t seq)
+{
+    return bin_encode_sta(buf, size, seq, &s_sta);
+}
+
+/**
+ * @brief  解码结果是否与输入一致
+ */
+static int verify(uint8_t type, const bin_frame_t *f)
+{
+    uint8_t i, n = (type == BIN_TYPE_DAT_BATCH) ? BATCH_N : 1;
+
+    if (type == BIN_TYPE_STA) return memcmp(&f->sta, &s_sta, sizeof(s_sta)) == 0;
+    if (f->count != n) return 0;
+    for (i = 0; i < n; i++)
+    {
+        if (memcmp(&f->dat[i], &s_dat[i], sizeof(bin_dat_t)) != 0) return 0;
+        if (type == BIN_TYPE_DAT_BATCH && f->offset_10ms[i] != s_off_10ms[i]) return 0;
+    }
+    return 1;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        uint8_t type;
+        int (*json)(char *, int);
+        uint16_t (*bin)(uint8_t *, uint16_t, uint16_t);
+    } kinds[] = {
+        { "dat",     BIN_TYPE_DAT,       json_dat,   bin_dat },
+        { "dat x8",  BIN_TYPE_DAT_BATCH, json_batch, bin_batch },
+        { "sta",     BIN_TYPE_STA,       json_sta,   bin_sta },
+    };
+    static volatile uint32_t sink;
+    long loops = (argc > 1) ? strtol(argv[1], NULL, 0) : 200000;
+    char text[512];
+    uint8_t frame[128];
+    bin_frame_t f;
+    uint16_t len;
+    double t0, t_json, t_enc, t_dec;
+    int i, json_len, bad = 0;
+    unsigned k;
+    long l;
+
+    if (loops <= 0) loops = 1;
+
+    for (i = 0; i < BATCH_N; i++)
+    {
+        s_dat[i].temp = (uint8_t)(24 + i % 3);
+        s_dat[i].humi = (uint8_t)(58 + i);
+        s_dat[i].soil = (uint8_t)(45 - i);
+        s_dat[i].light = (uint8_t)(80 + 2 * i);
+        s_off_10ms[i] = (uint16_t)(i * 500);
+    }
+
+    printf("%-7s %6s %6s %6s %12s %12s %12s\n",
+           "frame", "json B", "bin B", "ratio", "json ns", "encode ns", "decode ns");
+    for (k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+    {
+        json_len = kinds[k].json(text, sizeof(text));
+        len = kinds[k].bin(frame, sizeof(frame), 1);
+        if (len == 0 || bin_decode(frame, len, &f) != len || f.type != kinds[k].type || !verify(kinds[k].type, &f))
+        {
+            printf("%s: decode mismatch\n", kinds[k].name);
+            bad = 1;
+            continue;
+        }
+
+        t0 = now_ns();
+        for (l = 0; l < loops; l++) sink += (uint32_t)kinds[k].json(text, sizeof(text));
+        t_json = (now_ns() - t0) / loops;
+
+        t0 = now_ns();
+        for (l = 0; l < loops; l++) sink += kinds[k].bin(frame, sizeof(frame), (uint16_t)l);
+        t_enc = (now_ns() - t0) / loops;
+
+        t0 = now_ns();
+        for (l = 0; l < loops; l++) sink += (uint32_t)bin_decode(frame, len, &f) + f.seq;
+        t_dec = (now_ns() - t0) / loops;
+
+        printf("%-7s %6d %6u %5.1fx %12.0f %12.0f %12.0f\n", kinds[k].name, json_len, len,
+               (double)json_len / len, t_json, t_enc, t_dec);
+    }
+
+    return bad;
+}
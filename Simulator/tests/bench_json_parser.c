@@ -0,0 +1,252 @@
+/**
+ ****************************************************************************************************
+ * @file        bench_json_parser.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       下行报文解析基准: json_parse+json_get_* 对比旧的 find_json_string/find_json_int
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 用法: bench_json_parser [循环次数]   (默认20000)
+ *
+ * 对同一条 cfg/ctl 报文读取 parse_json_command 需要的全部字段:
+ * - old:      旧实现原样保留 (每个字段对整条报文做一次strstr, 键可能在错误的层级匹配)
+ * - old-byte: 同上, strstr换成逐字节比较, 接近目标板C库的行为
+ * - new:      一次分词后按路径/键遍历读取
+ * 先核对三种方式读出的值一致, 不一致时返回非0
+ *
+ ****************************************************************************************************
+ */
+
+#include "json_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_TOKENS  48
+
+/* parse_json_command读取的字段 */
+typedef struct {
+    char     type[16];
+    char     id[16];
+    char     key[16];
+    int32_t  state;
+    int32_t  limit[8];
+} fields_t;
+
+static const char *const s_limit_keys[8] = {
+    "temp_upper", "temp_lower", "humi_upper", "humi_lower",
+    "soil_upper", "soil_lower", "light_upper", "light_lower"
+};
+
+static const char s_ctl[] =
+    "{\"v\":\"2.0\",\"id\":\"1718\",\"ts\":1760000012345,\"t\":\"ctl\",\"p\":{\"k\":\"water\",\"s\":1}}";
+
+static const char s_cfg[] =
+    "{\"v\":\"2.0\",\"id\":\"42\",\"ts\":1760000012345,\"t\":\"cfg\",\"p\":{\"temp_upper\":35,\"temp_lower\":10,"
+    "\"humi_upper\":80,\"humi_lower\":30,\"soil_upper\":70,\"soil_lower\":20,"
+    "\"light_upper\":90,\"light_lower\":15}}";
+
+static char *(*s_strstr)(const char *, const char *);
+
+/**
+ * @brief  逐字节strstr (目标板C库没有向量化实现)
+ */
+static char *byte_strstr(const char *s, const char *sub)
+{
+    const char *a, *b;
+
+    for (; *s; s++)
+    {
+        for (a = s, b = sub; *b && *a == *b; a++, b++);
+        if (*b == '\0') return (char *)s;
+    }
+    return NULL;
+}
+
+static char *libc_strstr(const char *s, const char *sub)
+{
+    return strstr(s, sub);
+}
+
+/******************************************************************************************/
+/* 旧实现 (myserver.c 改用json_parser之前的版本) */
+
+static int find_json_int(const char *json, const char *key)
+{
+    char search[32];
+    char *pos;
+
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    pos = s_strstr(json, search);
+    if (pos == NULL) return -1;
+
+    pos += strlen(search);
+    while (*pos == ' ') pos++;
+
+    return atoi(pos);
+}
+
+static char* find_json_string(const char *json, const char *key, char *out, uint8_t max_len)
+{
+    char search[32];
+    char *pos, *end;
+    uint8_t len;
+
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    pos = s_strstr(json, search);
+    if (pos == NULL) return NULL;
+
+    pos += strlen(search);
+    while (*pos == ' ') pos++;
+
+    if (*pos != '"') return NULL;
+    pos++;
+
+    end = strchr(pos, '"');
+    if (end == NULL) return NULL;
+
+    len = end - pos;
+    if (len >= max_len) len = max_len - 1;
+
+    strncpy(out, pos, len);
+    out[len] = '\0';
+
+    return out;
+}
+
+static void read_old(const char *json, fields_t *f)
+{
+    uint8_t i;
+
+    memset(f, 0, sizeof(*f));
+    if (find_json_string(json, "t", f->type, sizeof(f->type)) == NULL) return;
+    find_json_string(json, "id", f->id, sizeof(f->id));
+
+    if (strcmp(f->type, "ctl") == 0)
+    {
+        if (find_json_string(json, "k", f->key, sizeof(f->key)) != NULL)
+        {
+            f->state = find_json_int(json, "s");
+        }
+    }
+    else if (strcmp(f->type, "cfg") == 0)
+    {
+        for (i = 0; i < 8; i++) f->limit[i] = find_json_int(json, s_limit_keys[i]);
+    }
+}
+
+/******************************************************************************************/
+/* 新实现 (与myserver.c parse_json_command相同的读取方式) */
+
+static void read_new(const char *json, fields_t *f)
+{
+    json_parser_t parser;
+    json_tok_t tokens[MAX_TOKENS];
+    int count, payload, key;
+    int32_t value;
+    uint8_t i;
+
+    memset(f, 0, sizeof(*f));
+    json_init(&parser);
+    count = json_parse(&parser, json, (uint16_t)strlen(json), tokens, MAX_TOKENS);
+    if (count <= 0) return;
+
+    if (json_get_string(json, tokens, count, "t", f->type, sizeof(f->type)) != 0) return;
+    json_get_string(json, tokens, count, "id", f->id, sizeof(f->id));
+
+    if (strcmp(f->type, "ctl") == 0)
+    {
+        if (json_get_string(json, tokens, count, "p.k", f->key, sizeof(f->key)) == 0)
+        {
+            json_get_int(json, tokens, count, "p.s", &f->state);
+        }
+    }
+    else if (strcmp(f->type, "cfg") == 0)
+    {
+        payload = json_find(json, tokens, count, "p");
+        for (key = json_obj_next(tokens, count, payload, -1); key >= 0;
+             key = json_obj_next(tokens, count, payload, key))
+        {
+            if (json_tok_int(json, &tokens[key + 1], &value) != 0) continue;
+            for (i = 0; i < 8; i++)
+            {
+                if (json_tok_equal(json, &tokens[key], s_limit_keys[i]))
+                {
+                    f->limit[i] = value;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************************/
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief  测量一种读取方式的单条耗时 (ns)
+ */
+static double run(void (*read)(const char *, fields_t *), const char *json, long loops)
+{
+    static volatile int32_t sink;
+    fields_t f;
+    double t0;
+    long i;
+
+    t0 = now_ns();
+    for (i = 0; i < loops; i++)
+    {
+        read(json, &f);
+        sink += f.state + f.limit[7] + f.id[0];
+    }
+    return (now_ns() - t0) / loops;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct { const char *name; const char *json; } msgs[] = {
+        { "ctl", s_ctl }, { "cfg", s_cfg }
+    };
+    long loops = (argc > 1) ? strtol(argv[1], NULL, 0) : 20000;
+    fields_t a, b;
+    double t_old, t_byte, t_new;
+    unsigned m;
+    int bad = 0;
+
+    if (loops <= 0) loops = 1;
+
+    printf("%-4s %5s %12s %12s %12s %8s\n", "msg", "bytes", "old ns", "old-byte ns", "new ns", "speedup");
+    for (m = 0; m < sizeof(msgs) / sizeof(msgs[0]); m++)
+    {
+        s_strstr = libc_strstr;
+        read_old(msgs[m].json, &a);
+        read_new(msgs[m].json, &b);
+        if (memcmp(&a, &b, sizeof(a)) != 0)
+        {
+            printf("%s: old and new results differ\n", msgs[m].name);
+            bad = 1;
+        }
+
+        t_old = run(read_old, msgs[m].json, loops);
+        s_strstr = byte_strstr;
+        t_byte = run(read_old, msgs[m].json, loops);
+        t_new = run(read_new, msgs[m].json, loops);
+
+        printf("%-4s %5u %12.0f %12.0f %12.0f %7.1fx\n", msgs[m].name, (unsigned)strlen(msgs[m].json),
+               t_old, t_byte, t_new, t_byte / t_new);
+    }
+
+    return bad;
+}
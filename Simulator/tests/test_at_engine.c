@@ -0,0 +1,445 @@
+/**
+ ****************************************************************************************************
+ * @file        test_at_engine.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       ATK-MW8266D异步AT指令引擎主机单元测试 (脚本化的收发接口)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 只链接 atk_mw8266d_at.c, 收发和时钟由本文件的 atk_mw8266d_at_port_t 提供:
+ * 发送的数据记录到缓冲中, 接收帧由测试按需放入队列, 时钟由测试推进, 发送可设为"队列满"。
+ * 覆盖: 发送前丢弃旧帧、应答拆成两帧 ("WIFI GOT" / " IP")、ERROR/FAIL、超时、队列满和指令过长、
+ *       回调中提交下一条指令、取消、发送队列满时整条重试、应答缓冲截断。
+ * 失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "atk_mw8266d_at.h"
+#include <stdio.h>
+#include <string.h>
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+/******************************************************************************************/
+/* 脚本化的接口 */
+
+#define RX_FRAMES       8
+#define RX_FRAME_MAX    256
+
+static char s_tx[1024];                         /* 已发送的数据 */
+static uint16_t s_tx_len;
+static uint8_t s_tx_busy;                       /* 1: 模拟发送队列满 */
+static uint32_t s_tx_calls;
+
+static uint8_t s_rx[RX_FRAMES][RX_FRAME_MAX];   /* 接收帧队列 */
+static uint8_t s_rx_head, s_rx_count;
+static uint32_t s_rx_flushed;                   /* 被丢弃的帧数 */
+
+static uint32_t s_now;
+
+static uint8_t port_send(const uint8_t *data, uint16_t len)
+{
+    s_tx_calls++;
+    if (s_tx_busy || s_tx_len + len >= sizeof(s_tx)) return 1;
+    memcpy(&s_tx[s_tx_len], data, len);
+    s_tx_len += len;
+    s_tx[s_tx_len] = '\0';
+    return 0;
+}
+
+static uint8_t *port_rx_get_frame(void)
+{
+    return s_rx_count ? s_rx[s_rx_head] : NULL;
+}
+
+static void port_rx_release(void)
+{
+    if (s_rx_count == 0) return;
+    s_rx_head = (s_rx_head + 1) % RX_FRAMES;
+    s_rx_count--;
+}
+
+static void port_rx_flush(void)
+{
+    s_rx_flushed += s_rx_count;
+    s_rx_count = 0;
+}
+
+static uint32_t port_now_ms(void)
+{
+    return s_now;
+}
+
+static const atk_mw8266d_at_port_t s_port = {
+    port_send, port_rx_get_frame, port_rx_release, port_rx_flush, port_now_ms
+};
+
+/**
+ * @brief  模块送来一帧
+ */
+static void rx_push(const char *frame)
+{
+    uint8_t i = (s_rx_head + s_rx_count) % RX_FRAMES;
+
+    snprintf((char *)s_rx[i], RX_FRAME_MAX, "%s", frame);
+    s_rx_count++;
+}
+
+/******************************************************************************************/
+/* 完成回调 */
+
+typedef struct {
+    uint8_t calls;
+    uint8_t seq;                                /* 完成顺序 */
+    uint8_t result;
+    char resp[ATK_MW8266D_AT_RESP_MAX];
+    const char *chain;                          /* 非NULL: 回调中提交这条指令 */
+    uint8_t chain_ret;
+} done_t;
+
+static uint8_t s_done_seq;                      /* 已完成的回调数 */
+
+static void on_done(uint8_t result, const char *resp, void *arg)
+{
+    done_t *d = arg;
+
+    d->calls++;
+    d->result = result;
+    snprintf(d->resp, sizeof(d->resp), "%s", resp);
+    d->seq = ++s_done_seq;
+    if (d->chain != NULL) d->chain_ret = atk_mw8266d_at_submit(d->chain, "OK", 1000, NULL, NULL);
+}
+
+static void reset(void)
+{
+    s_tx_len = 0;
+    s_tx[0] = '\0';
+    s_tx_busy = 0;
+    s_tx_calls = 0;
+    s_rx_head = s_rx_count = 0;
+    s_rx_flushed = 0;
+    s_now = 1000;
+    s_done_seq = 0;
+    atk_mw8266d_at_init(&s_port);
+}
+
+/******************************************************************************************/
+/* 测试 */
+
+/**
+ * @brief  发送前丢弃旧帧: 上一条指令之后到达的OK不能完成新指令
+ */
+static void test_stale_flush(void)
+{
+    done_t d = {0};
+
+    reset();
+    rx_push("OK\r\n");
+    rx_push("+IPD,4:abcd");
+    CHECK(atk_mw8266d_at_submit("AT+CIPMODE=1", "OK", 500, on_done, &d) == 0);
+    CHECK(s_tx_len == 0);                       /* 提交时不发送 */
+
+    atk_mw8266d_at_poll();
+    CHECK(strcmp(s_tx, "AT+CIPMODE=1\r\n") == 0);
+    CHECK(s_rx_flushed == 2);
+    CHECK(d.calls == 0 && atk_mw8266d_at_busy());
+
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d.calls == 1 && d.result == ATK_MW8266D_AT_EOK);
+    CHECK(strcmp(d.resp, "OK\r\n") == 0);
+    CHECK(!atk_mw8266d_at_busy());
+
+    /* 空闲时不读取接收帧 (透传数据由上层读取) */
+    rx_push("server data");
+    atk_mw8266d_at_poll();
+    CHECK(s_rx_count == 1 && s_rx_flushed == 2);
+}
+
+/**
+ * @brief  期望应答被拆成两帧
+ */
+static void test_split(void)
+{
+    done_t d = {0};
+
+    reset();
+    CHECK(atk_mw8266d_at_submit("AT+CWJAP=\"ssid\",\"pwd\"", "WIFI GOT IP", 15000, on_done, &d) == 0);
+    atk_mw8266d_at_poll();
+
+    rx_push("WIFI CONNECTED\r\n");
+    rx_push("WIFI GOT");
+    s_now += 3000;
+    atk_mw8266d_at_poll();
+    CHECK(d.calls == 0);
+
+    rx_push(" IP\r\n");
+    s_now += 10;
+    atk_mw8266d_at_poll();
+    CHECK(d.calls == 1 && d.result == ATK_MW8266D_AT_EOK);
+    CHECK(strcmp(d.resp, "WIFI CONNECTED\r\nWIFI GOT IP\r\n") == 0);
+}
+
+/**
+ * @brief  ERROR/FAIL结束指令, 后续帧留给下一条
+ */
+static void test_error(void)
+{
+    done_t d1 = {0}, d2 = {0};
+    atk_mw8266d_at_stats_t st;
+
+    reset();
+    CHECK(atk_mw8266d_at_submit("AT+CIPSTART=\"TCP\",\"1.2.3.4\",8080", "CONNECT", 5000, on_done, &d1) == 0);
+    CHECK(atk_mw8266d_at_submit("AT+CWJAP=\"x\",\"y\"", "WIFI GOT IP", 5000, on_done, &d2) == 0);
+    atk_mw8266d_at_poll();
+    rx_push("busy p...\r\n");
+    rx_push("ERROR\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d1.calls == 1 && d1.result == ATK_MW8266D_AT_ERROR);
+    CHECK(strcmp(d1.resp, "busy p...\r\nERROR\r\n") == 0);
+
+    /* 下一条在同一次poll中发出 */
+    CHECK(strstr(s_tx, "AT+CWJAP") != NULL && d2.calls == 0);
+    rx_push("+CWJAP:3\r\n\r\nFAIL\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d2.calls == 1 && d2.result == ATK_MW8266D_AT_ERROR);
+
+    atk_mw8266d_at_get_stats(&st);
+    CHECK(st.submitted == 2 && st.errors == 2 && st.ok == 0 && st.pending == 0);
+}
+
+/**
+ * @brief  超时: 从发送开始计算, 到达超时时间才结束; 下一条立即开始
+ */
+static void test_timeout(void)
+{
+    done_t d1 = {0}, d2 = {0};
+    atk_mw8266d_at_stats_t st;
+
+    reset();
+    CHECK(atk_mw8266d_at_submit("AT", "OK", 1000, on_done, &d1) == 0);
+    CHECK(atk_mw8266d_at_submit("AT+GMR", "OK", 1000, on_done, &d2) == 0);
+
+    s_now = 5000;                               /* 排队时间不计入 */
+    atk_mw8266d_at_poll();
+    s_now = 5999;
+    rx_push("AT\r\n");                          /* 回显 */
+    atk_mw8266d_at_poll();
+    CHECK(d1.calls == 0);
+
+    s_now = 6000;
+    atk_mw8266d_at_poll();
+    CHECK(d1.calls == 1 && d1.result == ATK_MW8266D_AT_ETIMEOUT);
+    CHECK(strcmp(d1.resp, "AT\r\n") == 0);
+    CHECK(strcmp(s_tx, "AT\r\nAT+GMR\r\n") == 0);
+
+    s_now = 6400;
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d2.calls == 1 && d2.result == ATK_MW8266D_AT_EOK);
+
+    atk_mw8266d_at_get_stats(&st);
+    CHECK(st.timeouts == 1 && st.ok == 1 && st.max_ms == 1000);
+}
+
+/**
+ * @brief  队列满、指令过长被拒绝, 不影响已入队的指令
+ */
+static void test_full(void)
+{
+    char longcmd[ATK_MW8266D_AT_CMD_MAX + 2];
+    atk_mw8266d_at_stats_t st;
+    uint8_t i;
+
+    reset();
+    memset(longcmd, 'A', sizeof(longcmd) - 1);
+    longcmd[sizeof(longcmd) - 1] = '\0';
+    CHECK(atk_mw8266d_at_submit(longcmd, "OK", 100, NULL, NULL) == 1);
+    longcmd[ATK_MW8266D_AT_CMD_MAX] = '\0';     /* 正好最大长度 */
+    CHECK(atk_mw8266d_at_submit(longcmd, "OK", 100, NULL, NULL) == 0);
+
+    for (i = 1; i < ATK_MW8266D_AT_QUEUE_SIZE; i++)
+    {
+        CHECK(atk_mw8266d_at_submit("AT", "OK", 100, NULL, NULL) == 0);
+    }
+    CHECK(atk_mw8266d_at_submit("AT", "OK", 100, NULL, NULL) == 1);
+
+    atk_mw8266d_at_get_stats(&st);
+    CHECK(st.submitted == ATK_MW8266D_AT_QUEUE_SIZE && st.rejected == 2);
+    CHECK(st.pending == ATK_MW8266D_AT_QUEUE_SIZE);
+
+    /* 最长的指令完整发出 */
+    atk_mw8266d_at_poll();
+    CHECK(s_tx_len == ATK_MW8266D_AT_CMD_MAX + 2 && s_tx[s_tx_len - 1] == '\n');
+    for (i = 0; i < ATK_MW8266D_AT_QUEUE_SIZE; i++)
+    {
+        rx_push("OK\r\n");
+        atk_mw8266d_at_poll();
+    }
+    atk_mw8266d_at_get_stats(&st);
+    CHECK(st.ok == ATK_MW8266D_AT_QUEUE_SIZE && st.pending == 0);
+}
+
+/**
+ * @brief  回调中提交下一条指令: 在同一次poll中发出; 队列满时也能提交 (先出队再回调)
+ */
+static void test_chain(void)
+{
+    done_t d[ATK_MW8266D_AT_QUEUE_SIZE];
+    uint8_t i;
+
+    reset();
+    memset(d, 0, sizeof(d));
+    d[0].chain = "AT+CIPMODE=1";
+    d[0].chain_ret = 0xFF;
+    CHECK(atk_mw8266d_at_submit("AT+CIPMUX=0", "OK", 100, on_done, &d[0]) == 0);
+    atk_mw8266d_at_poll();
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d[0].calls == 1 && d[0].result == ATK_MW8266D_AT_EOK && d[0].chain_ret == 0);
+    CHECK(strcmp(s_tx, "AT+CIPMUX=0\r\nAT+CIPMODE=1\r\n") == 0);
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(!atk_mw8266d_at_busy());
+
+    /* 队列满 */
+    reset();
+    memset(d, 0, sizeof(d));
+    for (i = 0; i < ATK_MW8266D_AT_QUEUE_SIZE; i++)
+    {
+        CHECK(atk_mw8266d_at_submit("AT+CIPMUX=0", NULL, 100, on_done, &d[i]) == 0);
+    }
+    d[0].chain = "AT+CIPMODE=1";
+    d[0].chain_ret = 0xFF;
+
+    /* 无期望应答的指令发送后立即完成; 每次poll最多处理一轮队列, 串联的指令下次发出 */
+    atk_mw8266d_at_poll();
+    CHECK(d[0].calls == 1 && d[0].result == ATK_MW8266D_AT_EOK && d[0].chain_ret == 0);
+    CHECK(d[1].calls == 1 && d[2].calls == 1 && d[3].calls == 1);
+    CHECK(strcmp(s_tx, "AT+CIPMUX=0\r\nAT+CIPMUX=0\r\nAT+CIPMUX=0\r\nAT+CIPMUX=0\r\n") == 0);
+    CHECK(atk_mw8266d_at_busy());
+
+    atk_mw8266d_at_poll();
+    CHECK(strstr(s_tx, "AT+CIPMODE=1\r\n") != NULL);
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(!atk_mw8266d_at_busy());
+}
+
+/**
+ * @brief  发送队列满: 整条指令下次再发, 不会只发出一部分
+ */
+static void test_send_busy(void)
+{
+    done_t d = {0};
+
+    reset();
+    s_tx_busy = 1;
+    CHECK(atk_mw8266d_at_submit("AT+CIPSEND", ">", 500, on_done, &d) == 0);
+    atk_mw8266d_at_poll();
+    s_now += 2000;                              /* 未发出时不计超时 */
+    atk_mw8266d_at_poll();
+    CHECK(s_tx_calls == 2 && s_tx_len == 0 && d.calls == 0);
+
+    s_tx_busy = 0;
+    atk_mw8266d_at_poll();
+    CHECK(strcmp(s_tx, "AT+CIPSEND\r\n") == 0);
+    rx_push("\r\nOK\r\n\r\n>");
+    atk_mw8266d_at_poll();
+    CHECK(d.calls == 1 && d.result == ATK_MW8266D_AT_EOK);
+}
+
+/**
+ * @brief  取消: 按顺序以EABORT回调所有未完成指令, 之后可以继续使用
+ */
+static void test_abort(void)
+{
+    done_t d[3];
+    atk_mw8266d_at_stats_t st;
+
+    reset();
+    memset(d, 0, sizeof(d));
+    CHECK(atk_mw8266d_at_submit("AT+CWQAP", "OK", 1000, on_done, &d[0]) == 0);
+    CHECK(atk_mw8266d_at_submit("AT+CWJAP=\"a\",\"b\"", "WIFI GOT IP", 15000, on_done, &d[1]) == 0);
+    CHECK(atk_mw8266d_at_submit("AT+CIFSR", "OK", 1000, on_done, &d[2]) == 0);
+    atk_mw8266d_at_poll();
+    rx_push("partial");
+    atk_mw8266d_at_poll();
+
+    atk_mw8266d_at_abort();
+    CHECK(d[0].calls == 1 && d[1].calls == 1 && d[2].calls == 1);
+    CHECK(d[0].result == ATK_MW8266D_AT_EABORT && d[1].result == ATK_MW8266D_AT_EABORT &&
+          d[2].result == ATK_MW8266D_AT_EABORT);
+    CHECK(d[0].seq == 1 && d[1].seq == 2 && d[2].seq == 3);
+    CHECK(d[0].resp[0] == '\0');                /* 不带部分应答 */
+    CHECK(!atk_mw8266d_at_busy());
+    CHECK(strcmp(s_tx, "AT+CWQAP\r\n") == 0);   /* 后两条没有发出 */
+
+    atk_mw8266d_at_get_stats(&st);
+    CHECK(st.aborted == 3 && st.pending == 0);
+
+    /* 取消后重新提交: 正常发送, 旧帧被丢弃 */
+    memset(d, 0, sizeof(d));
+    rx_push("OK\r\n");
+    CHECK(atk_mw8266d_at_submit("AT", "OK", 1000, on_done, &d[0]) == 0);
+    atk_mw8266d_at_poll();
+    CHECK(d[0].calls == 0);
+    rx_push("OK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d[0].calls == 1 && d[0].result == ATK_MW8266D_AT_EOK);
+
+    /* 空队列取消无回调 */
+    atk_mw8266d_at_abort();
+    CHECK(d[0].calls == 1);
+}
+
+/**
+ * @brief  应答超过缓冲长度时截断, 期望应答在当前帧中仍能匹配
+ */
+static void test_long_resp(void)
+{
+    char frame[RX_FRAME_MAX];
+    done_t d = {0};
+
+    reset();
+    CHECK(atk_mw8266d_at_submit("AT+CWLAP", "OK", 5000, on_done, &d) == 0);
+    atk_mw8266d_at_poll();
+
+    memset(frame, 'x', 200);
+    strcpy(&frame[200], "\r\n");
+    rx_push(frame);
+    rx_push("+CWLAP:(3,\"ap\",-60)\r\nOK\r\n");
+    atk_mw8266d_at_poll();
+    CHECK(d.calls == 1 && d.result == ATK_MW8266D_AT_EOK);
+    CHECK(strlen(d.resp) == ATK_MW8266D_AT_RESP_MAX - 1);
+}
+
+int main(void)
+{
+    /* 未初始化时拒绝 */
+    CHECK(atk_mw8266d_at_submit("AT", "OK", 100, NULL, NULL) == 1);
+
+    test_stale_flush();
+    test_split();
+    test_error();
+    test_timeout();
+    test_full();
+    test_chain();
+    test_send_busy();
+    test_abort();
+    test_long_resp();
+
+    printf("test_at_engine: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+/**
+ ****************************************************************************************************
+ * @file        test_bin_codec.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       bin_codec 主机单元测试
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 覆盖: DAT/STA/BATCH编码后解码还原、超过127的值截断、缓冲区不足、
+ *       任意长度截断返回0、帧头/长度/校验/类型错误返回-1、连续两帧。
+ *       失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "bin_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+#define BATCH_LEN(n)    (BIN_FRAME_OVERHEAD + 1 + (n) * (2 + BIN_DAT_SIZE))
+
+/**
+ * @brief  重新计算校验 (构造长度/类型错误但校验正确的帧)
+ */
+static void fix_sum(uint8_t *frame)
+{
+    uint8_t sum = 0;
+    uint16_t i, end = 2 + frame[1];
+
+    for (i = 1; i < end; i++) sum += frame[i];
+    frame[end] = sum;
+}
+
+/**
+ * @brief  所有比完整帧短的前缀都应返回0 (数据不完整)
+ */
+static void check_truncated(const uint8_t *frame, uint16_t len)
+{
+    bin_frame_t f;
+    uint16_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        CHECK(bin_decode(frame, i, &f) == 0);
+    }
+}
+
+static void test_dat(void)
+{
+    static const bin_dat_t cases[] = {
+        { 0, 0, 0, 0 }, { 25, 60, 45, 80 }, { 127, 127, 127, 127 }, { 1, 126, 64, 99 }
+    };
+    uint8_t buf[32];
+    bin_frame_t f;
+    uint16_t len;
+    unsigned i;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        len = bin_encode_dat(buf, sizeof(buf), (uint16_t)(0xBEEF + i), &cases[i]);
+        CHECK(len == BIN_FRAME_OVERHEAD + BIN_DAT_SIZE);
+        CHECK(buf[0] == BIN_MAGIC && buf[2] == BIN_TYPE_DAT);
+        CHECK(bin_decode(buf, len, &f) == len);
+        CHECK(f.type == BIN_TYPE_DAT && f.seq == (uint16_t)(0xBEEF + i) && f.count == 1);
+        CHECK(memcmp(&f.dat[0], &cases[i], sizeof(bin_dat_t)) == 0);
+        check_truncated(buf, len);
+    }
+
+    CHECK(bin_encode_dat(buf, BIN_FRAME_OVERHEAD + BIN_DAT_SIZE - 1, 0, &cases[1]) == 0);
+}
+
+static void test_dat_clip(void)
+{
+    static const bin_dat_t in = { 128, 200, 255, 127 };
+    static const bin_dat_t mix = { 0, 255, 0, 3 };
+    uint8_t buf[32];
+    bin_frame_t f;
+    uint16_t len;
+
+    len = bin_encode_dat(buf, sizeof(buf), 1, &in);
+    CHECK(bin_decode(buf, len, &f) == len);
+    CHECK(f.dat[0].temp == 127 && f.dat[0].humi == 127 && f.dat[0].soil == 127 && f.dat[0].light == 127);
+
+    /* 截断只影响自己的字段, 不溢出到相邻字段 */
+    len = bin_encode_dat(buf, sizeof(buf), 2, &mix);
+    CHECK(bin_decode(buf, len, &f) == len);
+    CHECK(f.dat[0].temp == 0 && f.dat[0].humi == 127 && f.dat[0].soil == 0 && f.dat[0].light == 3);
+}
+
+static void test_sta(void)
+{
+    uint8_t buf[16];
+    bin_sta_t sta;
+    bin_frame_t f;
+    uint16_t len;
+    unsigned bits;
+
+    for (bits = 0; bits < 16; bits++)
+    {
+        /* 非0即1 */
+        sta.mode  = (bits & 1) ? 1 : 0;
+        sta.light = (bits & 2) ? 5 : 0;
+        sta.water = (bits & 4) ? 1 : 0;
+        sta.fan   = (bits & 8) ? 0xFF : 0;
+        len = bin_encode_sta(buf, sizeof(buf), (uint16_t)bits, &sta);
+        CHECK(len == BIN_FRAME_OVERHEAD + BIN_STA_SIZE);
+        CHECK(bin_decode(buf, len, &f) == len);
+        CHECK(f.type == BIN_TYPE_STA && f.seq == bits && f.count == 0);
+        CHECK(f.sta.mode == ((bits >> 0) & 1) && f.sta.light == ((bits >> 1) & 1) &&
+              f.sta.water == ((bits >> 2) & 1) && f.sta.fan == ((bits >> 3) & 1));
+        check_truncated(buf, len);
+    }
+
+    CHECK(bin_encode_sta(buf, BIN_FRAME_OVERHEAD + BIN_STA_SIZE - 1, 0, &sta) == 0);
+}
+
+static void test_batch(void)
+{
+    bin_dat_t dat[BIN_MAX_SAMPLES + 1];
+    uint16_t off[BIN_MAX_SAMPLES + 1];
+    uint8_t buf[BATCH_LEN(BIN_MAX_SAMPLES + 1)];
+    bin_frame_t f;
+    uint16_t len;
+    uint8_t n, i, ok;
+
+    for (i = 0; i <= BIN_MAX_SAMPLES; i++)
+    {
+        dat[i].temp = (uint8_t)(20 + i);
+        dat[i].humi = (uint8_t)(50 + i);
+        dat[i].soil = (uint8_t)(i * 8);
+        dat[i].light = (uint8_t)(120 + i);     /* 部分超过127 */
+        off[i] = (i == BIN_MAX_SAMPLES - 1) ? 0xFFFF : (uint16_t)(i * 500);
+    }
+
+    for (n = 1; n <= BIN_MAX_SAMPLES; n++)
+    {
+        len = bin_encode_dat_batch(buf, sizeof(buf), 0x1234, dat, off, n);
+        CHECK(len == BATCH_LEN(n));
+        CHECK(bin_decode(buf, len, &f) == len);
+        CHECK(f.type == BIN_TYPE_DAT_BATCH && f.seq == 0x1234 && f.count == n);
+
+        ok = 1;
+        for (i = 0; i < n && i < f.count; i++)
+        {
+            if (f.offset_10ms[i] != off[i] || f.dat[i].temp != dat[i].temp || f.dat[i].humi != dat[i].humi ||
+                f.dat[i].soil != dat[i].soil || f.dat[i].light != (dat[i].light > 127 ? 127 : dat[i].light))
+            {
+                ok = 0;
+            }
+        }
+        CHECK(ok);
+        check_truncated(buf, len);
+
+        CHECK(bin_encode_dat_batch(buf, (uint16_t)(BATCH_LEN(n) - 1), 0, dat, off, n) == 0);
+    }
+
+    CHECK(bin_encode_dat_batch(buf, sizeof(buf), 0, dat, off, 0) == 0);
+    CHECK(bin_encode_dat_batch(buf, sizeof(buf), 0, dat, off, BIN_MAX_SAMPLES + 1) == 0);
+}
+
+static void test_corrupt(void)
+{
+    static const bin_dat_t d = { 25, 60, 45, 80 };
+    uint8_t good[BATCH_LEN(2)], buf[BATCH_LEN(2)];
+    bin_dat_t dat[2] = { { 25, 60, 45, 80 }, { 26, 61, 44, 79 } };
+    uint16_t off[2] = { 0, 500 };
+    bin_frame_t f;
+    uint16_t len, i;
+
+    len = bin_encode_dat(good, sizeof(good), 7, &d);
+
+    /* 帧头 */
+    memcpy(buf, good, len);
+    buf[0] = '{';
+    CHECK(bin_decode(buf, len, &f) == -1);
+    CHECK(bin_decode(buf, 1, &f) == 0);            /* 不足2字节时还无法判断 */
+
+    /* 长度字段小于 type+seq */
+    memcpy(buf, good, len);
+    buf[1] = 2;
+    CHECK(bin_decode(buf, len, &f) == -1);
+
+    /* 校验: 任意一个字节出错 (不含长度字段, 改长度可能只是数据不完整) */
+    for (i = 2; i < len; i++)
+    {
+        memcpy(buf, good, len);
+        buf[i] ^= 0x10;
+        CHECK(bin_decode(buf, len, &f) == -1);
+    }
+
+    /* 校验正确但长度与类型不符 */
+    memcpy(buf, good, len);
+    buf[1] = 3 + BIN_DAT_SIZE - 1;
+    fix_sum(buf);
+    CHECK(bin_decode(buf, len, &f) == -1);
+
+    memcpy(buf, good, len);
+    buf[2] = BIN_TYPE_STA;
+    fix_sum(buf);
+    CHECK(bin_decode(buf, len, &f) == -1);
+
+    /* 未知类型 */
+    memcpy(buf, good, len);
+    buf[2] = 0x7E;
+    fix_sum(buf);
+    CHECK(bin_decode(buf, len, &f) == -1);
+
+    /* 批量帧: 样本数与长度不符, 样本数为0 */
+    len = bin_encode_dat_batch(good, sizeof(good), 8, dat, off, 2);
+    memcpy(buf, good, len);
+    buf[BIN_HEAD_SIZE] = 1;
+    fix_sum(buf);
+    CHECK(bin_decode(buf, len, &f) == -1);
+    buf[BIN_HEAD_SIZE] = 0;
+    fix_sum(buf);
+    CHECK(bin_decode(buf, len, &f) == -1);
+}
+
+/**
+ * @brief  连续两帧: 按返回的消耗字节数逐帧解码
+ */
+static void test_stream(void)
+{
+    static const bin_dat_t d = { 25, 60, 45, 80 };
+    static const bin_sta_t s = { 1, 0, 1, 0 };
+    uint8_t buf[32];
+    bin_frame_t f;
+    uint16_t a, b;
+
+    a = bin_encode_dat(buf, sizeof(buf), 1, &d);
+    b = bin_encode_sta(buf + a, (uint16_t)(sizeof(buf) - a), 2, &s);
+    CHECK(bin_decode(buf, (uint16_t)(a + b), &f) == a && f.type == BIN_TYPE_DAT && f.seq == 1);
+    CHECK(bin_decode(buf + a, b, &f) == b && f.type == BIN_TYPE_STA && f.seq == 2 && f.sta.water == 1);
+}
+
+int main(void)
+{
+    test_dat();
+    test_dat_clip();
+    test_sta();
+    test_batch();
+    test_corrupt();
+    test_stream();
+
+    printf("test_bin_codec: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
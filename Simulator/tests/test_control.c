@@ -0,0 +1,347 @@
+/**
+ ****************************************************************************************************
+ * @file        test_control.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       control 引擎主机单元测试
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 合成的温度序列 (6小时, 200ms周期, 缓慢来回穿越阈值并叠加±1噪声, 固定种子) 驱动风扇规则,
+ * 比较无回差、1℃回差、1℃回差加30s最短开/关时间的切换次数, 并在执行器回调中检查每次切换
+ * 都满足最短开/关时间。另外覆盖: 手动模式不驱动执行器、外部切换被采纳并重新计时、
+ * 修改阈值下一周期生效、CTRL_VALUE_INVALID 跳过规则和告警区间。失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "control.h"
+#include <stdio.h>
+#include <string.h>
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+#define STEP_MS         200
+#define TRACE_MS        (6UL * 3600 * 1000)
+#define CYCLE_MS        (40UL * 60 * 1000)  /* 温度来回一次 */
+
+#define SENSOR_TEMP     0
+#define SENSOR_SOIL     1
+
+#define ACT_FAN         0
+#define ACT_PUMP        1
+
+/******************************************************************************************/
+/* 执行器和配置 */
+
+static uint32_t s_now;
+static uint8_t s_fan, s_pump;
+static uint8_t s_temp_upper = 30, s_temp_lower = 10;
+static uint8_t s_soil_lower = 40;
+
+static uint32_t s_sets;                 /* 执行器回调次数 */
+static uint32_t s_violations;           /* 违反最短开/关时间的切换次数 */
+static uint32_t s_fan_since;            /* 风扇上次切换时间 (按回调记录) */
+static uint8_t  s_fan_seen;             /* 回调记录的风扇状态 */
+static uint32_t s_events;               /* 执行器事件数 */
+
+static ctrl_rule_t s_rules[2];
+static const ctrl_band_t s_bands[2] = {
+    { &s_temp_upper, &s_temp_lower, 1 },
+    { NULL, &s_soil_lower, 3 },
+};
+
+static void fan_set(uint8_t on)
+{
+    const ctrl_rule_t *r = &s_rules[0];
+    uint32_t hold = s_fan_seen ? r->min_on_ms : r->min_off_ms;
+
+    s_sets++;
+    if (on != s_fan_seen && s_now - s_fan_since < hold) s_violations++;
+    s_fan_seen = on;
+    s_fan_since = s_now;
+}
+
+static void pump_set(uint8_t on)
+{
+    (void)on;
+    s_sets++;
+}
+
+static const ctrl_actuator_t s_acts[2] = {
+    { fan_set, &s_fan },
+    { pump_set, &s_pump },
+};
+
+static void on_event(const ctrl_event_t *evt)
+{
+    if (evt->type == CTRL_EVT_ACTUATOR) s_events++;
+}
+
+/**
+ * @brief  按给定的回差和最短时间重新初始化 (风扇: 温度高于上限开启; 水泵: 土壤低于下限开启)
+ */
+static void setup(uint8_t hyst, uint32_t min_ms)
+{
+    static const ctrl_config_t cfg = { s_rules, 2, s_acts, 2, s_bands, 2 };
+
+    s_rules[0] = (ctrl_rule_t){ SENSOR_TEMP, CTRL_CMP_ABOVE, &s_temp_upper, hyst, min_ms, min_ms, ACT_FAN };
+    s_rules[1] = (ctrl_rule_t){ SENSOR_SOIL, CTRL_CMP_BELOW, &s_soil_lower, 3, 0, 0, ACT_PUMP };
+    s_now = 0;
+    s_fan = s_pump = 0;
+    s_temp_upper = 30;
+    s_temp_lower = 10;
+    s_soil_lower = 40;
+    s_sets = s_violations = s_events = 0;
+    s_fan_since = 0;
+    s_fan_seen = 0;
+
+    CHECK(ctrl_init(&cfg, 0) == 0);
+    CHECK(ctrl_subscribe(on_event) == 0);
+}
+
+static void step(uint8_t temp, uint8_t soil, uint8_t auto_mode)
+{
+    uint8_t v[2];
+
+    v[SENSOR_TEMP] = temp;
+    v[SENSOR_SOIL] = soil;
+    ctrl_step(v, auto_mode, s_now);
+}
+
+/******************************************************************************************/
+/* 合成温度序列 */
+
+static uint32_t s_seed;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 16;
+}
+
+/**
+ * @brief  时刻t的温度: 28~32℃三角波 (40分钟一个来回) 叠加 -1/0/+1 噪声
+ */
+static uint8_t trace_temp(uint32_t t)
+{
+    uint32_t phase = t % CYCLE_MS;
+    uint32_t half = CYCLE_MS / 2;
+    uint32_t tri = (phase < half) ? phase : CYCLE_MS - phase;       /* 0..half */
+    int base = 28 + (int)((tri * 4 + half / 2) / half);              /* 28..32 */
+
+    return (uint8_t)(base + (int)(rnd() % 3) - 1);
+}
+
+/**
+ * @brief  自动模式运行整段序列
+ * @retval 风扇切换次数
+ */
+static uint32_t run_trace(uint8_t hyst, uint32_t min_ms, uint8_t auto_mode)
+{
+    ctrl_stats_t st;
+
+    setup(hyst, min_ms);
+    s_seed = 12345;
+    for (s_now = 0; s_now < TRACE_MS; s_now += STEP_MS)
+    {
+        step(trace_temp(s_now), 60, auto_mode);
+    }
+    ctrl_get_stats(&st);
+    CHECK(st.steps == TRACE_MS / STEP_MS);
+    CHECK(st.switches == s_sets && s_events == s_sets);
+    return st.switches;
+}
+
+/******************************************************************************************/
+/* 测试 */
+
+/**
+ * @brief  切换次数: 回差和最短时间逐级减少抖动, 且任何切换都不违反最短开/关时间
+ */
+static void test_chatter(void)
+{
+    uint32_t cycles = TRACE_MS / CYCLE_MS;
+    uint32_t none, hyst, full;
+
+    none = run_trace(0, 0, 1);
+    CHECK(s_violations == 0);
+    hyst = run_trace(1, 0, 1);
+    CHECK(s_violations == 0);
+    full = run_trace(1, 30000, 1);
+    CHECK(s_violations == 0);
+
+    printf("fan switches over %lu h: no hysteresis %lu, 1 degC %lu, 1 degC + 30 s %lu\n",
+           TRACE_MS / 3600000UL, (unsigned long)none, (unsigned long)hyst, (unsigned long)full);
+
+    CHECK(none > 2 * hyst);
+    CHECK(hyst > 10 * full);
+    CHECK(full >= 2 * cycles);                  /* 每个来回至少开关一次 */
+    CHECK(full <= TRACE_MS / 30000);            /* 最短时间限制了最高切换频率 */
+}
+
+/**
+ * @brief  手动模式: 不驱动执行器, 不切换
+ */
+static void test_manual(void)
+{
+    CHECK(run_trace(1, 0, 0) == 0);
+    CHECK(s_sets == 0 && s_fan == 0);
+
+    setup(0, 0);
+    s_now = 1000;
+    step(40, 10, 0);
+    CHECK(s_sets == 0 && s_fan == 0 && s_pump == 0);
+}
+
+/**
+ * @brief  外部切换 (手动/远程): 以实际状态为准, 并从切换时刻重新计算最短时间
+ */
+static void test_external(void)
+{
+    ctrl_stats_t st;
+
+    setup(1, 30000);
+    s_now = 100000;
+
+    /* 温度正常时外部开风扇: 开启后30s内保持, 之后自动关闭 */
+    s_fan = 1;
+    step(25, 60, 1);
+    CHECK(s_sets == 0 && s_fan == 1);
+    s_now += 29800;
+    step(25, 60, 1);
+    CHECK(s_sets == 0 && s_fan == 1);
+    ctrl_get_stats(&st);
+    CHECK(st.held == 2);                        /* 采纳外部状态的那个周期也计一次 */
+    s_now += 200;
+    step(25, 60, 1);
+    CHECK(s_sets == 1 && s_fan == 0);
+
+    /* 温度过高时外部关风扇: 关闭后30s内保持, 之后自动开启 */
+    s_now += 60000;
+    step(35, 60, 1);
+    CHECK(s_fan == 1);
+    s_now += 60000;
+    s_fan = 0;
+    step(35, 60, 1);
+    CHECK(s_fan == 0);
+    s_now += 29800;
+    step(35, 60, 1);
+    CHECK(s_fan == 0);
+    s_now += 200;
+    step(35, 60, 1);
+    CHECK(s_fan == 1);
+
+    /* 手动模式下的切换同样被采纳: 切回自动后按新状态计时 */
+    s_now += 60000;
+    s_fan = 0;
+    step(35, 60, 0);
+    s_now += 1000;
+    step(35, 60, 1);
+    CHECK(s_fan == 0);
+    s_now += 29000;
+    step(35, 60, 1);
+    CHECK(s_fan == 1);
+}
+
+/**
+ * @brief  修改阈值: 下一个控制周期生效
+ */
+static void test_threshold(void)
+{
+    setup(2, 0);
+    s_now = 1000;
+
+    step(28, 60, 1);
+    CHECK(s_fan == 0);
+    s_temp_upper = 27;
+    s_now += STEP_MS;
+    step(28, 60, 1);
+    CHECK(s_fan == 1);
+
+    /* 回差按新阈值计算: 27-2=25 及以下关闭 */
+    s_now += STEP_MS;
+    step(26, 60, 1);
+    CHECK(s_fan == 1);
+    s_temp_upper = 35;
+    s_now += STEP_MS;
+    step(26, 60, 1);
+    CHECK(s_fan == 0);
+
+    /* 下限 (水泵, BELOW) */
+    s_now += STEP_MS;
+    step(26, 38, 1);
+    CHECK(s_pump == 1);
+    s_soil_lower = 30;
+    s_now += STEP_MS;
+    step(26, 38, 1);
+    CHECK(s_pump == 0);
+}
+
+/**
+ * @brief  CTRL_VALUE_INVALID: 依赖它的规则保持执行器状态, 告警等级不变, 其他传感器照常
+ */
+static void test_invalid(void)
+{
+    ctrl_stats_t st;
+
+    setup(1, 0);
+    s_now = 1000;
+
+    step(35, 60, 1);
+    CHECK(s_fan == 1);
+    CHECK(ctrl_get_level(SENSOR_TEMP) == CTRL_LEVEL_HIGH);
+
+    /* 0xFF 按数值会被当成高于阈值, 必须被跳过 */
+    s_now += STEP_MS;
+    step(CTRL_VALUE_INVALID, 60, 1);
+    CHECK(s_fan == 1 && ctrl_get_level(SENSOR_TEMP) == CTRL_LEVEL_HIGH);
+
+    s_now += STEP_MS;
+    step(20, 60, 1);
+    CHECK(s_fan == 0 && ctrl_get_level(SENSOR_TEMP) == CTRL_LEVEL_NORMAL);
+
+    s_now += STEP_MS;
+    step(CTRL_VALUE_INVALID, 60, 1);
+    CHECK(s_fan == 0 && ctrl_get_level(SENSOR_TEMP) == CTRL_LEVEL_NORMAL);
+
+    /* 温度无效时土壤规则和区间照常 */
+    s_now += STEP_MS;
+    step(CTRL_VALUE_INVALID, 30, 1);
+    CHECK(s_pump == 1 && ctrl_get_level(SENSOR_SOIL) == CTRL_LEVEL_LOW);
+    s_now += STEP_MS;
+    step(CTRL_VALUE_INVALID, CTRL_VALUE_INVALID, 1);
+    CHECK(s_pump == 1 && ctrl_get_level(SENSOR_SOIL) == CTRL_LEVEL_LOW);
+
+    /* 告警区间回差: 低于下限后升到 下限+3 才恢复 */
+    s_now += STEP_MS;
+    step(20, 42, 1);
+    CHECK(ctrl_get_level(SENSOR_SOIL) == CTRL_LEVEL_LOW);
+    s_now += STEP_MS;
+    step(20, 43, 1);
+    CHECK(ctrl_get_level(SENSOR_SOIL) == CTRL_LEVEL_NORMAL);
+
+    ctrl_get_stats(&st);
+    CHECK(st.switches == 4 && st.level_changes == 4);
+}
+
+int main(void)
+{
+    test_chatter();
+    test_manual();
+    test_external();
+    test_threshold();
+    test_invalid();
+
+    printf("test_control: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
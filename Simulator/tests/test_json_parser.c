@@ -0,0 +1,236 @@
+/**
+ ****************************************************************************************************
+ * @file        test_json_parser.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       json_parser 主机单元测试
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 覆盖: 任意位置截断后续传、一个缓冲区内两条报文、嵌套层级不同的同名键、转义引号、
+ *       token数组不足, 以及路径查询和类型读取。失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "json_parser.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_TOKENS  48
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+static const char s_ctl[] =
+    "{\"v\":\"2.0\",\"id\":\"1718\",\"ts\":1760000012345,\"t\":\"ctl\",\"p\":{\"k\":\"water\",\"s\":1}}";
+
+static const char s_cfg[] =
+    "{\"v\":\"2.0\",\"id\":\"42\",\"t\":\"cfg\",\"p\":{\"temp_upper\":35,\"temp_lower\":10,"
+    "\"humi_upper\":80,\"humi_lower\":30,\"soil_upper\":70,\"soil_lower\":20,"
+    "\"light_upper\":90,\"light_lower\":15,\"note\":\"a, \\\"b\\\" {c}\"}}";
+
+/**
+ * @brief  一次解析整条报文
+ */
+static int parse_all(const char *js, uint16_t len, json_tok_t *tokens, uint16_t num_tokens)
+{
+    json_parser_t p;
+
+    json_init(&p);
+    return json_parse(&p, js, len, tokens, num_tokens);
+}
+
+/**
+ * @brief  路径查询与类型读取
+ */
+static void test_lookup(void)
+{
+    json_tok_t tok[MAX_TOKENS];
+    int n, obj, key, keys;
+    int32_t v;
+    uint64_t ts;
+    char s[16];
+
+    n = parse_all(s_ctl, sizeof(s_ctl) - 1, tok, MAX_TOKENS);
+    CHECK(n > 0);
+    CHECK(json_get_string(s_ctl, tok, n, "t", s, sizeof(s)) == 0 && strcmp(s, "ctl") == 0);
+    CHECK(json_get_string(s_ctl, tok, n, "p.k", s, sizeof(s)) == 0 && strcmp(s, "water") == 0);
+    CHECK(json_get_int(s_ctl, tok, n, "p.s", &v) == 0 && v == 1);
+    CHECK(json_get_u64(s_ctl, tok, n, "ts", &ts) == 0 && ts == 1760000012345ULL);
+    CHECK(json_get_int(s_ctl, tok, n, "p.k", &v) != 0);        /* 类型不符 */
+    CHECK(json_get_string(s_ctl, tok, n, "p.x", s, sizeof(s)) != 0);
+    CHECK(json_get_string(s_ctl, tok, n, "t", s, 3) == 0 && strcmp(s, "ct") == 0);   /* 截断 */
+
+    n = parse_all(s_cfg, sizeof(s_cfg) - 1, tok, MAX_TOKENS);
+    CHECK(n > 0);
+    CHECK(json_get_int(s_cfg, tok, n, "p.light_lower", &v) == 0 && v == 15);
+    keys = 0;
+    obj = json_find(s_cfg, tok, n, "p");
+    for (key = json_obj_next(tok, n, obj, -1); key >= 0; key = json_obj_next(tok, n, obj, key))
+    {
+        keys++;
+    }
+    CHECK(keys == 9);
+}
+
+/**
+ * @brief  在每一个位置截断后续传, 结果必须与一次解析完全相同
+ */
+static void test_partial_resume(void)
+{
+    static const char *const msgs[] = { s_ctl, s_cfg };
+    json_tok_t whole[MAX_TOKENS], split[MAX_TOKENS];
+    json_parser_t p;
+    uint16_t len, cut;
+    int32_t v;
+    int n, r;
+    unsigned m;
+
+    for (m = 0; m < sizeof(msgs) / sizeof(msgs[0]); m++)
+    {
+        len = (uint16_t)strlen(msgs[m]);
+        n = parse_all(msgs[m], len, whole, MAX_TOKENS);
+        CHECK(n > 0);
+
+        for (cut = 1; cut < len; cut++)
+        {
+            json_init(&p);
+            r = json_parse(&p, msgs[m], cut, split, MAX_TOKENS);
+            if (r != JSON_ERROR_PART)
+            {
+                printf("cut %u of msg %u: %d\n", cut, m, r);
+                CHECK(r == JSON_ERROR_PART);
+                continue;
+            }
+            CHECK(p.pos <= cut);
+            r = json_parse(&p, msgs[m], len, split, MAX_TOKENS);
+            CHECK(r == n);
+            CHECK(p.pos == len);
+            if (r == n) CHECK(memcmp(whole, split, sizeof(json_tok_t) * (size_t)n) == 0);
+        }
+    }
+
+    /* 分三段: 字符串中间和数字中间各断一次 */
+    json_init(&p);
+    CHECK(json_parse(&p, s_ctl, 30, split, MAX_TOKENS) == JSON_ERROR_PART);
+    CHECK(json_parse(&p, s_ctl, 68, split, MAX_TOKENS) == JSON_ERROR_PART);
+    n = json_parse(&p, s_ctl, sizeof(s_ctl) - 1, split, MAX_TOKENS);
+    CHECK(n > 0 && json_get_int(s_ctl, split, n, "p.s", &v) == 0 && v == 1);
+}
+
+/**
+ * @brief  一个缓冲区内两条报文: 解析在第一个根对象闭合处停止
+ */
+static void test_two_objects(void)
+{
+    static const char buf[] = "{\"t\":\"hb_ok\",\"ts\":5}{\"t\":\"ctl\",\"p\":{\"k\":\"fan\",\"s\":0}}";
+    const uint16_t first = (uint16_t)strlen("{\"t\":\"hb_ok\",\"ts\":5}");
+    json_tok_t tok[MAX_TOKENS];
+    json_parser_t p;
+    char s[8];
+    int n;
+
+    json_init(&p);
+    n = json_parse(&p, buf, sizeof(buf) - 1, tok, MAX_TOKENS);
+    CHECK(n == 5);
+    CHECK(p.pos == first);
+    CHECK(json_get_string(buf, tok, n, "t", s, sizeof(s)) == 0 && strcmp(s, "hb_ok") == 0);
+    CHECK(json_find(buf, tok, n, "p") < 0);
+
+    /* 剩余部分作为新报文解析 */
+    json_init(&p);
+    n = json_parse(&p, buf + first, (uint16_t)(sizeof(buf) - 1 - first), tok, MAX_TOKENS);
+    CHECK(n > 0 && p.pos == sizeof(buf) - 1 - first);
+    CHECK(json_get_string(buf + first, tok, n, "p.k", s, sizeof(s)) == 0 && strcmp(s, "fan") == 0);
+}
+
+/**
+ * @brief  同名键在不同层级: 按路径只匹配指定层级, 值为字符串的同名内容不匹配
+ */
+static void test_nesting(void)
+{
+    static const char js[] =
+        "{\"t\":\"ctl\",\"x\":{\"s\":7,\"k\":\"light\"},\"p\":{\"m\":{\"s\":9},\"k\":\"fan\",\"s\":0},"
+        "\"s\":\"\\\"s\\\":5\"}";
+    json_tok_t tok[MAX_TOKENS];
+    int32_t v;
+    char s[8];
+    int n;
+
+    n = parse_all(js, sizeof(js) - 1, tok, MAX_TOKENS);
+    CHECK(n > 0);
+    CHECK(json_get_int(js, tok, n, "p.s", &v) == 0 && v == 0);
+    CHECK(json_get_int(js, tok, n, "p.m.s", &v) == 0 && v == 9);
+    CHECK(json_get_int(js, tok, n, "x.s", &v) == 0 && v == 7);
+    CHECK(json_get_string(js, tok, n, "p.k", s, sizeof(s)) == 0 && strcmp(s, "fan") == 0);
+    CHECK(json_get_int(js, tok, n, "s", &v) != 0);             /* 根的"s"是字符串 */
+    CHECK(json_get_string(js, tok, n, "k", s, sizeof(s)) != 0); /* 根没有"k" */
+}
+
+/**
+ * @brief  转义引号不结束字符串, 内容按原文拷贝
+ */
+static void test_escapes(void)
+{
+    static const char js[] = "{\"a\":\"x\\\"}y\\\\\",\"b\":\"\\u00e9\",\"c\":1}";
+    static const char bad[] = "{\"a\":\"x\\q\"}";
+    json_tok_t tok[MAX_TOKENS];
+    int32_t v;
+    char s[16];
+    int n;
+
+    n = parse_all(js, sizeof(js) - 1, tok, MAX_TOKENS);
+    CHECK(n == 7);
+    CHECK(json_get_string(js, tok, n, "a", s, sizeof(s)) == 0 && strcmp(s, "x\\\"}y\\\\") == 0);
+    CHECK(json_get_string(js, tok, n, "b", s, sizeof(s)) == 0 && strcmp(s, "\\u00e9") == 0);
+    CHECK(json_get_int(js, tok, n, "c", &v) == 0 && v == 1);
+
+    CHECK(parse_all(bad, sizeof(bad) - 1, tok, MAX_TOKENS) == JSON_ERROR_INVAL);
+}
+
+/**
+ * @brief  token数组不足, 以及其他非法输入
+ */
+static void test_errors(void)
+{
+    json_tok_t tok[MAX_TOKENS];
+    int n, need;
+    uint16_t i;
+
+    need = parse_all(s_cfg, sizeof(s_cfg) - 1, tok, MAX_TOKENS);
+    CHECK(need > 0);
+    for (i = 0; i < (uint16_t)need; i++)
+    {
+        CHECK(parse_all(s_cfg, sizeof(s_cfg) - 1, tok, i) == JSON_ERROR_NOMEM);
+    }
+    n = parse_all(s_cfg, sizeof(s_cfg) - 1, tok, (uint16_t)need);
+    CHECK(n == need);
+
+    CHECK(parse_all("{\"a\":1]", 7, tok, MAX_TOKENS) == JSON_ERROR_INVAL);
+    CHECK(parse_all("}", 1, tok, MAX_TOKENS) == JSON_ERROR_INVAL);
+    CHECK(parse_all("{1:2}", 5, tok, MAX_TOKENS) == JSON_ERROR_INVAL);
+    CHECK(parse_all("{\"a\":{}", 7, tok, MAX_TOKENS) == JSON_ERROR_PART);
+    CHECK(parse_all("", 0, tok, MAX_TOKENS) == JSON_ERROR_PART);
+}
+
+int main(void)
+{
+    test_lookup();
+    test_partial_resume();
+    test_two_objects();
+    test_nesting();
+    test_escapes();
+    test_errors();
+
+    printf("test_json_parser: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
@@ -0,0 +1,381 @@
+/**
+ ****************************************************************************************************
+ * @file        test_scheduler.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       scheduler 主机单元测试 (伪时钟)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 伪时钟只在任务函数中按设定的运行时间前进, 或由测试直接推进, 调度结果完全确定。
+ * 覆盖: 周期释放时刻、优先级与同优先级按释放先后、截止时间错过、严重超时跳过释放、
+ *       sched_post 事件释放、32位微秒时钟回绕。失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+/******************************************************************************************/
+/* 伪时钟和任务 */
+
+static uint32_t s_now;                      /* 伪时钟 (us) */
+static uint32_t s_cost[4];                  /* 各任务每次运行消耗的时间 (us) */
+static uint32_t s_start[4];                 /* 各任务最近一次开始时刻 */
+static uint32_t s_runs[4];                  /* 各任务运行次数 */
+static char s_order[64];                    /* 执行顺序 ('A'+任务序号) */
+static uint8_t s_order_len;
+static int8_t s_post_self = -1;             /* 任务A运行时事件释放的任务ID */
+
+static uint32_t fake_clock(void)
+{
+    return s_now;
+}
+
+static void run_task(uint8_t i)
+{
+    s_start[i] = s_now;
+    s_runs[i]++;
+    if (s_order_len < sizeof(s_order) - 1) s_order[s_order_len++] = (char)('A' + i);
+    s_now += s_cost[i];
+}
+
+static void task_a(void) { run_task(0); if (s_post_self >= 0) { sched_post(s_post_self); s_post_self = -1; } }
+static void task_b(void) { run_task(1); }
+static void task_c(void) { run_task(2); }
+static void task_d(void) { run_task(3); }
+
+/**
+ * @brief  以指定起始时刻重新初始化
+ */
+static void reset(uint32_t start)
+{
+    s_now = start;
+    memset(s_cost, 0, sizeof(s_cost));
+    memset(s_start, 0, sizeof(s_start));
+    memset(s_runs, 0, sizeof(s_runs));
+    memset(s_order, 0, sizeof(s_order));
+    s_order_len = 0;
+    s_post_self = -1;
+    sched_init(fake_clock);
+}
+
+/**
+ * @brief  执行所有就绪任务
+ * @retval 执行的任务数
+ */
+static int run_ready(void)
+{
+    int n = 0;
+
+    while (sched_run_once()) n++;
+    return n;
+}
+
+/**
+ * @brief  按调度器给出的等待时间推进伪时钟, 直到 end (不含), 期间执行所有任务
+ */
+static void run_until(uint32_t end)
+{
+    uint32_t wait;
+
+    while ((int32_t)(s_now - end) < 0)
+    {
+        run_ready();
+        wait = sched_time_to_next_us();
+        if ((int32_t)(end - s_now) < (int32_t)wait) wait = end - s_now;
+        s_now += wait;
+    }
+}
+
+/******************************************************************************************/
+/* 测试 */
+
+/**
+ * @brief  周期释放: 添加时立即释放, 之后每个周期一次, 不累积漂移
+ */
+static void test_release(void)
+{
+    uint32_t last = 0, worst = 0;
+    int i;
+
+    reset(1000);
+    CHECK(sched_add_task("a", task_a, 10, 0, 1) == 0);
+    s_cost[0] = 300;
+
+    CHECK(sched_time_to_next_us() == 0);
+    CHECK(run_ready() == 1 && s_start[0] == 1000);
+    CHECK(s_now == 1300);
+    CHECK(sched_time_to_next_us() == 11000 - 1300);
+
+    s_now = 10999;
+    CHECK(run_ready() == 0);
+    s_now = 11000;
+    CHECK(run_ready() == 1 && s_start[0] == 11000);
+
+    /* 每次晚到300us执行, 下次释放仍按周期对齐 */
+    for (i = 0; i < 10; i++)
+    {
+        s_now += sched_time_to_next_us() + 300;
+        last = s_start[0];
+        CHECK(run_ready() == 1);
+        if (i > 0 && s_start[0] - last > worst) worst = s_start[0] - last;
+    }
+    CHECK(s_runs[0] == 12);
+    CHECK(s_start[0] == 1000 + 11 * 10000 + 300);
+    CHECK(worst == 10000);
+    CHECK(sched_get_task(0)->max_latency_us == 300);
+    CHECK(sched_get_task(0)->deadline_miss == 0 && sched_get_task(0)->skipped == 0);
+
+    /* 禁用后不再释放, 启用时立即释放 */
+    sched_set_enabled(0, 0);
+    s_now += 50000;
+    CHECK(run_ready() == 0);
+    sched_set_enabled(0, 1);
+    CHECK(run_ready() == 1 && s_start[0] == s_now - 300);
+}
+
+/**
+ * @brief  优先级: 同时就绪按优先级; 同优先级按释放时刻先后, 与添加顺序无关
+ */
+static void test_priority(void)
+{
+    reset(0);
+    sched_add_task("a", task_a, 100, 0, 3);
+    sched_add_task("b", task_b, 100, 0, 1);
+    sched_add_task("c", task_c, 100, 0, 2);
+    sched_add_task("d", task_d, 100, 0, 1);
+    CHECK(run_ready() == 4);
+    CHECK(strcmp(s_order, "BDCA") == 0);
+
+    /* 同优先级: C的周期释放晚于A, 先释放的A先执行 */
+    reset(0);
+    sched_add_task("a", task_a, 10, 0, 2);
+    s_now = 2000;
+    sched_add_task("b", task_b, 10, 0, 2);      /* 释放时刻 2000 */
+    s_now = 1000;
+    sched_add_task("c", task_c, 10, 0, 2);      /* 释放时刻 1000 */
+    s_now = 3000;
+    CHECK(run_ready() == 3);
+    CHECK(strcmp(s_order, "ACB") == 0);
+
+    /* 同优先级: 事件释放时刻早于另一任务的周期释放时刻 */
+    reset(0);
+    sched_add_task("a", task_a, 10, 0, 2);
+    sched_add_task("b", task_b, 1000, 0, 2);
+    run_ready();
+    s_order_len = 0;
+    memset(s_order, 0, sizeof(s_order));
+    s_now = 9000;
+    sched_post(1);                              /* B: 9000, A: 10000 */
+    s_now = 10500;
+    CHECK(run_ready() == 2);
+    CHECK(strcmp(s_order, "BA") == 0);
+
+    /* 高优先级任务总是先于已等待更久的低优先级任务 */
+    reset(0);
+    sched_add_task("a", task_a, 10, 0, 5);
+    sched_add_task("b", task_b, 2, 0, 0);
+    run_ready();
+    s_order_len = 0;
+    memset(s_order, 0, sizeof(s_order));
+    s_now = 10000;                              /* A释放于10000, B释放于2000且一直未执行 */
+    CHECK(run_ready() == 2);
+    CHECK(strcmp(s_order, "BA") == 0);
+}
+
+/**
+ * @brief  截止时间: 从释放到完成超过截止时间计一次错过 (运行过长或被阻塞)
+ */
+static void test_deadline(void)
+{
+    const sched_task_t *a, *b;
+
+    reset(0);
+    sched_add_task("a", task_a, 10, 2, 0);      /* 截止2ms */
+    sched_add_task("b", task_b, 10, 0, 1);      /* 截止=周期 */
+    a = sched_get_task(0);
+    b = sched_get_task(1);
+
+    s_cost[0] = 1500;
+    s_cost[1] = 500;
+    run_until(100000);
+    CHECK(s_runs[0] == 10 && a->deadline_miss == 0);
+    CHECK(b->deadline_miss == 0 && b->max_latency_us == 1500);
+
+    /* A运行2.5ms: 每次都错过 */
+    s_cost[0] = 2500;
+    run_until(150000);
+    CHECK(a->deadline_miss == 5);
+
+    /* B运行很快, 但被高优先级A阻塞, 释放到完成超过截止时间 */
+    s_cost[0] = 9800;
+    s_cost[1] = 300;
+    run_until(170000);
+    CHECK(b->deadline_miss > 0);
+    CHECK(a->max_us == 9800);
+}
+
+/**
+ * @brief  严重超时: 落后超过一个周期时跳到下一个未来的释放点, 不连续补跑
+ */
+static void test_skip(void)
+{
+    const sched_task_t *a;
+
+    reset(0);
+    sched_add_task("a", task_a, 10, 0, 0);
+    a = sched_get_task(0);
+
+    s_cost[0] = 35000;                          /* 释放0, 完成35000, 跳过10000/20000/30000 */
+    CHECK(run_ready() == 1);
+    CHECK(a->skipped == 3);
+    CHECK(sched_time_to_next_us() == 40000 - 35000);
+
+    s_cost[0] = 100;
+    s_now = 40000;
+    CHECK(run_ready() == 1 && s_start[0] == 40000);
+    CHECK(run_ready() == 0);
+    CHECK(a->skipped == 3 && a->deadline_miss == 1);
+}
+
+/**
+ * @brief  事件释放: 立即执行一次, 不改变周期释放时刻; 多次释放合并, 执行期间释放再执行一次
+ */
+static void test_post(void)
+{
+    const sched_task_t *b;
+
+    reset(0);
+    sched_add_task("a", task_a, 1000, 0, 1);
+    sched_add_task("b", task_b, 1000, 5, 0);
+    b = sched_get_task(1);
+    run_ready();
+
+    s_now = 300000;
+    CHECK(sched_time_to_next_us() == 700000);
+    sched_post(1);
+    CHECK(sched_time_to_next_us() == 0);
+    s_now = 301000;
+    CHECK(run_ready() == 1 && s_runs[1] == 2 && s_start[1] == 301000);
+    CHECK(b->max_latency_us == 1000);
+    CHECK(sched_time_to_next_us() == 1000000 - 301000);
+
+    /* 执行前多次释放只执行一次, 释放延迟从第一次释放算起 */
+    s_now = 400000;
+    sched_post(1);
+    s_now = 402000;
+    sched_post(1);
+    s_now = 406000;
+    CHECK(run_ready() == 1 && s_runs[1] == 3);
+    CHECK(b->posts == 3);
+    CHECK(b->max_latency_us == 6000 && b->deadline_miss == 1);
+
+    /* 执行期间 (A中) 释放B: A完成后B再执行 */
+    s_post_self = 1;
+    sched_post(0);
+    CHECK(run_ready() == 2);
+    CHECK(s_runs[0] == 2 && s_runs[1] == 4);
+
+    /* 周期释放与事件释放同时到达只执行一次, 周期照常推进 */
+    s_now = 1000000;
+    sched_post(1);
+    CHECK(run_ready() == 2 && s_runs[1] == 5);
+    CHECK(sched_time_to_next_us() == 1000000);
+
+    /* 无效ID忽略 */
+    sched_post(-1);
+    sched_post(7);
+    CHECK(run_ready() == 0);
+}
+
+/**
+ * @brief  32位微秒时钟回绕 (约71分钟): 周期、等待时间和统计不受影响
+ */
+static void test_wrap(void)
+{
+    const sched_task_t *a, *b;
+    uint32_t last = 0, worst = 0, best = 0xFFFFFFFF;
+    uint32_t start = 0xFFFFFFFFu - 25000;
+    int i;
+
+    reset(start);
+    sched_add_task("a", task_a, 10, 0, 0);
+    sched_add_task("b", task_b, 1000, 0, 1);
+    a = sched_get_task(0);
+    b = sched_get_task(1);
+    s_cost[0] = 200;
+    s_cost[1] = 50;
+
+    CHECK(run_ready() == 2);
+    for (i = 0; i < 20; i++)
+    {
+        last = s_start[0];
+        s_now += sched_time_to_next_us();
+        CHECK(sched_time_to_next_us() == 0);
+        run_ready();
+        if (s_start[0] - last > worst) worst = s_start[0] - last;
+        if (s_start[0] - last < best) best = s_start[0] - last;
+    }
+    CHECK(s_now < start);                       /* 已回绕 */
+    CHECK(s_runs[0] == 21 && s_runs[1] == 1);
+    CHECK(worst == 10000 && best == 10000);
+    CHECK(a->max_us == 200 && a->max_latency_us == 0);
+    CHECK(a->deadline_miss == 0 && a->skipped == 0);
+    CHECK(b->next_release == start + 1000000);
+
+    /* 跨回绕的事件释放 */
+    reset(0xFFFFFF00u);
+    sched_add_task("a", task_a, 1000, 1, 0);
+    run_ready();
+    sched_post(0);
+    s_now += 0x200;
+    CHECK(run_ready() == 1);
+    CHECK(sched_get_task(0)->max_latency_us == 0x200);
+    CHECK(sched_get_task(0)->deadline_miss == 0);
+}
+
+/**
+ * @brief  任务表容量
+ */
+static void test_table(void)
+{
+    int i;
+
+    reset(0);
+    CHECK(sched_add_task("a", task_a, 0, 0, 0) == -1);
+    CHECK(sched_add_task("a", NULL, 10, 0, 0) == -1);
+    for (i = 0; i < SCHED_MAX_TASKS; i++)
+    {
+        CHECK(sched_add_task("a", task_a, 10, 0, 0) == i);
+    }
+    CHECK(sched_add_task("a", task_a, 10, 0, 0) == -1);
+    CHECK(sched_get_task_count() == SCHED_MAX_TASKS);
+}
+
+int main(void)
+{
+    test_release();
+    test_priority();
+    test_deadline();
+    test_skip();
+    test_post();
+    test_wrap();
+    test_table();
+
+    printf("test_scheduler: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
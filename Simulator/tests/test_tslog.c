@@ -0,0 +1,434 @@
+/**
+ ****************************************************************************************************
+ * @file        test_tslog.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       tslog 主机单元测试 (文件模拟的NOR Flash)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * Flash模型按NOR的规则工作: 擦除后为0xFF, 编程只能把1变成0 (要求把0变成1的编程计为违规并拒绝),
+ * 跨页的编程被拒绝, 数据保存在临时文件中, 重新挂载时从文件读取。
+ * 覆盖: 缓冲中的样本可查询、追加+多次重新挂载+轮转后全量查询与写入的样本一致、
+ *       随机区间查询、未同步的页尾在重启后丢失但不损坏数据、时间戳回退修正。
+ * 失败时打印位置并返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "tslog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failed;
+static int s_checks;
+
+#define CHECK(cond) do { \
+        s_checks++; \
+        if (!(cond)) { s_failed++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+    } while (0)
+
+#define FLASH_SIZE      ((uint32_t)TSLOG_SECTORS * TSLOG_SECTOR_SIZE)
+#define LONG_SAMPLES    200000              /* 长序列样本数 (约为日志区容量的2.5倍) */
+#define REMOUNT_EVERY   5000                /* 长序列平均每隔多少样本重新挂载一次 */
+#define RANGE_QUERIES   200
+
+/******************************************************************************************/
+/* 文件模拟的NOR Flash */
+
+typedef struct {
+    FILE *fp;
+    uint32_t reads;
+    uint32_t programs;
+    uint32_t erases;
+    uint32_t rejected;                  /* 越界或跨页而被拒绝的编程 */
+    uint32_t zero_to_one;               /* 要求把0写成1而被拒绝的编程 */
+} nor_t;
+
+static nor_t s_nor;
+
+static uint8_t nor_read(void *ctx, uint32_t addr, uint8_t *buf, uint16_t len)
+{
+    nor_t *nor = ctx;
+
+    nor->reads++;
+    if (addr + len > FLASH_SIZE) return 1;
+    if (fseek(nor->fp, (long)addr, SEEK_SET) != 0) return 1;
+    return fread(buf, 1, len, nor->fp) == len ? 0 : 1;
+}
+
+static uint8_t nor_program(void *ctx, uint32_t addr, const uint8_t *buf, uint16_t len)
+{
+    nor_t *nor = ctx;
+    uint8_t old[TSLOG_PAGE_SIZE];
+    uint16_t i;
+
+    nor->programs++;
+    if (len == 0 || addr + len > FLASH_SIZE || addr % TSLOG_PAGE_SIZE + len > TSLOG_PAGE_SIZE)
+    {
+        nor->rejected++;
+        return 1;
+    }
+
+    if (fseek(nor->fp, (long)addr, SEEK_SET) != 0 || fread(old, 1, len, nor->fp) != len) return 1;
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] & ~old[i])
+        {
+            nor->zero_to_one++;
+            return 1;
+        }
+        old[i] &= buf[i];
+    }
+
+    if (fseek(nor->fp, (long)addr, SEEK_SET) != 0) return 1;
+    return fwrite(old, 1, len, nor->fp) == len ? 0 : 1;
+}
+
+static uint8_t nor_erase(void *ctx, uint32_t addr)
+{
+    nor_t *nor = ctx;
+    uint8_t blank[TSLOG_SECTOR_SIZE];
+
+    nor->erases++;
+    if (addr >= FLASH_SIZE) return 1;
+    memset(blank, 0xFF, sizeof(blank));
+    if (fseek(nor->fp, (long)(addr / TSLOG_SECTOR_SIZE * TSLOG_SECTOR_SIZE), SEEK_SET) != 0) return 1;
+    return fwrite(blank, 1, sizeof(blank), nor->fp) == sizeof(blank) ? 0 : 1;
+}
+
+/**
+ * @brief  新建一块出厂状态的Flash (内容随机, 需要格式化)
+ */
+static void nor_open(void)
+{
+    uint32_t i;
+
+    memset(&s_nor, 0, sizeof(s_nor));
+    s_nor.fp = tmpfile();
+    if (s_nor.fp == NULL)
+    {
+        perror("tmpfile");
+        exit(2);
+    }
+    for (i = 0; i < FLASH_SIZE; i++) fputc((int)(i * 2654435761u >> 24), s_nor.fp);
+}
+
+static void nor_close(void)
+{
+    fclose(s_nor.fp);
+    s_nor.fp = NULL;
+}
+
+static const tslog_flash_t s_flash = { nor_read, nor_program, nor_erase, &s_nor };
+
+/******************************************************************************************/
+/* 参考序列 */
+
+static tslog_sample_t s_ref[LONG_SAMPLES];  /* 写入的样本 (含被修正后的时间戳) */
+static uint32_t s_ref_len;
+static uint32_t s_seed;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return s_seed >> 8;
+}
+
+/**
+ * @brief  生成下一个样本: 间隔约60秒, 各通道缓慢随机游走, 偶尔跳变
+ */
+static void next_sample(tslog_sample_t *s)
+{
+    uint8_t ch;
+    uint32_t r;
+
+    s->ts += 55 + rnd() % 11;
+    if (rnd() % 500 == 0) s->ts += 3600;    /* 偶尔断电一段时间 */
+    for (ch = 0; ch < TSLOG_CHANNELS; ch++)
+    {
+        r = rnd() % 100;
+        if (r < 10) s->v[ch]++;
+        else if (r < 20) s->v[ch]--;
+        else if (r == 20) s->v[ch] = (uint8_t)rnd();
+    }
+}
+
+static uint8_t append_ref(tslog_t *log, const tslog_sample_t *s)
+{
+    if (tslog_append(log, s->ts, s->v) != 0) return 1;
+    s_ref[s_ref_len++] = *s;
+    return 0;
+}
+
+/**
+ * @brief  查询结果与参考序列逐个比较
+ */
+typedef struct {
+    const tslog_sample_t *expect;       /* 期望的第一个样本 */
+    uint32_t count;
+    uint32_t bad;
+} cmp_t;
+
+static uint8_t visit_cmp(const tslog_sample_t *sample, void *arg)
+{
+    cmp_t *c = arg;
+
+    if (memcmp(sample, &c->expect[c->count], sizeof(tslog_sample_t)) != 0) c->bad++;
+    c->count++;
+    return 0;
+}
+
+static uint8_t visit_stop(const tslog_sample_t *sample, void *arg)
+{
+    (void)sample;
+    (void)arg;
+    return 1;
+}
+
+/**
+ * @brief  参考序列中第一个时间不小于ts的样本下标
+ */
+static uint32_t ref_lower_bound(uint32_t first, uint32_t ts)
+{
+    uint32_t lo = first, hi = s_ref_len, mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (s_ref[mid].ts < ts) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief  全量查询: 结果应为参考序列的一段后缀 (更早的样本已被轮转覆盖)
+ * @retval 保留的样本数
+ */
+static uint32_t check_all(tslog_t *log)
+{
+    uint32_t t_first, t_last, first;
+    cmp_t c;
+
+    CHECK(tslog_get_range(log, &t_first, &t_last) == 0);
+    CHECK(t_last == s_ref[s_ref_len - 1].ts);
+
+    first = ref_lower_bound(0, t_first);
+    CHECK(first < s_ref_len && s_ref[first].ts == t_first);
+
+    memset(&c, 0, sizeof(c));
+    c.expect = &s_ref[first];
+    CHECK(tslog_query(log, 0, 0xFFFFFFFF, visit_cmp, &c) == s_ref_len - first);
+    CHECK(c.count == s_ref_len - first && c.bad == 0);
+    return c.count;
+}
+
+/**
+ * @brief  全量查询: 结果应为参考序列的前缀 (重启丢失的只能是最后写入的样本)
+ * @retval 保留的样本数
+ */
+static uint32_t check_prefix(tslog_t *log)
+{
+    cmp_t c;
+
+    memset(&c, 0, sizeof(c));
+    c.expect = s_ref;
+    tslog_query(log, 0, 0xFFFFFFFF, visit_cmp, &c);
+    CHECK(c.count <= s_ref_len && c.bad == 0);
+    return c.count;
+}
+
+/******************************************************************************************/
+/* 测试 */
+
+/**
+ * @brief  格式化、缓冲中的样本可查询、时间戳回退修正、提前结束查询
+ */
+static void test_basic(void)
+{
+    static tslog_t log;
+    tslog_sample_t s = { 1000, { 25, 60, 45, 80 } };
+    uint32_t t_first, t_last, i;
+    cmp_t c = { NULL, 0, 0 };
+
+    nor_open();
+    CHECK(tslog_mount(&log, &s_flash) == 0);
+    CHECK(tslog_format(&log) == 0);
+    CHECK(tslog_get_range(&log, &t_first, &t_last) == 1);
+    CHECK(tslog_query(&log, 0, 0xFFFFFFFF, visit_cmp, &c) == 0);
+
+    s_ref_len = 0;
+    s_seed = 1;
+    for (i = 0; i < 50; i++)
+    {
+        CHECK(append_ref(&log, &s) == 0);
+        next_sample(&s);
+    }
+    CHECK(s_nor.programs == 0);                 /* 还在页缓冲中 */
+    CHECK(check_all(&log) == 50);
+
+    /* 不变的样本每条2字节 */
+    i = log.stats.bytes;
+    CHECK(tslog_append(&log, s_ref[49].ts + 60, s_ref[49].v) == 0);
+    CHECK(log.stats.bytes - i == 2);
+    s_ref[s_ref_len].ts = s_ref[49].ts + 60;
+    memcpy(s_ref[s_ref_len].v, s_ref[49].v, TSLOG_CHANNELS);
+    s_ref_len++;
+
+    /* 时间戳回退: 按上一样本的时间记录 */
+    s.ts = s_ref[s_ref_len - 1].ts - 100;
+    CHECK(tslog_append(&log, s.ts, s.v) == 0);
+    CHECK(log.stats.ts_clamped == 1);
+    s.ts = s_ref[s_ref_len - 1].ts;
+    s_ref[s_ref_len++] = s;
+    CHECK(check_all(&log) == 52);
+
+    /* 单点区间、回调返回非0时停止、空区间 */
+    memset(&c, 0, sizeof(c));
+    c.expect = &s_ref[10];
+    CHECK(tslog_query(&log, s_ref[10].ts, s_ref[10].ts, visit_cmp, &c) == 1 && c.bad == 0);
+    CHECK(tslog_query(&log, 0, 0xFFFFFFFF, visit_stop, &c) == 1);
+    CHECK(tslog_query(&log, 20, 10, visit_stop, &c) == 0);
+
+    CHECK(tslog_sync(&log) == 0);
+    CHECK(s_nor.programs == 1);
+    CHECK(tslog_mount(&log, &s_flash) == 0);
+    CHECK(check_all(&log) == 52);
+
+    CHECK(s_nor.rejected == 0 && s_nor.zero_to_one == 0);
+    CHECK(log.stats.flash_errors == 0);
+    nor_close();
+}
+
+/**
+ * @brief  长序列: 多次同步后重新挂载、轮转超过两圈, 全量查询与写入一致, 再做随机区间查询
+ */
+static void test_long(void)
+{
+    static tslog_t log;
+    tslog_sample_t s = { 1760000000, { 25, 60, 45, 80 } };
+    uint32_t i, remounts = 0, kept, bytes = 0, reads = 0, bad = 0;
+    uint32_t first, t_first, t_last, a, b, lo, hi, n;
+    cmp_t c;
+
+    nor_open();
+    CHECK(tslog_mount(&log, &s_flash) == 0);
+    CHECK(tslog_format(&log) == 0);
+    s_ref_len = 0;
+    s_seed = 2;
+
+    for (i = 0; i < LONG_SAMPLES; i++)
+    {
+        next_sample(&s);
+        if (append_ref(&log, &s) != 0) break;
+
+        if (rnd() % REMOUNT_EVERY == 0)
+        {
+            bytes += log.stats.bytes;
+            CHECK(tslog_sync(&log) == 0);
+            CHECK(tslog_mount(&log, &s_flash) == 0);
+            CHECK(log.last.ts == s.ts && memcmp(log.last.v, s.v, TSLOG_CHANNELS) == 0);
+            remounts++;
+        }
+    }
+    CHECK(s_ref_len == LONG_SAMPLES);
+    bytes += log.stats.bytes;
+
+    kept = check_all(&log);
+    CHECK(log.seq >= 2 * TSLOG_SECTORS);        /* 已轮转两圈以上 */
+    CHECK(kept > (TSLOG_SECTORS - 1) * (TSLOG_SECTOR_SIZE / 4));
+
+    /* 重新挂载后结果不变 */
+    CHECK(tslog_sync(&log) == 0);
+    CHECK(tslog_mount(&log, &s_flash) == 0);
+    CHECK(check_all(&log) == kept);
+
+    /* 随机1~24小时区间 */
+    CHECK(tslog_get_range(&log, &t_first, &t_last) == 0);
+    first = s_ref_len - kept;
+    for (i = 0; i < RANGE_QUERIES; i++)
+    {
+        a = t_first + rnd() % (t_last - t_first);
+        b = a + 3600 * (1 + rnd() % 24);
+        lo = ref_lower_bound(first, a);
+        hi = ref_lower_bound(lo, b + 1);
+
+        memset(&c, 0, sizeof(c));
+        c.expect = &s_ref[lo];
+        log.stats.sectors_read = 0;
+        n = tslog_query(&log, a, b, visit_cmp, &c);
+        reads += log.stats.sectors_read;
+        if (n != hi - lo || c.count != n || c.bad != 0) bad++;
+    }
+    CHECK(bad == 0);
+    CHECK(reads <= RANGE_QUERIES * 3);          /* 只解码与区间相交的扇区 */
+
+    printf("%lu samples, %lu remounts: %.2f B/sample, %lu kept, range queries read %.2f of %d sectors\n",
+           (unsigned long)s_ref_len, (unsigned long)remounts, (double)bytes / s_ref_len, (unsigned long)kept,
+           (double)reads / RANGE_QUERIES, TSLOG_SECTORS);
+
+    CHECK(s_nor.rejected == 0 && s_nor.zero_to_one == 0);
+    CHECK(log.stats.flash_errors == 0);
+    nor_close();
+}
+
+/**
+ * @brief  未同步就重启: 只丢失页缓冲中的样本, 已写入的数据完整, 之后可以继续追加
+ */
+static void test_unsynced(void)
+{
+    static tslog_t log;
+    tslog_sample_t s = { 5000, { 25, 60, 45, 80 } };
+    uint32_t i, before, kept, lost;
+    int round;
+
+    nor_open();
+    CHECK(tslog_mount(&log, &s_flash) == 0);
+    CHECK(tslog_format(&log) == 0);
+    s_ref_len = 0;
+    s_seed = 3;
+
+    for (round = 0; round < 20; round++)
+    {
+        /* 每轮追加的样本数不同, 未同步的尾部可能跨过页边界或扇区边界 */
+        before = s_ref_len;
+        for (i = 0; i < 37 + (uint32_t)round * 211; i++)
+        {
+            next_sample(&s);
+            CHECK(append_ref(&log, &s) == 0);
+        }
+        if (round % 5 == 4) CHECK(tslog_sync(&log) == 0);
+
+        /* 掉电: 丢弃RAM中的实例, 从Flash重新挂载 */
+        memset(&log, 0xA5, sizeof(log));
+        CHECK(tslog_mount(&log, &s_flash) == 0);
+
+        /* 重启后的内容是已写入样本的前缀 */
+        kept = check_prefix(&log);
+        lost = s_ref_len - kept;
+        CHECK(kept >= before);                  /* 上一轮保留的样本都已在Flash中 */
+        CHECK(lost <= TSLOG_PAGE_SIZE / 2);     /* 最多一页 (每条至少2字节) */
+        if (round % 5 == 4) CHECK(lost == 0);
+        s_ref_len = kept;
+        if (kept > 0) s = s_ref[kept - 1];
+    }
+
+    CHECK(s_nor.rejected == 0 && s_nor.zero_to_one == 0);
+    CHECK(log.stats.flash_errors == 0);
+    nor_close();
+}
+
+int main(void)
+{
+    test_basic();
+    test_long();
+    test_unsynced();
+
+    printf("test_tslog: %d checks, %d failed\n", s_checks, s_failed);
+    return s_failed ? 1 : 0;
+}
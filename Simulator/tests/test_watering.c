@@ -0,0 +1,130 @@
+/**
+ ****************************************************************************************************
+ * @file        test_watering.c
+ * @author      NixStudio(NixLockhart)
+ * @version     V1.0
+ * @date        2026-10-17
+ * @brief       浇水控制器闭环测试: 脉冲-渗透 对比 开泵直到读数达标, 土壤用两层滞后模型
+ ****************************************************************************************************
+ * @attention
+ *
+ * 平台: Linux 主机
+ *
+ * 从干燥的土壤开始闭环运行4小时 (100ms步长, 与固件控制周期相同量级), 两种控制方式:
+ * - pulse-soak: Functions/Control/watering.c, 参数与固件相同 (ctrl_rules.h)
+ * - on-off:     改造前的自动模式, 读数低于下限开泵, 高于上限关泵
+ * 要求脉冲-渗透的根区峰值不超过上限且没有从盆底流失, 开关控制则明显超调 (说明模型的滞后起作用)。
+ * 失败时返回非0, 由ctest判定
+ *
+ ****************************************************************************************************
+ */
+
+#include "ctrl_rules.h"
+#include "sim_soil.h"
+#include <stdio.h>
+
+#define RUN_MS          (4UL * 3600 * 1000)
+#define STEP_MS         100
+#define SOIL_START      30.0
+
+static const uint8_t s_lower = 40;
+static const uint8_t s_upper = 65;
+
+static uint8_t s_pump;
+
+static void pump_set(uint8_t on)
+{
+    s_pump = on;
+}
+
+typedef struct {
+    double peak;                /* 根区峰值 */
+    double runoff;              /* 流失水量 */
+    double end;                 /* 结束时根区湿度 */
+    double pump_s;              /* 累计开泵时间 */
+    uint32_t starts;            /* 开泵次数 */
+} result_t;
+
+/**
+ * @brief  闭环运行
+ * @param  pulse_soak: 1:脉冲-渗透控制器 0:开关控制
+ */
+static void run(uint8_t pulse_soak, result_t *r)
+{
+    static const water_config_t cfg = {
+        {pump_set, &s_pump},
+        &s_lower, &s_upper,
+        WATER_MS_PER_PCT, WATER_MIN_PULSE_MS, WATER_MAX_PULSE_MS,
+        WATER_SOAK_MS, WATER_HOUR_CAP_MS, WATER_FLOW_ML_MIN, WATER_DRY_PULSES,
+    };
+    sim_soil_t soil;
+    uint32_t now;
+    uint8_t reading, was_on = 0;
+
+    s_pump = 0;
+    sim_soil_init(&soil, SOIL_START);
+    water_init(&cfg, 0);
+    r->pump_s = 0;
+    r->starts = 0;
+
+    for (now = 0; now < RUN_MS; now += STEP_MS)
+    {
+        reading = (uint8_t)(soil.root + 0.5);
+
+        if (pulse_soak)
+        {
+            water_step(reading, 1, now);
+        }
+        else
+        {
+            if (reading < s_lower) pump_set(1);
+            else if (reading > s_upper) pump_set(0);
+        }
+
+        if (s_pump && !was_on) r->starts++;
+        was_on = s_pump;
+        if (s_pump) r->pump_s += STEP_MS / 1000.0;
+
+        sim_soil_step(&soil, s_pump, STEP_MS / 1000.0);
+    }
+
+    r->peak = soil.peak;
+    r->runoff = soil.runoff;
+    r->end = soil.root;
+}
+
+int main(void)
+{
+    result_t ps, oo;
+    water_stats_t st;
+    int failed = 0;
+
+    run(0, &oo);
+    run(1, &ps);
+    water_get_stats(&st);
+
+    printf("%-10s %8s %8s %8s %8s %7s\n", "control", "peak %", "runoff %", "end %", "pump s", "starts");
+    printf("%-10s %8.1f %8.1f %8.1f %8.1f %7lu\n", "on-off", oo.peak, oo.runoff, oo.end, oo.pump_s,
+           (unsigned long)oo.starts);
+    printf("%-10s %8.1f %8.1f %8.1f %8.1f %7lu\n", "pulse-soak", ps.peak, ps.runoff, ps.end, ps.pump_s,
+           (unsigned long)ps.starts);
+
+    if (ps.peak > s_upper || ps.runoff > 0)
+    {
+        printf("FAIL: pulse-soak overshoots the upper limit\n");
+        failed = 1;
+    }
+    if (ps.end < s_lower - 1 || st.faults != 0)
+    {
+        printf("FAIL: pulse-soak does not keep the soil above the lower limit (faults %lu)\n",
+               (unsigned long)st.faults);
+        failed = 1;
+    }
+    if (oo.peak < s_upper + 10)
+    {
+        printf("FAIL: on-off control does not overshoot, soil model has no lag\n");
+        failed = 1;
+    }
+
+    return failed;
+}
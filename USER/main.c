@@ -38,7 +38,28 @@
 #include "lvgl/lvgl.h"
 #include "lv_port_disp_template.h"
 #include "lv_port_indev_template.h"
+#include "scheduler.h"
+#include "history.h"
+#include "ctrl_rules.h"
+#include "wallclock.h"
+#include "perf.h"
 
+#define LCD_BENCH_ENABLE	0		/* 1: ʱˢٶȲԲӡ () */
+
+#if LCD_BENCH_ENABLE
+/**
+ * @brief  ˢٶȲ, ӡԴ
+ */
+static void Lcd_Benchmark(void) {
+	static uint16_t buf[320 * 2];	/* Դ */
+	lcd_bench_t res;
+
+	lcd_benchmark(micros, buf, sizeof(buf) / sizeof(buf[0]), &res);
+	printf("[LCD] id=%04X %ux%u solid=%lu px/s blit=%lu px/s row=%lu px/s dma=%lu px/s\r\n",
+	       res.id, res.width, res.height, (unsigned long)res.solid_pps, (unsigned long)res.blit_pps,
+	       (unsigned long)res.row_pps, (unsigned long)res.dma_pps);
+}
+#endif
 
 /**
  * @brief  ϵͳʼ
@@ -47,8 +68,11 @@
  */
 void System_Init() {
 	uint8_t ret;
-	delay_init();
+	tslog_flash_t spool_flash;
 	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+	delay_init();				/* ϵͳʱTIM3 (ʱ/LVGL//Э鹲) */
+	DWT_Init();
+	perf_init(DWT_Get_Cycles, SystemCoreClock / 1000000);	/* ֶ */
 	uart_init(115200);
 	LED_Init();	 				/* ʼLED */
 	Adc_Init();					/* ʼADC */
@@ -57,9 +81,15 @@ void System_Init() {
 	Lsens_Init();				/* ʼ */
 	TS_Init();					/* ʼʪȴ(PA5) */
 	tp_dev.init();				/* ʼ */
-	TIM3_Int_Init(71, 999);
+	history_init();				/* W25QXXʷ־ */
+	if (history_get_spool_flash(&spool_flash) == 0) {
+		myserver_telemetry_set_spool(&spool_flash, HISTORY_SPOOL_SECTORS);	/* ϱW25QXX */
+	}
 	lv_init();					/* ʼLVGL */
 	lv_port_disp_init();
+#if LCD_BENCH_ENABLE
+	Lcd_Benchmark();
+#endif
 	lv_port_indev_init();
 	BUMP_Init();				/* ʼˮü̵(PA7) */
 	FUN_Init();					/* ʼȼ̵(PA6) */
@@ -78,6 +108,10 @@ void System_Init() {
 
 	/* ʼUIģ */
 	UI_Init();
+
+	/* ʼԶ (ֻĸ澯ȼɫ) */
+	ctrl_rules_init();
+	ctrl_subscribe(ui_ctrl_event);
 }
 
 /**
@@ -86,129 +120,388 @@ void System_Init() {
  * @retval 
  */
 void Get_Monitor_Value(void) {
-	DHT11_Read_Data(&temp, &humi);   		/* ʪ */
+	dht_stale = DHT11_Get_Data(&temp, &humi);	/* ʪ (̨תĻֵ), ʱ/ϱ/治ʹ */
 	TS_GetData(&soil_humi);         		/* ʪ */
 	Lsens_Get_Val(&light_intensity);		/* ǿ */
 }
 
+/******************************************************************************************/
+/*  */
+
+static int8_t s_task_server = -1;		/* ID (֡¼ͷ) */
+static int8_t s_task_ui = -1;			/* ˢID (Ľͷ) */
+
 /**
- * @brief  
- * @param  
- * @retval 
+ * @brief  봥ɨ
  */
-int main(void)
-{
-	uint8_t t = 0;
+static void Task_Input(void) {
+	uint8_t key;
+
+	PERF_BEGIN(PERF_INPUT);
+	key = KEY_Scan(0);
+	UI_Switch(key);
+
+	/* ⴥ */
+	if (tpad_scan(0)) {
+		UI_Switch(10);
+	}
+	PERF_END(PERF_INPUT);
+}
+
+/**
+ * @brief  ɼ
+ */
+static void Task_Sensor(void) {
+	PERF_BEGIN(PERF_ADC);
+	Get_Monitor_Value();
+	PERF_END(PERF_ADC);
+}
+
+/**
+ * @brief  DHT11̨ת (ʼźżʱ/ʱ/У)
+ */
+static void Task_DHT11(void) {
+	PERF_BEGIN(PERF_DHT11);
+	DHT11_Process();
+	PERF_END(PERF_DHT11);
+}
+
+/**
+ * @brief  澯Զ
+ * @note   Ʒ/ˮ/, κν¶ִ
+ */
+static void Task_Control(void) {
+	PERF_BEGIN(PERF_CONTROL);
+	ctrl_rules_step();
+	PERF_END(PERF_CONTROL);
+}
+
+/**
+ * @brief  ϱ
+ * @note   myserverϱֵֻ״̬仯ʱ, ڷ͹ؼ֡
+ *         δʱͬ, ߻, 󲹷
+ */
+static void Task_Telemetry(void) {
 	my_sensor_data_t sensor_data;
 	my_device_status_t device_status;
 
-	System_Init();
-	create_main_screen();
+	sensor_data.temperature = dht_stale ? MY_SENSOR_INVALID : temp;
+	sensor_data.humidity = dht_stale ? MY_SENSOR_INVALID : humi;
+	sensor_data.soil_humidity = soil_humi;
+	sensor_data.light_intensity = light_intensity;
 
-	/* WiFi */
-	if (wifi_sta == 2 || myserver_wifi_connect()) {
-		create_popup();
-		show_popup("WiFi Connect Failed!", 3000);
-		wifi_sta = 0;
-	}
-	else {
-		wifi_sta = 1;
-		create_popup();
-		show_popup("WiFi Connected!", 3000);
-	}
+	device_status.mode = mode;
+	device_status.light_status = light_status;
+	device_status.water_status = water_status;
+	device_status.fan_status = fun_status;
 
-	/* ӷ */
-	if (wifi_sta) {
-		if (myserver_connect() == 0) {
-			atkcld_sta = 1;
+	PERF_BEGIN(PERF_TLM);
+	myserver_report(&sensor_data, &device_status);
+	PERF_END(PERF_TLM);
+}
+
+/**
+ * @brief  WiFiͷӹ: ˢ״̬, Ͽʱں̨ ()
+ */
+static void Task_Link(void) {
+	static uint8_t backoff = 0;		/* ´ */
+	static uint8_t was_busy = 0;
+	my_link_stats_t link;
+	uint8_t wifi_now, server_now;
+
+	/* ״̬, 仯ʱʾ */
+	wifi_now = (myserver_check_wifi() == MY_WIFI_CONNECTED);
+	server_now = wifi_now && (myserver_check_server() == MY_SERVER_CONNECTED);	/* WiFiϿʱҲϿ */
+	if (wifi_now != wifi_sta || server_now != atkcld_sta) {
+		if (server_now && !atkcld_sta) {
 			create_popup();
 			show_popup("Server Connected!", 3000);
-		} else {
-			atkcld_sta = 0;
+		} else if (wifi_now && !wifi_sta) {
 			create_popup();
-			show_popup("Server Connect Failed!", 3000);
+			show_popup("WiFi Connected!", 3000);
 		}
+		wifi_sta = wifi_now;
+		atkcld_sta = server_now;
+		update_wifi_status();
 	}
 
-	while (1)
-	{
-		uint8_t key = KEY_Scan(0);
-		UI_Switch(key);
+	/* ӹATں̨ƽ */
+	if (myserver_link_busy()) {
+		was_busy = 1;
+		return;
+	}
 
-		/* ⴥ */
-		if (tpad_scan(0)) {
-			UI_Switch(10);
+	/* ʧ: ʾ˱ (WiFiʧܴÿζ5s, 60s) */
+	if (was_busy) {
+		was_busy = 0;
+		if (!wifi_now) {
+			myserver_link_get_stats(&link);
+			backoff = link.fail_streak < 12 ? link.fail_streak * 10 : 120;
+			create_popup();
+			show_popup("WiFi Connect Failed!", 3000);
+		} else if (!server_now) {
+			backoff = 10;
+			create_popup();
+			show_popup("Server Connect Failed!", 3000);
 		}
+	}
 
-		Get_Monitor_Value();
-
-		/* ÿ200ms(t%4==0)ִϱ */
-		if (t % 4 == 0) {
-			Warn_function();
-
-			/* ʹݵ */
-			if (atkcld_sta) {
-				sensor_data.temperature = temp;
-				sensor_data.humidity = humi;
-				sensor_data.soil_humidity = soil_humi;
-				sensor_data.light_intensity = light_intensity;
-				myserver_send_sensor_data(&sensor_data);
-
-				/* 豸״̬ */
-				device_status.mode = mode;
-				device_status.light_status = light_status;
-				device_status.water_status = water_status;
-				device_status.fan_status = fun_status;
-				myserver_send_device_status(&device_status);
-			}
+	if (!server_now) {
+		if (backoff > 0) {
+			backoff--;
+			return;
 		}
+		printf("[Reconnect] Trying to reconnect %s...\r\n", wifi_now ? "server" : "WiFi");
+		myserver_link_start(1);
+		was_busy = 1;		/* ӱܾʱ´μǰѽ, ͬҪ˱ */
+	}
+}
 
-		/* ÿ5(t>=99)WiFiͷ״̬ */
-		if (t >= 99) {
-			t = 0;
-
-			/* ״̬ʾ */
-			uint8_t server_check = myserver_check_server();
-			if (server_check == MY_SERVER_CONNECTED) {
-				atkcld_sta = 1;
-			} else {
-				atkcld_sta = 0;
-			}
-
-			/* WiFi״̬ */
-			uint8_t wifi_check = myserver_check_wifi();
-			if (wifi_check == MY_WIFI_CONNECTED) {
-				wifi_sta = 1;
-			} else {
-				wifi_sta = 0;
-				atkcld_sta = 0;  /* WiFiϿʱҲϿ */
-			}
-			update_wifi_status();
-
-			/* WiFiӵδ,  */
-			if (wifi_sta == 1 && atkcld_sta == 0) {
-				printf("[Reconnect] Trying to reconnect server...\r\n");
-				if (myserver_connect() == 0) {
-					atkcld_sta = 1;
-					create_popup();
-					show_popup("Server Reconnected!", 2000);
-					printf("[Reconnect] Server reconnected!\r\n");
-				}
-			}
-		}
+/**
+ * @brief  ATָ״̬
+ */
+static void Task_AT(void) {
+	PERF_BEGIN(PERF_AT);
+	atk_mw8266d_at_poll();
+	myserver_link_poll();
+	PERF_END(PERF_AT);
+}
+
+/**
+ * @brief  ͨ: ߿
+ * @note   ȼϿ: ȡ"CLOSED"֡, ֻ֮ܵʱŷֶϿ;
+ *         ֡¼ͷ, ÿδһ, ʱͷһ,
+ *         Ľ½ȼϵ͵Ľ
+ */
+static void Task_Server(void) {
+	myserver_process();
+	myserver_wireless_control();
+	if (myserver_rx_pending()) {
+		sched_post(s_task_server);
+	}
+	if (myserver_ui_pending()) {
+		sched_post(s_task_ui);
+	}
+}
 
-		/* ߿ */
-		myserver_wireless_control();
+/**
+ * @brief  ESP8266֡¼ (USART3же)
+ */
+static void ESP_Frame_Event(void) {
+	myserver_rx_event();
+	sched_post(s_task_server);
+}
 
-		/*  */
-		myserver_process();
+/**
+ * @brief  /ʷˢ, ԼԶĵͽ
+ */
+static void Task_UI(void) {
+	PERF_BEGIN(PERF_UI);
+	myserver_ui_update();
+	if (get_current_screen() == SCREEN_MAIN) {
+		update_main_screen();
+	} else if (get_current_screen() == SCREEN_HISTORY) {
+		update_history_screen();
+	}
+	PERF_END(PERF_UI);
+}
 
-		if (get_current_screen() == SCREEN_MAIN) {
-			update_main_screen();
-		}
+/**
+ * @brief  ʷݼ¼
+ * @note   ϵһڴֵδȶ, ¼; DHT11ʱʪȼΪЧֵ
+ */
+static void Task_History(void) {
+	if (millis() < HISTORY_PERIOD_MS) return;
+	PERF_BEGIN(PERF_HISTORY);
+	history_record(dht_stale ? HISTORY_VALUE_INVALID : temp, dht_stale ? HISTORY_VALUE_INVALID : humi,
+	               soil_humi, light_intensity);
+	PERF_END(PERF_HISTORY);
+}
+
+/**
+ * @brief  LVGLʱ
+ */
+static void Task_LVGL(void) {
+	PERF_BEGIN(PERF_LVGL);
+	lv_timer_handler();
+	PERF_END(PERF_LVGL);
+}
 
-		lv_timer_handler();
-		delay_ms(50);
-		t++;
+/**
+ * @brief  /ڶ/ϱ/ˢ//ʷͳƴӡ
+ */
+static void Task_Stats(void) {
+	atk_mw8266d_uart_tx_stats_t tx;
+	atk_mw8266d_uart_rx_stats_t rx;
+	my_telemetry_stats_t tlm;
+	lv_port_disp_stats_t disp;
+	tslog_stats_t hist;
+	ctrl_stats_t ctrl;
+	water_stats_t water;
+	my_link_stats_t link;
+	atk_mw8266d_at_stats_t at;
+	hb_stats_t hb;
+	my_cmd_stats_t cmd;
+	wallclock_stats_t clk;
+	perf_stats_t perf;
+	uint8_t i;
+
+	PERF_BEGIN(PERF_STATS);
+	sched_print_stats();
+
+	atk_mw8266d_uart_tx_get_stats(&tx);
+	printf("[UART3] tx queued=%lu sent=%lu used=%u hwm=%u/%u rejected=%lu(%lu B)\r\n",
+	       (unsigned long)tx.queued_bytes, (unsigned long)tx.sent_bytes, tx.used, tx.high_water,
+	       ATK_MW8266D_UART_TX_RING_SIZE - 1, (unsigned long)tx.rejected, (unsigned long)tx.rejected_bytes);
+
+	myserver_telemetry_get_stats(&tlm);
+	printf("[Telemetry] dat sent=%lu suppressed=%lu, sta sent=%lu suppressed=%lu, keyframes=%lu failed=%lu\r\n",
+	       (unsigned long)tlm.dat_sent, (unsigned long)tlm.dat_suppressed, (unsigned long)tlm.sta_sent,
+	       (unsigned long)tlm.sta_suppressed, (unsigned long)tlm.keyframes, (unsigned long)tlm.send_failed);
+	printf("[Telemetry] samples sent=%lu dropped=%lu, batch size=%u, enc=%s bytes=%lu\r\n",
+	       (unsigned long)tlm.samples_sent, (unsigned long)tlm.samples_dropped, tlm.batch_size,
+	       tlm.encoding == MY_ENC_BIN ? "bin1" : "json", (unsigned long)tlm.bytes_sent);
+	printf("[Telemetry] offline spooled=%lu replayed=%lu pending=%lu\r\n",
+	       (unsigned long)tlm.spooled, (unsigned long)tlm.replayed, (unsigned long)tlm.spool_pending);
+
+	atk_mw8266d_uart_rx_get_stats(&rx);
+	printf("[UART3] rx frames=%lu pending=%u dropped=%lu(%lu B) overrun=%lu ore=%lu\r\n",
+	       (unsigned long)rx.frames, rx.pending, (unsigned long)rx.dropped_frames,
+	       (unsigned long)rx.dropped_bytes, (unsigned long)rx.overrun, (unsigned long)rx.uart_ore);
+
+	atk_mw8266d_at_get_stats(&at);
+	printf("[AT] submitted=%lu ok=%lu error=%lu timeout=%lu aborted=%lu rejected=%lu max=%lums pending=%u\r\n",
+	       (unsigned long)at.submitted, (unsigned long)at.ok, (unsigned long)at.errors, (unsigned long)at.timeouts,
+	       (unsigned long)at.aborted, (unsigned long)at.rejected, (unsigned long)at.max_ms, at.pending);
+
+	lv_port_disp_get_stats(&disp);
+	printf("[Disp] %s frames=%lu flushes=%lu frame last=%luus avg=%luus max=%luus cpu last=%luus avg=%luus px=%lu\r\n",
+	       disp.dma ? "dma" : "cpu", (unsigned long)disp.frames, (unsigned long)disp.flushes,
+	       (unsigned long)disp.last_frame_us, (unsigned long)(disp.frames ? (uint32_t)(disp.total_frame_us / disp.frames) : 0),
+	       (unsigned long)disp.max_frame_us, (unsigned long)disp.last_cpu_us,
+	       (unsigned long)(disp.frames ? (uint32_t)(disp.total_cpu_us / disp.frames) : 0), (unsigned long)disp.last_px);
+	printf("[Render] last=%luus avg=%luus max=%luus wait=%luus areas=%u mem used=%lu free=%lu max=%lu frag=%u%%\r\n",
+	       (unsigned long)disp.last_render_us,
+	       (unsigned long)(disp.frames ? (uint32_t)(disp.total_render_us / disp.frames) : 0),
+	       (unsigned long)disp.max_render_us, (unsigned long)disp.last_wait_us, disp.last_areas,
+	       (unsigned long)disp.mem_used, (unsigned long)disp.mem_free, (unsigned long)disp.mem_max_used,
+	       disp.mem_frag_pct);
+
+	ctrl_get_stats(&ctrl);
+	printf("[Control] steps=%lu switches=%lu held=%lu level_changes=%lu\r\n",
+	       (unsigned long)ctrl.steps, (unsigned long)ctrl.switches, (unsigned long)ctrl.held,
+	       (unsigned long)ctrl.level_changes);
+
+	water_get_stats(&water);
+	printf("[Water] state=%u pulses=%lu cycles=%lu on=%lums delivered=%lumL hour=%lums last=%lums capped=%lu faults=%lu\r\n",
+	       water.state, (unsigned long)water.pulses, (unsigned long)water.cycles, (unsigned long)water.on_ms,
+	       (unsigned long)water.delivered_ml, (unsigned long)water.hour_on_ms, (unsigned long)water.last_pulse_ms,
+	       (unsigned long)water.capped, (unsigned long)water.faults);
+
+	myserver_link_get_stats(&link);
+	printf("[Link] boot-to-online=%lums wifi last=%lums path=%u fast=%lu join=%lu full=%lu failed=%lu streak=%u\r\n",
+	       (unsigned long)link.boot_online_ms, (unsigned long)link.wifi_ms, link.path, (unsigned long)link.fast,
+	       (unsigned long)link.joins, (unsigned long)link.full_resets, (unsigned long)link.failures, link.fail_streak);
+
+	myserver_heartbeat_get_stats(&hb);
+	printf("[Heartbeat] sent=%lu acked=%lu skipped=%lu lost=%lu, rtt min=%lu avg=%lu max=%lu last=%lums, interval=%lums timeout=%lums%s\r\n",
+	       (unsigned long)hb.sent, (unsigned long)hb.acked, (unsigned long)hb.skipped, (unsigned long)hb.lost,
+	       (unsigned long)hb.rtt_min, (unsigned long)hb.rtt_avg, (unsigned long)hb.rtt_max, (unsigned long)hb.rtt_last,
+	       (unsigned long)hb.interval_ms, (unsigned long)hb.timeout_ms, hb.degraded ? " degraded" : "");
+
+	myserver_cmd_get_stats(&cmd);
+	printf("[Cmd] acked=%lu last=%luus avg=%luus max=%luus slow(>%uus)=%lu\r\n",
+	       (unsigned long)cmd.count, (unsigned long)cmd.last_us, (unsigned long)cmd.avg_us,
+	       (unsigned long)cmd.max_us, MY_CMD_SLOW_US, (unsigned long)cmd.slow);
+
+	wallclock_get_stats(&clk);
+	printf("[Clock] %s unix=%lus syncs=%lu steps=%lu rejected=%lu, last err=%ldms slew left=%ldms drift=%ldppm\r\n",
+	       clk.synced ? "synced" : "unsynced", (unsigned long)(wallclock_now(millis()) / 1000),
+	       (unsigned long)clk.syncs, (unsigned long)clk.steps, (unsigned long)clk.rejected,
+	       (long)clk.last_err_ms, (long)clk.slew_ms, (long)clk.drift_ppm);
+
+	history_get_stats(&hist);
+	printf("[History] %s samples=%lu bytes=%lu pages=%lu erases=%lu clamped=%lu errors=%lu\r\n",
+	       history_ready() ? "ok" : "off", (unsigned long)hist.appended, (unsigned long)hist.bytes,
+	       (unsigned long)hist.pages_written, (unsigned long)hist.sectors_erased,
+	       (unsigned long)hist.ts_clamped, (unsigned long)hist.flash_errors);
+
+	/* ֱͼ: <4us <16us <64us <256us <1ms <4ms <16ms >=16ms */
+	for (i = 0; perf_get(i, &perf) == 0; i++) {
+		printf("[Perf] %-8s n=%lu min=%lu avg=%lu max=%luus hist=%u/%u/%u/%u/%u/%u/%u/%u\r\n",
+		       perf.name, (unsigned long)perf.count, (unsigned long)perf.min_us, (unsigned long)perf.avg_us,
+		       (unsigned long)perf.max_us, perf.hist[0], perf.hist[1], perf.hist[2], perf.hist[3],
+		       perf.hist[4], perf.hist[5], perf.hist[6], perf.hist[7]);
+	}
+	PERF_END(PERF_STATS);
+}
+
+/**
+ * @brief  , ʧʱӡ (SCHED_MAX_TASKS)
+ * @retval ID, -1:ʧ
+ */
+static int8_t App_Add_Task(const char *name, sched_task_fn_t fn, uint32_t period_ms,
+                           uint32_t deadline_ms, uint8_t priority) {
+	int8_t id = sched_add_task(name, fn, period_ms, deadline_ms, priority);
+
+	if (id < 0) {
+		printf("[Sched] Failed to add task %s (%u/%u tasks)\r\n", name, sched_get_task_count(), SCHED_MAX_TASKS);
+	}
+	return id;
+}
+
+/**
+ * @brief  
+ * @note   /ֹʱ䵥λΪms, ȼֵԽСԽ
+ */
+static void App_Tasks_Init(void) {
+	sched_init(micros);
+	/*                                    ֹ   ȼ */
+	App_Add_Task("lvgl",      Task_LVGL,      5,     30,    1);
+	App_Add_Task("input",     Task_Input,     50,    0,     0);
+	s_task_server =
+	App_Add_Task("server",    Task_Server,    50,    10,    0);
+	App_Add_Task("at",        Task_AT,        10,    0,     2);
+	App_Add_Task("control",   Task_Control,   200,   0,     2);
+	App_Add_Task("sensor",    Task_Sensor,    200,   0,     3);
+	App_Add_Task("dht11",     Task_DHT11,     10,    0,     3);
+	App_Add_Task("telemetry", Task_Telemetry, 200,   0,     4);
+	s_task_ui =
+	App_Add_Task("ui",        Task_UI,        100,   0,     4);
+	App_Add_Task("link",      Task_Link,      500,   0,     5);
+	App_Add_Task("history",   Task_History,   HISTORY_PERIOD_MS, 0, 6);
+	App_Add_Task("stats",     Task_Stats,     60000, 0,     7);
+
+	/* ֡ʱͷŷ, 50ms */
+	atk_mw8266d_uart_rx_set_callback(ESP_Frame_Event);
+}
+
+/**
+ * @brief  
+ * @param  
+ * @retval 
+ */
+int main(void)
+{
+	System_Init();
+	create_main_screen();
+
+	/* WiFiͷ: ں̨ATƽ, ӹʾ */
+	if (wifi_sta == 2) {
+		create_popup();
+		show_popup("WiFi Connect Failed!", 3000);
+		wifi_sta = 0;
+	} else {
+		myserver_link_start(1);
+	}
+
+	App_Tasks_Init();
+
+	while (1)
+	{
+		/* ûоʱ˯, TIM3ÿ1msжϻ */
+		if (!sched_run_once()) {
+			WFI_SET();
+		}
 	}
 }